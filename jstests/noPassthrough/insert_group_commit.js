@@ -0,0 +1,124 @@
+/**
+ * Tests that concurrent single-document inserts coalesced by group commit are each acknowledged,
+ * replicated and reported on their own, including when some of them fail with a duplicate key, and
+ * that inserts which queue up behind a leader are committed together.
+ *
+ * @tags: [requires_replication]
+ */
+(function() {
+"use strict";
+
+load("jstests/libs/fail_point_util.js");
+load("jstests/libs/parallelTester.js");
+
+const rst =
+    new ReplSetTest({nodes: 1, nodeOptions: {setParameter: {internalInsertGroupCommit: true}}});
+rst.startSet();
+rst.initiate();
+
+const primary = rst.getPrimary();
+const dbName = "test";
+const collName = "insert_group_commit";
+const coll = primary.getDB(dbName)[collName];
+assert.commandWorked(coll.insert({_id: "init"}));
+
+const kNumThreads = 16;
+const kNumInserts = 200;
+// Every tenth insert of every thread uses an _id that all the threads insert.
+const kSharedEvery = 10;
+
+function insertDocuments(host, dbName, collName, threadId, numInserts, sharedEvery) {
+    const coll = new Mongo(host).getDB(dbName)[collName];
+    let numInserted = 0;
+    let numDuplicates = 0;
+    for (let i = 0; i < numInserts; ++i) {
+        const _id = (i % sharedEvery === 0) ? "shared" + i : threadId + "-" + i;
+        const res = coll.runCommand(
+            {insert: collName, documents: [{_id: _id}], writeConcern: {w: 1, j: true}});
+        assert.commandWorked(res);
+        if (res.writeErrors) {
+            assert.eq(1, res.writeErrors.length, tojson(res));
+            assert.eq(ErrorCodes.DuplicateKey, res.writeErrors[0].code, tojson(res));
+            assert.eq(0, res.n, tojson(res));
+            ++numDuplicates;
+        } else {
+            assert.eq(1, res.n, tojson(res));
+            ++numInserted;
+        }
+    }
+    return {numInserted: numInserted, numDuplicates: numDuplicates};
+}
+
+let threads = [];
+for (let t = 0; t < kNumThreads; ++t) {
+    threads.push(new Thread(
+        insertDocuments, primary.host, dbName, collName, t, kNumInserts, kSharedEvery));
+    threads[t].start();
+}
+
+let numInserted = 0;
+let numDuplicates = 0;
+for (let thread of threads) {
+    thread.join();
+    const result = thread.returnData();
+    numInserted += result.numInserted;
+    numDuplicates += result.numDuplicates;
+}
+
+const numShared = kNumInserts / kSharedEvery;
+assert.eq(kNumThreads * (kNumInserts - numShared) + numShared, numInserted);
+assert.eq((kNumThreads - 1) * numShared, numDuplicates);
+
+// Every acknowledged insert is in the collection and has its own oplog entry.
+assert.eq(numInserted + 1, coll.find().itcount());
+const oplog = primary.getDB("local").oplog.rs;
+assert.eq(numInserted + 1, oplog.find({op: "i", ns: coll.getFullName()}).itcount());
+
+// Inserts which arrive while the leader of a group is held up are all inserted by the leader, in a
+// single storage transaction.
+function getGroupCommitMetrics() {
+    const metrics = primary.getDB("admin").serverStatus().metrics.insertGroupCommit;
+    return {
+        groupedCommits: Number(metrics.groupedCommits),
+        groupedInserts: Number(metrics.groupedInserts)
+    };
+}
+
+function insertDocument(host, dbName, collName, id) {
+    const db = new Mongo(host).getDB(dbName);
+    const res = db.runCommand({insert: collName, documents: [{_id: id}]});
+    assert.commandWorked(res);
+    assert.eq(1, res.n, tojson(res));
+}
+
+const metricsBefore = getGroupCommitMetrics();
+const leaderFp = configureFailPoint(primary, "hangInsertGroupCommitLeader");
+const kNumGrouped = 4;
+let groupedThreads = [];
+for (let t = 0; t < kNumGrouped; ++t) {
+    groupedThreads.push(new Thread(insertDocument, primary.host, dbName, collName, "grouped" + t));
+    groupedThreads[t].start();
+    if (t === 0) {
+        leaderFp.wait();
+    }
+}
+
+// Wait for the other inserts to queue up behind the leader.
+assert.soon(() => primary.getDB("admin")
+                      .aggregate([
+                          {$currentOp: {}},
+                          {$match: {op: "insert", ns: coll.getFullName()}},
+                      ])
+                      .itcount() === kNumGrouped);
+leaderFp.off();
+for (let thread of groupedThreads) {
+    thread.join();
+}
+
+const metricsAfter = getGroupCommitMetrics();
+assert.eq(metricsBefore.groupedCommits + 1, metricsAfter.groupedCommits, metricsAfter);
+assert.eq(metricsBefore.groupedInserts + kNumGrouped, metricsAfter.groupedInserts, metricsAfter);
+assert.eq(kNumGrouped, coll.find({_id: /^grouped/}).itcount());
+
+rst.stopSet();
+}());
@@ -0,0 +1,123 @@
+/**
+ * Tests that a localField/foreignField $lookup which joins its input against a hash table over the
+ * foreign collection, or which queries the foreign collection for batches of input documents,
+ * returns the same results as one which queries the foreign collection for each input document,
+ * and that explain reports the strategy used. The hash join is enabled, and every aggregation
+ * allows the use of disk, which the hash join requires.
+ */
+load("jstests/libs/analyze_plan.js");  // For getAggPlanStage.
+
+(function() {
+"use strict";
+
+const conn = MongoRunner.runMongod(
+    {setParameter: {internalDocumentSourceLookupEnableHashJoin: true}});
+assert.neq(null, conn, "mongod was unable to start up");
+const db = conn.getDB("test");
+const local = db.lookup_hash_join_local;
+const foreign = db.lookup_hash_join_foreign;
+
+local.drop();
+foreign.drop();
+assert.commandWorked(local.insert([
+    {_id: 0, x: 1},
+    {_id: 1, x: [2, 3]},
+    {_id: 2, x: null},
+    {_id: 3},
+    {_id: 4, x: {y: 1}},
+    {_id: 5, x: "abc"},
+    {_id: 6, x: NumberLong(1)},
+]));
+assert.commandWorked(foreign.insert([
+    {_id: 0, a: 1},
+    {_id: 1, a: [1, 2]},
+    {_id: 2, a: null},
+    {_id: 3},
+    {_id: 4, a: {y: 1}},
+    {_id: 5, a: [{y: 1}]},
+    {_id: 6, a: "ABC"},
+    {_id: 7, a: 1.0},
+]));
+
+function setParameters(params) {
+    assert.commandWorked(db.adminCommand(Object.assign({setParameter: 1}, params)));
+}
+
+function runLookup(pipelineSuffix, options = {}) {
+    const pipeline = [
+        {$lookup: {from: foreign.getName(), localField: "x", foreignField: "a", as: "joined"}}
+    ].concat(pipelineSuffix);
+    return local.aggregate(pipeline, Object.assign({allowDiskUse: true}, options)).toArray();
+}
+
+function strategy(pipelineSuffix) {
+    const pipeline = [
+        {$lookup: {from: foreign.getName(), localField: "x", foreignField: "a", as: "joined"}}
+    ].concat(pipelineSuffix);
+    const explain = local.explain("executionStats").aggregate(pipeline, {allowDiskUse: true});
+    return getAggPlanStage(explain, "$lookup").$lookup.strategy;
+}
+
+const testCases = [
+    [{$sort: {_id: 1}}],
+    [{$unwind: "$joined"}, {$sort: {_id: 1, "joined._id": 1}}],
+    [{$unwind: "$joined"}, {$match: {"joined._id": {$gte: 1}}}, {$sort: {_id: 1, "joined._id": 1}}],
+];
+
+const collation = {collation: {locale: "en", strength: 2}};
+for (let suffix of testCases) {
+    setParameters({
+        internalDocumentSourceLookupHashJoinMinInputDocuments: 1000,
+        internalDocumentSourceLookupBatchSize: 0
+    });
+    const nestedLoopResults = runLookup(suffix);
+    const nestedLoopCollationResults = runLookup(suffix, collation);
+    assert.eq("NestedLoopJoin", strategy(suffix));
+
+    // Batches of 3 documents leave a partial batch at the end of the input.
+    setParameters({internalDocumentSourceLookupBatchSize: 3});
+    assert.eq(nestedLoopResults, runLookup(suffix));
+    assert.eq(nestedLoopCollationResults, runLookup(suffix, collation));
+    assert.eq("BatchedNestedLoopJoin", strategy(suffix));
+
+    setParameters({internalDocumentSourceLookupHashJoinMinInputDocuments: 0});
+    assert.eq(nestedLoopResults, runLookup(suffix));
+    assert.eq(nestedLoopCollationResults, runLookup(suffix, collation));
+    assert.eq("HashJoin", strategy(suffix));
+
+    // Without the use of disk, the input is still looked up in batches.
+    const explain = local.explain("executionStats").aggregate([
+        {$lookup: {from: foreign.getName(), localField: "x", foreignField: "a", as: "joined"}}
+    ].concat(suffix));
+    assert.eq("BatchedNestedLoopJoin", getAggPlanStage(explain, "$lookup").$lookup.strategy);
+}
+
+// With an index on the foreign field, each batch is looked up with a single index scan. Results are
+// compared after unwinding, since the order of the joined documents follows the index.
+assert.commandWorked(foreign.createIndex({a: 1}));
+setParameters({
+    internalDocumentSourceLookupHashJoinMinInputDocuments: 1000,
+    internalDocumentSourceLookupBatchSize: 0
+});
+const indexedNestedLoopResults = runLookup(testCases[1]);
+setParameters({internalDocumentSourceLookupBatchSize: 3});
+assert.eq(indexedNestedLoopResults, runLookup(testCases[1]));
+setParameters({internalDocumentSourceLookupHashJoinMinInputDocuments: 0});
+
+// A foreign collection which does not fit in the memory limit is queried for in batches, and a
+// batch whose results do not fit is queried for one input document at a time.
+setParameters({internalDocumentSourceLookupCacheSizeBytes: 100});
+assert.eq("BatchedNestedLoopJoin", strategy([{$sort: {_id: 1}}]));
+setParameters({internalDocumentSourceLookupBatchMaxMemoryBytes: 100});
+assert.eq(runLookup([{$sort: {_id: 1}}])[0].joined.length, 3);
+assert.eq("NestedLoopJoin", strategy([{$sort: {_id: 1}}]));
+
+// A foreign field with a numeric component is always queried for each input document.
+setParameters({internalDocumentSourceLookupCacheSizeBytes: 100 * 1024 * 1024});
+const numericPathExplain = local.explain("executionStats").aggregate([
+    {$lookup: {from: foreign.getName(), localField: "x", foreignField: "a.0", as: "joined"}}
+], {allowDiskUse: true});
+assert.eq("NestedLoopJoin", getAggPlanStage(numericPathExplain, "$lookup").$lookup.strategy);
+
+MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,74 @@
+/**
+ * Tests that collection scans in the slot-based execution engine which are split across multiple
+ * threads return the same results as serial scans. Only reads at a timestamp, such as snapshot
+ * reads, are split across threads.
+ * @tags: [requires_replication]
+ */
+(function() {
+"use strict";
+
+const rst = new ReplSetTest({
+    nodes: 1,
+    nodeOptions: {
+        setParameter: {
+            internalQueryEnableSlotBasedExecutionEngine: true,
+            internalQuerySlotBasedExecutionParallelScanMinRecords: 1000,
+        }
+    }
+});
+rst.startSet();
+rst.initiate();
+const db = rst.getPrimary().getDB("test");
+const coll = db.sbe_parallel_collscan;
+
+coll.drop();
+const kNumDocs = 20000;
+let bulk = coll.initializeUnorderedBulkOp();
+for (let i = 0; i < kNumDocs; ++i) {
+    bulk.insert({_id: i, a: i % 10, b: "x".repeat(i % 50)});
+}
+// Snapshot reads outside of transactions read at the majority commit point.
+assert.commandWorked(bulk.execute({w: "majority"}));
+
+function setDegreeOfParallelism(degree) {
+    assert.commandWorked(db.adminCommand(
+        {setParameter: 1, internalQuerySlotBasedExecutionMaxDegreeOfParallelism: degree}));
+}
+
+function runQueries() {
+    const find = (filter) => coll.find(filter).readConcern("snapshot");
+    return {
+        all: find().toArray().map(doc => doc._id).sort((x, y) => x - y),
+        filtered: find({a: 3}).toArray().map(doc => doc._id).sort((x, y) => x - y),
+        limited: find({a: {$gte: 5}}).limit(100).itcount(),
+        natural: find().hint({$natural: 1}).limit(10).toArray().map(doc => doc._id),
+    };
+}
+
+setDegreeOfParallelism(1);
+const expected = runQueries();
+assert.eq(expected.all.length, kNumDocs);
+assert.eq(expected.filtered.length, kNumDocs / 10);
+assert.eq(expected.limited, 100);
+
+for (let degree of [2, 4, 8]) {
+    setDegreeOfParallelism(degree);
+    assert.eq(runQueries(), expected, "degree of parallelism: " + degree);
+}
+
+// A "local" read on the primary has no read timestamp for the producers to share, so it runs
+// serially and sees every write that was acknowledged before it, even with w:1.
+for (let i = 0; i < 100; ++i) {
+    const doc = {_id: kNumDocs + i, a: -1};
+    assert.commandWorked(coll.insert(doc, {writeConcern: {w: 1}}));
+    assert.eq(coll.find({a: -1}).itcount(), i + 1, doc);
+}
+assert.commandWorked(coll.remove({a: -1}, {writeConcern: {w: "majority"}}));
+
+// Parallel scans must not be used once the global limit on worker threads is used up.
+assert.commandWorked(
+    db.adminCommand({setParameter: 1, internalQuerySlotBasedExecutionMaxParallelWorkers: 0}));
+assert.eq(runQueries(), expected);
+
+rst.stopSet();
+}());
@@ -0,0 +1,77 @@
+/**
+ * Tests that a plan cached by the slot-based execution engine for an auto-parameterized query is
+ * rebound to the constants of other queries of the same shape, and that these queries return the
+ * same results as when their plans are built from scratch.
+ */
+(function() {
+"use strict";
+
+const conn = MongoRunner.runMongod({
+    setParameter: {
+        internalQueryEnableSlotBasedExecutionEngine: true,
+    }
+});
+assert.neq(null, conn, "mongod was unable to start up");
+const db = conn.getDB("test");
+const coll = db.sbe_plan_cache_auto_parameterization;
+
+coll.drop();
+const kNumDocs = 2000;
+let bulk = coll.initializeUnorderedBulkOp();
+for (let i = 0; i < kNumDocs; ++i) {
+    bulk.insert({_id: i, a: i % 100, b: i % 7, c: "s" + (i % 3)});
+}
+assert.commandWorked(bulk.execute());
+assert.commandWorked(coll.createIndex({a: 1}));
+assert.commandWorked(coll.createIndex({b: 1}));
+
+function expectedIds(predicate) {
+    let ids = [];
+    for (let i = 0; i < kNumDocs; ++i) {
+        if (predicate({a: i % 100, b: i % 7, c: "s" + (i % 3)})) {
+            ids.push(i);
+        }
+    }
+    return ids;
+}
+
+function ids(query) {
+    return coll.find(query).toArray().map(doc => doc._id).sort((x, y) => x - y);
+}
+
+function summary() {
+    return coll.aggregate([{$planCacheStats: {summary: true}}]).toArray()[0];
+}
+
+// Each query runs several times, so that its plan cache entry becomes active and the later runs
+// reuse the cached plan with different constants.
+for (let round = 0; round < 3; ++round) {
+    for (let x = 0; x < 10; ++x) {
+        const y = x % 7;
+        assert.eq(expectedIds(doc => doc.a === x && doc.b === y), ids({a: x, b: y}));
+        assert.eq(expectedIds(doc => doc.a >= x && doc.a < x + 3 && doc.b === y),
+                  ids({a: {$gte: x, $lt: x + 3}, b: y}));
+        assert.eq(expectedIds(doc => doc.a === x && doc.b === y && doc.c === "s1"),
+                  ids({a: x, b: y, c: "s1"}));
+    }
+}
+
+let stats = summary();
+assert.gte(stats.numCachedExecutionPlans, 1, stats);
+assert.gt(stats.hits, 0, stats);
+
+// A constant of another type is not bound to the cached plan, but still gives the right results.
+assert.eq([], ids({a: "1", b: 1}));
+assert.eq(expectedIds(doc => doc.a === 1 && doc.b === 1), ids({a: 1, b: 1}));
+
+// Results are the same with auto-parameterization disabled.
+assert.commandWorked(
+    db.adminCommand({setParameter: 1, internalQueryEnableAutoParameterization: false}));
+coll.getPlanCache().clear();
+for (let x = 0; x < 10; ++x) {
+    const y = x % 7;
+    assert.eq(expectedIds(doc => doc.a === x && doc.b === y), ids({a: x, b: y}));
+}
+
+MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,67 @@
+/**
+ * Tests that blocking sorts and $group spill with the codec picked by
+ * internalSorterSpillCompressor, and that explain reports the compression ratio of the spilled
+ * data.
+ * @tags: [requires_find_command]
+ */
+(function() {
+"use strict";
+
+load("jstests/libs/analyze_plan.js");
+
+const kNumDocs = 200;
+
+function runTest(compressor) {
+    const conn = MongoRunner.runMongod({
+        setParameter: {
+            internalSorterSpillCompressor: compressor,
+            internalQueryMaxBlockingSortMemoryUsageBytes: 100 * 1024,
+            internalDocumentSourceGroupMaxMemoryBytes: 100 * 1024,
+        }
+    });
+    assert.neq(null, conn, "mongod was unable to start up with compressor " + compressor);
+    const coll = conn.getDB("test").sorter_spill_compression;
+
+    // Documents of just over 1 kB whose padding compresses well.
+    for (let i = 0; i < kNumDocs; ++i) {
+        assert.commandWorked(coll.insert({sequenceNumber: i, padding: "-".repeat(1024)}));
+    }
+
+    // Spilled data must read back correctly.
+    const sorted = coll.find().sort({sequenceNumber: -1}).allowDiskUse().toArray();
+    assert.eq(kNumDocs, sorted.length);
+    for (let i = 0; i < kNumDocs; ++i) {
+        assert.eq(kNumDocs - 1 - i, sorted[i].sequenceNumber);
+    }
+    const groupPipeline = [{$group: {_id: "$sequenceNumber", padding: {$first: "$padding"}}}];
+    assert.eq(kNumDocs, coll.aggregate(groupPipeline, {allowDiskUse: true}).itcount());
+
+    const sortStats = getPlanStage(
+        coll.find().sort({sequenceNumber: -1}).allowDiskUse().explain("executionStats")
+            .executionStats.executionStages,
+        "SORT");
+    assert.eq(sortStats.usedDisk, true, tojson(sortStats));
+
+    const groupExplain =
+        coll.explain("executionStats").aggregate(groupPipeline, {allowDiskUse: true});
+    const groupStats = getAggPlanStage(groupExplain, "$group");
+    assert.neq(null, groupStats, tojson(groupExplain));
+
+    for (let stats of [sortStats, groupStats]) {
+        if (compressor === "none") {
+            assert.lt(stats.spillCompressionRatio, 1, tojson(stats));
+        } else {
+            assert.gt(stats.spillCompressionRatio, 1, tojson(stats));
+        }
+    }
+
+    MongoRunner.stopMongod(conn);
+}
+
+runTest("none");
+runTest("snappy");
+runTest("zstd");
+
+// An unknown codec is rejected at startup.
+assert.eq(null, MongoRunner.runMongod({setParameter: {internalSorterSpillCompressor: "lz4"}}));
+}());
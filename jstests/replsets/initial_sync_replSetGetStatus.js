@@ -72,6 +72,10 @@ assert.eq(res.initialSyncStatus.databases.test["test.foo"].documentsToCopy, 4);
 assert.eq(res.initialSyncStatus.databases.test["test.foo"].documentsCopied, 4);
 assert.eq(res.initialSyncStatus.databases.test["test.foo"].indexes, 1);
 assert.eq(res.initialSyncStatus.databases.test["test.foo"].fetchedBatches, 1);
+assert.eq(res.initialSyncStatus.databases.test["test.foo"].bytesCopied,
+          coll.aggregate([{$group: {_id: null, size: {$sum: {$bsonSize: "$$ROOT"}}}}])
+              .toArray()[0]
+              .size);
 
 // Let initial sync finish and get into secondary state.
 failPointBeforeFinish.off();
@@ -33,6 +33,7 @@
 
 #include "mongo/db/catalog/multi_index_block.h"
 
+#include <deque>
 #include <ostream>
 
 #include "mongo/base/error_codes.h"
@@ -45,6 +46,7 @@
 #include "mongo/db/client.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/index/multikey_paths.h"
+#include "mongo/db/matcher/expression.h"
 #include "mongo/db/multi_key_path_tracker.h"
 #include "mongo/db/op_observer.h"
 #include "mongo/db/operation_context.h"
@@ -56,6 +58,8 @@
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/db/storage/write_unit_of_work.h"
 #include "mongo/logv2/log.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/progress_meter.h"
@@ -73,6 +77,213 @@ MONGO_FAIL_POINT_DEFINE(hangIndexBuildDuringCollectionScanPhaseBeforeInsertion);
 MONGO_FAIL_POINT_DEFINE(hangIndexBuildDuringCollectionScanPhaseAfterInsertion);
 MONGO_FAIL_POINT_DEFINE(leaveIndexBuildUnfinishedForShutdown);
 
+namespace {
+
+/**
+ * Generates the keys of the documents returned by a collection scan on a set of worker threads.
+ *
+ * The scanning thread hands out batches of consecutive documents, so that the RecordId space is
+ * partitioned between the workers. Each worker fills its own partition of the BulkBuilder of every
+ * index being built, which keeps its keys in a separate Sorter. finish() merges the partitions back
+ * into the BulkBuilders, whose bulk load then merges the Sorters of all of the workers.
+ */
+class ParallelKeyGenerator {
+    ParallelKeyGenerator(const ParallelKeyGenerator&) = delete;
+    ParallelKeyGenerator& operator=(const ParallelKeyGenerator&) = delete;
+
+public:
+    struct Target {
+        const MatchExpression* filterExpression;
+        const InsertDeleteOptions* options;
+        IndexAccessMethod::BulkBuilder* bulk;
+    };
+
+    ParallelKeyGenerator(ServiceContext* serviceContext,
+                         std::vector<Target> targets,
+                         size_t numWorkers,
+                         size_t eachIndexMaxMemoryUsageBytes)
+        : _targets(std::move(targets)), _partitions(numWorkers) {
+        for (auto&& partitions : _partitions) {
+            for (const auto& target : _targets) {
+                partitions.push_back(
+                    target.bulk->makePartition(eachIndexMaxMemoryUsageBytes / numWorkers));
+            }
+        }
+
+        _workers.reserve(numWorkers);
+        for (size_t i = 0; i < numWorkers; ++i) {
+            _workers.emplace_back([this, serviceContext, i] { _work(serviceContext, i); });
+        }
+    }
+
+    ~ParallelKeyGenerator() {
+        _stopAndJoin();
+    }
+
+    /**
+     * Queues the document for key generation. Blocks while all of the workers are busy and the
+     * queue is full. Throws the first error encountered by a worker.
+     */
+    void add(OperationContext* opCtx, const BSONObj& doc, const RecordId& loc) {
+        _batchBytes += doc.objsize();
+        _batch.emplace_back(doc.getOwned(), loc);
+        if (_batchBytes >= kMaxBatchBytes) {
+            _dispatchBatch(opCtx);
+        }
+    }
+
+    /**
+     * Waits for the keys of all queued documents to be generated and merges the partitions into
+     * the BulkBuilders of the targets. Throws the first error encountered by a worker.
+     */
+    void finish(OperationContext* opCtx) {
+        _dispatchBatch(opCtx);
+        {
+            stdx::lock_guard<Latch> lk(_mutex);
+            _noMoreBatches = true;
+        }
+        _workAvailable.notify_all();
+
+        for (auto&& worker : _workers) {
+            worker.join();
+        }
+        _workers.clear();
+        uassertStatusOK(_status);
+
+        for (auto&& partitions : _partitions) {
+            for (size_t i = 0; i < _targets.size(); ++i) {
+                _targets[i].bulk->mergePartition(opCtx, std::move(partitions[i]));
+            }
+        }
+        _partitions.clear();
+    }
+
+private:
+    using Batch = std::vector<std::pair<BSONObj, RecordId>>;
+
+    // Batches are large enough for the workers to rarely contend on the queue, and the queue holds
+    // at most two batches per worker.
+    static constexpr int kMaxBatchBytes = 1024 * 1024;
+    static constexpr size_t kMaxQueuedBatchesPerWorker = 2;
+
+    void _dispatchBatch(OperationContext* opCtx) {
+        if (_batch.empty()) {
+            uassertStatusOK(_getStatus());
+            return;
+        }
+
+        {
+            stdx::unique_lock<Latch> lk(_mutex);
+            opCtx->waitForConditionOrInterrupt(_spaceAvailable, lk, [&] {
+                return !_status.isOK() ||
+                    _queue.size() < kMaxQueuedBatchesPerWorker * _workers.size();
+            });
+            uassertStatusOK(_status);
+            _queue.push_back(std::move(_batch));
+        }
+        _workAvailable.notify_one();
+
+        _batch = {};
+        _batchBytes = 0;
+    }
+
+    void _work(ServiceContext* serviceContext, size_t workerId) {
+        ThreadClient tc("IndexBuildKeyGenerator-" + std::to_string(workerId), serviceContext);
+        auto opCtx = cc().makeOperationContext();
+        auto& partitions = _partitions[workerId];
+
+        while (true) {
+            Batch batch;
+            {
+                stdx::unique_lock<Latch> lk(_mutex);
+                _workAvailable.wait(lk, [&] {
+                    return _stopped || !_status.isOK() || !_queue.empty() || _noMoreBatches;
+                });
+                if (_stopped || !_status.isOK() || _queue.empty()) {
+                    return;
+                }
+                batch = std::move(_queue.front());
+                _queue.pop_front();
+            }
+            _spaceAvailable.notify_one();
+
+            Status status = Status::OK();
+            for (const auto& [doc, loc] : batch) {
+                for (size_t i = 0; i < _targets.size() && status.isOK(); ++i) {
+                    const auto& target = _targets[i];
+                    if (target.filterExpression && !target.filterExpression->matchesBSON(doc)) {
+                        continue;
+                    }
+
+                    // When calling insert, BulkBuilderImpl's Sorter performs file I/O that may
+                    // result in an exception.
+                    try {
+                        status = partitions[i]->insert(opCtx.get(), doc, loc, *target.options);
+                    } catch (...) {
+                        status = exceptionToStatus();
+                    }
+                }
+                if (!status.isOK()) {
+                    break;
+                }
+            }
+
+            if (!status.isOK()) {
+                {
+                    stdx::lock_guard<Latch> lk(_mutex);
+                    if (_status.isOK()) {
+                        _status = status;
+                    }
+                }
+                _workAvailable.notify_all();
+                _spaceAvailable.notify_all();
+                return;
+            }
+        }
+    }
+
+    Status _getStatus() {
+        stdx::lock_guard<Latch> lk(_mutex);
+        return _status;
+    }
+
+    void _stopAndJoin() {
+        {
+            stdx::lock_guard<Latch> lk(_mutex);
+            _stopped = true;
+        }
+        _workAvailable.notify_all();
+
+        for (auto&& worker : _workers) {
+            worker.join();
+        }
+        _workers.clear();
+    }
+
+    const std::vector<Target> _targets;
+
+    // The partitions of the BulkBuilder of every target, indexed by worker and then by target.
+    std::vector<std::vector<std::unique_ptr<IndexAccessMethod::BulkBuilder>>> _partitions;
+
+    std::vector<stdx::thread> _workers;
+
+    // The batch being accumulated by the scanning thread.
+    Batch _batch;
+    int _batchBytes = 0;
+
+    Mutex _mutex = MONGO_MAKE_LATCH("ParallelKeyGenerator::_mutex");
+    stdx::condition_variable _workAvailable;
+    stdx::condition_variable _spaceAvailable;
+
+    // Protected by '_mutex'.
+    std::deque<Batch> _queue;
+    bool _noMoreBatches = false;
+    bool _stopped = false;
+    Status _status = Status::OK();
+};
+
+}  // namespace
+
 MultiIndexBlock::~MultiIndexBlock() {
     invariant(_buildIsCleanedUp);
 }
@@ -202,9 +413,8 @@ StatusWith<std::vector<BSONObj>> MultiIndexBlock::init(
 
         std::vector<BSONObj> indexInfoObjs;
         indexInfoObjs.reserve(indexSpecs.size());
-        std::size_t eachIndexBuildMaxMemoryUsageBytes = 0;
         if (!indexSpecs.empty()) {
-            eachIndexBuildMaxMemoryUsageBytes =
+            _eachIndexBuildMaxMemoryUsageBytes =
                 static_cast<std::size_t>(maxIndexBuildMemoryUsageMegabytes.load()) * 1024 * 1024 /
                 indexSpecs.size();
         }
@@ -279,7 +489,7 @@ StatusWith<std::vector<BSONObj>> MultiIndexBlock::init(
             if (!status.isOK())
                 return status;
 
-            index.bulk = index.real->initiateBulk(eachIndexBuildMaxMemoryUsageBytes, stateInfo);
+            index.bulk = index.real->initiateBulk(_eachIndexBuildMaxMemoryUsageBytes, stateInfo);
 
             const IndexDescriptor* descriptor = indexCatalogEntry->descriptor();
 
@@ -298,7 +508,7 @@ StatusWith<std::vector<BSONObj>> MultiIndexBlock::init(
                   "properties"_attr = *descriptor,
                   "method"_attr = _method,
                   "maxTemporaryMemoryUsageMB"_attr =
-                      eachIndexBuildMaxMemoryUsageBytes / 1024 / 1024);
+                      _eachIndexBuildMaxMemoryUsageBytes / 1024 / 1024);
 
             index.filterExpression = indexCatalogEntry->getFilterExpression();
 
@@ -422,6 +632,26 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(
                   IndexBuildPhase_serializer(_phase).toString());
         _phase = IndexBuildPhaseEnum::kCollectionScan;
 
+        boost::optional<ParallelKeyGenerator> keyGenerator;
+        boost::optional<RecordId> lastRecordIdScanned;
+        const auto numKeyGenerationThreads =
+            static_cast<size_t>(maxIndexBuildKeyGenerationThreads.load());
+        if (numKeyGenerationThreads > 1) {
+            std::vector<ParallelKeyGenerator::Target> targets;
+            for (auto& index : _indexes) {
+                targets.push_back({index.filterExpression, &index.options, index.bulk.get()});
+            }
+            keyGenerator.emplace(opCtx->getServiceContext(),
+                                 std::move(targets),
+                                 numKeyGenerationThreads,
+                                 _eachIndexBuildMaxMemoryUsageBytes);
+            _collectionScannedInParallel = true;
+
+            // No keys reach the BulkBuilders before the end of the scan, so an interrupted scan
+            // can only be resumed from where it started.
+            _lastRecordIdInserted = resumeAfterRecordId;
+        }
+
         BSONObj objToIndex;
         RecordId loc;
         PlanExecutor::ExecState state;
@@ -444,7 +674,13 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(
 
             // The external sorter is not part of the storage engine and therefore does not need a
             // WriteUnitOfWork to write keys.
-            uassertStatusOK(insertSingleDocumentForInitialSyncOrRecovery(opCtx, objToIndex, loc));
+            if (keyGenerator) {
+                keyGenerator->add(opCtx, objToIndex, loc);
+                lastRecordIdScanned = loc;
+            } else {
+                uassertStatusOK(
+                    insertSingleDocumentForInitialSyncOrRecovery(opCtx, objToIndex, loc));
+            }
 
             _failPointHangDuringBuild(opCtx,
                                       &hangIndexBuildDuringCollectionScanPhaseAfterInsertion,
@@ -457,6 +693,13 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(
             progress->hit();
             n++;
         }
+
+        if (keyGenerator) {
+            keyGenerator->finish(opCtx);
+            if (lastRecordIdScanned) {
+                _lastRecordIdInserted = lastRecordIdScanned;
+            }
+        }
     } catch (DBException& ex) {
         if (ex.isA<ErrorCategory::Interruption>() || ex.isA<ErrorCategory::ShutdownError>() ||
             ErrorCodes::IndexBuildAborted == ex.code()) {
@@ -525,6 +768,7 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(
           "totalRecords"_attr = n,
           "readSource"_attr =
               RecoveryUnit::toString(opCtx->recoveryUnit()->getTimestampReadSource()),
+          "keyGenerationInParallel"_attr = _collectionScannedInParallel,
           "duration"_attr = duration_cast<Milliseconds>(Seconds(t.seconds())));
 
     Status ret = dumpInsertsFromBulk(opCtx, collection);
@@ -814,6 +1058,17 @@ void MultiIndexBlock::abortWithoutCleanup(OperationContext* opCtx,
             invariant(IndexBuildPhaseEnum::kBulkLoad != _phase, str::stream() << *_buildUUID);
         }
 
+        // The bulk load of keys generated on several threads consumes the Sorters of all of them,
+        // which cannot be persisted as the single Sorter per index that resuming expects.
+        if (IndexBuildPhaseEnum::kBulkLoad == _phase && _collectionScannedInParallel) {
+            LOGV2(5189100,
+                  "Index build: not resumable from the bulk load of keys generated in parallel",
+                  "buildUUID"_attr = *_buildUUID);
+            isResumable = false;
+        }
+    }
+
+    if (isResumable) {
         _writeStateToDisk(opCtx, collection);
         action = TemporaryRecordStore::FinalizationAction::kKeep;
     }
@@ -893,6 +1148,13 @@ BSONObj MultiIndexBlock::_constructStateObject(OperationContext* opCtx,
                 range.append("endOffset", rangeInfo.getEndOffset());
                 range.append("checksum", rangeInfo.getChecksum());
             }
+            ranges.done();
+
+            // Versions that predate zstd read every compressed block as snappy. Recording the codec
+            // makes them fail to parse the resume info, so they restart the build from scratch.
+            if (state.spillCompressor == SorterSpillCompressor::kZstd && !state.ranges.empty()) {
+                indexInfo.append("spillCompressor", "zstd");
+            }
         }
 
         auto indexBuildInterceptor =
@@ -333,5 +333,13 @@ private:
 
     // The current phase of the index build.
     IndexBuildPhaseEnum _phase = IndexBuildPhaseEnum::kInitialized;
+
+    // The memory budget of the BulkBuilder of each index, which is split between its partitions
+    // when keys are generated on several threads.
+    std::size_t _eachIndexBuildMaxMemoryUsageBytes = 0;
+
+    // Set to true when the keys of the collection scan were generated on several threads, in which
+    // case the bulk load phase merges the Sorters of all of them and cannot be resumed.
+    bool _collectionScannedInParallel = false;
 };
 }  // namespace mongo
@@ -32,10 +32,12 @@
 #include "mongo/db/catalog/multi_index_block.h"
 
 #include "mongo/db/catalog/catalog_test_fixture.h"
+#include "mongo/db/catalog/multi_index_block_gen.h"
 #include "mongo/db/catalog_raii.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -183,5 +185,72 @@ TEST_F(MultiIndexBlockTest, InitWriteConflictException) {
     indexer->abortIndexBuild(operationContext(), coll, MultiIndexBlock::kNoopOnCleanUpFn);
 }
 
+TEST_F(MultiIndexBlockTest, InsertAllDocumentsGeneratesKeysOnSeveralThreads) {
+    const int originalNumThreads = maxIndexBuildKeyGenerationThreads.load();
+    maxIndexBuildKeyGenerationThreads.store(4);
+    ON_BLOCK_EXIT([&] { maxIndexBuildKeyGenerationThreads.store(originalNumThreads); });
+
+    // Documents with an odd _id have two keys in the index on 'a', and only the documents with
+    // 'b' less than 10 are in the partial index on 'b'. The documents are large enough for the
+    // collection scan to hand out several batches to the workers.
+    const int kNumDocs = 3000;
+    const std::string padding(1024, 'x');
+    {
+        AutoGetCollection autoColl(operationContext(), getNSS(), MODE_X);
+        for (int i = 0; i < kNumDocs; ++i) {
+            auto a = i % 2 ? BSON_ARRAY(i << i + kNumDocs) : BSON_ARRAY(i);
+            WriteUnitOfWork wuow(operationContext());
+            ASSERT_OK(autoColl->insertDocument(
+                operationContext(),
+                InsertStatement(BSON("_id" << i << "a" << a << "b" << i % 100 << "p" << padding)),
+                nullptr));
+            wuow.commit();
+        }
+    }
+
+    auto indexer = getIndexer();
+
+    AutoGetCollection autoColl(operationContext(), getNSS(), MODE_X);
+    CollectionWriter coll(autoColl);
+
+    const auto version = static_cast<int>(IndexDescriptor::kLatestIndexVersion);
+    std::vector<BSONObj> specs{
+        BSON("key" << BSON("a" << 1) << "name"
+                   << "a_1"
+                   << "v" << version),
+        BSON("key" << BSON("b" << 1) << "name"
+                   << "b_1"
+                   << "v" << version << "partialFilterExpression"
+                   << BSON("b" << BSON("$lt" << 10)))};
+    {
+        WriteUnitOfWork wuow(operationContext());
+        ASSERT_OK(
+            indexer->init(operationContext(), coll, specs, MultiIndexBlock::kNoopOnInitFn)
+                .getStatus());
+        wuow.commit();
+    }
+
+    ASSERT_OK(indexer->insertAllDocumentsInCollection(operationContext(), coll.get()));
+    ASSERT_OK(indexer->checkConstraints(operationContext(), coll.get()));
+    {
+        WriteUnitOfWork wuow(operationContext());
+        ASSERT_OK(indexer->commit(operationContext(),
+                                  coll.getWritableCollection(),
+                                  MultiIndexBlock::kNoopOnCreateEachFn,
+                                  MultiIndexBlock::kNoopOnCommitFn));
+        wuow.commit();
+    }
+
+    auto indexCatalog = coll->getIndexCatalog();
+    auto entryA = indexCatalog->getEntry(indexCatalog->findIndexByName(operationContext(), "a_1"));
+    auto entryB = indexCatalog->getEntry(indexCatalog->findIndexByName(operationContext(), "b_1"));
+    ASSERT_EQ(kNumDocs + kNumDocs / 2,
+              entryA->accessMethod()->getSortedDataInterface()->numEntries(operationContext()));
+    ASSERT_EQ(kNumDocs / 10,
+              entryB->accessMethod()->getSortedDataInterface()->numEntries(operationContext()));
+    ASSERT_TRUE(entryA->isMultikey());
+    ASSERT_FALSE(entryB->isMultikey());
+}
+
 }  // namespace
 }  // namespace mongo
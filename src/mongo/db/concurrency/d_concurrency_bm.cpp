@@ -42,6 +42,10 @@ namespace {
 
 const int kMaxPerfThreads = 16;  // max number of threads to use for lock perf
 
+// Thread counts beyond kMaxPerfThreads, for the lock types whose contention matters on many-core
+// machines.
+const int kManyCoreThreads[] = {64, 128};
+
 
 class DConcurrencyTest : public benchmark::Fixture {
 public:
@@ -159,10 +163,15 @@ BENCHMARK_REGISTER_F(DConcurrencyTest, BM_StdMutex)->ThreadRange(1, kMaxPerfThre
 BENCHMARK_REGISTER_F(DConcurrencyTest, BM_ResourceMutexShared)->ThreadRange(1, kMaxPerfThreads);
 BENCHMARK_REGISTER_F(DConcurrencyTest, BM_ResourceMutexExclusive)->ThreadRange(1, kMaxPerfThreads);
 
-BENCHMARK_REGISTER_F(DConcurrencyTest, BM_CollectionIntentSharedLock)
-    ->ThreadRange(1, kMaxPerfThreads);
-BENCHMARK_REGISTER_F(DConcurrencyTest, BM_CollectionIntentExclusiveLock)
-    ->ThreadRange(1, kMaxPerfThreads);
+void manyCoreThreads(benchmark::internal::Benchmark* b) {
+    b->ThreadRange(1, kMaxPerfThreads);
+    for (auto threads : kManyCoreThreads) {
+        b->Threads(threads);
+    }
+}
+
+BENCHMARK_REGISTER_F(DConcurrencyTest, BM_CollectionIntentSharedLock)->Apply(manyCoreThreads);
+BENCHMARK_REGISTER_F(DConcurrencyTest, BM_CollectionIntentExclusiveLock)->Apply(manyCoreThreads);
 
 BENCHMARK_REGISTER_F(DConcurrencyTest, BM_CollectionSharedLock)->ThreadRange(1, kMaxPerfThreads);
 BENCHMARK_REGISTER_F(DConcurrencyTest, BM_CollectionExclusiveLock)->ThreadRange(1, kMaxPerfThreads);
@@ -36,6 +36,10 @@
 #include <fmt/format.h>
 #include <fmt/ostream.h>
 
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
 #include "mongo/base/data_type_endian.h"
 #include "mongo/base/data_view.h"
 #include "mongo/base/static_assert.h"
@@ -45,6 +49,7 @@
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/concurrency/locker.h"
 #include "mongo/logv2/log.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/str.h"
 #include "mongo/util/timer.h"
@@ -413,9 +418,22 @@ void LockHead::migratePartitionedLockHeads() {
 // Have more buckets than CPUs to reduce contention on lock and caches
 const unsigned LockManager::_numLockBuckets(128);
 
-// Balance scalability of intent locks against potential added cost of conflicting locks.
-// The exact value doesn't appear very important, but should be power of two
-const unsigned LockManager::_numPartitions = 32;
+namespace {
+
+// Balance scalability of intent locks against potential added cost of conflicting locks. Below
+// this the exact value doesn't appear very important, but above it there must be a partition per
+// CPU so that intent locks taken on different CPUs never share a partition.
+const unsigned kMinPartitions = 32;
+
+unsigned computeNumPartitions() {
+    unsigned numPartitions = kMinPartitions;
+    while (numPartitions < stdx::thread::hardware_concurrency()) {
+        numPartitions *= 2;
+    }
+    return numPartitions;
+}
+
+}  // namespace
 
 // static
 std::map<LockerId, BSONObj> LockManager::getLockToClientMap(ServiceContext* serviceContext) {
@@ -443,7 +461,7 @@ std::map<LockerId, BSONObj> LockManager::getLockToClientMap(ServiceContext* serv
     return lockToClientMap;
 }
 
-LockManager::LockManager() {
+LockManager::LockManager() : _numPartitions(computeNumPartitions()) {
     _lockBuckets = new LockBucket[_numLockBuckets];
     _partitions = new Partition[_numPartitions];
 }
@@ -469,6 +487,7 @@ LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mo
 
     // For intent modes, try the PartitionedLockHead
     if (request->partitioned) {
+        request->partitionId = _choosePartition(request);
         Partition* partition = _getPartition(request);
         stdx::lock_guard<SimpleMutex> scopedLock(partition->mutex);
         invariant(request->status == LockRequest::STATUS_NEW);
@@ -839,8 +858,19 @@ LockManager::LockBucket* LockManager::_getBucket(ResourceId resId) const {
     return &_lockBuckets[resId % _numLockBuckets];
 }
 
+unsigned LockManager::_choosePartition(LockRequest* request) const {
+#if defined(__linux__)
+    // CPU numbers can exceed the number of CPUs available to the process, hence the mask.
+    const int cpu = sched_getcpu();
+    if (cpu >= 0) {
+        return static_cast<unsigned>(cpu) & (_numPartitions - 1);
+    }
+#endif
+    return request->locker->getId() % _numPartitions;
+}
+
 LockManager::Partition* LockManager::_getPartition(LockRequest* request) const {
-    return &_partitions[request->locker->getId() % _numPartitions];
+    return &_partitions[request->partitionId];
 }
 
 void LockManager::dump() const {
@@ -981,6 +1011,7 @@ void LockRequest::initNew(Locker* locker, LockGrantNotification* notify) {
 
     lock = nullptr;
     partitionedLock = nullptr;
+    partitionId = 0;
     prev = nullptr;
     next = nullptr;
     status = STATUS_NEW;
@@ -164,9 +164,10 @@ private:
         LockHead* findOrInsert(ResourceId resId);
     };
 
-    // Each locker maps to a partition that is used for resources acquired in intent modes
-    // modes and potentially other modes that don't conflict with themselves. This avoids
-    // contention on the regular LockHead in the lock manager.
+    // Each intent mode request maps to a partition, normally the one of the CPU it was made on,
+    // which is used for resources acquired in intent modes and potentially other modes that don't
+    // conflict with themselves. This avoids contention on the regular LockHead in the lock
+    // manager, and keeps the partition's mutex and map local to one CPU's cache.
     struct Partition {
         PartitionedLockHead* find(ResourceId resId);
         PartitionedLockHead* findOrInsert(ResourceId resId);
@@ -183,7 +184,13 @@ private:
 
 
     /**
-     * Retrieves the Partition that a particular LockRequest should use for intent locking.
+     * Chooses the partition a new intent mode LockRequest should use: the one of the CPU the
+     * calling thread runs on where that is known, otherwise one derived from the locker.
+     */
+    unsigned _choosePartition(LockRequest* request) const;
+
+    /**
+     * Retrieves the Partition that a particular LockRequest uses for intent locking.
      */
     Partition* _getPartition(LockRequest* request) const;
 
@@ -219,7 +226,8 @@ private:
     static const unsigned _numLockBuckets;
     LockBucket* _lockBuckets;
 
-    static const unsigned _numPartitions;
+    // A power of two, and at least the number of CPUs.
+    const unsigned _numPartitions;
     Partition* _partitions;
 };
 }  // namespace mongo
@@ -426,6 +426,14 @@ struct LockRequest {
     // Protected by LockHead bucket's mutex
     PartitionedLockHead* partitionedLock;
 
+    // Index of the LockManager partition chosen for this request when it was made. Only meaningful
+    // if 'partitioned' is set.
+    //
+    // Written by LockManager on Locker thread
+    // Read by LockManager on Locker thread
+    // No synchronization
+    unsigned partitionId;
+
     // The linked list chain on which this request hangs off the owning lock head. The reason
     // intrusive linked list is used instead of the std::list class is to allow for entries to be
     // removed from the middle of the list in O(1) time, if they are known instead of having to
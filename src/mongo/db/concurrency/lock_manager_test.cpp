@@ -29,6 +29,7 @@
 
 #include "mongo/db/concurrency/lock_manager_defs.h"
 #include "mongo/db/concurrency/lock_manager_test_help.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 
 namespace mongo {
@@ -952,4 +953,47 @@ TEST(LockManager, Fairness) {
     ASSERT(lockMgr.unlock(&requestIX1));
 }
 
+TEST(LockManager, ConflictMigratesIntentLocksFromAllPartitions) {
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_GLOBAL, 0);
+
+    // Take the intent locks from many threads, so that they land on the partitions of different
+    // CPUs.
+    const size_t numLockers = 64;
+    std::vector<std::unique_ptr<LockerImpl>> lockers;
+    std::vector<std::unique_ptr<LockRequestCombo>> requests;
+    for (size_t i = 0; i < numLockers; i++) {
+        lockers.push_back(std::make_unique<LockerImpl>());
+        requests.push_back(std::make_unique<LockRequestCombo>(lockers.back().get()));
+    }
+
+    std::vector<LockResult> results(numLockers, LOCK_INVALID);
+    std::vector<stdx::thread> threads;
+    for (size_t i = 0; i < numLockers; i++) {
+        threads.emplace_back([&, i] {
+            results[i] = lockMgr.lock(resId, requests[i].get(), i % 2 ? MODE_IX : MODE_IS);
+        });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+    for (auto result : results) {
+        ASSERT_EQ(LOCK_OK, result);
+    }
+
+    LockerImpl lockerX;
+    LockRequestCombo requestX(&lockerX);
+    ASSERT_EQ(LOCK_WAITING, lockMgr.lock(resId, &requestX, MODE_X));
+
+    // The X lock is granted only once every intent lock has been released.
+    for (size_t i = 0; i < numLockers; i++) {
+        ASSERT_EQ(0, requestX.numNotifies);
+        ASSERT(lockMgr.unlock(requests[i].get()));
+    }
+    ASSERT_EQ(LOCK_OK, requestX.lastResult);
+    ASSERT_EQ(1, requestX.numNotifies);
+
+    ASSERT(lockMgr.unlock(&requestX));
+}
+
 }  // namespace mongo
@@ -360,9 +360,11 @@ bool LockerImpl::_acquireTicket(OperationContext* opCtx, LockMode mode, Date_t d
             invariant(!opCtx->recoveryUnit()->isTimestamped());
 
         OperationContext* interruptible = _uninterruptibleLocksRequested ? nullptr : opCtx;
+        const auto priority =
+            _yielded ? TicketHolder::Priority::kLow : TicketHolder::Priority::kNormal;
         if (deadline == Date_t::max()) {
-            holder->waitForTicket(interruptible);
-        } else if (!holder->waitForTicketUntil(interruptible, deadline)) {
+            holder->waitForTicket(interruptible, priority);
+        } else if (!holder->waitForTicketUntil(interruptible, deadline, priority)) {
             return false;
         }
         restoreStateOnErrorGuard.dismiss();
@@ -403,6 +405,7 @@ bool LockerImpl::unlockGlobal() {
     if (!unlock(resourceIdGlobal)) {
         return false;
     }
+    _yielded = false;
 
     invariant(!inAWriteUnitOfWork());
 
@@ -782,6 +785,7 @@ bool LockerImpl::saveLockStateAndUnlock(Locker::LockSnapshot* stateOut) {
     // Sort locks by ResourceId. They'll later be acquired in this canonical locking order.
     std::sort(stateOut->locks.begin(), stateOut->locks.end());
 
+    _yielded = true;
     return true;
 }
 
@@ -346,6 +346,11 @@ private:
     // Mode for which the Locker acquired a ticket, or MODE_NONE if no ticket was acquired.
     LockMode _modeForTicket = MODE_NONE;
 
+    // Set when the locks are yielded and cleared when the global lock is released for good. An
+    // operation that yields runs long, so it reacquires its ticket with low priority to let short
+    // operations go first.
+    bool _yielded = false;
+
     // Indicates whether the client is active reader/writer or is queued.
     AtomicWord<ClientState> _clientState{kInactive};
 
@@ -41,6 +41,7 @@
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/repl/optime.h"
 #include "mongo/db/storage/oplog_hack.h"
 #include "mongo/logv2/log.h"
@@ -108,6 +109,7 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
     }
 
     boost::optional<Record> record;
+    SnapshotId snapshotId = opCtx()->recoveryUnit()->getSnapshotId();
     const bool needToMakeCursor = !_cursor;
     try {
         if (needToMakeCursor) {
@@ -185,7 +187,14 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
         }
 
         if (!record) {
-            record = _cursor->next();
+            // Tailable scans read one record at a time so that they never read past the point
+            // they will resume from after hitting EOF.
+            if (_params.tailable) {
+                record = _cursor->next();
+            } else {
+                record = nextFromBatch();
+                snapshotId = _batchSnapshotId;
+            }
         }
     } catch (const WriteConflictException&) {
         // Leave us in a state to try again next time.
@@ -217,12 +226,28 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
     WorkingSetID id = _workingSet->allocate();
     WorkingSetMember* member = _workingSet->get(id);
     member->recordId = record->id;
-    member->resetDocument(opCtx()->recoveryUnit()->getSnapshotId(), record->data.releaseToBson());
+    member->resetDocument(snapshotId, record->data.releaseToBson());
     _workingSet->transitionToRecordIdAndObj(id);
 
     return returnIfMatches(member, id, out);
 }
 
+boost::optional<Record> CollectionScan::nextFromBatch() {
+    if (_batchPosition == _batch.size()) {
+        // A batch interrupted by a write conflict keeps the records read before it, which are
+        // returned once the scan resumes.
+        _batchPosition = 0;
+        _batchSnapshotId = opCtx()->recoveryUnit()->getSnapshotId();
+        const size_t maxBatchSize = internalQueryExecScanBatchSize.load();
+        const size_t batchSize = std::min(_batchSize, maxBatchSize);
+        _batchSize = std::min(batchSize * 2, maxBatchSize);
+        if (!_cursor->nextBatch(batchSize, &_batch)) {
+            return boost::none;
+        }
+    }
+    return std::move(_batch[_batchPosition++]);
+}
+
 void CollectionScan::setLatestOplogEntryTimestamp(const Record& record) {
     auto tsElem = record.data.toBson()[repl::OpTime::kTimestampFieldName];
     uassert(ErrorCodes::Error(4382100),
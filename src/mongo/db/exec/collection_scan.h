@@ -30,16 +30,18 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "mongo/db/exec/collection_scan_common.h"
 #include "mongo/db/exec/requires_collection_stage.h"
 #include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/record_id.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/db/storage/snapshot.h"
 #include "mongo/s/resharding/resume_token_gen.h"
 
 namespace mongo {
 
-struct Record;
 class SeekableRecordCursor;
 class WorkingSet;
 class OperationContext;
@@ -115,6 +117,12 @@ private:
      */
     void assertMinTsHasNotFallenOffOplog(const Record& record);
 
+    /**
+     * Returns the next record of a non-tailable scan from '_batch', reading the next batch from
+     * '_cursor' once it has been consumed.
+     */
+    boost::optional<Record> nextFromBatch();
+
     // WorkingSet is not owned by us.
     WorkingSet* _workingSet;
 
@@ -132,6 +140,14 @@ private:
 
     RecordId _lastSeenId;  // Null if nothing has been returned from _cursor yet.
 
+    // Records read ahead from '_cursor' by a non-tailable scan, the position of the next one to
+    // return and the number of records to ask for next. A batch may outlive a yield, so the
+    // snapshot it was read in is kept alongside it.
+    std::vector<Record> _batch;
+    size_t _batchPosition = 0;
+    size_t _batchSize = 1;
+    SnapshotId _batchSnapshotId;
+
     // If _params.shouldTrackLatestOplogTimestamp is set and the collection is the oplog, the latest
     // timestamp seen in the collection.  Otherwise, this is a null timestamp.
     Timestamp _latestOplogEntryTimestamp;
@@ -127,39 +127,54 @@ bool DocumentStorageIterator::shouldSkipDeleted() {
 }
 
 Position DocumentStorage::findFieldInCache(StringData requested) const {
-    int reqSize = requested.size();  // get size calculation out of the way if needed
+    if (_numFields >= HASH_TAB_MIN) {
+        return findFieldInHashTable(HashedFieldName(requested));
+    }
+    return findFieldLinear(requested);
+}
 
-    if (_numFields >= HASH_TAB_MIN) {  // hash lookup
-        const unsigned hash = hashKey(requested);
-        const unsigned bucket = hash & _hashTabMask;
+Position DocumentStorage::findFieldInCache(HashedFieldName requested) const {
+    if (_numFields >= HASH_TAB_MIN) {
+        return findFieldInHashTable(requested);
+    }
+    return findFieldLinear(requested.name());
+}
 
-        Position pos = _hashTab[bucket];
-        while (pos.found()) {
-            const ValueElement& elem = getField(pos);
-            if (elem.nameLen == reqSize && memcmp(requested.rawData(), elem._name, reqSize) == 0) {
-                return pos;
-            }
+Position DocumentStorage::findFieldInHashTable(HashedFieldName requested) const {
+    const int reqSize = requested.name().size();
+    const unsigned hash = requested.hash();
 
-            // possible collision
-            pos = elem.nextCollision;
+    // Linear probing. The table is never more than half full, so this always finds an empty slot.
+    for (unsigned bucket = hash & _hashTabMask;; bucket = (bucket + 1) & _hashTabMask) {
+        const HashTabSlot& slot = _hashTab[bucket];
+        if (!slot.pos.found()) {
+            return Position();
         }
-    } else {  // linear scan
-        for (auto it = iteratorCacheOnly(); !it.atEnd(); it.advance()) {
-            if (it->nameLen == reqSize && memcmp(requested.rawData(), it->_name, reqSize) == 0) {
-                return it.position();
+
+        // Only compare names when the full hashes match.
+        if (slot.hash == hash) {
+            const ValueElement& elem = getField(slot.pos);
+            if (elem.nameLen == reqSize &&
+                memcmp(requested.name().rawData(), elem._name, reqSize) == 0) {
+                return slot.pos;
             }
         }
     }
+}
+
+Position DocumentStorage::findFieldLinear(StringData requested) const {
+    const int reqSize = requested.size();
+    for (auto it = iteratorCacheOnly(); !it.atEnd(); it.advance()) {
+        if (it->nameLen == reqSize && memcmp(requested.rawData(), it->_name, reqSize) == 0) {
+            return it.position();
+        }
+    }
 
     // if we got here, there's no such field
     return Position();
 }
 
-Position DocumentStorage::findField(StringData requested, LookupPolicy policy) const {
-    if (auto pos = findFieldInCache(requested); pos.found() || policy == LookupPolicy::kCacheOnly) {
-        return pos;
-    }
-
+Position DocumentStorage::findFieldInBson(StringData requested) const {
     for (auto&& bsonElement : _bson) {
         if (requested == bsonElement.fieldNameStringData()) {
             return const_cast<DocumentStorage*>(this)->constructInCache(bsonElement);
@@ -170,11 +185,27 @@ Position DocumentStorage::findField(StringData requested, LookupPolicy policy) c
     return Position();
 }
 
+Position DocumentStorage::findField(StringData requested, LookupPolicy policy) const {
+    if (auto pos = findFieldInCache(requested); pos.found() || policy == LookupPolicy::kCacheOnly) {
+        return pos;
+    }
+    return findFieldInBson(requested);
+}
+
+Position DocumentStorage::findField(HashedFieldName requested, LookupPolicy policy) const {
+    if (auto pos = findFieldInCache(requested); pos.found() || policy == LookupPolicy::kCacheOnly) {
+        return pos;
+    }
+    return findFieldInBson(requested.name());
+}
+
 Position DocumentStorage::constructInCache(const BSONElement& elem) {
     auto savedModified = _modified;
     auto pos = getNextPosition();
     const auto fieldName = elem.fieldNameStringData();
-    appendField(fieldName, ValueElement::Kind::kCached) = Value(elem);
+    // Let subobjects and arrays share the buffer of the backing BSON rather than copy it.
+    appendField(fieldName, ValueElement::Kind::kCached) =
+        _bson.isOwned() ? Value(elem, _bson.sharedBuffer()) : Value(elem);
     _modified = savedModified;
 
     return pos;
@@ -185,12 +216,12 @@ Value& DocumentStorage::appendField(StringData name, ValueElement::Kind kind) {
     const int nameSize = name.size();
 
     // these are the same for everyone
-    const Position nextCollision;
     const Value value;
 
-    // Make room for new field (and padding at end for alignment)
+    // Make room for new field (and padding at end for alignment), growing the hash table as well
+    // if adding the field would make it more than half full.
     const unsigned newUsed = ValueElement::align(_usedBytes + sizeof(ValueElement) + nameSize);
-    if (_cache + newUsed > _cacheEnd)
+    if (_cache + newUsed > _cacheEnd || needRehash(_numFields + 1))
         alloc(newUsed);
     _usedBytes = newUsed;
 
@@ -200,7 +231,6 @@ Value& DocumentStorage::appendField(StringData name, ValueElement::Kind kind) {
     memcpy(dest, &(x), sizeof(x)); \
     dest += sizeof(x)
     append(value);
-    append(nextCollision);
     append(nameSize);
     append(kind);
     name.copyTo(dest, true);
@@ -213,7 +243,7 @@ Value& DocumentStorage::appendField(StringData name, ValueElement::Kind kind) {
     _numFields++;
 
     if (_numFields > HASH_TAB_MIN) {
-        addFieldToHashTable(pos);
+        addFieldToHashTable(pos, HashedFieldName::hash(name));
     } else if (_numFields == HASH_TAB_MIN) {
         // adds all fields to hash table (including the one we just added)
         rehash();
@@ -223,27 +253,24 @@ Value& DocumentStorage::appendField(StringData name, ValueElement::Kind kind) {
 }
 
 // Call after adding field to _fields and increasing _numFields
-void DocumentStorage::addFieldToHashTable(Position pos) {
-    ValueElement& elem = getField(pos);
-    elem.nextCollision = Position();
-
-    const unsigned bucket = bucketForKey(elem.nameSD());
-
-    Position* posPtr = &_hashTab[bucket];
-    while (posPtr->found()) {
-        // collision: walk links and add new to end
-        posPtr = &getField(*posPtr).nextCollision;
+void DocumentStorage::addFieldToHashTable(Position pos, unsigned hash) {
+    unsigned bucket = hash & _hashTabMask;
+    while (_hashTab[bucket].pos.found()) {
+        // collision: probe the next slot
+        bucket = (bucket + 1) & _hashTabMask;
     }
-    *posPtr = Position(pos.index);
+    _hashTab[bucket] = {hash, pos};
 }
 
 void DocumentStorage::alloc(unsigned newSize) {
     const bool firstAlloc = !_cache;
-    const bool doingRehash = needRehash();
+    // Make room for the field being appended, which is not yet counted in _numFields.
+    const unsigned numFields = _numFields + 1;
+    const bool doingRehash = needRehash(numFields);
     const size_t oldCapacity = _cacheEnd - _cache;
 
     // make new bucket count big enough
-    while (needRehash() || hashTabBuckets() < HASH_TAB_INIT_SIZE)
+    while (needRehash(numFields) || hashTabBuckets() < HASH_TAB_INIT_SIZE)
         _hashTabMask = hashTabBuckets() * 2 - 1;
 
     // only allocate power-of-two sized space > 128 bytes
@@ -277,7 +304,7 @@ void DocumentStorage::reserveFields(size_t expectedFields) {
     fassert(16487, !_cache);
 
     unsigned buckets = HASH_TAB_INIT_SIZE;
-    while (buckets < expectedFields)
+    while (buckets < expectedFields * 2)
         buckets *= 2;
     _hashTabMask = buckets - 1;
 
@@ -512,7 +539,44 @@ Document Document::fromBsonWithMetaData(const BSONObj& bson) {
     return md.freeze();
 }
 
+bool Document::sharesLargerBuffer(const char* ownBuffer) const {
+    if (!_storage) {
+        return false;
+    }
+
+    const auto bson = storage().bsonObj();
+    if (isViewOfLargerBuffer(bson, ownBuffer)) {
+        return true;
+    }
+    if (!storage().isModified()) {
+        // Every cached field was read from the BSON, so it either shares its buffer or is a copy.
+        return false;
+    }
+
+    const auto& bsonBuffer = bson.sharedBuffer();
+    const char* fieldBuffer = bsonBuffer ? bsonBuffer.get() : ownBuffer;
+    for (auto it = storage().iteratorCacheOnly(); !it.atEnd(); it.advance()) {
+        if (it->val.sharesLargerBuffer(fieldBuffer)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 Document Document::getOwned() const {
+    if (sharesLargerBuffer()) {
+        // Write out only the fields of this document, so that it no longer pins the buffers they
+        // were read from.
+        BSONObjBuilder bb;
+        toBson(&bb);
+        if (!metadata()) {
+            return Document(bb.obj());
+        }
+        MutableDocument md(Document(bb.obj()));
+        md.setMetadata(DocumentMetadataFields(metadata()));
+        return md.freeze();
+    }
+
     if (isOwned()) {
         return *this;
     } else {
@@ -531,9 +595,9 @@ MutableDocument::MutableDocument(size_t expectedFields)
 
 MutableValue MutableDocument::getNestedFieldHelper(const FieldPath& dottedField, size_t level) {
     if (level == dottedField.getPathLength() - 1) {
-        return getField(dottedField.getFieldName(level));
+        return getField(dottedField.getFieldNameHashed(level));
     } else {
-        MutableDocument nested(getFieldNonLeaf(dottedField.getFieldName(level)));
+        MutableDocument nested(getFieldNonLeaf(dottedField.getFieldNameHashed(level)));
         return nested.getNestedFieldHelper(dottedField, level + 1);
     }
 }
@@ -624,8 +688,7 @@ static Value getNestedFieldHelper(const Document& doc,
                                   const FieldPath& fieldNames,
                                   vector<Position>* positions,
                                   size_t level) {
-    const auto fieldName = fieldNames.getFieldName(level);
-    const Position pos = doc.positionOf(fieldName);
+    const Position pos = doc.positionOf(fieldNames.getFieldNameHashed(level));
 
     if (!pos.found())
         return Value();
@@ -137,6 +137,14 @@ public:
         return storage().getField(key);
     }
 
+    /// Same as above, but saves hashing the key when it is looked up repeatedly.
+    const Value operator[](HashedFieldName key) const {
+        return getField(key);
+    }
+    const Value getField(HashedFieldName key) const {
+        return storage().getField(key);
+    }
+
     /// Look up a field by Position. See positionOf and getNestedField.
     const Value operator[](Position pos) const {
         return getField(pos);
@@ -278,6 +286,9 @@ public:
     Position positionOf(StringData fieldName) const {
         return storage().findField(fieldName, DocumentStorage::LookupPolicy::kCacheAndBSON);
     }
+    Position positionOf(HashedFieldName fieldName) const {
+        return storage().findField(fieldName, DocumentStorage::LookupPolicy::kCacheAndBSON);
+    }
 
     /** Clone a document.
      *
@@ -308,10 +319,17 @@ public:
     }
 
     /**
-     * Returns a document that owns the underlying BSONObj.
+     * Returns a document that owns the underlying BSONObj. If the document is, or holds, a view
+     * into the buffer of a larger document, only its own fields are copied out of that buffer.
      */
     Document getOwned() const;
 
+    /**
+     * Returns true if this document, or a value in it, is a view into a buffer larger than itself
+     * other than 'ownBuffer'. Holding on to such a document keeps the whole buffer alive.
+     */
+    bool sharesLargerBuffer(const char* ownBuffer = nullptr) const;
+
     /**
      * Returns true if the underlying BSONObj is owned.
      */
@@ -530,6 +548,12 @@ public:
     MutableValue getFieldNonLeaf(StringData key) {
         return MutableValue(storage().getField(key, DocumentStorage::LookupPolicy::kCacheAndBSON));
     }
+    MutableValue getField(HashedFieldName key) {
+        return MutableValue(storage().getField(key, DocumentStorage::LookupPolicy::kCacheOnly));
+    }
+    MutableValue getFieldNonLeaf(HashedFieldName key) {
+        return MutableValue(storage().getField(key, DocumentStorage::LookupPolicy::kCacheAndBSON));
+    }
 
     /// Update field by Position. Must already be a valid Position.
     MutableValue operator[](Position pos) {
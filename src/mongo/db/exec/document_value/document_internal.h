@@ -29,14 +29,13 @@
 
 #pragma once
 
-#include <third_party/murmurhash3/MurmurHash3.h>
-
 #include <bitset>
 #include <boost/intrusive_ptr.hpp>
 
 #include "mongo/base/static_assert.h"
 #include "mongo/db/exec/document_value/document_metadata_fields.h"
 #include "mongo/db/exec/document_value/value.h"
+#include "mongo/db/pipeline/field_path.h"
 #include "mongo/stdx/variant.h"
 #include "mongo/util/intrusive_counter.h"
 
@@ -94,10 +93,9 @@ public:
     };
 
     Value val;
-    Position nextCollision;  // Position of next field with same hashBucket
-    const int nameLen;       // doesn't include '\0'
-    Kind kind;               // See the possible kinds above for comments
-    const char _name[1];     // pointer to start of name (use nameSD instead)
+    const int nameLen;    // doesn't include '\0'
+    Kind kind;            // See the possible kinds above for comments
+    const char _name[1];  // pointer to start of name (use nameSD instead)
 
     ValueElement* next() {
         return align(plusBytes(sizeof(ValueElement) + nameLen));
@@ -140,8 +138,7 @@ private:
 };
 // Real size is sizeof(ValueElement) + nameLen
 #pragma pack()
-MONGO_STATIC_ASSERT(sizeof(ValueElement) ==
-                    (sizeof(Value) + sizeof(Position) + sizeof(int) + sizeof(char) + 1));
+MONGO_STATIC_ASSERT(sizeof(ValueElement) == (sizeof(Value) + sizeof(int) + sizeof(char) + 1));
 
 class DocumentStorage;
 
@@ -326,6 +323,7 @@ public:
 
     /// Returns the position of the named field or Position()
     Position findField(StringData name, LookupPolicy policy) const;
+    Position findField(HashedFieldName name, LookupPolicy policy) const;
 
     // Document uses these
     const ValueElement& getField(Position pos) const {
@@ -338,6 +336,12 @@ public:
             return Value();
         return getField(pos).val;
     }
+    Value getField(HashedFieldName name) const {
+        Position pos = findField(name, LookupPolicy::kCacheAndBSON);
+        if (!pos.found())
+            return Value();
+        return getField(pos).val;
+    }
 
     // MutableDocument uses these
     ValueElement& getField(Position pos) {
@@ -352,6 +356,13 @@ public:
             return appendField(name, ValueElement::Kind::kMaybeInserted);
         return getField(pos).val;
     }
+    Value& getField(HashedFieldName name, LookupPolicy policy) {
+        _modified = true;
+        Position pos = findField(name, policy);
+        if (!pos.found())
+            return appendField(name.name(), ValueElement::Kind::kMaybeInserted);
+        return getField(pos).val;
+    }
 
     /**
      * Given a field name either return a Value if the field resides in the cache, or a BSONElement
@@ -398,8 +409,9 @@ public:
         return !_cache ? 0 : (_cacheEnd - _cache + hashTabBytes());
     }
 
+    /// The size of the BSON, or of the whole buffer if the BSON is a view into a larger object.
     auto bsonObjSize() const {
-        return _bson.objsize();
+        return bsonBytesKeptAlive(_bson);
     }
 
     bool isOwned() const {
@@ -462,13 +474,6 @@ public:
         _metadataFields = std::move(metadata);
     }
 
-    static unsigned hashKey(StringData name) {
-        // TODO consider FNV-1a once we have a better benchmark corpus
-        unsigned out;
-        MurmurHash3_x86_32(name.rawData(), name.size(), 0, &out);
-        return out;
-    }
-
     const ValueElement* begin() const {
         return _firstElement;
     }
@@ -493,26 +498,46 @@ public:
     }
 
 private:
+    /**
+     * A slot of the open-addressing hash table. The full hash of the field name is kept next to
+     * its position, so that probing only touches the field itself when the hashes match.
+     */
+    struct HashTabSlot {
+        unsigned hash;
+        Position pos;  // Position() marks an empty slot
+    };
+
     /// Returns the position of the named field in the cache or Position()
     Position findFieldInCache(StringData name) const;
+    Position findFieldInCache(HashedFieldName name) const;
+
+    /// Probes the hash table. Only valid once _numFields >= HASH_TAB_MIN.
+    Position findFieldInHashTable(HashedFieldName name) const;
+
+    /// Scans the cached fields in order.
+    Position findFieldLinear(StringData name) const;
+
+    /// Returns the position of the named field in _bson after constructing it in the cache, or
+    /// Position()
+    Position findFieldInBson(StringData name) const;
 
     /// Allocates space in _cache. Copies existing data if there is any.
     void alloc(unsigned newSize);
 
     /// Call after adding field to _cache and increasing _numFields
-    void addFieldToHashTable(Position pos);
+    void addFieldToHashTable(Position pos, unsigned hash);
 
     // assumes _hashTabMask is (power of two) - 1
     unsigned hashTabBuckets() const {
         return _hashTabMask + 1;
     }
     unsigned hashTabBytes() const {
-        return hashTabBuckets() * sizeof(Position);
+        return hashTabBuckets() * sizeof(HashTabSlot);
     }
 
-    /// rehash on buffer growth if load-factor > .5 (attempt to keep lf < 1 when full)
-    bool needRehash() const {
-        return _numFields * 2 > hashTabBuckets();
+    /// Keep the load-factor at or below .5 so that probe sequences stay short
+    bool needRehash(unsigned numFields) const {
+        return numFields * 2 > hashTabBuckets();
     }
 
     /// Initialize empty hash table
@@ -520,15 +545,11 @@ private:
         memset(static_cast<void*>(_hashTab), -1, hashTabBytes());
     }
 
-    unsigned bucketForKey(StringData name) const {
-        return hashKey(name) & _hashTabMask;
-    }
-
     /// Adds all fields to the hash table
     void rehash() {
         hashTabInit();
         for (auto it = iteratorCacheOnly(); !it.atEnd(); it.advance())
-            addFieldToHashTable(it.position());
+            addFieldToHashTable(it.position(), HashedFieldName::hash(it->nameSD()));
     }
 
     void loadLazyMetadata() const;
@@ -556,7 +577,7 @@ private:
     union {
         // pointer to "end" of _cache element space and start of hash table (same position)
         char* _cacheEnd;
-        Position* _hashTab;  // table lazily initialized once _numFields == HASH_TAB_MIN
+        HashTabSlot* _hashTab;  // table lazily initialized once _numFields == HASH_TAB_MIN
     };
 
     unsigned _usedBytes;    // position where next field would start
@@ -45,6 +45,7 @@
 #include "mongo/db/pipeline/field_path.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/logv2/log.h"
+#include "mongo/stdx/thread.h"
 
 namespace DocumentTests {
 
@@ -355,6 +356,159 @@ TEST(DocumentGetFieldNonCaching, TraverseArray) {
     checkArrayTagIsReturned();
 }
 
+TEST(DocumentGetField, WideDocument) {
+    const int kNumFields = 300;
+    BSONObjBuilder builder;
+    for (int i = 0; i < kNumFields; ++i) {
+        builder.append("field" + std::to_string(i), i);
+    }
+    Document document = fromBson(builder.obj());
+
+    // Look up every field twice. The first lookup constructs the field in the cache and the second
+    // finds it in the hash table, which grows as the cache fills up.
+    for (int round = 0; round < 2; ++round) {
+        for (int i = 0; i < kNumFields; ++i) {
+            const auto name = "field" + std::to_string(i);
+            ASSERT_VALUE_EQ(document[name], Value(i));
+            ASSERT_VALUE_EQ(document[HashedFieldName(name)], Value(i));
+        }
+        ASSERT_TRUE(document["missing"].missing());
+        ASSERT_TRUE(document[HashedFieldName("missing")].missing());
+    }
+
+    // Fields appended to a mutable copy are found along with the existing ones.
+    MutableDocument md(document);
+    for (int i = kNumFields; i < 2 * kNumFields; ++i) {
+        md.addField("field" + std::to_string(i), Value(i));
+    }
+    Document extended = md.freeze();
+    for (int i = 0; i < 2 * kNumFields; ++i) {
+        const auto name = "field" + std::to_string(i);
+        ASSERT_VALUE_EQ(extended[HashedFieldName(name)], Value(i));
+        ASSERT_VALUE_EQ(extended.getNestedField(FieldPath(name)), Value(i));
+    }
+}
+
+TEST(DocumentLazyBson, LargeSubobjectSharesBuffer) {
+    std::string padding(1000, 'x');
+    BSONObj bson = BSON("small" << BSON("a" << 1) << "large" << BSON("padding" << padding)
+                                << "array" << BSON_ARRAY(padding << padding << BSON("a" << 1)));
+    ASSERT_TRUE(bson.isOwned());
+    Document document = fromBson(bson);
+
+    // The large subobject and array are views of the original BSON, the small one is copied.
+    auto objdata = [](const Value& value) {
+        return static_cast<const void*>(value.getDocument().toBson().objdata());
+    };
+    ASSERT_EQ(objdata(document["large"]), bson["large"].embeddedObject().objdata());
+    ASSERT_NE(objdata(document["small"]), bson["small"].embeddedObject().objdata());
+
+    // An unmodified subtree is written out as is.
+    MutableDocument md(document);
+    md["small"] = Value(2);
+    ASSERT_BSONOBJ_EQ(md.freeze().toBson(),
+                      BSON("small" << 2 << "large" << BSON("padding" << padding) << "array"
+                                   << BSON_ARRAY(padding << padding << BSON("a" << 1))));
+}
+
+TEST(DocumentLazyBson, SharedSubtreeCountsTheBufferItKeepsAlive) {
+    std::string padding(1000, 'x');
+    BSONObj bson = BSON("large" << BSON("padding" << padding) << "array"
+                                << BSON_ARRAY(padding << padding) << "rest" << padding);
+    Document document = fromBson(bson);
+
+    // Both subtrees share the buffer of 'bson', so holding on to either keeps all of it alive.
+    const auto bufferSize = static_cast<size_t>(bson.sharedBuffer().capacity());
+    ASSERT_GTE(document["large"].getApproximateSize(), bufferSize);
+    ASSERT_GTE(document["array"].getApproximateSize(), bufferSize);
+
+    // An owned copy of either subtree only counts its own bytes.
+    ASSERT_LT(document["large"].getOwned().getApproximateSize(), bufferSize);
+    ASSERT_LT(document["array"].getOwned().getApproximateSize(), bufferSize);
+}
+
+TEST(DocumentLazyBson, GetOwnedCopiesOnlyTheSharedSubtree) {
+    std::string padding(1000, 'x');
+    BSONObj bson = BSON("large" << BSON("padding" << padding) << "array"
+                                << BSON_ARRAY(BSON("padding" << padding) << padding) << "rest"
+                                << padding);
+    Document document = fromBson(bson);
+    ASSERT_FALSE(document.sharesLargerBuffer());
+
+    // A lazy array, a converted array and a subobject all stop sharing the buffer of 'bson'.
+    const Value large = document["large"];
+    const Value lazyArray = document["array"];
+    const Value convertedArray = fromBson(bson)["array"];
+    ASSERT_EQ(convertedArray.getArrayLength(), 2U);
+    for (auto&& value : {large, lazyArray, convertedArray}) {
+        ASSERT_TRUE(value.sharesLargerBuffer());
+        const Value owned = value.getOwned();
+        ASSERT_FALSE(owned.sharesLargerBuffer());
+        ASSERT_VALUE_EQ(owned, value);
+    }
+
+    // A new document holding a shared subtree copies just that subtree, and keeps its metadata.
+    MutableDocument md;
+    md["large"] = large;
+    md.metadata().setTextScore(1.0);
+    const Document projected = md.freeze();
+    ASSERT_TRUE(projected.sharesLargerBuffer());
+    const Document owned = projected.getOwned();
+    ASSERT_FALSE(owned.sharesLargerBuffer());
+    ASSERT_DOCUMENT_EQ(owned, projected);
+    ASSERT_EQ(owned.metadata().getTextScore(), 1.0);
+    ASSERT_LT(owned.getApproximateSize(),
+              static_cast<size_t>(bson.sharedBuffer().capacity()));
+
+    // A value which owns its data is returned as is.
+    ASSERT_FALSE(Value(1).sharesLargerBuffer());
+    ASSERT_EQ(static_cast<const void*>(document.getOwned().toBson().objdata()),
+              static_cast<const void*>(bson.objdata()));
+}
+
+TEST(DocumentLazyBson, ArrayIsConvertedOnceByConcurrentReaders) {
+    BSONArrayBuilder arrayBuilder;
+    for (int i = 0; i < 1000; ++i) {
+        arrayBuilder.append(i);
+    }
+    const Value array = fromBson(BSON("array" << arrayBuilder.arr()))["array"];
+
+    std::vector<stdx::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 1000; ++i) {
+                invariant(array.getArray()[i].getInt() == i);
+            }
+        });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(array.getArrayLength(), 1000U);
+}
+
+TEST(DocumentLazyBson, ArrayIsConvertedOnAccess) {
+    BSONObj bson = BSON("array" << BSON_ARRAY(1 << "two" << BSON("three" << 3)
+                                                << BSON_ARRAY(4 << 5)));
+    Document document = fromBson(bson);
+    const Value array = document["array"];
+
+    // Writing the array out before and after its elements are converted gives the same result.
+    ASSERT_BSONOBJ_EQ(document.toBson(), bson);
+    ASSERT_EQ(array.getArrayLength(), 4U);
+    ASSERT_VALUE_EQ(array.getArray()[2]["three"], Value(3));
+    ASSERT_VALUE_EQ(array,
+                    Value(std::vector<Value>{Value(1),
+                                             Value("two"_sd),
+                                             Value(BSON("three" << 3)),
+                                             Value(std::vector<Value>{Value(4), Value(5)})}));
+    ASSERT_BSONOBJ_EQ(document.toBson(), bson);
+
+    MutableDocument md;
+    md["copy"] = array;
+    ASSERT_BSONOBJ_EQ(md.freeze().toBson(), BSON("copy" << bson["array"]));
+}
+
 /** Add Document fields. */
 class AddField {
 public:
@@ -59,6 +59,36 @@ using std::stringstream;
 using std::vector;
 using namespace std::string_literals;
 
+namespace {
+// Sharing a subobject keeps the whole buffer that contains it alive. Only share subobjects which
+// make up at least this fraction of the buffer; smaller ones are cheap enough to copy.
+constexpr size_t kMaxSharedBufferToSubobjectRatio = 8;
+
+/**
+ * Returns an owned copy of the object or array in 'elem', or a view of it which shares 'owner'
+ * when that is worth it.
+ */
+BSONObj ownedEmbeddedObject(const BSONElement& elem, const ConstSharedBuffer& owner) {
+    BSONObj obj = elem.embeddedObject();
+    if (owner &&
+        static_cast<size_t>(obj.objsize()) * kMaxSharedBufferToSubobjectRatio >=
+            owner.capacity()) {
+        dassert(obj.objdata() >= owner.get() &&
+                obj.objdata() + obj.objsize() <= owner.get() + owner.capacity());
+        return std::move(obj).shareOwnershipWith(owner);
+    }
+    return obj.getOwned();
+}
+}  // namespace
+
+void RCVector::materialize() const {
+    invariant(vec.empty());
+    BSONForEach(sub, bson) {
+        vec.push_back(Value(sub, bson.sharedBuffer()));
+    }
+    _materialized.store(true);
+}
+
 void ValueStorage::verifyRefCountingIfShould() const {
     switch (type) {
         case MinKey:
@@ -161,7 +191,9 @@ Document ValueStorage::getDocument() const {
 Value::Value(const BSONObj& obj) : _storage(Object, Document(obj.getOwned())) {}
 Value::Value(const Document& doc) : _storage(Object, doc.isOwned() ? doc : doc.getOwned()) {}
 
-Value::Value(const BSONElement& elem) : _storage(elem.type()) {
+Value::Value(const BSONElement& elem) : Value(elem, ConstSharedBuffer()) {}
+
+Value::Value(const BSONElement& elem, const ConstSharedBuffer& owner) : _storage(elem.type()) {
     switch (elem.type()) {
         // These are all type-only, no data
         case EOO:
@@ -182,16 +214,13 @@ Value::Value(const BSONElement& elem) : _storage(elem.type()) {
             break;
 
         case Object: {
-            _storage.putDocument(Document(elem.embeddedObject().getOwned()));
+            _storage.putDocument(Document(ownedEmbeddedObject(elem, owner)));
             break;
         }
 
         case Array: {
-            auto vec = make_intrusive<RCVector>();
-            BSONForEach(sub, elem.embeddedObject()) {
-                vec->vec.push_back(Value(sub));
-            }
-            _storage.putVector(std::move(vec));
+            // The elements are converted when the array is first accessed.
+            _storage.putVector(make_intrusive<RCVector>(ownedEmbeddedObject(elem, owner)));
             break;
         }
 
@@ -248,13 +277,7 @@ Value::Value(const BSONElement& elem) : _storage(elem.type()) {
     }
 }
 
-Value::Value(const BSONArray& arr) : _storage(Array) {
-    auto vec = make_intrusive<RCVector>();
-    BSONForEach(sub, arr) {
-        vec->vec.push_back(Value(sub));
-    }
-    _storage.putVector(std::move(vec));
-}
+Value::Value(const BSONArray& arr) : _storage(Array, make_intrusive<RCVector>(arr.getOwned())) {}
 
 Value::Value(const vector<BSONObj>& vec) : _storage(Array) {
     auto storageVec = make_intrusive<RCVector>();
@@ -381,6 +404,9 @@ BSONObjBuilder& operator<<(BSONObjBuilderValueStream& builder, const Value& val)
                                              val._storage.getCodeWScope()->scope);
 
         case Array: {
+            if (val._storage.getRCVector()->isLazy()) {
+                return builder << BSONArray(val._storage.getRCVector()->bson);
+            }
             BSONArrayBuilder arrayBuilder(builder.subarrayStart());
             for (auto&& value : val.getArray()) {
                 value.addToBsonArray(&arrayBuilder);
@@ -400,7 +426,13 @@ void Value::addToBsonObj(BSONObjBuilder* builder,
                           << BSONDepth::getMaxAllowableDepth() << " levels of nesting",
             recursionLevel <= BSONDepth::getMaxAllowableDepth());
 
-    if (getType() == BSONType::Object) {
+    if (auto bson = _unmodifiedBson(recursionLevel)) {
+        if (getType() == BSONType::Object) {
+            builder->append(fieldName, *bson);
+        } else {
+            builder->appendArray(fieldName, *bson);
+        }
+    } else if (getType() == BSONType::Object) {
         BSONObjBuilder subobjBuilder(builder->subobjStart(fieldName));
         getDocument().toBson(&subobjBuilder, recursionLevel + 1);
         subobjBuilder.doneFast();
@@ -415,6 +447,22 @@ void Value::addToBsonObj(BSONObjBuilder* builder,
     }
 }
 
+boost::optional<BSONObj> Value::_unmodifiedBson(size_t recursionLevel) const {
+    // BSON read from a collection is never nested deeper than getMaxDepthForUserStorage(), so it
+    // only needs to be walked when it would be written close to the depth limit.
+    if (recursionLevel + BSONDepth::getMaxDepthForUserStorage() >=
+        BSONDepth::getMaxAllowableDepth()) {
+        return boost::none;
+    }
+
+    if (getType() == BSONType::Object) {
+        return getDocument().toBsonIfTriviallyConvertible();
+    } else if (getType() == BSONType::Array && _storage.getRCVector()->isLazy()) {
+        return _storage.getRCVector()->bson;
+    }
+    return boost::none;
+}
+
 void Value::addToBsonArray(BSONArrayBuilder* builder, size_t recursionLevel) const {
     uassert(ErrorCodes::Overflow,
             str::stream() << "cannot convert document to BSON because it exceeds the limit of "
@@ -426,7 +474,13 @@ void Value::addToBsonArray(BSONArrayBuilder* builder, size_t recursionLevel) con
         return;
     }
 
-    if (getType() == BSONType::Object) {
+    if (auto bson = _unmodifiedBson(recursionLevel)) {
+        if (getType() == BSONType::Object) {
+            builder->append(*bson);
+        } else {
+            builder->append(BSONArray(*bson));
+        }
+    } else if (getType() == BSONType::Object) {
         BSONObjBuilder subobjBuilder(builder->subobjStart());
         getDocument().toBson(&subobjBuilder, recursionLevel + 1);
         subobjBuilder.doneFast();
@@ -1096,6 +1150,9 @@ size_t Value::getApproximateSize() const {
         case Array: {
             size_t size = sizeof(Value);
             size += sizeof(RCVector);
+            if (_storage.getRCVector()->isLazy()) {
+                return size + bsonBytesKeptAlive(_storage.getRCVector()->bson);
+            }
             const size_t n = getArray().size();
             for (size_t i = 0; i < n; ++i) {
                 size += getArray()[i].getApproximateSize();
@@ -1131,6 +1188,57 @@ size_t Value::getApproximateSize() const {
     verify(false);
 }
 
+bool Value::sharesLargerBuffer(const char* ownBuffer) const {
+    switch (getType()) {
+        case Object:
+            return getDocument().sharesLargerBuffer(ownBuffer);
+
+        case Array: {
+            const auto& rcVector = *_storage.getRCVector();
+            if (isViewOfLargerBuffer(rcVector.bson, ownBuffer)) {
+                return true;
+            }
+            if (rcVector.isLazy()) {
+                return false;
+            }
+            // Elements converted from the array's BSON may share its buffer.
+            const auto& arrayBuffer = rcVector.bson.sharedBuffer();
+            const char* elementBuffer = arrayBuffer ? arrayBuffer.get() : ownBuffer;
+            for (auto&& elem : rcVector.getVec()) {
+                if (elem.sharesLargerBuffer(elementBuffer)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        default:
+            return false;
+    }
+}
+
+Value Value::getOwned() const {
+    if (!sharesLargerBuffer()) {
+        return *this;
+    }
+
+    if (getType() == Object) {
+        return Value(getDocument().getOwned());
+    }
+
+    invariant(getType() == Array);
+    const auto& rcVector = *_storage.getRCVector();
+    if (rcVector.isLazy()) {
+        return Value(BSONArray(rcVector.bson.copy()));
+    }
+    std::vector<Value> elems;
+    elems.reserve(rcVector.getVec().size());
+    for (auto&& elem : rcVector.getVec()) {
+        elems.push_back(elem.getOwned());
+    }
+    return Value(std::move(elems));
+}
+
 string Value::toString() const {
     // TODO use StringBuilder when operator << is ready
     stringstream out;
@@ -135,10 +135,16 @@ public:
     explicit Value(const InvalidArgumentType&) = delete;
 
 
-    // TODO: add an unsafe version that can share storage with the BSONElement
     /// Deep-convert from BSONElement to Value
     explicit Value(const BSONElement& elem);
 
+    /**
+     * Like Value(const BSONElement&), but 'elem' must point into the buffer held by 'owner'.
+     * Subobjects and arrays then share that buffer rather than copying their bytes, provided they
+     * make up enough of it that keeping the rest of the buffer alive is worth saving the copy.
+     */
+    Value(const BSONElement& elem, const ConstSharedBuffer& owner);
+
 
     /** Construct a long or integer-valued Value.
      *
@@ -352,9 +358,18 @@ public:
     int memUsageForSorter() const {
         return getApproximateSize();
     }
-    Value getOwned() const {
-        return *this;
-    }
+
+    /**
+     * Returns a Value which does not keep a larger buffer alive. Objects and arrays which are views
+     * into the buffer of a larger document are copied; everything else is shared.
+     */
+    Value getOwned() const;
+
+    /**
+     * Returns true if this value, or a value nested in it, is a view into a buffer larger than
+     * itself other than 'ownBuffer'. Holding on to such a value keeps the whole buffer alive.
+     */
+    bool sharesLargerBuffer(const char* ownBuffer = nullptr) const;
 
     /// Members to support parsing/deserialization from IDL generated code.
     void serializeForIDL(StringData fieldName, BSONObjBuilder* builder) const;
@@ -367,6 +382,13 @@ private:
     // May contain embedded NUL bytes, does not check the type.
     StringData getRawData() const;
 
+    /**
+     * Returns the BSON of an object or array which is unchanged since it was read from BSON, so
+     * that it can be copied into a builder as is. Returns boost::none otherwise, or when the value
+     * would be written 'recursionLevel' levels deep and the BSON might exceed the depth limit.
+     */
+    boost::optional<BSONObj> _unmodifiedBson(size_t recursionLevel) const;
+
     ValueStorage _storage;
     friend class MutableValue;  // gets and sets _storage.genericRCPtr
 };
@@ -31,6 +31,7 @@
 
 #include <algorithm>
 #include <boost/intrusive_ptr.hpp>
+#include <mutex>
 
 #include "mongo/base/static_assert.h"
 #include "mongo/bson/bsonmisc.h"
@@ -38,6 +39,7 @@
 #include "mongo/bson/bsontypes.h"
 #include "mongo/bson/oid.h"
 #include "mongo/bson/timestamp.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/util/debug_util.h"
 #include "mongo/util/intrusive_counter.h"
 
@@ -48,14 +50,70 @@ class DocumentStorage;
 class Value;
 
 // TODO: a MutableVector, similar to MutableDocument
-/// A heap-allocated reference-counted std::vector
+/**
+ * A heap-allocated reference-counted std::vector.
+ *
+ * An array read from BSON keeps the BSON and only converts its elements to Values the first time
+ * they are accessed, so that arrays which are passed through a pipeline untouched can be written
+ * back out without ever being converted. The conversion happens in const methods, and it is done
+ * at most once even if several threads read the array at the same time.
+ */
 class RCVector : public RefCountable {
 public:
     RCVector() {}
     RCVector(std::vector<Value> v) : vec(std::move(v)) {}
-    std::vector<Value> vec;
+    explicit RCVector(BSONObj array) : bson(std::move(array)), _materialized(false) {
+        dassert(bson.isOwned());
+    }
+
+    const std::vector<Value>& getVec() const {
+        if (!_materialized.load()) {
+            std::call_once(_materializeOnce, [this] { materialize(); });
+        }
+        return vec;
+    }
+
+    /// True if the elements are still only held as BSON.
+    bool isLazy() const {
+        return !_materialized.load();
+    }
+
+    // Only written to while building the vector or converting it from 'bson'.
+    mutable std::vector<Value> vec;
+
+    // The array this vector was read from, if any. Owned.
+    const BSONObj bson;
+
+private:
+    // Defined in value.cpp.
+    void materialize() const;
+
+    // Set once 'vec' holds the elements, after which 'vec' is safe to read without synchronization.
+    mutable AtomicWord<bool> _materialized{true};
+    mutable std::once_flag _materializeOnce;
 };
 
+/**
+ * Returns the number of bytes which 'obj' keeps alive. This is the size of the whole buffer if 'obj'
+ * is a view of an object embedded in a larger buffer, and the size of 'obj' otherwise.
+ */
+inline size_t bsonBytesKeptAlive(const BSONObj& obj) {
+    const auto& buffer = obj.sharedBuffer();
+    if (buffer && obj.objdata() != buffer.get()) {
+        return std::max(static_cast<size_t>(obj.objsize()), buffer.capacity());
+    }
+    return obj.objsize();
+}
+
+/**
+ * Returns true if 'obj' is a view of an object embedded in a larger buffer, unless that buffer is
+ * 'ownBuffer', which the caller keeps alive anyway.
+ */
+inline bool isViewOfLargerBuffer(const BSONObj& obj, const char* ownBuffer) {
+    const auto& buffer = obj.sharedBuffer();
+    return buffer && buffer.get() != ownBuffer && obj.objdata() != buffer.get();
+}
+
 class RCCodeWScope : public RefCountable {
 public:
     RCCodeWScope(const std::string& str, BSONObj obj) : code(str), scope(obj.getOwned()) {}
@@ -267,9 +325,12 @@ public:
     }
 
     const std::vector<Value>& getArray() const {
+        return getRCVector()->getVec();
+    }
+
+    const RCVector* getRCVector() const {
         dassert(typeid(*genericRCPtr) == typeid(const RCVector));
-        const RCVector* arrayPtr = static_cast<const RCVector*>(genericRCPtr);
-        return arrayPtr->vec;
+        return static_cast<const RCVector*>(genericRCPtr);
     }
 
     boost::intrusive_ptr<const RCCodeWScope> getCodeWScope() const {
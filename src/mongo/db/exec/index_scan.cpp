@@ -42,6 +42,7 @@
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/index_names.h"
 #include "mongo/db/query/index_bounds_builder.h"
+#include "mongo/db/query/query_knobs_gen.h"
 
 namespace {
 
@@ -137,16 +138,39 @@ boost::optional<IndexKeyEntry> IndexScan::initIndexScan() {
     }
 }
 
+boost::optional<IndexKeyEntry> IndexScan::nextFromBatch() {
+    if (_batchPosition == _batch.size()) {
+        // A batch interrupted by a write conflict keeps the keys read before it, which are
+        // returned once the scan resumes.
+        _batchPosition = 0;
+        _batchSnapshotId = opCtx()->recoveryUnit()->getSnapshotId();
+        const size_t maxBatchSize = internalQueryExecScanBatchSize.load();
+        const size_t batchSize = std::min(_batchSize, maxBatchSize);
+        _batchSize = std::min(batchSize * 2, maxBatchSize);
+        if (!_indexCursor->nextBatch(batchSize, &_batch)) {
+            return boost::none;
+        }
+    }
+    return std::move(_batch[_batchPosition++]);
+}
+
 PlanStage::StageState IndexScan::doWork(WorkingSetID* out) {
     // Get the next kv pair from the index, if any.
     boost::optional<IndexKeyEntry> kv;
+    SnapshotId snapshotId = opCtx()->recoveryUnit()->getSnapshotId();
     try {
         switch (_scanState) {
             case INITIALIZING:
                 kv = initIndexScan();
                 break;
             case GETTING_NEXT:
-                kv = _indexCursor->next();
+                // Scans which use '_checker' may seek after any key, so they read one at a time.
+                if (_checker) {
+                    kv = _indexCursor->next();
+                } else {
+                    kv = nextFromBatch();
+                    snapshotId = _batchSnapshotId;
+                }
                 break;
             case NEED_SEEK:
                 ++_specificStats.seeks;
@@ -232,7 +256,7 @@ PlanStage::StageState IndexScan::doWork(WorkingSetID* out) {
     WorkingSetMember* member = _workingSet->get(id);
     member->recordId = kv->loc;
     member->keyData.push_back(IndexKeyDatum(
-        _keyPattern, kv->key, workingSetIndexId(), opCtx()->recoveryUnit()->getSnapshotId()));
+        _keyPattern, kv->key, workingSetIndexId(), snapshotId));
     _workingSet->transitionToRecordIdAndIdx(id);
 
     if (_addKeyMetadata) {
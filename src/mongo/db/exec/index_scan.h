@@ -36,6 +36,7 @@
 #include "mongo/db/query/index_bounds.h"
 #include "mongo/db/record_id.h"
 #include "mongo/db/storage/index_entry_comparison.h"
+#include "mongo/db/storage/snapshot.h"
 #include "mongo/db/storage/sorted_data_interface.h"
 #include "mongo/stdx/unordered_set.h"
 
@@ -140,6 +141,12 @@ private:
      */
     boost::optional<IndexKeyEntry> initIndexScan();
 
+    /**
+     * Returns the next key of a single interval scan from '_batch', reading the next batch from
+     * '_indexCursor' once it has been consumed.
+     */
+    boost::optional<IndexKeyEntry> nextFromBatch();
+
     // The WorkingSet we fill with results.  Not owned by us.
     WorkingSet* const _workingSet;
 
@@ -199,6 +206,14 @@ private:
     bool _startKeyInclusive;
     // Is the end key included in the range?
     bool _endKeyInclusive;
+
+    // Keys read ahead from '_indexCursor' by a single interval scan, the position of the next one
+    // to return and the number of keys to ask for next. A batch may outlive a yield, so the
+    // snapshot it was read in is kept alongside it.
+    std::vector<IndexKeyEntry> _batch;
+    size_t _batchPosition = 0;
+    size_t _batchSize = 1;
+    SnapshotId _batchSnapshotId;
 };
 
 }  // namespace mongo
@@ -32,6 +32,7 @@
 #include "mongo/db/exec/plan_stats.h"
 #include "mongo/db/query/canonical_query.h"
 #include "mongo/db/query/collection_query_info.h"
+#include "mongo/db/query/sbe_cached_plan.h"
 #include "mongo/db/query/sbe_plan_ranker.h"
 
 namespace mongo {
@@ -76,6 +77,8 @@ void logNotCachingNoData(std::string&& solution);
  *    * Always cached.
  *    * Never cached.
  *    * Cached, except in certain special cases.
+ *
+ * The execution tree of the best candidate is cached along with its solution if it is an SBE tree.
  */
 template <typename PlanStageType, typename ResultType, typename Data>
 void updatePlanCache(
@@ -160,12 +163,20 @@ void updatePlanCache(
         }
 
         if (validSolutions) {
+            std::shared_ptr<const CachedExecutionPlan> cachedPlan;
+            if constexpr (std::is_same_v<PlanStageType, std::unique_ptr<sbe::PlanStage>>) {
+                cachedPlan = std::make_shared<sbe::CachedSbePlan>(
+                    query, *candidates[winnerIdx].root, candidates[winnerIdx].data);
+            }
+
             uassertStatusOK(CollectionQueryInfo::get(collection)
                                 .getPlanCache()
                                 ->set(query,
                                       solutions,
                                       std::move(ranking),
-                                      opCtx->getServiceContext()->getPreciseClockSource()->now()));
+                                      opCtx->getServiceContext()->getPreciseClockSource()->now(),
+                                      boost::none /* worksGrowthCoefficient */,
+                                      std::move(cachedPlan)));
         }
     }
 }
@@ -637,6 +637,16 @@ struct SortStats : public SpecificStats {
 
     // Whether we spilled data to disk during the execution of this query.
     bool wasDiskUsed = false;
+
+    // The number of bytes of data spilled to disk, and the number of bytes written to disk for it
+    // after compression.
+    uint64_t spilledDataSizeBytes = 0u;
+    uint64_t spilledBytesWritten = 0u;
+
+    double spillCompressionRatio() const {
+        return spilledBytesWritten ? static_cast<double>(spilledDataSizeBytes) / spilledBytesWritten
+                                   : 1.0;
+    }
 };
 
 struct MergeSortStats : public SpecificStats {
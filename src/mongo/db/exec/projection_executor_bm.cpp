@@ -0,0 +1,171 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/exec/add_fields_projection_executor.h"
+#include "mongo/db/exec/document_value/document.h"
+#include "mongo/db/exec/projection_executor_builder.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/query/projection_parser.h"
+
+namespace mongo::projection_executor {
+namespace {
+
+std::string fieldName(int i) {
+    return "field" + std::to_string(i);
+}
+
+/**
+ * Builds a document with 'numFields' top-level fields, like the wide events written by ingestion
+ * workloads.
+ */
+BSONObj makeWideDocument(int numFields) {
+    BSONObjBuilder builder;
+    for (int i = 0; i < numFields; ++i) {
+        builder.append(fieldName(i), i);
+    }
+    return builder.obj();
+}
+
+/**
+ * Builds a projection spec with 'numComputed' fields which each read a field spread across the
+ * width of the input document.
+ */
+BSONObj makeComputedSpec(int numFields, int numComputed, bool excludeId) {
+    BSONObjBuilder builder;
+    if (excludeId) {
+        builder.append("_id", false);
+    }
+    for (int i = 0; i < numComputed; ++i) {
+        const int field = numFields - 1 - (i * numFields / numComputed);
+        builder.append("computed" + std::to_string(i),
+                       BSON("$add" << BSON_ARRAY("$" + fieldName(field) << 1)));
+    }
+    return builder.obj();
+}
+
+/**
+ * Runs 'executor' over a wide document. When the second benchmark argument is 0 each iteration
+ * starts from the BSON, as the first stage of a pipeline would. Otherwise the input has all of its
+ * fields in the Document cache, as the output of an earlier stage would.
+ */
+void runProjection(benchmark::State& state, ProjectionExecutor* executor) {
+    const int numFields = state.range(0);
+    const bool fromBson = state.range(1) == 0;
+    const auto bson = makeWideDocument(numFields);
+
+    MutableDocument md(numFields);
+    for (int i = 0; i < numFields; ++i) {
+        md.addField(fieldName(i), Value(i));
+    }
+    const auto cached = md.freeze();
+
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(executor->applyTransformation(fromBson ? Document(bson) : cached));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_ProjectWideDocument(benchmark::State& state) {
+    const int numFields = state.range(0);
+    const boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    const auto projection =
+        projection_ast::parse(expCtx,
+                              makeComputedSpec(numFields, 16, true),
+                              ProjectionPolicies::aggregateProjectionPolicies());
+    auto executor = buildProjectionExecutor(expCtx,
+                                            &projection,
+                                            ProjectionPolicies::aggregateProjectionPolicies(),
+                                            kDefaultBuilderParams);
+
+    runProjection(state, executor.get());
+}
+
+void BM_AddFieldsWideDocument(benchmark::State& state) {
+    const int numFields = state.range(0);
+    const boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto executor =
+        AddFieldsProjectionExecutor::create(expCtx, makeComputedSpec(numFields, 16, false));
+
+    runProjection(state, executor.get());
+}
+
+/**
+ * Projects two large subtrees out of a document of about 50KB and writes the result out as BSON,
+ * as a pipeline would for its reply.
+ */
+void BM_ProjectLargeSubtrees(benchmark::State& state) {
+    BSONObjBuilder builder;
+    builder.append("_id", 0);
+    for (int i = 0; i < 5; ++i) {
+        BSONObjBuilder sub(builder.subobjStart("object" + std::to_string(i)));
+        for (int j = 0; j < 100; ++j) {
+            sub.append(fieldName(j), std::string(40, 'x'));
+        }
+        sub.doneFast();
+
+        BSONArrayBuilder array(builder.subarrayStart("array" + std::to_string(i)));
+        for (int j = 0; j < 100; ++j) {
+            array.append(BSON("a" << j << "b" << std::string(20, 'y')));
+        }
+        array.doneFast();
+    }
+    const auto bson = builder.obj();
+
+    const boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    const auto projection =
+        projection_ast::parse(expCtx,
+                              BSON("object2" << 1 << "array3" << 1),
+                              ProjectionPolicies::aggregateProjectionPolicies());
+    auto executor = buildProjectionExecutor(expCtx,
+                                            &projection,
+                                            ProjectionPolicies::aggregateProjectionPolicies(),
+                                            kDefaultBuilderParams);
+
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(executor->applyTransformation(Document(bson)).toBson());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * bson.objsize());
+}
+
+// The first argument is the number of fields in the input document, the second whether the input
+// is already in the Document cache.
+BENCHMARK(BM_ProjectWideDocument)->Ranges({{16, 512}, {0, 1}});
+BENCHMARK(BM_AddFieldsWideDocument)->Ranges({{16, 512}, {0, 1}});
+BENCHMARK(BM_ProjectLargeSubtrees);
+
+}  // namespace
+}  // namespace mongo::projection_executor
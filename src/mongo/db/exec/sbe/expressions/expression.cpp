@@ -34,6 +34,7 @@
 #include <iomanip>
 #include <sstream>
 
+#include "mongo/db/exec/sbe/size_estimator.h"
 #include "mongo/db/exec/sbe/stages/spool.h"
 #include "mongo/db/exec/sbe/stages/stages.h"
 #include "mongo/util/str.h"
@@ -84,6 +85,10 @@ std::vector<DebugPrinter::Block> EConstant::debugPrint() const {
     return ret;
 }
 
+size_t EConstant::estimateSize() const {
+    return sizeof(*this) + size_estimator::estimate(_nodes) + size_estimator::estimate(_tag, _val);
+}
+
 std::unique_ptr<EExpression> EVariable::clone() const {
     return _frameId ? std::make_unique<EVariable>(*_frameId, _var)
                     : std::make_unique<EVariable>(_var);
@@ -115,6 +120,10 @@ std::vector<DebugPrinter::Block> EVariable::debugPrint() const {
     return ret;
 }
 
+size_t EVariable::estimateSize() const {
+    return sizeof(*this) + size_estimator::estimate(_nodes);
+}
+
 std::unique_ptr<EExpression> EPrimBinary::clone() const {
     return std::make_unique<EPrimBinary>(_op, _nodes[0]->clone(), _nodes[1]->clone());
 }
@@ -275,6 +284,10 @@ std::vector<DebugPrinter::Block> EPrimBinary::debugPrint() const {
     return ret;
 }
 
+size_t EPrimBinary::estimateSize() const {
+    return sizeof(*this) + size_estimator::estimate(_nodes);
+}
+
 std::unique_ptr<EExpression> EPrimUnary::clone() const {
     return std::make_unique<EPrimUnary>(_op, _nodes[0]->clone());
 }
@@ -320,6 +333,10 @@ std::vector<DebugPrinter::Block> EPrimUnary::debugPrint() const {
     return ret;
 }
 
+size_t EPrimUnary::estimateSize() const {
+    return sizeof(*this) + size_estimator::estimate(_nodes);
+}
+
 std::unique_ptr<EExpression> EFunction::clone() const {
     std::vector<std::unique_ptr<EExpression>> args;
     args.reserve(_nodes.size());
@@ -528,6 +545,10 @@ std::vector<DebugPrinter::Block> EFunction::debugPrint() const {
     return ret;
 }
 
+size_t EFunction::estimateSize() const {
+    return sizeof(*this) + size_estimator::estimate(_nodes) + size_estimator::estimate(_name);
+}
+
 std::unique_ptr<EExpression> EIf::clone() const {
     return std::make_unique<EIf>(_nodes[0]->clone(), _nodes[1]->clone(), _nodes[2]->clone());
 }
@@ -578,6 +599,10 @@ std::vector<DebugPrinter::Block> EIf::debugPrint() const {
     return ret;
 }
 
+size_t EIf::estimateSize() const {
+    return sizeof(*this) + size_estimator::estimate(_nodes);
+}
+
 std::unique_ptr<EExpression> ELocalBind::clone() const {
     std::vector<std::unique_ptr<EExpression>> binds;
     binds.reserve(_nodes.size() - 1);
@@ -632,6 +657,10 @@ std::vector<DebugPrinter::Block> ELocalBind::debugPrint() const {
     return ret;
 }
 
+size_t ELocalBind::estimateSize() const {
+    return sizeof(*this) + size_estimator::estimate(_nodes);
+}
+
 std::unique_ptr<EExpression> EFail::clone() const {
     return std::make_unique<EFail>(_code, _message);
 }
@@ -665,6 +694,10 @@ std::vector<DebugPrinter::Block> EFail::debugPrint() const {
     return ret;
 }
 
+size_t EFail::estimateSize() const {
+    return sizeof(*this) + size_estimator::estimate(_nodes) + size_estimator::estimate(_message);
+}
+
 std::unique_ptr<EExpression> ENumericConvert::clone() const {
     return std::make_unique<ENumericConvert>(_nodes[0]->clone(), _target);
 }
@@ -712,6 +745,10 @@ std::vector<DebugPrinter::Block> ENumericConvert::debugPrint() const {
     return ret;
 }
 
+size_t ENumericConvert::estimateSize() const {
+    return sizeof(*this) + size_estimator::estimate(_nodes);
+}
+
 std::unique_ptr<EExpression> ETypeMatch::clone() const {
     return std::make_unique<ETypeMatch>(_nodes[0]->clone(), _typeMask);
 }
@@ -744,6 +781,10 @@ std::vector<DebugPrinter::Block> ETypeMatch::debugPrint() const {
     return ret;
 }
 
+size_t ETypeMatch::estimateSize() const {
+    return sizeof(*this) + size_estimator::estimate(_nodes);
+}
+
 RuntimeEnvironment::RuntimeEnvironment(const RuntimeEnvironment& other)
     : _state{other._state}, _isSmp{other._isSmp} {
     for (auto&& [type, slot] : _state->slots) {
@@ -785,6 +826,13 @@ value::SlotId RuntimeEnvironment::getSlot(StringData type) {
     uasserted(4946305, str::stream() << "environment slot is not registered for type: " << type);
 }
 
+boost::optional<value::SlotId> RuntimeEnvironment::getSlotIfExists(StringData type) {
+    if (auto it = _state->slots.find(type); it != _state->slots.end()) {
+        return it->second.first;
+    }
+    return boost::none;
+}
+
 void RuntimeEnvironment::resetSlot(value::SlotId slot,
                                    value::TypeTags tag,
                                    value::Value val,
@@ -818,6 +866,22 @@ std::unique_ptr<RuntimeEnvironment> RuntimeEnvironment::makeCopy(bool isSmp) {
     return std::unique_ptr<RuntimeEnvironment>(new RuntimeEnvironment(*this));
 }
 
+std::unique_ptr<RuntimeEnvironment> RuntimeEnvironment::makeDeepCopy() const {
+    auto env = std::make_unique<RuntimeEnvironment>();
+    *env->_state = *_state;
+    for (size_t idx = 0; idx < env->_state->vals.size(); ++idx) {
+        if (env->_state->owned[idx]) {
+            auto [tag, val] = copyValue(env->_state->typeTags[idx], env->_state->vals[idx]);
+            env->_state->typeTags[idx] = tag;
+            env->_state->vals[idx] = val;
+        }
+    }
+    for (auto&& [type, slot] : env->_state->slots) {
+        env->emplaceAccessor(slot.first, slot.second);
+    }
+    return env;
+}
+
 void RuntimeEnvironment::debugString(StringBuilder* builder) {
     *builder << "env: { ";
     for (auto&& [type, slot] : _state->slots) {
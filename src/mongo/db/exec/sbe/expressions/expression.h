@@ -37,6 +37,8 @@
 #include "mongo/db/exec/sbe/values/slot.h"
 #include "mongo/db/exec/sbe/values/value.h"
 #include "mongo/db/exec/sbe/vm/vm.h"
+#include "mongo/db/query/stage_types.h"
+#include "mongo/platform/mutex.h"
 #include "mongo/stdx/unordered_map.h"
 #include "mongo/util/string_map.h"
 
@@ -92,6 +94,12 @@ public:
      */
     value::SlotId getSlot(StringData type);
 
+    /**
+     * Returns a SlotId registered for the given slot 'type', or boost::none if the slot hasn't
+     * been registered.
+     */
+    boost::optional<value::SlotId> getSlotIfExists(StringData type);
+
     /**
      * Store the given value in the specified slot within this runtime environment instance.
      *
@@ -118,6 +126,13 @@ public:
      */
     std::unique_ptr<RuntimeEnvironment> makeCopy(bool isSmp);
 
+    /**
+     * Make a copy of this environment which holds its own copies of the slot values, and so can be
+     * used independently of this environment, e.g. by a plan cloned from the plan cache. The slots
+     * keep their SlotIds.
+     */
+    std::unique_ptr<RuntimeEnvironment> makeDeepCopy() const;
+
     /**
      * Dumps all the slots currently defined in this environment into the given string builder.
      */
@@ -189,6 +204,32 @@ private:
     friend class Accessor;
 };
 
+/**
+ * The state which the copies of a subtree run by the producers of one exchange share with each
+ * other, such as the record id ranges that their parallel scans divide among themselves. Each piece
+ * of state is owned by the plan node which created it.
+ */
+class SmpSharedState {
+public:
+    /**
+     * Returns the state of the plan node 'nodeId', creating it on first use. May be called from the
+     * threads of several producers at once.
+     */
+    template <typename T>
+    std::shared_ptr<T> getOrCreate(PlanNodeId nodeId) {
+        stdx::lock_guard<Latch> lock(_mutex);
+        auto& state = _states[nodeId];
+        if (!state) {
+            state = std::make_shared<T>();
+        }
+        return std::static_pointer_cast<T>(state);
+    }
+
+private:
+    Mutex _mutex = MONGO_MAKE_LATCH("SmpSharedState::_mutex");
+    stdx::unordered_map<PlanNodeId, std::shared_ptr<void>> _states;
+};
+
 class PlanStage;
 struct CompileCtx {
     CompileCtx(std::unique_ptr<RuntimeEnvironment> env) : env{std::move(env)} {}
@@ -207,6 +248,9 @@ struct CompileCtx {
     stdx::unordered_map<SpoolId, std::shared_ptr<SpoolBuffer>> spoolBuffers;
     bool aggExpression{false};
 
+    // Set in the contexts of the producers of an exchange, which all share the same instance.
+    std::shared_ptr<SmpSharedState> smpSharedState;
+
 private:
     // Any data that a PlanStage needs from the RuntimeEnvironment should not be accessed directly
     // but insteady by looking up the corresponding slots. These slots are set up during the process
@@ -241,6 +285,11 @@ public:
 
     virtual std::vector<DebugPrinter::Block> debugPrint() const = 0;
 
+    /**
+     * Returns an estimate of the memory held by this expression and its children, in bytes.
+     */
+    virtual size_t estimateSize() const = 0;
+
 protected:
     std::vector<std::unique_ptr<EExpression>> _nodes;
 
@@ -329,6 +378,8 @@ public:
 
     std::vector<DebugPrinter::Block> debugPrint() const override;
 
+    size_t estimateSize() const override;
+
 private:
     value::TypeTags _tag;
     value::Value _val;
@@ -350,6 +401,8 @@ public:
 
     std::vector<DebugPrinter::Block> debugPrint() const override;
 
+    size_t estimateSize() const override;
+
 private:
     value::SlotId _var;
     boost::optional<FrameId> _frameId;
@@ -395,6 +448,8 @@ public:
 
     std::vector<DebugPrinter::Block> debugPrint() const override;
 
+    size_t estimateSize() const override;
+
 private:
     Op _op;
 };
@@ -420,6 +475,8 @@ public:
 
     std::vector<DebugPrinter::Block> debugPrint() const override;
 
+    size_t estimateSize() const override;
+
 private:
     Op _op;
 };
@@ -442,6 +499,8 @@ public:
 
     std::vector<DebugPrinter::Block> debugPrint() const override;
 
+    size_t estimateSize() const override;
+
 private:
     std::string _name;
 };
@@ -465,6 +524,8 @@ public:
     std::unique_ptr<vm::CodeFragment> compile(CompileCtx& ctx) const override;
 
     std::vector<DebugPrinter::Block> debugPrint() const override;
+
+    size_t estimateSize() const override;
 };
 
 /**
@@ -487,6 +548,8 @@ public:
 
     std::vector<DebugPrinter::Block> debugPrint() const override;
 
+    size_t estimateSize() const override;
+
 private:
     FrameId _frameId;
 };
@@ -505,6 +568,8 @@ public:
 
     std::vector<DebugPrinter::Block> debugPrint() const override;
 
+    size_t estimateSize() const override;
+
 private:
     ErrorCodes::Error _code;
     std::string _message;
@@ -536,6 +601,8 @@ public:
 
     std::vector<DebugPrinter::Block> debugPrint() const override;
 
+    size_t estimateSize() const override;
+
 private:
     value::TypeTags _target;
 };
@@ -558,6 +625,8 @@ public:
 
     std::vector<DebugPrinter::Block> debugPrint() const override;
 
+    size_t estimateSize() const override;
+
 private:
     uint32_t _typeMask;
 };
@@ -0,0 +1,199 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include <limits>
+
+#include "mongo/db/exec/sbe/expression_test_base.h"
+#include "mongo/db/exec/sbe/values/bson.h"
+
+namespace mongo::sbe {
+
+/**
+ * Checks that the instruction sequences fused by the CodeFragment evaluate exactly like the
+ * unfused ones. The reference results are computed by reading the constant operand from a slot,
+ * which keeps the compiler from fusing anything.
+ */
+class SBESuperinstructionTest : public EExpressionTestFixture {
+protected:
+    std::pair<value::TypeTags, value::Value> makeViewOfObject(const BSONObj& obj) {
+        return {value::TypeTags::bsonObject, value::bitcastFrom<const char*>(obj.objdata())};
+    }
+
+    vm::Instruction::Tags firstInstruction(const vm::CodeFragment& code) {
+        ASSERT_FALSE(code.instrs().empty());
+        return static_cast<vm::Instruction::Tags>(code.instrs()[0]);
+    }
+
+    void assertSameResult(const vm::CodeFragment* fused, const vm::CodeFragment* reference) {
+        auto [fusedTag, fusedVal] = runCompiledExpression(fused);
+        value::ValueGuard fusedGuard{fusedTag, fusedVal};
+        auto [refTag, refVal] = runCompiledExpression(reference);
+        value::ValueGuard refGuard{refTag, refVal};
+
+        ASSERT_EQ(fusedTag, refTag);
+        if (fusedTag != value::TypeTags::Nothing) {
+            auto [cmpTag, cmpVal] = value::compareValue(fusedTag, fusedVal, refTag, refVal);
+            ASSERT_EQ(cmpTag, value::TypeTags::NumberInt32);
+            ASSERT_EQ(value::bitcastTo<int32_t>(cmpVal), 0);
+        }
+    }
+};
+
+TEST_F(SBESuperinstructionTest, FieldEqualityPredicate) {
+    value::ViewOfValueAccessor objAccessor;
+    auto objSlot = bindAccessor(&objAccessor);
+
+    auto expr = makeE<EPrimBinary>(
+        EPrimBinary::eq,
+        makeE<EFunction>("getField",
+                         makeEs(makeE<EVariable>(objSlot), makeE<EConstant>("a"))),
+        makeE<EConstant>(value::TypeTags::NumberInt32, value::bitcastFrom<int32_t>(5)));
+    auto compiledExpr = compileExpression(*expr);
+    ASSERT_EQ(firstInstruction(*compiledExpr), vm::Instruction::pushAccessFieldConst);
+
+    auto runOn = [&](const BSONObj& obj) {
+        auto [tag, val] = makeViewOfObject(obj);
+        objAccessor.reset(tag, val);
+        return runCompiledExpressionPredicate(compiledExpr.get());
+    };
+
+    ASSERT_TRUE(runOn(BSON("a" << 5)));
+    ASSERT_TRUE(runOn(BSON("b" << 1 << "a" << 5LL)));
+    ASSERT_TRUE(runOn(BSON("a" << 5.0)));
+    ASSERT_FALSE(runOn(BSON("a" << 6)));
+    ASSERT_FALSE(runOn(BSON("a"
+                            << "5")));
+    ASSERT_FALSE(runOn(BSON("b" << 5)));
+}
+
+TEST_F(SBESuperinstructionTest, ComparisonsAgainstConstants) {
+    value::OwnedValueAccessor lhsAccessor;
+    auto lhsSlot = bindAccessor(&lhsAccessor);
+    value::OwnedValueAccessor rhsAccessor;
+    auto rhsSlot = bindAccessor(&rhsAccessor);
+
+    std::vector<std::pair<value::TypeTags, value::Value>> values{
+        {value::TypeTags::Nothing, 0},
+        {value::TypeTags::Null, 0},
+        {value::TypeTags::NumberInt32, value::bitcastFrom<int32_t>(-1)},
+        {value::TypeTags::NumberInt32, value::bitcastFrom<int32_t>(7)},
+        {value::TypeTags::NumberInt64, value::bitcastFrom<int64_t>(7)},
+        {value::TypeTags::NumberInt64, value::bitcastFrom<int64_t>(1LL << 40)},
+        {value::TypeTags::NumberDouble, value::bitcastFrom<double>(7.0)},
+        {value::TypeTags::NumberDouble, value::bitcastFrom<double>(7.5)},
+        {value::TypeTags::NumberDouble,
+         value::bitcastFrom<double>(std::numeric_limits<double>::quiet_NaN())},
+        {value::TypeTags::Date, value::bitcastFrom<int64_t>(1000)},
+        {value::TypeTags::Date, value::bitcastFrom<int64_t>(-1000)},
+        {value::TypeTags::Boolean, value::bitcastFrom<bool>(true)},
+        value::makeSmallString("abc"),
+    };
+
+    for (auto op : {EPrimBinary::less,
+                    EPrimBinary::lessEq,
+                    EPrimBinary::greater,
+                    EPrimBinary::greaterEq,
+                    EPrimBinary::eq,
+                    EPrimBinary::neq}) {
+        for (auto [constTag, constVal] : values) {
+            auto fusedExpr = makeE<EPrimBinary>(
+                op, makeE<EVariable>(lhsSlot), makeE<EConstant>(constTag, constVal));
+            auto fused = compileExpression(*fusedExpr);
+            auto refExpr =
+                makeE<EPrimBinary>(op, makeE<EVariable>(lhsSlot), makeE<EVariable>(rhsSlot));
+            auto reference = compileExpression(*refExpr);
+            ASSERT_LT(fused->instrs().size(), reference->instrs().size());
+
+            rhsAccessor.reset(false, constTag, constVal);
+            for (auto [lhsTag, lhsVal] : values) {
+                lhsAccessor.reset(false, lhsTag, lhsVal);
+                assertSameResult(fused.get(), reference.get());
+            }
+        }
+    }
+}
+
+TEST_F(SBESuperinstructionTest, FillEmptyChain) {
+    value::ViewOfValueAccessor objAccessor;
+    auto objSlot = bindAccessor(&objAccessor);
+
+    // fillEmpty(fillEmpty(getField(obj, "a"), getField(obj, "b")), false)
+    auto expr = makeE<EFunction>(
+        "fillEmpty",
+        makeEs(makeE<EFunction>(
+                   "fillEmpty",
+                   makeEs(makeE<EFunction>(
+                              "getField", makeEs(makeE<EVariable>(objSlot), makeE<EConstant>("a"))),
+                          makeE<EFunction>("getField",
+                                           makeEs(makeE<EVariable>(objSlot),
+                                                  makeE<EConstant>("b"))))),
+               makeE<EConstant>(value::TypeTags::Boolean, value::bitcastFrom<bool>(false))));
+    auto compiledExpr = compileExpression(*expr);
+
+    auto runOn = [&](const BSONObj& obj) {
+        auto [tag, val] = makeViewOfObject(obj);
+        objAccessor.reset(tag, val);
+        return runCompiledExpressionPredicate(compiledExpr.get());
+    };
+
+    ASSERT_TRUE(runOn(BSON("a" << true << "b" << false)));
+    ASSERT_TRUE(runOn(BSON("b" << true)));
+    ASSERT_FALSE(runOn(BSON("a" << false << "b" << true)));
+    ASSERT_FALSE(runOn(BSON("c" << true)));
+}
+
+TEST_F(SBESuperinstructionTest, DoesNotFuseAcrossJumpTargets) {
+    value::ViewOfValueAccessor objAccessor;
+    auto objSlot = bindAccessor(&objAccessor);
+    value::OwnedValueAccessor condAccessor;
+    auto condSlot = bindAccessor(&condAccessor);
+
+    // getField(obj, if(cond, "a", "b")) == 1
+    auto expr = makeE<EPrimBinary>(
+        EPrimBinary::eq,
+        makeE<EFunction>("getField",
+                         makeEs(makeE<EVariable>(objSlot),
+                                makeE<EIf>(makeE<EVariable>(condSlot),
+                                           makeE<EConstant>("a"),
+                                           makeE<EConstant>("b")))),
+        makeE<EConstant>(value::TypeTags::NumberInt32, value::bitcastFrom<int32_t>(1)));
+    auto compiledExpr = compileExpression(*expr);
+    ASSERT_EQ(firstInstruction(*compiledExpr), vm::Instruction::pushAccessVal);
+
+    auto obj = BSON("a" << 1 << "b" << 2);
+    auto [objTag, objVal] = makeViewOfObject(obj);
+    objAccessor.reset(objTag, objVal);
+
+    condAccessor.reset(false, value::TypeTags::Boolean, value::bitcastFrom<bool>(true));
+    ASSERT_TRUE(runCompiledExpressionPredicate(compiledExpr.get()));
+    condAccessor.reset(false, value::TypeTags::Boolean, value::bitcastFrom<bool>(false));
+    ASSERT_FALSE(runCompiledExpressionPredicate(compiledExpr.get()));
+}
+
+}  // namespace mongo::sbe
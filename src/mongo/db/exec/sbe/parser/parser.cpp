@@ -873,6 +873,8 @@ void Parser::walkHashJoin(AstQuery& ast) {
                              lookupSlots(ast.nodes[0]->nodes[1]->identifiers),  // outer projections
                              lookupSlots(ast.nodes[1]->nodes[0]->identifiers),  // inner conditions
                              lookupSlots(ast.nodes[1]->nodes[1]->identifiers),  // inner projections
+                             std::numeric_limits<size_t>::max(),
+                             false,
                              kEmptyPlanNodeId);
 }
 
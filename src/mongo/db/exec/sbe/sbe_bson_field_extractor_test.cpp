@@ -0,0 +1,97 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/exec/sbe/values/bson_field_extractor.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo::sbe {
+namespace {
+
+void assertInt32(value::ViewOfValueAccessor* accessor, int32_t expected) {
+    auto [tag, val] = accessor->getViewOfValue();
+    ASSERT_EQ(tag, value::TypeTags::NumberInt32);
+    ASSERT_EQ(value::bitcastTo<int32_t>(val), expected);
+}
+
+void assertNothing(value::ViewOfValueAccessor* accessor) {
+    auto [tag, val] = accessor->getViewOfValue();
+    ASSERT_EQ(tag, value::TypeTags::Nothing);
+}
+
+TEST(SbeBsonFieldExtractorTest, ExtractsTopLevelFields) {
+    bson::FieldExtractor extractor;
+    auto a = extractor.addField("a");
+    auto longName = extractor.addField(std::string(100, 'x'));
+    auto missing = extractor.addField("b");
+    auto empty = extractor.addField("");
+    extractor.compile();
+
+    auto obj = BSON("c" << 0 << "a" << 1 << std::string(100, 'x') << 2 << "" << 3);
+    extractor.extract(obj.objdata());
+    assertInt32(a, 1);
+    assertInt32(longName, 2);
+    assertInt32(empty, 3);
+    assertNothing(missing);
+
+    // Values from an earlier object do not leak into the next one.
+    auto other = BSON("b" << 4);
+    extractor.extract(other.objdata());
+    assertNothing(a);
+    assertNothing(longName);
+    assertNothing(empty);
+    assertInt32(missing, 4);
+}
+
+TEST(SbeBsonFieldExtractorTest, RejectsDuplicateFields) {
+    bson::FieldExtractor extractor;
+    ASSERT(extractor.addField("a"));
+    ASSERT(extractor.addField("a.b"));
+    ASSERT_FALSE(extractor.addField("a"));
+    ASSERT_FALSE(extractor.addField("a.b"));
+}
+
+TEST(SbeBsonFieldExtractorTest, ExtractsFieldsWithDotsInTheirNames) {
+    bson::FieldExtractor extractor;
+    auto dotted = extractor.addField("a.b");
+    auto a = extractor.addField("a");
+    extractor.compile();
+
+    // A name with a dot is a top-level field name, not a path.
+    auto obj = BSON("a" << BSON("b" << 1) << "a.b" << 2);
+    extractor.extract(obj.objdata());
+    assertInt32(dotted, 2);
+    auto [aTag, aVal] = a->getViewOfValue();
+    ASSERT_EQ(aTag, value::TypeTags::bsonObject);
+}
+
+}  // namespace
+}  // namespace mongo::sbe
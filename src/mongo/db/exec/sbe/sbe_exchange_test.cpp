@@ -0,0 +1,96 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/**
+ * This file contains tests for sbe::ExchangeWorkerReservation.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <vector>
+
+#include "mongo/db/exec/sbe/stages/exchange.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo::sbe {
+namespace {
+
+TEST(ExchangeWorkerReservationTest, ReservesOnlyFreeWorkers) {
+    const auto reservedBefore = ExchangeWorkerReservation::numReserved();
+    const auto maxWorkers = reservedBefore + 6;
+    {
+        auto first = ExchangeWorkerReservation::reserve(4, maxWorkers);
+        ASSERT_EQ(first.count(), 4U);
+
+        auto second = ExchangeWorkerReservation::reserve(4, maxWorkers);
+        ASSERT_EQ(second.count(), 2U);
+        ASSERT_EQ(ExchangeWorkerReservation::reserve(4, maxWorkers).count(), 0U);
+
+        // A worker taken from a reservation stays reserved until it is given back.
+        auto worker = first.takeOne();
+        ASSERT_EQ(worker.count(), 1U);
+        ASSERT_EQ(first.count(), 3U);
+        ASSERT_EQ(ExchangeWorkerReservation::numReserved(), reservedBefore + 6);
+
+        worker = {};
+        ASSERT_EQ(ExchangeWorkerReservation::numReserved(), reservedBefore + 5);
+        ASSERT_EQ(ExchangeWorkerReservation::reserve(4, maxWorkers).count(), 1U);
+    }
+    ASSERT_EQ(ExchangeWorkerReservation::numReserved(), reservedBefore);
+}
+
+TEST(ExchangeWorkerReservationTest, ConcurrentReservationsStayWithinLimit) {
+    const auto reservedBefore = ExchangeWorkerReservation::numReserved();
+    const auto maxWorkers = reservedBefore + 8;
+    const size_t numThreads = 16;
+
+    std::vector<ExchangeWorkerReservation> reservations(numThreads);
+    std::vector<stdx::thread> threads;
+    for (size_t i = 0; i < numThreads; ++i) {
+        threads.emplace_back(
+            [&, i] { reservations[i] = ExchangeWorkerReservation::reserve(2, maxWorkers); });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+
+    size_t granted = 0;
+    for (auto&& reservation : reservations) {
+        granted += reservation.count();
+    }
+    ASSERT_EQ(granted, 8U);
+    ASSERT_EQ(ExchangeWorkerReservation::numReserved(), maxWorkers);
+
+    reservations.clear();
+    ASSERT_EQ(ExchangeWorkerReservation::numReserved(), reservedBefore);
+}
+
+}  // namespace
+}  // namespace mongo::sbe
@@ -0,0 +1,129 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <boost/filesystem/operations.hpp>
+
+#include "mongo/db/exec/sbe/stages/co_scan.h"
+#include "mongo/db/exec/sbe/stages/hash_join.h"
+#include "mongo/db/exec/sbe/stages/limit_skip.h"
+#include "mongo/db/exec/sbe/stages/project.h"
+#include "mongo/db/exec/sbe/stages/unwind.h"
+#include "mongo/db/storage/storage_options.h"
+
+namespace mongo::sbe {
+namespace {
+
+constexpr int64_t kProbeSize = 100 * 1000;
+constexpr size_t kSpillMemoryLimit = 1024 * 1024;
+
+/**
+ * Builds a subtree which streams out the keys [0, size), each one modulo 'numKeys'.
+ */
+std::unique_ptr<PlanStage> makeKeyScan(value::SlotIdGenerator& slotIdGenerator,
+                                       value::SlotId outSlot,
+                                       int64_t size,
+                                       int64_t numKeys) {
+    auto [arrTag, arrVal] = value::makeNewArray();
+    auto arr = value::getArrayView(arrVal);
+    arr->reserve(size);
+    for (int64_t i = 0; i < size; ++i) {
+        arr->push_back(value::TypeTags::NumberInt64, value::bitcastFrom<int64_t>(i % numKeys));
+    }
+
+    auto arrSlot = slotIdGenerator.generate();
+    return makeS<UnwindStage>(
+        makeProjectStage(
+            makeS<LimitSkipStage>(
+                makeS<CoScanStage>(kEmptyPlanNodeId), 1, boost::none, kEmptyPlanNodeId),
+            kEmptyPlanNodeId,
+            arrSlot,
+            makeE<EConstant>(arrTag, arrVal)),
+        arrSlot,
+        outSlot,
+        slotIdGenerator.generate(),
+        false,
+        kEmptyPlanNodeId);
+}
+
+/**
+ * Joins a build side of 'state.range(0)' distinct keys with a fixed size probe side whose keys all
+ * find a match. With 'spill' set, the build side is limited to 'kSpillMemoryLimit' bytes, so the
+ * larger build sizes are partitioned to disk.
+ */
+void BM_HashJoin(benchmark::State& state, bool spill) {
+    auto buildSize = state.range(0);
+
+    auto tempDir = boost::filesystem::temp_directory_path() /
+        boost::filesystem::unique_path("sbe_hash_join_bm-%%%%-%%%%");
+    auto originalDbPath = storageGlobalParams.dbpath;
+    storageGlobalParams.dbpath = tempDir.string();
+
+    value::SlotIdGenerator slotIdGenerator;
+    auto outerSlot = slotIdGenerator.generate();
+    auto innerSlot = slotIdGenerator.generate();
+    auto memoryLimit = spill ? kSpillMemoryLimit : std::numeric_limits<size_t>::max();
+    auto outer = makeKeyScan(slotIdGenerator, outerSlot, buildSize, buildSize);
+    auto inner = makeKeyScan(slotIdGenerator, innerSlot, kProbeSize, buildSize);
+    auto stage = makeS<HashJoinStage>(std::move(outer),
+                                      std::move(inner),
+                                      makeSV(outerSlot),
+                                      makeSV(),
+                                      makeSV(innerSlot),
+                                      makeSV(),
+                                      memoryLimit,
+                                      true,
+                                      kEmptyPlanNodeId);
+
+    CompileCtx ctx{std::make_unique<RuntimeEnvironment>()};
+    stage->prepare(ctx);
+
+    for (auto _ : state) {
+        stage->open(false);
+        int64_t numRows = 0;
+        while (stage->getNext() == PlanState::ADVANCED) {
+            ++numRows;
+        }
+        benchmark::DoNotOptimize(numRows);
+        stage->close();
+    }
+    state.SetItemsProcessed(state.iterations() * (buildSize + kProbeSize));
+
+    stage.reset();
+    storageGlobalParams.dbpath = originalDbPath;
+    boost::filesystem::remove_all(tempDir);
+}
+
+BENCHMARK_CAPTURE(BM_HashJoin, InMemory, false)->RangeMultiplier(8)->Range(1 << 6, 1 << 21);
+BENCHMARK_CAPTURE(BM_HashJoin, Spilled, true)->RangeMultiplier(8)->Range(1 << 6, 1 << 21);
+
+}  // namespace
+}  // namespace mongo::sbe
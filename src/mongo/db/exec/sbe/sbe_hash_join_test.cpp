@@ -0,0 +1,156 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <set>
+
+#include "mongo/db/exec/sbe/sbe_plan_stage_test.h"
+#include "mongo/db/exec/sbe/stages/hash_join.h"
+#include "mongo/db/storage/storage_options.h"
+#include "mongo/unittest/temp_dir.h"
+
+namespace mongo::sbe {
+
+class HashJoinStageTest : public PlanStageTestFixture {
+public:
+    // A joined row of (key, outer value, inner value).
+    using JoinedRow = std::tuple<int32_t, int32_t, int32_t>;
+
+    void setUp() override {
+        PlanStageTestFixture::setUp();
+        _originalDbPath = storageGlobalParams.dbpath;
+        storageGlobalParams.dbpath = _tempDir.path();
+    }
+
+    void tearDown() override {
+        storageGlobalParams.dbpath = _originalDbPath;
+        PlanStageTestFixture::tearDown();
+    }
+
+    /**
+     * Joins two inputs of (key, value) pairs on their keys, projecting the values of both sides.
+     * Returns the stage with its output slots for the outer key, outer value and inner value.
+     */
+    std::pair<value::SlotVector, std::unique_ptr<PlanStage>> makeJoinStage(
+        const BSONArray& outer, const BSONArray& inner, size_t memoryLimit, bool allowDiskUse) {
+        auto [outerSlots, outerStage] = generateMockScanMulti(2, outer);
+        auto [innerSlots, innerStage] = generateMockScanMulti(2, inner);
+        auto stage = makeS<HashJoinStage>(std::move(outerStage),
+                                          std::move(innerStage),
+                                          makeSV(outerSlots[0]),
+                                          makeSV(outerSlots[1]),
+                                          makeSV(innerSlots[0]),
+                                          makeSV(innerSlots[1]),
+                                          memoryLimit,
+                                          allowDiskUse,
+                                          kEmptyPlanNodeId);
+        return {makeSV(outerSlots[0], outerSlots[1], innerSlots[1]), std::move(stage)};
+    }
+
+    std::multiset<JoinedRow> getJoinedRows(PlanStage* stage,
+                                           const std::vector<value::SlotAccessor*>& accessors) {
+        std::multiset<JoinedRow> result;
+        while (stage->getNext() == PlanState::ADVANCED) {
+            int32_t values[3];
+            for (size_t idx = 0; idx < 3; ++idx) {
+                auto [tag, val] = accessors[idx]->getViewOfValue();
+                ASSERT_EQ(tag, value::TypeTags::NumberInt32);
+                values[idx] = value::bitcastTo<int32_t>(val);
+            }
+            result.emplace(values[0], values[1], values[2]);
+        }
+        return result;
+    }
+
+private:
+    unittest::TempDir _tempDir{"hash_join_stage_test"};
+    std::string _originalDbPath;
+};
+
+TEST_F(HashJoinStageTest, JoinsInMemoryWithinLimit) {
+    auto [slots, stage] =
+        makeJoinStage(BSON_ARRAY(BSON_ARRAY(1 << 10) << BSON_ARRAY(2 << 20) << BSON_ARRAY(1 << 11)),
+                      BSON_ARRAY(BSON_ARRAY(1 << 100) << BSON_ARRAY(3 << 300)
+                                                      << BSON_ARRAY(1 << 101)),
+                      std::numeric_limits<size_t>::max(),
+                      false);
+    auto accessors = prepareTree(stage.get(), slots);
+
+    auto rows = getJoinedRows(stage.get(), accessors);
+    std::multiset<JoinedRow> expected{{1, 10, 100}, {1, 11, 100}, {1, 10, 101}, {1, 11, 101}};
+    ASSERT(rows == expected);
+
+    auto stats = static_cast<const HashJoinStats*>(stage->getSpecificStats());
+    ASSERT_FALSE(stats->usedDisk);
+    ASSERT_EQ(stats->spilledPartitions, 0u);
+}
+
+TEST_F(HashJoinStageTest, SpillsPartitionsRecursively) {
+    BSONArrayBuilder outer;
+    BSONArrayBuilder inner;
+    std::multiset<JoinedRow> expected;
+    for (int key = 0; key < 200; ++key) {
+        outer.append(BSON_ARRAY(key << key));
+        outer.append(BSON_ARRAY(key << -key));
+        if (key % 2 == 0) {
+            inner.append(BSON_ARRAY(key << key * 10));
+            expected.emplace(key, key, key * 10);
+            expected.emplace(key, -key, key * 10);
+        }
+    }
+
+    // A limit of a single byte forces every partition to be spilled on every recursion level.
+    auto [slots, stage] = makeJoinStage(outer.arr(), inner.arr(), 1, true);
+    auto accessors = prepareTree(stage.get(), slots);
+
+    auto rows = getJoinedRows(stage.get(), accessors);
+    ASSERT_EQ(rows.size(), expected.size());
+    ASSERT(rows == expected);
+
+    auto stats = static_cast<const HashJoinStats*>(stage->getSpecificStats());
+    ASSERT_TRUE(stats->usedDisk);
+    ASSERT_GT(stats->spilledPartitions, HashJoinStage::kNumSpillPartitions);
+    ASSERT_GTE(stats->spilledBuildRecords, 400u);
+    ASSERT_GTE(stats->spilledProbeRecords, 100u);
+    ASSERT_GT(stats->spilledBytes, 0u);
+    ASSERT_EQ(stats->maxRecursionDepth, HashJoinStage::kMaxRecursionDepth);
+}
+
+TEST_F(HashJoinStageTest, FailsWhenOverLimitWithoutDiskUse) {
+    auto [slots, stage] = makeJoinStage(BSON_ARRAY(BSON_ARRAY(1 << 10) << BSON_ARRAY(2 << 20)),
+                                        BSON_ARRAY(BSON_ARRAY(1 << 100)),
+                                        1,
+                                        false);
+    ASSERT_THROWS_CODE(prepareTree(stage.get(), slots),
+                       DBException,
+                       ErrorCodes::QueryExceededMemoryLimitNoDiskUseAllowed);
+}
+
+}  // namespace mongo::sbe
@@ -0,0 +1,144 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/exec/sbe/stages/bson_scan.h"
+#include "mongo/db/exec/sbe/stages/project.h"
+
+namespace mongo::sbe {
+namespace {
+
+constexpr int kNumDocuments = 1000;
+
+std::string fieldName(int i) {
+    return "field" + std::to_string(i);
+}
+
+/**
+ * Builds 'kNumDocuments' documents with 'numFields' top-level fields, the last of which holds the
+ * embedded object {a: {b: {c: <n>}}}.
+ */
+BufBuilder makeDocuments(int numFields) {
+    BufBuilder buffer;
+    for (int n = 0; n < kNumDocuments; ++n) {
+        BSONObjBuilder builder;
+        for (int i = 0; i < numFields - 1; ++i) {
+            builder.append(fieldName(i), i);
+        }
+        builder.append("nested", BSON("a" << BSON("b" << BSON("c" << n))));
+        auto obj = builder.obj();
+        buffer.appendBuf(obj.objdata(), obj.objsize());
+    }
+    return buffer;
+}
+
+/**
+ * Opens 'stage' and drains it once per iteration.
+ */
+void runScan(benchmark::State& state, PlanStage* stage) {
+    CompileCtx ctx{std::make_unique<RuntimeEnvironment>()};
+    stage->prepare(ctx);
+
+    for (auto _ : state) {
+        stage->open(false);
+        int64_t numRows = 0;
+        while (stage->getNext() == PlanState::ADVANCED) {
+            ++numRows;
+        }
+        benchmark::DoNotOptimize(numRows);
+        stage->close();
+    }
+    state.SetItemsProcessed(state.iterations() * kNumDocuments);
+}
+
+/**
+ * Extracts four top-level fields spread across documents of 'state.range(0)' fields, so that each
+ * document is scanned to its end.
+ */
+void BM_ScanTopLevelFields(benchmark::State& state) {
+    const int numFields = state.range(0);
+    auto buffer = makeDocuments(numFields);
+
+    value::SlotIdGenerator slotIdGenerator;
+    std::vector<std::string> fields{
+        fieldName(0), fieldName(numFields / 3), fieldName(2 * numFields / 3), "nested"};
+    auto stage = makeS<BSONScanStage>(buffer.buf(),
+                                      buffer.buf() + buffer.len(),
+                                      boost::none,
+                                      fields,
+                                      slotIdGenerator.generateMultiple(fields.size()),
+                                      kEmptyPlanNodeId);
+
+    runScan(state, stage.get());
+}
+
+/**
+ * Reads the last field of documents of 'state.range(0)' fields, either by having the scan extract
+ * it or with a getField() call on the record.
+ */
+void BM_ScanLastField(benchmark::State& state, bool pushdown) {
+    auto buffer = makeDocuments(state.range(0));
+
+    value::SlotIdGenerator slotIdGenerator;
+    std::unique_ptr<PlanStage> stage;
+    if (pushdown) {
+        stage = makeS<BSONScanStage>(buffer.buf(),
+                                     buffer.buf() + buffer.len(),
+                                     boost::none,
+                                     std::vector<std::string>{"nested"},
+                                     makeSV(slotIdGenerator.generate()),
+                                     kEmptyPlanNodeId);
+    } else {
+        auto recordSlot = slotIdGenerator.generate();
+        stage = makeProjectStage(
+            makeS<BSONScanStage>(buffer.buf(),
+                                 buffer.buf() + buffer.len(),
+                                 recordSlot,
+                                 std::vector<std::string>{},
+                                 makeSV(),
+                                 kEmptyPlanNodeId),
+            kEmptyPlanNodeId,
+            slotIdGenerator.generate(),
+            makeE<EFunction>("getField",
+                             makeEs(makeE<EVariable>(recordSlot), makeE<EConstant>("nested"))));
+    }
+
+    runScan(state, stage.get());
+}
+
+BENCHMARK(BM_ScanTopLevelFields)->Arg(20)->Arg(200)->Arg(2000);
+BENCHMARK_CAPTURE(BM_ScanLastField, Pushdown, true)->Arg(20)->Arg(200)->Arg(2000);
+BENCHMARK_CAPTURE(BM_ScanLastField, GetField, false)->Arg(20)->Arg(200)->Arg(2000);
+
+}  // namespace
+}  // namespace mongo::sbe
@@ -0,0 +1,177 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <chrono>
+
+#include "mongo/db/exec/sbe/expressions/expression.h"
+#include "mongo/db/exec/sbe/stages/co_scan.h"
+#include "mongo/db/exec/sbe/values/slot.h"
+#include "mongo/db/exec/sbe/vm/vm.h"
+
+namespace mongo::sbe {
+namespace {
+
+constexpr int kNumDocs = 1000;
+
+std::vector<BSONObj> makeDocuments() {
+    std::vector<BSONObj> docs;
+    docs.reserve(kNumDocs);
+    for (int i = 0; i < kNumDocs; ++i) {
+        BSONObjBuilder bob;
+        bob.append("_id", i);
+        bob.append("status", i % 3 == 0 ? "A" : "D");
+        bob.append("qty", i % 100);
+        bob.append("price", (i % 50) * 1.5);
+        bob.appendDate("ts", Date_t::fromMillisSinceEpoch(1000LL * i));
+        if (i % 2) {
+            bob.append("flag", true);
+        }
+        bob.append("tags", BSON_ARRAY(1 << 2 << 3));
+        docs.push_back(bob.obj());
+    }
+    return docs;
+}
+
+std::unique_ptr<EExpression> getField(value::SlotId slot, StringData field) {
+    return makeE<EFunction>("getField",
+                            makeEs(makeE<EVariable>(slot), makeE<EConstant>(field.toString())));
+}
+
+std::unique_ptr<EExpression> makeInt32(int32_t value) {
+    return makeE<EConstant>(value::TypeTags::NumberInt32, value::bitcastFrom<int32_t>(value));
+}
+
+/**
+ * Compiles the filter produced by 'makeFilter' and evaluates it against every document of a fixed
+ * collection, reporting the time spent per document.
+ */
+template <typename MakeFilter>
+void runFilter(benchmark::State& state, MakeFilter makeFilter) {
+    auto docs = makeDocuments();
+
+    CoScanStage root{kEmptyPlanNodeId};
+    CompileCtx ctx{std::make_unique<RuntimeEnvironment>()};
+    ctx.root = &root;
+
+    value::SlotIdGenerator slotIdGenerator;
+    value::ViewOfValueAccessor docAccessor;
+    auto docSlot = slotIdGenerator.generate();
+    ctx.pushCorrelated(docSlot, &docAccessor);
+
+    auto filter = makeFilter(docSlot);
+    auto code = filter->compile(ctx);
+    vm::ByteCode vm;
+
+    size_t matched = 0;
+    std::chrono::nanoseconds elapsed{0};
+    for (auto _ : state) {
+        auto start = std::chrono::steady_clock::now();
+        for (auto&& doc : docs) {
+            docAccessor.reset(value::TypeTags::bsonObject,
+                              value::bitcastFrom<const char*>(doc.objdata()));
+            matched += vm.runPredicate(code.get());
+        }
+        elapsed += std::chrono::steady_clock::now() - start;
+    }
+    benchmark::DoNotOptimize(matched);
+
+    auto numDocs = state.iterations() * kNumDocs;
+    state.SetItemsProcessed(numDocs);
+    state.counters["nsPerDoc"] = static_cast<double>(elapsed.count()) / numDocs;
+}
+
+// status == "A"
+void BM_FieldEquality(benchmark::State& state) {
+    runFilter(state, [](value::SlotId slot) {
+        return makeE<EPrimBinary>(EPrimBinary::eq, getField(slot, "status"), makeE<EConstant>("A"));
+    });
+}
+
+// qty >= 10 && qty < 50
+void BM_Range(benchmark::State& state) {
+    runFilter(state, [](value::SlotId slot) {
+        return makeE<EPrimBinary>(
+            EPrimBinary::logicAnd,
+            makeE<EPrimBinary>(EPrimBinary::greaterEq, getField(slot, "qty"), makeInt32(10)),
+            makeE<EPrimBinary>(EPrimBinary::less, getField(slot, "qty"), makeInt32(50)));
+    });
+}
+
+// fillEmpty(flag, false) || fillEmpty(price > 30.0, false)
+void BM_FillEmptyOr(benchmark::State& state) {
+    runFilter(state, [](value::SlotId slot) {
+        auto falseConst = [] {
+            return makeE<EConstant>(value::TypeTags::Boolean, value::bitcastFrom<bool>(false));
+        };
+        return makeE<EPrimBinary>(
+            EPrimBinary::logicOr,
+            makeE<EFunction>("fillEmpty", makeEs(getField(slot, "flag"), falseConst())),
+            makeE<EFunction>(
+                "fillEmpty",
+                makeEs(makeE<EPrimBinary>(
+                           EPrimBinary::greater,
+                           getField(slot, "price"),
+                           makeE<EConstant>(value::TypeTags::NumberDouble,
+                                            value::bitcastFrom<double>(30.0))),
+                       falseConst())));
+    });
+}
+
+// status == "A" && qty < 90 && ts >= Date(100000) && price != 0.0
+void BM_Conjunction(benchmark::State& state) {
+    runFilter(state, [](value::SlotId slot) {
+        auto datePred = makeE<EPrimBinary>(
+            EPrimBinary::greaterEq,
+            getField(slot, "ts"),
+            makeE<EConstant>(value::TypeTags::Date, value::bitcastFrom<int64_t>(100000)));
+        auto pricePred = makeE<EPrimBinary>(
+            EPrimBinary::neq,
+            getField(slot, "price"),
+            makeE<EConstant>(value::TypeTags::NumberDouble, value::bitcastFrom<double>(0.0)));
+        auto tail = makeE<EPrimBinary>(
+            EPrimBinary::logicAnd,
+            makeE<EPrimBinary>(EPrimBinary::less, getField(slot, "qty"), makeInt32(90)),
+            makeE<EPrimBinary>(EPrimBinary::logicAnd, std::move(datePred), std::move(pricePred)));
+        return makeE<EPrimBinary>(
+            EPrimBinary::logicAnd,
+            makeE<EPrimBinary>(EPrimBinary::eq, getField(slot, "status"), makeE<EConstant>("A")),
+            std::move(tail));
+    });
+}
+
+BENCHMARK(BM_FieldEquality);
+BENCHMARK(BM_Range);
+BENCHMARK(BM_FillEmptyOr);
+BENCHMARK(BM_Conjunction);
+
+}  // namespace
+}  // namespace mongo::sbe
@@ -0,0 +1,103 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/sbe/size_estimator.h"
+
+#include "mongo/db/exec/sbe/expressions/expression.h"
+#include "mongo/db/exec/sbe/stages/stages.h"
+
+namespace mongo::sbe::size_estimator {
+namespace {
+// Strings of up to this length are stored within the std::string object itself.
+constexpr size_t kSmallStringCapacity = 15;
+}  // namespace
+
+size_t estimate(const std::string& str) {
+    return str.capacity() > kSmallStringCapacity ? str.capacity() + 1 : 0;
+}
+
+size_t estimate(value::TypeTags tag, value::Value val) {
+    switch (tag) {
+        case value::TypeTags::StringBig:
+        case value::TypeTags::bsonString:
+            return value::getStringView(tag, val).size() + 1;
+        case value::TypeTags::NumberDecimal:
+            return sizeof(Decimal128);
+        case value::TypeTags::ObjectId:
+        case value::TypeTags::bsonObjectId:
+            return sizeof(value::ObjectIdType);
+        case value::TypeTags::bsonObject:
+        case value::TypeTags::bsonArray:
+            return ConstDataView(value::getRawPointerView(val)).read<LittleEndian<uint32_t>>();
+        case value::TypeTags::bsonBinData:
+            return sizeof(uint32_t) + 1 + value::getBSONBinDataSize(tag, val);
+        case value::TypeTags::Array: {
+            auto arr = value::getArrayView(val);
+            size_t size = sizeof(value::Array);
+            for (size_t idx = 0; idx < arr->size(); ++idx) {
+                auto [elemTag, elemVal] = arr->getAt(idx);
+                size += sizeof(elemTag) + sizeof(elemVal) + estimate(elemTag, elemVal);
+            }
+            return size;
+        }
+        case value::TypeTags::ArraySet: {
+            auto arrSet = value::getArraySetView(val);
+            size_t size = sizeof(value::ArraySet);
+            for (auto&& [elemTag, elemVal] : arrSet->values()) {
+                size += sizeof(elemTag) + sizeof(elemVal) + estimate(elemTag, elemVal);
+            }
+            return size;
+        }
+        case value::TypeTags::Object: {
+            auto obj = value::getObjectView(val);
+            size_t size = sizeof(value::Object);
+            for (size_t idx = 0; idx < obj->size(); ++idx) {
+                auto [fieldTag, fieldVal] = obj->getAt(idx);
+                size += sizeof(fieldTag) + sizeof(fieldVal) + sizeof(std::string) +
+                    estimate(obj->field(idx)) + estimate(fieldTag, fieldVal);
+            }
+            return size;
+        }
+        default:
+            // Other values are either held within the Value itself, or, like compiled regular
+            // expressions, are small next to the plan they are part of.
+            return 0;
+    }
+}
+
+size_t estimate(const std::unique_ptr<EExpression>& expr) {
+    return expr ? expr->estimateSize() : 0;
+}
+
+size_t estimate(const std::unique_ptr<PlanStage>& stage) {
+    return stage ? stage->estimateCompileTimeSize() : 0;
+}
+}  // namespace mongo::sbe::size_estimator
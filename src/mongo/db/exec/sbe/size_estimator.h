@@ -0,0 +1,83 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "mongo/db/exec/sbe/values/slot.h"
+#include "mongo/db/exec/sbe/values/value.h"
+
+namespace mongo::sbe {
+class EExpression;
+class PlanStage;
+
+/**
+ * Functions which estimate the memory held by the parts of an SBE plan, for the stages and
+ * expressions to report their compile-time size. The size of an object itself is counted by its
+ * owner, so each function only returns the size of the memory allocated outside of its argument.
+ */
+namespace size_estimator {
+size_t estimate(const std::string& str);
+size_t estimate(value::TypeTags tag, value::Value val);
+size_t estimate(const std::unique_ptr<EExpression>& expr);
+size_t estimate(const std::unique_ptr<PlanStage>& stage);
+
+template <typename T>
+size_t estimate(const std::vector<T>& vector);
+
+template <typename T>
+size_t estimate(const value::SlotMap<T>& map);
+
+template <typename T>
+size_t estimate(const std::vector<T>& vector) {
+    size_t size = vector.capacity() * sizeof(T);
+    if constexpr (!std::is_trivially_copyable_v<T>) {
+        for (auto&& elem : vector) {
+            size += estimate(elem);
+        }
+    }
+    return size;
+}
+
+template <typename T>
+size_t estimate(const value::SlotMap<T>& map) {
+    size_t size = map.capacity() * sizeof(typename value::SlotMap<T>::value_type);
+    if constexpr (!std::is_trivially_copyable_v<T>) {
+        for (auto&& [slot, elem] : map) {
+            size += estimate(elem);
+        }
+    }
+    return size;
+}
+}  // namespace size_estimator
+}  // namespace mongo::sbe
@@ -32,6 +32,7 @@
 #include "mongo/db/exec/sbe/stages/branch.h"
 
 #include "mongo/db/exec/sbe/expressions/expression.h"
+#include "mongo/db/exec/sbe/size_estimator.h"
 
 namespace mongo {
 namespace sbe {
@@ -225,5 +226,15 @@ std::vector<DebugPrinter::Block> BranchStage::debugPrint() const {
     return ret;
 }
 
+size_t BranchStage::estimateCompileTimeSize() const {
+    size_t size = sizeof(*this);
+    size += size_estimator::estimate(_children);
+    size += size_estimator::estimate(_filter);
+    size += size_estimator::estimate(_inputThenVals);
+    size += size_estimator::estimate(_inputElseVals);
+    size += size_estimator::estimate(_outputVals);
+    return size;
+}
+
 }  // namespace sbe
 }  // namespace mongo
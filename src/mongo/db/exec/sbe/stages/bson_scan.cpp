@@ -32,6 +32,7 @@
 #include "mongo/db/exec/sbe/stages/bson_scan.h"
 
 #include "mongo/db/exec/sbe/expressions/expression.h"
+#include "mongo/db/exec/sbe/size_estimator.h"
 #include "mongo/util/str.h"
 
 namespace mongo {
@@ -61,12 +62,12 @@ void BSONScanStage::prepare(CompileCtx& ctx) {
     }
 
     for (size_t idx = 0; idx < _fields.size(); ++idx) {
-        auto [it, inserted] =
-            _fieldAccessors.emplace(_fields[idx], std::make_unique<value::ViewOfValueAccessor>());
-        uassert(4822841, str::stream() << "duplicate field: " << _fields[idx], inserted);
-        auto [itRename, insertedRename] = _varAccessors.emplace(_vars[idx], it->second.get());
+        auto accessor = _fieldExtractor.addField(_fields[idx]);
+        uassert(4822841, str::stream() << "duplicate field: " << _fields[idx], accessor);
+        auto [itRename, insertedRename] = _varAccessors.emplace(_vars[idx], accessor);
         uassert(4822842, str::stream() << "duplicate field: " << _vars[idx], insertedRename);
     }
+    _fieldExtractor.compile();
 }
 
 value::SlotAccessor* BSONScanStage::getAccessor(CompileCtx& ctx, value::SlotId slot) {
@@ -93,28 +94,8 @@ PlanState BSONScanStage::getNext() {
                                    value::bitcastFrom<const char*>(_bsonCurrent));
         }
 
-        if (auto fieldsToMatch = _fieldAccessors.size(); fieldsToMatch != 0) {
-            auto be = _bsonCurrent + 4;
-            auto end = _bsonCurrent + value::readFromMemory<uint32_t>(_bsonCurrent);
-            for (auto& [name, accessor] : _fieldAccessors) {
-                accessor->reset();
-            }
-            while (*be != 0) {
-                auto sv = bson::fieldNameView(be);
-                if (auto it = _fieldAccessors.find(sv); it != _fieldAccessors.end()) {
-                    // Found the field so convert it to Value.
-                    auto [tag, val] = bson::convertFrom(true, be, end, sv.size());
-
-                    it->second->reset(tag, val);
-
-                    if ((--fieldsToMatch) == 0) {
-                        // No need to scan any further so bail out early.
-                        break;
-                    }
-                }
-
-                be = bson::advance(be, sv.size());
-            }
+        if (!_fieldExtractor.empty()) {
+            _fieldExtractor.extract(_bsonCurrent);
         }
 
         // Advance to the next document.
@@ -166,5 +147,13 @@ std::vector<DebugPrinter::Block> BSONScanStage::debugPrint() const {
 
     return ret;
 }
+
+size_t BSONScanStage::estimateCompileTimeSize() const {
+    size_t size = sizeof(*this);
+    size += size_estimator::estimate(_children);
+    size += size_estimator::estimate(_fields);
+    size += size_estimator::estimate(_vars);
+    return size;
+}
 }  // namespace sbe
 }  // namespace mongo
@@ -31,6 +31,7 @@
 
 #include "mongo/db/exec/sbe/stages/stages.h"
 #include "mongo/db/exec/sbe/values/bson.h"
+#include "mongo/db/exec/sbe/values/bson_field_extractor.h"
 
 namespace mongo {
 namespace sbe {
@@ -55,6 +56,7 @@ public:
     const SpecificStats* getSpecificStats() const final;
 
     std::vector<DebugPrinter::Block> debugPrint() const final;
+    size_t estimateCompileTimeSize() const final;
 
 private:
     const char* const _bsonBegin;
@@ -66,7 +68,7 @@ private:
 
     std::unique_ptr<value::ViewOfValueAccessor> _recordAccessor;
 
-    value::FieldAccessorMap _fieldAccessors;
+    bson::FieldExtractor _fieldExtractor;
     value::SlotAccessorMap _varAccessors;
 
     const char* _bsonCurrent;
@@ -31,6 +31,8 @@
 
 #include "mongo/db/exec/sbe/stages/check_bounds.h"
 
+#include "mongo/db/exec/sbe/size_estimator.h"
+
 namespace mongo::sbe {
 CheckBoundsStage::CheckBoundsStage(std::unique_ptr<PlanStage> input,
                                    const CheckBoundsParams& params,
@@ -148,4 +150,19 @@ std::vector<DebugPrinter::Block> CheckBoundsStage::debugPrint() const {
     DebugPrinter::addBlocks(ret, _children[0]->debugPrint());
     return ret;
 }
+
+size_t CheckBoundsStage::estimateCompileTimeSize() const {
+    size_t size = sizeof(*this);
+    size += size_estimator::estimate(_children);
+    size += _params.keyPattern.objsize();
+    size += _params.bounds.fields.capacity() * sizeof(OrderedIntervalList);
+    for (auto&& oil : _params.bounds.fields) {
+        size += size_estimator::estimate(oil.name);
+        size += oil.intervals.capacity() * sizeof(Interval);
+        for (auto&& interval : oil.intervals) {
+            size += interval._intervalData.objsize();
+        }
+    }
+    return size;
+}
 }  // namespace mongo::sbe
@@ -32,6 +32,7 @@
 #include "mongo/db/exec/sbe/stages/co_scan.h"
 
 #include "mongo/db/exec/sbe/expressions/expression.h"
+#include "mongo/db/exec/sbe/size_estimator.h"
 
 namespace mongo::sbe {
 CoScanStage::CoScanStage(PlanNodeId planNodeId) : PlanStage("coscan"_sd, planNodeId) {}
@@ -74,4 +75,10 @@ std::vector<DebugPrinter::Block> CoScanStage::debugPrint() const {
     DebugPrinter::addKeyword(ret, "coscan");
     return ret;
 }
+
+size_t CoScanStage::estimateCompileTimeSize() const {
+    size_t size = sizeof(*this);
+    size += size_estimator::estimate(_children);
+    return size;
+}
 }  // namespace mongo::sbe
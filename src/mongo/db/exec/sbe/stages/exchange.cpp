@@ -33,8 +33,15 @@
 
 #include "mongo/base/init.h"
 #include "mongo/db/client.h"
+#include "mongo/db/exec/sbe/size_estimator.h"
+#include "mongo/db/storage/recovery_unit.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo::sbe {
+namespace {
+AtomicWord<size_t> s_reservedWorkers{0};
+}  // namespace
+
 std::unique_ptr<ThreadPool> s_globalThreadPool;
 MONGO_INITIALIZER(s_globalThreadPool)(InitializerContext* context) {
     ThreadPool::Options options;
@@ -49,6 +56,45 @@ MONGO_INITIALIZER(s_globalThreadPool)(InitializerContext* context) {
     return Status::OK();
 }
 
+ExchangeWorkerReservation ExchangeWorkerReservation::reserve(size_t wanted, size_t maxWorkers) {
+    auto reserved = s_reservedWorkers.load();
+    while (true) {
+        auto count = std::min(wanted, maxWorkers > reserved ? maxWorkers - reserved : 0);
+        if (count == 0) {
+            return {};
+        }
+        if (s_reservedWorkers.compareAndSwap(&reserved, reserved + count)) {
+            return ExchangeWorkerReservation(count);
+        }
+    }
+}
+
+size_t ExchangeWorkerReservation::numReserved() {
+    return s_reservedWorkers.load();
+}
+
+ExchangeWorkerReservation& ExchangeWorkerReservation::operator=(ExchangeWorkerReservation&& other) {
+    if (this != &other) {
+        release();
+        _count = std::exchange(other._count, 0);
+    }
+    return *this;
+}
+
+ExchangeWorkerReservation ExchangeWorkerReservation::takeOne() {
+    if (_count == 0) {
+        return {};
+    }
+    --_count;
+    return ExchangeWorkerReservation(1);
+}
+
+void ExchangeWorkerReservation::release() {
+    if (_count > 0) {
+        s_reservedWorkers.fetchAndSubtract(std::exchange(_count, 0));
+    }
+}
+
 ExchangePipe::ExchangePipe(size_t size) {
     // All buffers start empty.
     _fullCount = 0;
@@ -134,6 +180,20 @@ ExchangePipe* ExchangeState::pipe(size_t consumerTid, size_t producerTid) {
     return _consumers[consumerTid]->pipe(producerTid);
 }
 
+void ExchangeState::addProducerStats(std::unique_ptr<PlanStageStats> stats) {
+    stdx::lock_guard<Latch> lock(_producerStatsMutex);
+    _producerStats.emplace_back(std::move(stats));
+}
+
+std::vector<std::unique_ptr<PlanStageStats>> ExchangeState::producerStats() const {
+    stdx::lock_guard<Latch> lock(_producerStatsMutex);
+    std::vector<std::unique_ptr<PlanStageStats>> stats;
+    for (auto&& producerStats : _producerStats) {
+        stats.emplace_back(producerStats->clone());
+    }
+    return stats;
+}
+
 ExchangeBuffer* ExchangeConsumer::getBuffer(size_t producerId) {
     if (_fullBuffers[producerId]) {
         return _fullBuffers[producerId].get();
@@ -175,16 +235,47 @@ ExchangeConsumer::ExchangeConsumer(std::shared_ptr<ExchangeState> state, PlanNod
     _tid = _state->addConsumer(this);
     _orderPreserving = _state->isOrderPreserving();
 }
+void ExchangeConsumer::setWorkerReservation(ExchangeWorkerReservation reservation,
+                                            size_t maxWorkers) {
+    invariant(reservation.count() == _state->numOfProducers());
+    _state->workerReservation() = std::move(reservation);
+    _maxWorkers = maxWorkers;
+}
 std::unique_ptr<PlanStage> ExchangeConsumer::clone() const {
-    return std::make_unique<ExchangeConsumer>(_state, _commonStats.nodeId);
+    // A clone, such as one made from a plan in the plan cache, runs producers of its own and so
+    // gets a new exchange state. Its threads are reserved afresh, and it runs with fewer producers
+    // if not as many threads are free any more.
+    ExchangeWorkerReservation workers;
+    auto numOfProducers = _state->numOfProducers();
+    if (_maxWorkers > 0) {
+        workers = ExchangeWorkerReservation::reserve(numOfProducers, _maxWorkers);
+        numOfProducers = std::max(workers.count(), size_t{1});
+    }
+
+    auto consumer = std::make_unique<ExchangeConsumer>(
+        _children[0]->clone(),
+        numOfProducers,
+        _state->fields(),
+        _state->policy(),
+        _state->partition() ? _state->partition()->clone() : nullptr,
+        _state->orderLess() ? _state->orderLess()->clone() : nullptr,
+        _commonStats.nodeId);
+    if (workers.count() > 0) {
+        consumer->setWorkerReservation(std::move(workers), _maxWorkers);
+    }
+    return consumer;
 }
 void ExchangeConsumer::prepare(CompileCtx& ctx) {
     for (size_t idx = 0; idx < _state->fields().size(); ++idx) {
         _outgoing.emplace_back(ExchangeBuffer::Accessor{});
     }
 
+    // The copies of the subtree which the producers run share the state of their stages, such as
+    // the ranges of a parallel scan, through their compile contexts.
+    auto smpSharedState = std::make_shared<SmpSharedState>();
     for (size_t idx = 0; idx < _state->numOfProducers(); ++idx) {
         _state->producerCompileCtxs().push_back(ctx.makeCopy(true));
+        _state->producerCompileCtxs().back().smpSharedState = smpSharedState;
     }
     // Compile '<' function once we implement order preserving exchange.
 }
@@ -232,21 +323,23 @@ void ExchangeConsumer::open(bool reOpen) {
                     lock, [this]() { return _state->consumerOpen() == _state->numOfConsumers(); });
             }
 
-            // Clone n copies of the subtree for every producer.
+            // All producers read at the read timestamp of the operation, so that together they see
+            // the same point-in-time view of the data as a serial plan would. The stage builder
+            // only builds parallel plans for operations which read at a timestamp.
+            if (_opCtx) {
+                auto readTimestamp = _opCtx->recoveryUnit()->getPointInTimeReadTimestamp();
+                uassert(ErrorCodes::SnapshotUnavailable,
+                        "no timestamp for the producers of an exchange to read at",
+                        readTimestamp && !readTimestamp->isNull());
+                _state->readTimestamp() = *readTimestamp;
+            }
 
+            // Clone n copies of the subtree for every producer. The master copy stays with the
+            // consumer, so that the plan can still be printed.
             PlanStage* masterSubTree = _children[0].get();
-            masterSubTree->detachFromOperationContext();
-
             for (size_t idx = 0; idx < _state->numOfProducers(); ++idx) {
-                if (idx == 0) {
-                    _state->producerPlans().emplace_back(std::make_unique<ExchangeProducer>(
-                        std::move(_children[0]), _state, _commonStats.nodeId));
-                    // We have moved the child to the producer so clear the children vector.
-                    _children.clear();
-                } else {
-                    _state->producerPlans().emplace_back(std::make_unique<ExchangeProducer>(
-                        masterSubTree->clone(), _state, _commonStats.nodeId));
-                }
+                _state->producerPlans().emplace_back(std::make_unique<ExchangeProducer>(
+                    masterSubTree->clone(), _state, _commonStats.nodeId));
             }
 
             // Start n producers.
@@ -254,12 +347,22 @@ void ExchangeConsumer::open(bool reOpen) {
             for (size_t idx = 0; idx < _state->numOfProducers(); ++idx) {
                 auto pf = makePromiseFuture<void>();
                 s_globalThreadPool->schedule(
-                    [this, idx, promise = std::move(pf.promise)](auto status) mutable {
+                    [this,
+                     idx,
+                     worker = _state->workerReservation().takeOne(),
+                     promise = std::move(pf.promise)](auto status) mutable {
                         invariant(status);
 
                         auto opCtx = cc().makeOperationContext();
+                        if (!_state->readTimestamp().isNull()) {
+                            opCtx->recoveryUnit()->setTimestampReadSource(
+                                RecoveryUnit::ReadSource::kProvided, _state->readTimestamp());
+                        }
 
                         promise.setWith([&] {
+                            // Give the thread back before the consumer learns that this producer
+                            // has finished.
+                            ON_BLOCK_EXIT([&] { worker = {}; });
                             ExchangeProducer::start(opCtx.get(),
                                                     _state->producerCompileCtxs()[idx],
                                                     std::move(_state->producerPlans()[idx]));
@@ -363,7 +466,12 @@ void ExchangeConsumer::close() {
 
 std::unique_ptr<PlanStageStats> ExchangeConsumer::getStats() const {
     auto ret = std::make_unique<PlanStageStats>(_commonStats);
-    ret->children.emplace_back(_children[0]->getStats());
+    // The master copy of the subtree is never run, so report the subtrees which the producers ran
+    // in its place once they have finished.
+    ret->children = _state->producerStats();
+    if (ret->children.empty()) {
+        ret->children.emplace_back(_children[0]->getStats());
+    }
     return ret;
 }
 
@@ -403,6 +511,17 @@ std::vector<DebugPrinter::Block> ExchangeConsumer::debugPrint() const {
     return ret;
 }
 
+size_t ExchangeConsumer::estimateCompileTimeSize() const {
+    size_t size = sizeof(*this);
+    size += size_estimator::estimate(_children);
+    // The producers of the exchange are only created when the plan is prepared, so only the
+    // parameters held by the exchange state are counted.
+    size += size_estimator::estimate(_state->fields());
+    size += _state->partition() ? _state->partition()->estimateSize() : 0;
+    size += _state->orderLess() ? _state->orderLess()->estimateSize() : 0;
+    return size;
+}
+
 ExchangePipe* ExchangeConsumer::pipe(size_t producerTid) {
     if (_orderPreserving) {
         return _pipes[producerTid].get();
@@ -461,6 +580,9 @@ void ExchangeProducer::start(OperationContext* opCtx,
 
     p->attachFromOperationContext(opCtx);
 
+    // Hand the stats of the subtree to the consumer, as the producer goes away once it finishes.
+    ON_BLOCK_EXIT([&] { p->_state->addProducerStats(p->_children[0]->getStats()); });
+
     try {
         p->prepare(ctx);
         p->open(false);
@@ -574,6 +696,13 @@ const SpecificStats* ExchangeProducer::getSpecificStats() const {
 std::vector<DebugPrinter::Block> ExchangeProducer::debugPrint() const {
     return std::vector<DebugPrinter::Block>();
 }
+
+size_t ExchangeProducer::estimateCompileTimeSize() const {
+    size_t size = sizeof(*this);
+    size += size_estimator::estimate(_children);
+    return size;
+}
+
 bool ExchangeBuffer::appendData(std::vector<value::SlotAccessor*>& data) {
     ++_count;
     for (auto accesor : data) {
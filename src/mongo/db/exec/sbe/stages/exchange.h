@@ -29,8 +29,10 @@
 
 #pragma once
 
+#include <utility>
 #include <vector>
 
+#include "mongo/bson/timestamp.h"
 #include "mongo/db/exec/sbe/expressions/expression.h"
 #include "mongo/db/exec/sbe/stages/stages.h"
 #include "mongo/stdx/condition_variable.h"
@@ -141,6 +143,51 @@ private:
     bool _closed{false};
 };
 
+/**
+ * A number of the producer threads which the exchanges of all operations may run at once. Plan
+ * builders reserve the threads when they choose how many producers to give an exchange, so that
+ * builders running concurrently cannot together grant more threads than the limit, and each
+ * producer gives its thread back once it finishes.
+ */
+class ExchangeWorkerReservation {
+public:
+    /**
+     * Reserves up to 'wanted' threads, or fewer if more would take the number of threads reserved
+     * across all operations over 'maxWorkers'.
+     */
+    static ExchangeWorkerReservation reserve(size_t wanted, size_t maxWorkers);
+
+    /**
+     * Returns the number of threads which are reserved across all operations.
+     */
+    static size_t numReserved();
+
+    ExchangeWorkerReservation() = default;
+    ExchangeWorkerReservation(ExchangeWorkerReservation&& other)
+        : _count(std::exchange(other._count, 0)) {}
+    ExchangeWorkerReservation& operator=(ExchangeWorkerReservation&& other);
+
+    ~ExchangeWorkerReservation() {
+        release();
+    }
+
+    size_t count() const {
+        return _count;
+    }
+
+    /**
+     * Moves one of the reserved threads, if there are any, into a reservation of its own.
+     */
+    ExchangeWorkerReservation takeOne();
+
+private:
+    explicit ExchangeWorkerReservation(size_t count) : _count(count) {}
+
+    void release();
+
+    size_t _count{0};
+};
+
 /**
  * Common shared state between all consumers and producers of a single exchange.
  */
@@ -205,6 +252,24 @@ public:
         return _producerResults;
     }
 
+    auto& workerReservation() {
+        return _workerReservation;
+    }
+
+    auto& readTimestamp() {
+        return _readTimestamp;
+    }
+
+    /**
+     * Records the stats of the subtree of a producer which has finished.
+     */
+    void addProducerStats(std::unique_ptr<PlanStageStats> stats);
+
+    /**
+     * Returns copies of the stats recorded by the producers which have finished so far.
+     */
+    std::vector<std::unique_ptr<PlanStageStats>> producerStats() const;
+
     auto numOfConsumers() const {
         return _consumers.size();
     }
@@ -215,6 +280,12 @@ public:
     auto& fields() const {
         return _fields;
     }
+    const EExpression* partition() const {
+        return _partition.get();
+    }
+    const EExpression* orderLess() const {
+        return _orderLess.get();
+    }
     ExchangePipe* pipe(size_t consumerTid, size_t producerTid);
 
 private:
@@ -226,6 +297,16 @@ private:
     std::vector<CompileCtx> _producerCompileCtxs;
     std::vector<Future<void>> _producerResults;
 
+    // The threads reserved for the producers which have not been started yet.
+    ExchangeWorkerReservation _workerReservation;
+
+    // The timestamp which all producers read at, so that they see the same snapshot of the data.
+    Timestamp _readTimestamp;
+
+    // The stats of the subtrees of the producers which have finished.
+    mutable Mutex _producerStatsMutex = MONGO_MAKE_LATCH("ExchangeState::_producerStatsMutex");
+    std::vector<std::unique_ptr<PlanStageStats>> _producerStats;
+
     // Variables (fields) that pass through the exchange.
     const value::SlotVector _fields;
 
@@ -258,6 +339,14 @@ public:
 
     ExchangeConsumer(std::shared_ptr<ExchangeState> state, PlanNodeId planNodeId);
 
+    /**
+     * Hands the exchange the threads reserved for its producers, which each producer gives back as
+     * it finishes. 'maxWorkers' is the limit the threads were reserved under, which clones of the
+     * exchange reserve their own threads under. The threads of exchanges built without a
+     * reservation are not counted.
+     */
+    void setWorkerReservation(ExchangeWorkerReservation reservation, size_t maxWorkers);
+
     std::unique_ptr<PlanStage> clone() const final;
 
     void prepare(CompileCtx& ctx) final;
@@ -269,6 +358,7 @@ public:
     std::unique_ptr<PlanStageStats> getStats() const final;
     const SpecificStats* getSpecificStats() const final;
     std::vector<DebugPrinter::Block> debugPrint() const final;
+    size_t estimateCompileTimeSize() const final;
 
     ExchangePipe* pipe(size_t producerTid);
 
@@ -297,6 +387,10 @@ private:
     bool _orderPreserving{false};
 
     size_t _rowProcessed{0};
+
+    // The limit on the threads of all exchanges which the producers of this one were reserved
+    // under, or zero if they were not reserved.
+    size_t _maxWorkers{0};
 };
 
 class ExchangeProducer final : public PlanStage {
@@ -320,6 +414,7 @@ public:
     std::unique_ptr<PlanStageStats> getStats() const final;
     const SpecificStats* getSpecificStats() const final;
     std::vector<DebugPrinter::Block> debugPrint() const final;
+    size_t estimateCompileTimeSize() const final;
 
 private:
     ExchangeBuffer* getBuffer(size_t consumerId);
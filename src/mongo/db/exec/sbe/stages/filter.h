@@ -30,6 +30,7 @@
 #pragma once
 
 #include "mongo/db/exec/sbe/expressions/expression.h"
+#include "mongo/db/exec/sbe/size_estimator.h"
 #include "mongo/db/exec/sbe/stages/stages.h"
 #include "mongo/db/exec/sbe/vm/vm.h"
 
@@ -158,6 +159,13 @@ public:
         return ret;
     }
 
+    size_t estimateCompileTimeSize() const final {
+        size_t size = sizeof(*this);
+        size += size_estimator::estimate(_children);
+        size += size_estimator::estimate(_filter);
+        return size;
+    }
+
 private:
     const std::unique_ptr<EExpression> _filter;
     std::unique_ptr<vm::CodeFragment> _filterCode;
@@ -31,6 +31,7 @@
 
 #include "mongo/db/exec/sbe/stages/hash_agg.h"
 
+#include "mongo/db/exec/sbe/size_estimator.h"
 #include "mongo/util/str.h"
 
 namespace mongo {
@@ -196,5 +197,13 @@ std::vector<DebugPrinter::Block> HashAggStage::debugPrint() const {
 
     return ret;
 }
+
+size_t HashAggStage::estimateCompileTimeSize() const {
+    size_t size = sizeof(*this);
+    size += size_estimator::estimate(_children);
+    size += size_estimator::estimate(_gbs);
+    size += size_estimator::estimate(_aggs);
+    return size;
+}
 }  // namespace sbe
 }  // namespace mongo
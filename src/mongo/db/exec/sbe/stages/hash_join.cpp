@@ -31,24 +31,51 @@
 
 #include "mongo/db/exec/sbe/stages/hash_join.h"
 
+#include <boost/filesystem/operations.hpp>
+
 #include "mongo/db/exec/sbe/expressions/expression.h"
+#include "mongo/db/exec/sbe/size_estimator.h"
+#include "mongo/db/storage/storage_options.h"
+#include "mongo/util/destructor_guard.h"
 #include "mongo/util/str.h"
 
+namespace {
+std::string nextFileName() {
+    static mongo::AtomicWord<unsigned> hashJoinFileCounter;
+    return "extsort-hash-join-sbe." + std::to_string(hashJoinFileCounter.fetchAndAdd(1));
+}
+}  // namespace
+
+#include "mongo/db/sorter/sorter.cpp"
+
 namespace mongo {
 namespace sbe {
+namespace {
+// Approximate per-row cost of the arena and the hash table on top of the row values themselves:
+// the stored hash, the duplicate chain link and, with the table at most half full, two slots.
+constexpr size_t kRowOverheadBytes = 4 * sizeof(size_t);
+}  // namespace
+
+HashJoinStage::Partition::Partition() = default;
+HashJoinStage::Partition::Partition(Partition&&) = default;
+HashJoinStage::Partition::~Partition() = default;
+
 HashJoinStage::HashJoinStage(std::unique_ptr<PlanStage> outer,
                              std::unique_ptr<PlanStage> inner,
                              value::SlotVector outerCond,
                              value::SlotVector outerProjects,
                              value::SlotVector innerCond,
                              value::SlotVector innerProjects,
+                             size_t memoryLimit,
+                             bool allowDiskUse,
                              PlanNodeId planNodeId)
     : PlanStage("hj"_sd, planNodeId),
       _outerCond(std::move(outerCond)),
       _outerProjects(std::move(outerProjects)),
       _innerCond(std::move(innerCond)),
       _innerProjects(std::move(innerProjects)),
-      _probeKey(0) {
+      _memoryLimit(memoryLimit),
+      _allowDiskUse(allowDiskUse) {
     if (_outerCond.size() != _innerCond.size()) {
         uasserted(4822823, "left and right size do not match");
     }
@@ -57,6 +84,10 @@ HashJoinStage::HashJoinStage(std::unique_ptr<PlanStage> outer,
     _children.emplace_back(std::move(inner));
 }
 
+HashJoinStage::~HashJoinStage() {
+    DESTRUCTOR_GUARD(clearSpilledState());
+}
+
 std::unique_ptr<PlanStage> HashJoinStage::clone() const {
     return std::make_unique<HashJoinStage>(_children[0]->clone(),
                                            _children[1]->clone(),
@@ -64,6 +95,8 @@ std::unique_ptr<PlanStage> HashJoinStage::clone() const {
                                            _outerProjects,
                                            _innerCond,
                                            _innerProjects,
+                                           _memoryLimit,
+                                           _allowDiskUse,
                                            _commonStats.nodeId);
 }
 
@@ -78,8 +111,8 @@ void HashJoinStage::prepare(CompileCtx& ctx) {
         uassert(4822824, str::stream() << "duplicate field: " << slot, inserted);
 
         _inOuterKeyAccessors.emplace_back(_children[0]->getAccessor(ctx, slot));
-        _outOuterKeyAccessors.emplace_back(std::make_unique<HashKeyAccessor>(_htIt, counter++));
-        _outOuterAccessors[slot] = _outOuterKeyAccessors.back().get();
+        _ownedAccessors.emplace_back(std::make_unique<RowKeyAccessor>(_buildRowIt, counter++));
+        _outAccessors[slot] = _ownedAccessors.back().get();
     }
 
     counter = 0;
@@ -88,6 +121,8 @@ void HashJoinStage::prepare(CompileCtx& ctx) {
         uassert(4822825, str::stream() << "duplicate field: " << slot, inserted);
 
         _inInnerKeyAccessors.emplace_back(_children[1]->getAccessor(ctx, slot));
+        _ownedAccessors.emplace_back(std::make_unique<RowKeyAccessor>(_probeRowIt, counter++));
+        _outAccessors[slot] = _ownedAccessors.back().get();
     }
 
     counter = 0;
@@ -96,19 +131,24 @@ void HashJoinStage::prepare(CompileCtx& ctx) {
         uassert(4822826, str::stream() << "duplicate field: " << slot, inserted);
 
         _inOuterProjectAccessors.emplace_back(_children[0]->getAccessor(ctx, slot));
-        _outOuterProjectAccessors.emplace_back(
-            std::make_unique<HashProjectAccessor>(_htIt, counter++));
-        _outOuterAccessors[slot] = _outOuterProjectAccessors.back().get();
+        _ownedAccessors.emplace_back(std::make_unique<RowProjectAccessor>(_buildRowIt, counter++));
+        _outAccessors[slot] = _ownedAccessors.back().get();
     }
 
-    _probeKey.resize(_inInnerKeyAccessors.size());
+    // The inner projections may repeat the inner keys, in which case the key accessor is used.
+    counter = 0;
+    for (auto& slot : _innerProjects) {
+        _inInnerProjectAccessors.emplace_back(_children[1]->getAccessor(ctx, slot));
+        _ownedAccessors.emplace_back(std::make_unique<RowProjectAccessor>(_probeRowIt, counter++));
+        _outAccessors.emplace(slot, _ownedAccessors.back().get());
+    }
 
     _compiled = true;
 }
 
 value::SlotAccessor* HashJoinStage::getAccessor(CompileCtx& ctx, value::SlotId slot) {
     if (_compiled) {
-        if (auto it = _outOuterAccessors.find(slot); it != _outOuterAccessors.end()) {
+        if (auto it = _outAccessors.find(slot); it != _outAccessors.end()) {
             return it->second;
         }
 
@@ -118,10 +158,277 @@ value::SlotAccessor* HashJoinStage::getAccessor(CompileCtx& ctx, value::SlotId s
     return ctx.getAccessor(slot);
 }
 
+size_t HashJoinStage::partitionOf(size_t hash) const {
+    // Re-mix the hash differently on every recursion level, so that the rows of a partition are
+    // spread across all partitions of the next level.
+    uint64_t h = hash ^ (_level * 0x9E3779B97F4A7C15ULL);
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h % kNumSpillPartitions;
+}
+
+std::string HashJoinStage::makeSpillFile() {
+    _spillFiles.emplace_back(storageGlobalParams.dbpath + "/_tmp/" + nextFileName());
+    return _spillFiles.back();
+}
+
+void HashJoinStage::addBuildRow(Row row, size_t hash) {
+    auto& partition = _partitions[partitionOf(hash)];
+    if (partition.spilled) {
+        partition.buildWriter->addAlreadySorted(row.first, row.second);
+        ++_specificStats.spilledBuildRecords;
+        return;
+    }
+
+    auto rowSize =
+        row.first.memUsageForSorter() + row.second.memUsageForSorter() + kRowOverheadBytes;
+    partition.rows.emplace_back(std::move(row));
+    partition.hashes.push_back(hash);
+    partition.memUsage += rowSize;
+    _memoryUseBytes += rowSize;
+
+    // Past the maximum recursion depth the rows are kept in memory regardless of the limit.
+    if (_memoryUseBytes > _memoryLimit && _level < kMaxRecursionDepth) {
+        uassert(ErrorCodes::QueryExceededMemoryLimitNoDiskUseAllowed,
+                "Exceeded memory limit for hash join, but didn't allow external spilling."
+                " Pass allowDiskUse:true to opt in.",
+                _allowDiskUse);
+
+        spillPartitions();
+    }
+}
+
+void HashJoinStage::spillPartitions() {
+    SortOptions opts;
+    opts.tempDir = storageGlobalParams.dbpath + "/_tmp";
+
+    while (_memoryUseBytes > _memoryLimit) {
+        auto largest = std::max_element(
+            _partitions.begin(), _partitions.end(), [](const auto& lhs, const auto& rhs) {
+                return lhs.memUsage < rhs.memUsage;
+            });
+        if (largest->rows.empty()) {
+            break;
+        }
+
+        auto& partition = *largest;
+        partition.buildWriter = std::make_unique<RowWriter>(opts, makeSpillFile(), 0);
+        for (auto& row : partition.rows) {
+            partition.buildWriter->addAlreadySorted(row.first, row.second);
+        }
+
+        _specificStats.usedDisk = true;
+        ++_specificStats.spilledPartitions;
+        _specificStats.spilledBuildRecords += partition.rows.size();
+
+        partition.spilled = true;
+        _memoryUseBytes -= partition.memUsage;
+        partition.memUsage = 0;
+        std::vector<Row>{}.swap(partition.rows);
+        std::vector<size_t>{}.swap(partition.hashes);
+    }
+}
+
+void HashJoinStage::finishBuild() {
+    size_t numRows = 0;
+    for (auto& partition : _partitions) {
+        numRows += partition.rows.size();
+    }
+
+    _buildRows.reserve(numRows);
+    _buildHashes.reserve(numRows);
+    for (auto& partition : _partitions) {
+        if (partition.spilled) {
+            partition.buildRun.reset(partition.buildWriter->done());
+            _specificStats.spilledBytes +=
+                static_cast<size_t>(partition.buildWriter->getFileEndOffset());
+            partition.buildWriter.reset();
+            continue;
+        }
+
+        std::move(partition.rows.begin(), partition.rows.end(), std::back_inserter(_buildRows));
+        _buildHashes.insert(_buildHashes.end(), partition.hashes.begin(), partition.hashes.end());
+        std::vector<Row>{}.swap(partition.rows);
+        std::vector<size_t>{}.swap(partition.hashes);
+        partition.memUsage = 0;
+    }
+
+    size_t capacity = 1;
+    while (capacity < 2 * numRows) {
+        capacity <<= 1;
+    }
+    _slots.assign(capacity, 0);
+    _slotMask = capacity - 1;
+    _nextDuplicate.assign(numRows, kNoRow);
+
+    // Insert the rows back to front, so that every duplicate chain lists its rows in input order.
+    for (size_t idx = numRows; idx-- > 0;) {
+        for (auto slot = _buildHashes[idx] & _slotMask;; slot = (slot + 1) & _slotMask) {
+            auto entry = _slots[slot];
+            if (entry == 0) {
+                _slots[slot] = idx + 1;
+                break;
+            }
+
+            auto head = entry - 1;
+            if (_buildHashes[head] == _buildHashes[idx] &&
+                _buildRows[head].first == _buildRows[idx].first) {
+                _nextDuplicate[idx] = head;
+                _slots[slot] = idx + 1;
+                break;
+            }
+        }
+    }
+}
+
+size_t HashJoinStage::findMatch(size_t hash, const value::MaterializedRow& key) const {
+    for (auto slot = hash & _slotMask;; slot = (slot + 1) & _slotMask) {
+        auto entry = _slots[slot];
+        if (entry == 0) {
+            return kNoRow;
+        }
+
+        auto idx = entry - 1;
+        if (_buildHashes[idx] == hash && _buildRows[idx].first == key) {
+            return idx;
+        }
+    }
+}
+
+void HashJoinStage::resetBuildSide() {
+    std::vector<Row>{}.swap(_buildRows);
+    std::vector<size_t>{}.swap(_buildHashes);
+    std::vector<size_t>{}.swap(_nextDuplicate);
+    std::vector<size_t>{}.swap(_slots);
+    _slotMask = 0;
+    _memoryUseBytes = 0;
+    _matchIdx = kNoRow;
+    _buildRowIt = nullptr;
+
+    _partitions.clear();
+    _partitions.resize(kNumSpillPartitions);
+}
+
+void HashJoinStage::scheduleSpilledPartitions() {
+    for (auto& partition : _partitions) {
+        if (!partition.spilled || !partition.probeWriter) {
+            // Without any probe rows there is nothing to join the build rows with.
+            continue;
+        }
+
+        std::shared_ptr<RowIterator> probeRun{partition.probeWriter->done()};
+        _specificStats.spilledBytes +=
+            static_cast<size_t>(partition.probeWriter->getFileEndOffset());
+        _pendingPartitions.push_back(
+            {std::move(partition.buildRun), std::move(probeRun), _level + 1});
+    }
+
+    _partitions.clear();
+}
+
+void HashJoinStage::openPendingPartition(PendingPartition pending) {
+    resetBuildSide();
+    _level = pending.level;
+    _specificStats.maxRecursionDepth = std::max(_specificStats.maxRecursionDepth, _level);
+
+    value::MaterializedRowHasher hasher;
+    pending.buildRun->openSource();
+    while (pending.buildRun->more()) {
+        auto row = pending.buildRun->next();
+        auto hash = hasher(row.first);
+        addBuildRow(std::move(row), hash);
+    }
+    pending.buildRun->closeSource();
+
+    finishBuild();
+
+    _probeIt = std::move(pending.probeRun);
+    _probeIt->openSource();
+}
+
+bool HashJoinStage::nextProbeRow() {
+    value::MaterializedRowHasher hasher;
+    for (;;) {
+        bool haveRow = false;
+        if (_probeFromChild) {
+            if (_children[1]->getNext() == PlanState::ADVANCED) {
+                size_t idx = 0;
+                for (auto& p : _inInnerKeyAccessors) {
+                    auto [tag, val] = p->getViewOfValue();
+                    _probeRow.first.reset(idx++, false, tag, val);
+                }
+
+                idx = 0;
+                for (auto& p : _inInnerProjectAccessors) {
+                    auto [tag, val] = p->getViewOfValue();
+                    _probeRow.second.reset(idx++, false, tag, val);
+                }
+                haveRow = true;
+            } else {
+                _probeFromChild = false;
+            }
+        } else if (_probeIt) {
+            if (_probeIt->more()) {
+                _probeRow = _probeIt->next();
+                haveRow = true;
+            } else {
+                _probeIt->closeSource();
+                _probeIt.reset();
+            }
+        }
+
+        if (haveRow) {
+            _probeHash = hasher(_probeRow.first);
+
+            auto& partition = _partitions[partitionOf(_probeHash)];
+            if (!partition.spilled) {
+                return true;
+            }
+
+            // The matching build rows are on disk, so set the row aside until they are loaded.
+            if (!partition.probeWriter) {
+                SortOptions opts;
+                opts.tempDir = storageGlobalParams.dbpath + "/_tmp";
+                partition.probeWriter = std::make_unique<RowWriter>(opts, makeSpillFile(), 0);
+            }
+            partition.probeWriter->addAlreadySorted(_probeRow.first, _probeRow.second);
+            ++_specificStats.spilledProbeRecords;
+            continue;
+        }
+
+        scheduleSpilledPartitions();
+        if (_pendingPartitions.empty()) {
+            return false;
+        }
+
+        auto pending = std::move(_pendingPartitions.back());
+        _pendingPartitions.pop_back();
+        openPendingPartition(std::move(pending));
+    }
+}
+
+void HashJoinStage::clearSpilledState() {
+    _pendingPartitions.clear();
+    _probeIt.reset();
+    _partitions.clear();
+    _probeFromChild = false;
+    _level = 0;
+
+    for (auto& fileName : _spillFiles) {
+        boost::system::error_code ec;
+        boost::filesystem::remove(fileName, ec);
+    }
+    _spillFiles.clear();
+}
+
 void HashJoinStage::open(bool reOpen) {
     _commonStats.opens++;
+    clearSpilledState();
+    resetBuildSide();
+
     _children[0]->open(reOpen);
     // Insert the outer side into the hash table.
+    value::MaterializedRowHasher hasher;
     while (_children[0]->getNext() == PlanState::ADVANCED) {
         value::MaterializedRow key{_inOuterKeyAccessors.size()};
         value::MaterializedRow project{_inOuterProjectAccessors.size()};
@@ -140,62 +447,58 @@ void HashJoinStage::open(bool reOpen) {
             project.reset(idx++, true, tag, val);
         }
 
-        _ht.emplace(std::move(key), std::move(project));
+        auto hash = hasher(key);
+        addBuildRow({std::move(key), std::move(project)}, hash);
     }
 
     _children[0]->close();
 
-    _children[1]->open(reOpen);
+    finishBuild();
 
-    _htIt = _ht.end();
-    _htItEnd = _ht.end();
+    _children[1]->open(reOpen);
+    _probeFromChild = true;
+    _probeRow = Row{value::MaterializedRow{_inInnerKeyAccessors.size()},
+                    value::MaterializedRow{_inInnerProjectAccessors.size()}};
 }
 
 PlanState HashJoinStage::getNext() {
-    if (_htIt != _htItEnd) {
-        ++_htIt;
+    if (_matchIdx != kNoRow) {
+        _matchIdx = _nextDuplicate[_matchIdx];
     }
 
-    if (_htIt == _htItEnd) {
-        while (_htIt == _htItEnd) {
-            auto state = _children[1]->getNext();
-            if (state == PlanState::IS_EOF) {
-                // LEFT and OUTER joins should enumerate "non-returned" rows here.
-                return trackPlanState(state);
-            }
-
-            // Copy keys in order to do the lookup.
-            size_t idx = 0;
-            for (auto& p : _inInnerKeyAccessors) {
-                auto [tag, val] = p->getViewOfValue();
-                _probeKey.reset(idx++, false, tag, val);
-            }
-
-            auto [low, hi] = _ht.equal_range(_probeKey);
-            _htIt = low;
-            _htItEnd = hi;
-            // If _htIt == _htItEnd (i.e. no match) then RIGHT and OUTER joins
-            // should enumerate "non-returned" rows here.
+    while (_matchIdx == kNoRow) {
+        if (!nextProbeRow()) {
+            // LEFT and OUTER joins should enumerate "non-returned" rows here.
+            return trackPlanState(PlanState::IS_EOF);
         }
+
+        _matchIdx = findMatch(_probeHash, _probeRow.first);
+        // If there is no match then RIGHT and OUTER joins should enumerate "non-returned" rows
+        // here.
     }
 
+    _buildRowIt = &_buildRows[_matchIdx];
     return trackPlanState(PlanState::ADVANCED);
 }
 
 void HashJoinStage::close() {
     _commonStats.closes++;
     _children[1]->close();
+
+    clearSpilledState();
+    resetBuildSide();
 }
 
 std::unique_ptr<PlanStageStats> HashJoinStage::getStats() const {
     auto ret = std::make_unique<PlanStageStats>(_commonStats);
+    ret->specific = std::make_unique<HashJoinStats>(_specificStats);
     ret->children.emplace_back(_children[0]->getStats());
     ret->children.emplace_back(_children[1]->getStats());
     return ret;
 }
 
 const SpecificStats* HashJoinStage::getSpecificStats() const {
-    return nullptr;
+    return &_specificStats;
 }
 
 std::vector<DebugPrinter::Block> HashJoinStage::debugPrint() const {
@@ -259,5 +562,15 @@ std::vector<DebugPrinter::Block> HashJoinStage::debugPrint() const {
 
     return ret;
 }
+
+size_t HashJoinStage::estimateCompileTimeSize() const {
+    size_t size = sizeof(*this);
+    size += size_estimator::estimate(_children);
+    size += size_estimator::estimate(_outerCond);
+    size += size_estimator::estimate(_outerProjects);
+    size += size_estimator::estimate(_innerCond);
+    size += size_estimator::estimate(_innerProjects);
+    return size;
+}
 }  // namespace sbe
 }  // namespace mongo
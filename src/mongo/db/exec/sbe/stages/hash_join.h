@@ -34,17 +34,52 @@
 #include "mongo/db/exec/sbe/stages/stages.h"
 #include "mongo/db/exec/sbe/vm/vm.h"
 
+namespace mongo {
+template <typename Key, typename Value>
+class SortIteratorInterface;
+template <typename Key, typename Value>
+class SortedFileWriter;
+}  // namespace mongo
+
 namespace mongo::sbe {
+/**
+ * Joins the rows of the 'outer' (build) side with the rows of the 'inner' (probe) side whose
+ * 'outerCond' and 'innerCond' values are equal.
+ *
+ * The build side is materialized into a contiguous arena of rows indexed by an open-addressing
+ * hash table. Rows with equal keys share one table entry and are chained together through the
+ * arena, so a probe finds all its matches with a single lookup.
+ *
+ * Every build row is assigned to one of 'kNumSpillPartitions' partitions by its hash. When the
+ * approximate footprint of the build side exceeds 'memoryLimit' and 'allowDiskUse' is set, the
+ * largest partitions are written out to temporary files until the rest fits in memory (otherwise
+ * the query fails). Probe rows falling into a spilled partition are set aside into a file of their
+ * own. Once the probe side is exhausted, each spilled partition is joined in turn by building a
+ * table over its build rows and probing it with its probe rows. A spilled partition which still
+ * does not fit in memory is recursively re-partitioned, using a different hash for each level, up
+ * to 'kMaxRecursionDepth' levels deep. Past that depth the remaining rows most likely share the
+ * same key, so splitting them further would not help and the partition is joined in memory.
+ *
+ * Once anything has been spilled, only the 'innerCond' and 'innerProjects' slots are guaranteed
+ * to be available from the inner side.
+ */
 class HashJoinStage final : public PlanStage {
 public:
+    static constexpr size_t kNumSpillPartitions = 16;
+    static constexpr size_t kMaxRecursionDepth = 3;
+
     HashJoinStage(std::unique_ptr<PlanStage> outer,
                   std::unique_ptr<PlanStage> inner,
                   value::SlotVector outerCond,
                   value::SlotVector outerProjects,
                   value::SlotVector innerCond,
                   value::SlotVector innerProjects,
+                  size_t memoryLimit,
+                  bool allowDiskUse,
                   PlanNodeId planNodeId);
 
+    ~HashJoinStage();
+
     std::unique_ptr<PlanStage> clone() const final;
 
     void prepare(CompileCtx& ctx) final;
@@ -56,47 +91,142 @@ public:
     std::unique_ptr<PlanStageStats> getStats() const final;
     const SpecificStats* getSpecificStats() const final;
     std::vector<DebugPrinter::Block> debugPrint() const final;
+    size_t estimateCompileTimeSize() const final;
 
 private:
-    using TableType = std::unordered_multimap<value::MaterializedRow,  // NOLINT
-                                              value::MaterializedRow,
-                                              value::MaterializedRowHasher>;
-
-    using HashKeyAccessor = value::MaterializedRowKeyAccessor<TableType::iterator>;
-    using HashProjectAccessor = value::MaterializedRowValueAccessor<TableType::iterator>;
+    // A row is a pair of the join key and the projected values.
+    using Row = std::pair<value::MaterializedRow, value::MaterializedRow>;
+    using RowKeyAccessor = value::MaterializedRowKeyAccessor<Row*>;
+    using RowProjectAccessor = value::MaterializedRowValueAccessor<Row*>;
+    using RowIterator = SortIteratorInterface<value::MaterializedRow, value::MaterializedRow>;
+    using RowWriter = SortedFileWriter<value::MaterializedRow, value::MaterializedRow>;
+
+    static constexpr size_t kNoRow = std::numeric_limits<size_t>::max();
+
+    struct Partition {
+        Partition();
+        Partition(Partition&&);
+        ~Partition();
+
+        // The build rows of a partition which is still held in memory, with their hashes.
+        std::vector<Row> rows;
+        std::vector<size_t> hashes;
+        size_t memUsage{0};
+
+        // Set once the partition has been written out to disk. From then on, all rows belonging to
+        // the partition go straight to the writers.
+        bool spilled{false};
+        std::unique_ptr<RowWriter> buildWriter;
+        std::unique_ptr<RowWriter> probeWriter;
+        std::shared_ptr<RowIterator> buildRun;
+    };
+
+    // A spilled partition waiting to be joined once the current probe input is exhausted.
+    struct PendingPartition {
+        std::shared_ptr<RowIterator> buildRun;
+        std::shared_ptr<RowIterator> probeRun;
+        size_t level;
+    };
+
+    size_t partitionOf(size_t hash) const;
+
+    /**
+     * Adds a row to the build side, spilling partitions to disk if the memory limit is exceeded.
+     */
+    void addBuildRow(Row row, size_t hash);
+
+    /**
+     * Writes the largest in-memory partitions to disk until the build side fits in memory again.
+     */
+    void spillPartitions();
+
+    /**
+     * Moves the rows of all in-memory partitions into the arena and builds the hash table over it.
+     */
+    void finishBuild();
+
+    /**
+     * Returns the index of the first arena row whose key is equal to 'key', or 'kNoRow'.
+     */
+    size_t findMatch(size_t hash, const value::MaterializedRow& key) const;
+
+    /**
+     * Loads the next probe row into '_probeRow', setting aside rows belonging to spilled
+     * partitions. When the current probe input is exhausted, moves on to the next pending spilled
+     * partition. Returns false once there is nothing left to probe.
+     */
+    bool nextProbeRow();
+
+    /**
+     * Turns the spilled partitions of the current level into pending partitions.
+     */
+    void scheduleSpilledPartitions();
+
+    /**
+     * Builds the hash table over the build rows of a pending partition and starts probing it with
+     * the probe rows set aside for it.
+     */
+    void openPendingPartition(PendingPartition partition);
+
+    void resetBuildSide();
+    void clearSpilledState();
+
+    std::string makeSpillFile();
 
     const value::SlotVector _outerCond;
     const value::SlotVector _outerProjects;
     const value::SlotVector _innerCond;
     const value::SlotVector _innerProjects;
+    const size_t _memoryLimit;
+    const bool _allowDiskUse;
 
-    // All defined values from the outer side (i.e. they come from the hash table).
-    value::SlotAccessorMap _outOuterAccessors;
+    // All defined values from the outer side (i.e. they come from the hash table) and the inner
+    // key and projection values (i.e. they come from the current probe row).
+    value::SlotAccessorMap _outAccessors;
+    std::vector<std::unique_ptr<value::SlotAccessor>> _ownedAccessors;
 
     // Accessors of input codition values (keys) that are being inserted into the hash table.
     std::vector<value::SlotAccessor*> _inOuterKeyAccessors;
 
-    // Accessors of output keys.
-    std::vector<std::unique_ptr<HashKeyAccessor>> _outOuterKeyAccessors;
-
     // Accessors of input projection values that are build inserted into the hash table.
     std::vector<value::SlotAccessor*> _inOuterProjectAccessors;
 
-    // Accessors of output projections.
-    std::vector<std::unique_ptr<HashProjectAccessor>> _outOuterProjectAccessors;
-
-    // Accessors of input codition values (keys) that are being inserted into the hash table.
+    // Accessors of input codition values (keys) and projections of the probe side.
     std::vector<value::SlotAccessor*> _inInnerKeyAccessors;
-
-    // Key used to probe inside the hash table.
-    value::MaterializedRow _probeKey;
-
-    TableType _ht;
-    TableType::iterator _htIt;
-    TableType::iterator _htItEnd;
+    std::vector<value::SlotAccessor*> _inInnerProjectAccessors;
+
+    // The arena of build rows and their hashes.
+    std::vector<Row> _buildRows;
+    std::vector<size_t> _buildHashes;
+    // For every arena row, the index of the next row with an equal key, or 'kNoRow'.
+    std::vector<size_t> _nextDuplicate;
+    // The open-addressing hash table. Holds the arena index plus one of the first row of every
+    // distinct key, or zero for an empty slot. The size is always a power of two.
+    std::vector<size_t> _slots;
+    size_t _slotMask{0};
+
+    // The build row being returned, and the current probe row (key, projections) with its hash.
+    Row* _buildRowIt{nullptr};
+    Row _probeRow;
+    Row* _probeRowIt{&_probeRow};
+    size_t _probeHash{0};
+    size_t _matchIdx{kNoRow};
+
+    // Approximate number of bytes held by the in-memory build rows.
+    size_t _memoryUseBytes{0};
+
+    // The recursion level of the partitions being joined, zero while reading from the children.
+    size_t _level{0};
+    std::vector<Partition> _partitions;
+    std::vector<PendingPartition> _pendingPartitions;
+    bool _probeFromChild{false};
+    std::shared_ptr<RowIterator> _probeIt;
+    std::vector<std::string> _spillFiles;
 
     vm::ByteCode _bytecode;
 
+    HashJoinStats _specificStats;
+
     bool _compiled{false};
 };
 }  // namespace mongo::sbe
@@ -33,6 +33,7 @@
 
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/exec/sbe/expressions/expression.h"
+#include "mongo/db/exec/sbe/size_estimator.h"
 #include "mongo/db/exec/sbe/values/bson.h"
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/repl/replication_coordinator.h"
@@ -159,6 +160,10 @@ void IndexScanStage::doAttachFromOperationContext(OperationContext* opCtx) {
     }
 }
 
+void IndexScanStage::doAttachToTrialRunTracker(TrialRunProgressTracker* tracker) {
+    _tracker = tracker;
+}
+
 void IndexScanStage::open(bool reOpen) {
     _commonStats.opens++;
 
@@ -363,4 +368,12 @@ std::vector<DebugPrinter::Block> IndexScanStage::debugPrint() const {
 
     return ret;
 }
+
+size_t IndexScanStage::estimateCompileTimeSize() const {
+    size_t size = sizeof(*this);
+    size += size_estimator::estimate(_children);
+    size += size_estimator::estimate(_indexName);
+    size += size_estimator::estimate(_vars);
+    return size;
+}
 }  // namespace mongo::sbe
@@ -84,12 +84,14 @@ public:
     std::unique_ptr<PlanStageStats> getStats() const final;
     const SpecificStats* getSpecificStats() const final;
     std::vector<DebugPrinter::Block> debugPrint() const final;
+    size_t estimateCompileTimeSize() const final;
 
 protected:
     void doSaveState() override;
     void doRestoreState() override;
     void doDetachFromOperationContext() override;
     void doAttachFromOperationContext(OperationContext* opCtx) override;
+    void doAttachToTrialRunTracker(TrialRunProgressTracker* tracker) override;
 
 private:
     const NamespaceStringOrUUID _name;
@@ -31,6 +31,8 @@
 
 #include "mongo/db/exec/sbe/stages/limit_skip.h"
 
+#include "mongo/db/exec/sbe/size_estimator.h"
+
 namespace mongo::sbe {
 LimitSkipStage::LimitSkipStage(std::unique_ptr<PlanStage> input,
                                boost::optional<long long> limit,
@@ -112,4 +114,10 @@ std::vector<DebugPrinter::Block> LimitSkipStage::debugPrint() const {
 
     return ret;
 }
+
+size_t LimitSkipStage::estimateCompileTimeSize() const {
+    size_t size = sizeof(*this);
+    size += size_estimator::estimate(_children);
+    return size;
+}
 }  // namespace mongo::sbe
@@ -31,6 +31,7 @@
 
 #include "mongo/db/exec/sbe/stages/makeobj.h"
 
+#include "mongo/db/exec/sbe/size_estimator.h"
 #include "mongo/db/exec/sbe/values/bson.h"
 #include "mongo/util/str.h"
 
@@ -251,4 +252,13 @@ std::vector<DebugPrinter::Block> MakeObjStage::debugPrint() const {
 
     return ret;
 }
+
+size_t MakeObjStage::estimateCompileTimeSize() const {
+    size_t size = sizeof(*this);
+    size += size_estimator::estimate(_children);
+    size += size_estimator::estimate(_restrictFields);
+    size += size_estimator::estimate(_projectFields);
+    size += size_estimator::estimate(_projectVars);
+    return size;
+}
 }  // namespace mongo::sbe
@@ -111,6 +111,25 @@ struct LimitSkipStats : public SpecificStats {
     boost::optional<long long> skip;
 };
 
+struct HashJoinStats : public SpecificStats {
+    SpecificStats* clone() const final {
+        return new HashJoinStats(*this);
+    }
+
+    uint64_t estimateObjectSizeInBytes() const {
+        return sizeof(*this);
+    }
+
+    bool usedDisk{false};
+    // The number of partitions written out to disk, over all recursion levels.
+    size_t spilledPartitions{0};
+    size_t spilledBuildRecords{0};
+    size_t spilledProbeRecords{0};
+    size_t spilledBytes{0};
+    // The deepest level of re-partitioning reached.
+    size_t maxRecursionDepth{0};
+};
+
 /**
  * Calculates the total number of physical reads in the given plan stats tree. If a stage can do
  * a physical read (e.g. COLLSCAN or IXSCAN), then its 'numReads' stats is added to the total.
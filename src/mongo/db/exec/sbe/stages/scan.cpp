@@ -32,6 +32,8 @@
 #include "mongo/db/exec/sbe/stages/scan.h"
 
 #include "mongo/db/exec/sbe/expressions/expression.h"
+#include "mongo/db/exec/sbe/size_estimator.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/util/str.h"
 
@@ -86,12 +88,12 @@ void ScanStage::prepare(CompileCtx& ctx) {
     }
 
     for (size_t idx = 0; idx < _fields.size(); ++idx) {
-        auto [it, inserted] =
-            _fieldAccessors.emplace(_fields[idx], std::make_unique<value::ViewOfValueAccessor>());
-        uassert(4822814, str::stream() << "duplicate field: " << _fields[idx], inserted);
-        auto [itRename, insertedRename] = _varAccessors.emplace(_vars[idx], it->second.get());
+        auto accessor = _fieldExtractor.addField(_fields[idx]);
+        uassert(4822814, str::stream() << "duplicate field: " << _fields[idx], accessor);
+        auto [itRename, insertedRename] = _varAccessors.emplace(_vars[idx], accessor);
         uassert(4822815, str::stream() << "duplicate field: " << _vars[idx], insertedRename);
     }
+    _fieldExtractor.compile();
 
     if (_seekKeySlot) {
         _seekKeyAccessor = ctx.getAccessor(*_seekKeySlot);
@@ -157,6 +159,10 @@ void ScanStage::doAttachFromOperationContext(OperationContext* opCtx) {
     }
 }
 
+void ScanStage::doAttachToTrialRunTracker(TrialRunProgressTracker* tracker) {
+    _tracker = tracker;
+}
+
 void ScanStage::open(bool reOpen) {
     _commonStats.opens++;
     invariant(_opCtx);
@@ -198,6 +204,9 @@ void ScanStage::open(bool reOpen) {
 
     _open = true;
     _firstGetNext = true;
+    _batch.clear();
+    _batchPosition = 0;
+    _batchSize = 1;
 }
 
 PlanState ScanStage::getNext() {
@@ -205,10 +214,27 @@ PlanState ScanStage::getNext() {
         return trackPlanState(PlanState::IS_EOF);
     }
 
-    checkForInterrupt(_opCtx);
-
-    auto nextRecord =
-        (_firstGetNext && _seekKeyAccessor) ? _cursor->seekExact(_key) : _cursor->next();
+    // A scan without a seek key reads its records in batches, and only checks for interrupts and
+    // yields before reading each batch.
+    boost::optional<Record> seekRecord;
+    const Record* nextRecord = nullptr;
+    if (_seekKeyAccessor) {
+        checkForInterrupt(_opCtx);
+        seekRecord = _firstGetNext ? _cursor->seekExact(_key) : _cursor->next();
+        nextRecord = seekRecord.get_ptr();
+    } else {
+        if (_batchPosition == _batch.size()) {
+            checkForInterrupt(_opCtx);
+            _batchPosition = 0;
+            const size_t maxBatchSize = internalQueryExecScanBatchSize.load();
+            const size_t batchSize = std::min(_batchSize, maxBatchSize);
+            _batchSize = std::min(batchSize * 2, maxBatchSize);
+            _cursor->nextBatch(batchSize, &_batch);
+        }
+        if (_batchPosition < _batch.size()) {
+            nextRecord = &_batch[_batchPosition++];
+        }
+    }
     _firstGetNext = false;
 
     if (!nextRecord) {
@@ -225,30 +251,8 @@ PlanState ScanStage::getNext() {
                                  value::bitcastFrom<int64_t>(nextRecord->id.repr()));
     }
 
-    if (!_fieldAccessors.empty()) {
-        auto fieldsToMatch = _fieldAccessors.size();
-        auto rawBson = nextRecord->data.data();
-        auto be = rawBson + 4;
-        auto end = rawBson + ConstDataView(rawBson).read<LittleEndian<uint32_t>>();
-        for (auto& [name, accessor] : _fieldAccessors) {
-            accessor->reset();
-        }
-        while (*be != 0) {
-            auto sv = bson::fieldNameView(be);
-            if (auto it = _fieldAccessors.find(sv); it != _fieldAccessors.end()) {
-                // Found the field so convert it to Value.
-                auto [tag, val] = bson::convertFrom(true, be, end, sv.size());
-
-                it->second->reset(tag, val);
-
-                if ((--fieldsToMatch) == 0) {
-                    // No need to scan any further so bail out early.
-                    break;
-                }
-            }
-
-            be = bson::advance(be, sv.size());
-        }
+    if (!_fieldExtractor.empty()) {
+        _fieldExtractor.extract(nextRecord->data.data());
     }
 
     if (_tracker && _tracker->trackProgress<TrialRunProgressTracker::kNumReads>(1)) {
@@ -264,6 +268,8 @@ PlanState ScanStage::getNext() {
 
 void ScanStage::close() {
     _commonStats.closes++;
+    _batch.clear();
+    _batchPosition = 0;
     _cursor.reset();
     _coll.reset();
     _open = false;
@@ -318,6 +324,14 @@ std::vector<DebugPrinter::Block> ScanStage::debugPrint() const {
     return ret;
 }
 
+size_t ScanStage::estimateCompileTimeSize() const {
+    size_t size = sizeof(*this);
+    size += size_estimator::estimate(_children);
+    size += size_estimator::estimate(_fields);
+    size += size_estimator::estimate(_vars);
+    return size;
+}
+
 ParallelScanStage::ParallelScanStage(const NamespaceStringOrUUID& name,
                                      boost::optional<value::SlotId> recordSlot,
                                      boost::optional<value::SlotId> recordIdSlot,
@@ -336,27 +350,10 @@ ParallelScanStage::ParallelScanStage(const NamespaceStringOrUUID& name,
     _state = std::make_shared<ParallelState>();
 }
 
-ParallelScanStage::ParallelScanStage(const std::shared_ptr<ParallelState>& state,
-                                     const NamespaceStringOrUUID& name,
-                                     boost::optional<value::SlotId> recordSlot,
-                                     boost::optional<value::SlotId> recordIdSlot,
-                                     std::vector<std::string> fields,
-                                     value::SlotVector vars,
-                                     PlanYieldPolicy* yieldPolicy,
-                                     PlanNodeId nodeId)
-    : PlanStage("pscan"_sd, yieldPolicy, nodeId),
-      _name(name),
-      _recordSlot(recordSlot),
-      _recordIdSlot(recordIdSlot),
-      _fields(std::move(fields)),
-      _vars(std::move(vars)),
-      _state(state) {
-    invariant(_fields.size() == _vars.size());
-}
-
 std::unique_ptr<PlanStage> ParallelScanStage::clone() const {
-    return std::make_unique<ParallelScanStage>(_state,
-                                               _name,
+    // The clone gets state of its own. The copies of the scan run by the producers of an exchange
+    // share their state through the compile context instead, see prepare().
+    return std::make_unique<ParallelScanStage>(_name,
                                                _recordSlot,
                                                _recordIdSlot,
                                                _fields,
@@ -366,6 +363,10 @@ std::unique_ptr<PlanStage> ParallelScanStage::clone() const {
 }
 
 void ParallelScanStage::prepare(CompileCtx& ctx) {
+    if (ctx.smpSharedState) {
+        _state = ctx.smpSharedState->getOrCreate<ParallelState>(_commonStats.nodeId);
+    }
+
     if (_recordSlot) {
         _recordAccessor = std::make_unique<value::ViewOfValueAccessor>();
     }
@@ -375,12 +376,12 @@ void ParallelScanStage::prepare(CompileCtx& ctx) {
     }
 
     for (size_t idx = 0; idx < _fields.size(); ++idx) {
-        auto [it, inserted] =
-            _fieldAccessors.emplace(_fields[idx], std::make_unique<value::ViewOfValueAccessor>());
-        uassert(4822816, str::stream() << "duplicate field: " << _fields[idx], inserted);
-        auto [itRename, insertedRename] = _varAccessors.emplace(_vars[idx], it->second.get());
+        auto accessor = _fieldExtractor.addField(_fields[idx]);
+        uassert(4822816, str::stream() << "duplicate field: " << _fields[idx], accessor);
+        auto [itRename, insertedRename] = _varAccessors.emplace(_vars[idx], accessor);
         uassert(4822817, str::stream() << "duplicate field: " << _vars[idx], insertedRename);
     }
+    _fieldExtractor.compile();
 }
 
 value::SlotAccessor* ParallelScanStage::getAccessor(CompileCtx& ctx, value::SlotId slot) {
@@ -537,30 +538,8 @@ PlanState ParallelScanStage::getNext() {
     }
 
 
-    if (!_fieldAccessors.empty()) {
-        auto fieldsToMatch = _fieldAccessors.size();
-        auto rawBson = nextRecord->data.data();
-        auto be = rawBson + 4;
-        auto end = rawBson + ConstDataView(rawBson).read<LittleEndian<uint32_t>>();
-        for (auto& [name, accessor] : _fieldAccessors) {
-            accessor->reset();
-        }
-        while (*be != 0) {
-            auto sv = bson::fieldNameView(be);
-            if (auto it = _fieldAccessors.find(sv); it != _fieldAccessors.end()) {
-                // Found the field so convert it to Value.
-                auto [tag, val] = bson::convertFrom(true, be, end, sv.size());
-
-                it->second->reset(tag, val);
-
-                if ((--fieldsToMatch) == 0) {
-                    // No need to scan any further so bail out early.
-                    break;
-                }
-            }
-
-            be = bson::advance(be, sv.size());
-        }
+    if (!_fieldExtractor.empty()) {
+        _fieldExtractor.extract(nextRecord->data.data());
     }
 
     return PlanState::ADVANCED;
@@ -611,5 +590,13 @@ std::vector<DebugPrinter::Block> ParallelScanStage::debugPrint() const {
 
     return ret;
 }
+
+size_t ParallelScanStage::estimateCompileTimeSize() const {
+    size_t size = sizeof(*this);
+    size += size_estimator::estimate(_children);
+    size += size_estimator::estimate(_fields);
+    size += size_estimator::estimate(_vars);
+    return size;
+}
 }  // namespace sbe
 }  // namespace mongo
@@ -32,6 +32,7 @@
 #include "mongo/db/db_raii.h"
 #include "mongo/db/exec/sbe/stages/stages.h"
 #include "mongo/db/exec/sbe/values/bson.h"
+#include "mongo/db/exec/sbe/values/bson_field_extractor.h"
 #include "mongo/db/exec/trial_run_progress_tracker.h"
 #include "mongo/db/storage/record_store.h"
 
@@ -64,12 +65,14 @@ public:
     std::unique_ptr<PlanStageStats> getStats() const final;
     const SpecificStats* getSpecificStats() const final;
     std::vector<DebugPrinter::Block> debugPrint() const final;
+    size_t estimateCompileTimeSize() const final;
 
 protected:
     void doSaveState() override;
     void doRestoreState() override;
     void doDetachFromOperationContext() override;
     void doAttachFromOperationContext(OperationContext* opCtx) override;
+    void doAttachToTrialRunTracker(TrialRunProgressTracker* tracker) override;
 
 private:
     const NamespaceStringOrUUID _name;
@@ -89,7 +92,7 @@ private:
     std::unique_ptr<value::ViewOfValueAccessor> _recordAccessor;
     std::unique_ptr<value::ViewOfValueAccessor> _recordIdAccessor;
 
-    value::FieldAccessorMap _fieldAccessors;
+    bson::FieldExtractor _fieldExtractor;
     value::SlotAccessorMap _varAccessors;
     value::SlotAccessor* _seekKeyAccessor{nullptr};
 
@@ -100,6 +103,12 @@ private:
     RecordId _key;
     bool _firstGetNext{false};
 
+    // Records read ahead from '_cursor' when there is no seek key, the position of the next one to
+    // return and the number of records to ask for next.
+    std::vector<Record> _batch;
+    size_t _batchPosition{0};
+    size_t _batchSize{1};
+
     ScanStats _specificStats;
 };
 
@@ -123,15 +132,6 @@ public:
                       PlanYieldPolicy* yieldPolicy,
                       PlanNodeId nodeId);
 
-    ParallelScanStage(const std::shared_ptr<ParallelState>& state,
-                      const NamespaceStringOrUUID& name,
-                      boost::optional<value::SlotId> recordSlot,
-                      boost::optional<value::SlotId> recordIdSlot,
-                      std::vector<std::string> fields,
-                      value::SlotVector vars,
-                      PlanYieldPolicy* yieldPolicy,
-                      PlanNodeId nodeId);
-
     std::unique_ptr<PlanStage> clone() const final;
 
     void prepare(CompileCtx& ctx) final;
@@ -143,6 +143,7 @@ public:
     std::unique_ptr<PlanStageStats> getStats() const final;
     const SpecificStats* getSpecificStats() const final;
     std::vector<DebugPrinter::Block> debugPrint() const final;
+    size_t estimateCompileTimeSize() const final;
 
 protected:
     void doSaveState() final;
@@ -170,7 +171,7 @@ private:
     std::unique_ptr<value::ViewOfValueAccessor> _recordAccessor;
     std::unique_ptr<value::ViewOfValueAccessor> _recordIdAccessor;
 
-    value::FieldAccessorMap _fieldAccessors;
+    bson::FieldExtractor _fieldExtractor;
     value::SlotAccessorMap _varAccessors;
 
     size_t _currentRange{std::numeric_limits<std::size_t>::max()};
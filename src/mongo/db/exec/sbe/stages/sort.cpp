@@ -32,6 +32,7 @@
 #include "mongo/db/exec/sbe/stages/sort.h"
 
 #include "mongo/db/exec/sbe/expressions/expression.h"
+#include "mongo/db/exec/sbe/size_estimator.h"
 #include "mongo/util/str.h"
 
 namespace {
@@ -208,6 +209,10 @@ void SortStage::close() {
     _sorter.reset();
 }
 
+void SortStage::doAttachToTrialRunTracker(TrialRunProgressTracker* tracker) {
+    _tracker = tracker;
+}
+
 std::unique_ptr<PlanStageStats> SortStage::getStats() const {
     auto ret = std::make_unique<PlanStageStats>(_commonStats);
     ret->children.emplace_back(_children[0]->getStats());
@@ -251,5 +256,14 @@ std::vector<DebugPrinter::Block> SortStage::debugPrint() const {
 
     return ret;
 }
+
+size_t SortStage::estimateCompileTimeSize() const {
+    size_t size = sizeof(*this);
+    size += size_estimator::estimate(_children);
+    size += size_estimator::estimate(_obs);
+    size += size_estimator::estimate(_dirs);
+    size += size_estimator::estimate(_vals);
+    return size;
+}
 }  // namespace sbe
 }  // namespace mongo
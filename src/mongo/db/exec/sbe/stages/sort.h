@@ -65,6 +65,10 @@ public:
     std::unique_ptr<PlanStageStats> getStats() const final;
     const SpecificStats* getSpecificStats() const final;
     std::vector<DebugPrinter::Block> debugPrint() const final;
+    size_t estimateCompileTimeSize() const final;
+
+protected:
+    void doAttachToTrialRunTracker(TrialRunProgressTracker* tracker) override;
 
 private:
     void makeSorter();
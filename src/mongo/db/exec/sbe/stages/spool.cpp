@@ -146,6 +146,13 @@ std::vector<DebugPrinter::Block> SpoolEagerProducerStage::debugPrint() const {
     return ret;
 }
 
+size_t SpoolEagerProducerStage::estimateCompileTimeSize() const {
+    size_t size = sizeof(*this);
+    size += size_estimator::estimate(_children);
+    size += size_estimator::estimate(_vals);
+    return size;
+}
+
 SpoolLazyProducerStage::SpoolLazyProducerStage(std::unique_ptr<PlanStage> input,
                                                SpoolId spoolId,
                                                value::SlotVector vals,
@@ -285,4 +292,12 @@ std::vector<DebugPrinter::Block> SpoolLazyProducerStage::debugPrint() const {
     DebugPrinter::addBlocks(ret, _children[0]->debugPrint());
     return ret;
 }
+
+size_t SpoolLazyProducerStage::estimateCompileTimeSize() const {
+    size_t size = sizeof(*this);
+    size += size_estimator::estimate(_children);
+    size += size_estimator::estimate(_vals);
+    size += size_estimator::estimate(_predicate);
+    return size;
+}
 }  // namespace mongo::sbe
@@ -30,6 +30,7 @@
 #pragma once
 
 #include "mongo/db/exec/sbe/expressions/expression.h"
+#include "mongo/db/exec/sbe/size_estimator.h"
 #include "mongo/db/exec/sbe/stages/stages.h"
 
 namespace mongo::sbe {
@@ -64,6 +65,7 @@ public:
     std::unique_ptr<PlanStageStats> getStats() const final;
     const SpecificStats* getSpecificStats() const final;
     std::vector<DebugPrinter::Block> debugPrint() const final;
+    size_t estimateCompileTimeSize() const final;
 
 private:
     std::shared_ptr<SpoolBuffer> _buffer{nullptr};
@@ -112,6 +114,7 @@ public:
     std::unique_ptr<PlanStageStats> getStats() const final;
     const SpecificStats* getSpecificStats() const final;
     std::vector<DebugPrinter::Block> debugPrint() const final;
+    size_t estimateCompileTimeSize() const final;
 
 private:
     std::shared_ptr<SpoolBuffer> _buffer{nullptr};
@@ -242,6 +245,12 @@ public:
         return ret;
     }
 
+    size_t estimateCompileTimeSize() const {
+        size_t size = sizeof(*this);
+        size += size_estimator::estimate(_vals);
+        return size;
+    }
+
 private:
     std::shared_ptr<SpoolBuffer> _buffer{nullptr};
     size_t _bufferIt{0};
@@ -75,5 +75,24 @@ void CanChangeState::restoreState() {
 
     doRestoreState();
 }
+
+void PlanStage::attachNewYieldPolicy(PlanYieldPolicy* yieldPolicy) {
+    for (auto&& child : _children) {
+        child->attachNewYieldPolicy(yieldPolicy);
+    }
+
+    // Stages built without a yield policy only check for interrupts, and keep doing so.
+    if (_yieldPolicy) {
+        _yieldPolicy = yieldPolicy;
+    }
+}
+
+void PlanStage::attachToTrialRunTracker(TrialRunProgressTracker* tracker) {
+    for (auto&& child : _children) {
+        child->attachToTrialRunTracker(tracker);
+    }
+
+    doAttachToTrialRunTracker(tracker);
+}
 }  // namespace sbe
 }  // namespace mongo
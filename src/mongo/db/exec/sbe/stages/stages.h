@@ -38,6 +38,8 @@
 #include "mongo/db/query/plan_yield_policy.h"
 
 namespace mongo {
+class TrialRunProgressTracker;
+
 namespace sbe {
 
 struct CompileCtx;
@@ -208,7 +210,7 @@ public:
     }
 
 protected:
-    PlanYieldPolicy* const _yieldPolicy{nullptr};
+    PlanYieldPolicy* _yieldPolicy{nullptr};
 
 private:
     static const int kInterruptCheckPeriod = 128;
@@ -275,10 +277,37 @@ public:
 
     virtual std::vector<DebugPrinter::Block> debugPrint() const = 0;
 
+    /**
+     * Returns an estimate of the memory held by this tree before it is prepared: the stages, their
+     * expressions and their parameters, but not the state they build to run.
+     */
+    virtual size_t estimateCompileTimeSize() const = 0;
+
+    /**
+     * Makes the stages of this tree which yield do so according to 'yieldPolicy' instead of the
+     * policy they were built with. Must be called before prepare() on a tree cloned from a plan
+     * which was built for another operation.
+     *
+     * Propagates to all children.
+     */
+    void attachNewYieldPolicy(PlanYieldPolicy* yieldPolicy);
+
+    /**
+     * Makes the stages of this tree which track the progress of a trial run report it to
+     * 'tracker'. Must be called before prepare() on a tree cloned from a plan whose tracker has
+     * been destroyed.
+     *
+     * Propagates to all children, then calls doAttachToTrialRunTracker().
+     */
+    void attachToTrialRunTracker(TrialRunProgressTracker* tracker);
+
     friend class CanSwitchOperationContext;
     friend class CanChangeState;
 
 protected:
+    // Derived classes which track the progress of a trial run must override this method.
+    virtual void doAttachToTrialRunTracker(TrialRunProgressTracker* tracker) {}
+
     std::vector<std::unique_ptr<PlanStage>> _children;
 };
 
@@ -32,6 +32,7 @@
 #include "mongo/db/exec/sbe/stages/text_match.h"
 
 #include "mongo/db/exec/sbe/expressions/expression.h"
+#include "mongo/db/exec/sbe/size_estimator.h"
 #include "mongo/db/exec/sbe/values/bson.h"
 
 namespace mongo::sbe {
@@ -106,6 +107,12 @@ std::vector<DebugPrinter::Block> TextMatchStage::debugPrint() const {
     return ret;
 }
 
+size_t TextMatchStage::estimateCompileTimeSize() const {
+    size_t size = sizeof(*this);
+    size += size_estimator::estimate(_children);
+    return size;
+}
+
 std::unique_ptr<PlanStageStats> TextMatchStage::getStats() const {
     auto ret = std::make_unique<PlanStageStats>(_commonStats);
     ret->children.emplace_back(_children[0]->getStats());
@@ -70,6 +70,7 @@ public:
     void close() final;
 
     std::vector<DebugPrinter::Block> debugPrint() const final;
+    size_t estimateCompileTimeSize() const final;
 
     std::unique_ptr<PlanStageStats> getStats() const final;
 
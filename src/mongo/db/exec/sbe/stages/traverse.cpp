@@ -31,6 +31,8 @@
 
 #include "mongo/db/exec/sbe/stages/traverse.h"
 
+#include "mongo/db/exec/sbe/size_estimator.h"
+
 namespace mongo::sbe {
 TraverseStage::TraverseStage(std::unique_ptr<PlanStage> outer,
                              std::unique_ptr<PlanStage> inner,
@@ -315,4 +317,13 @@ std::vector<DebugPrinter::Block> TraverseStage::debugPrint() const {
 
     return ret;
 }
+
+size_t TraverseStage::estimateCompileTimeSize() const {
+    size_t size = sizeof(*this);
+    size += size_estimator::estimate(_children);
+    size += size_estimator::estimate(_correlatedSlots);
+    size += size_estimator::estimate(_fold);
+    size += size_estimator::estimate(_final);
+    return size;
+}
 }  // namespace mongo::sbe
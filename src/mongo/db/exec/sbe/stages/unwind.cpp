@@ -31,6 +31,7 @@
 
 #include "mongo/db/exec/sbe/stages/unwind.h"
 
+#include "mongo/db/exec/sbe/size_estimator.h"
 #include "mongo/util/str.h"
 
 namespace mongo::sbe {
@@ -179,4 +180,10 @@ std::vector<DebugPrinter::Block> UnwindStage::debugPrint() const {
 
     return ret;
 }
+
+size_t UnwindStage::estimateCompileTimeSize() const {
+    size_t size = sizeof(*this);
+    size += size_estimator::estimate(_children);
+    return size;
+}
 }  // namespace mongo::sbe
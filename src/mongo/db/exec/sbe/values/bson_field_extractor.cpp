@@ -0,0 +1,94 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/sbe/values/bson_field_extractor.h"
+
+#include <algorithm>
+
+#include "mongo/db/exec/sbe/values/bson.h"
+
+namespace mongo {
+namespace sbe {
+namespace bson {
+value::ViewOfValueAccessor* FieldExtractor::addField(StringData name) {
+    if (std::any_of(_fields.begin(), _fields.end(), [&](const Field& field) {
+            return field.name == name;
+        })) {
+        return nullptr;
+    }
+    _fields.push_back(Field{name.toString(), std::make_unique<value::ViewOfValueAccessor>()});
+    return _fields.back().accessor.get();
+}
+
+void FieldExtractor::compile() {
+    std::stable_sort(_fields.begin(), _fields.end(), [](const Field& lhs, const Field& rhs) {
+        return lengthBucket(lhs.name.size()) < lengthBucket(rhs.name.size());
+    });
+
+    _lengthMask = 0;
+    std::fill(std::begin(_bucketBegin), std::end(_bucketBegin), 0);
+    for (auto&& field : _fields) {
+        const auto bucket = lengthBucket(field.name.size());
+        _lengthMask |= uint64_t{1} << bucket;
+        ++_bucketBegin[bucket + 1];
+    }
+    for (size_t bucket = 0; bucket < kNumLengthBuckets; ++bucket) {
+        _bucketBegin[bucket + 1] += _bucketBegin[bucket];
+    }
+}
+
+void FieldExtractor::extract(const char* bson) {
+    for (auto&& field : _fields) {
+        field.accessor->reset();
+    }
+
+    auto be = bson + 4;
+    auto end = bson + ConstDataView(bson).read<LittleEndian<uint32_t>>();
+    auto fieldsToMatch = _fields.size();
+    while (*be != 0) {
+        auto sv = bson::fieldNameView(be);
+        if (auto field = find(sv)) {
+            // Found the field so convert it to Value.
+            auto [tag, val] = bson::convertFrom(true, be, end, sv.size());
+            field->accessor->reset(tag, val);
+
+            if ((--fieldsToMatch) == 0) {
+                // No need to scan any further so bail out early.
+                break;
+            }
+        }
+
+        be = bson::advance(be, sv.size());
+    }
+}
+}  // namespace bson
+}  // namespace sbe
+}  // namespace mongo
@@ -0,0 +1,115 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "mongo/base/string_data.h"
+#include "mongo/db/exec/sbe/values/slot.h"
+
+namespace mongo {
+namespace sbe {
+namespace bson {
+/**
+ * Extracts the values of a fixed set of top-level fields from BSON objects into slot accessors, for
+ * the stages which scan BSON documents.
+ *
+ * The fields are added before the first call to extract() and are then compiled into a matcher
+ * which rejects most field names with a single test of their length against a bitmask, and only
+ * compares a name with the requested names of the same length whose first byte is the same.
+ */
+class FieldExtractor {
+public:
+    /**
+     * Adds the field 'name' to the fields to extract and returns the accessor which will hold its
+     * value, or nullptr if 'name' has already been added.
+     */
+    value::ViewOfValueAccessor* addField(StringData name);
+
+    /**
+     * Builds the matcher for the fields added so far. Must be called after the last field has been
+     * added and before the first call to extract().
+     */
+    void compile();
+
+    /**
+     * Points the accessor of each field at its value in the BSON object 'bson', or resets it if the
+     * field is missing. The values are views which are valid as long as 'bson' is.
+     */
+    void extract(const char* bson);
+
+    bool empty() const {
+        return _fields.empty();
+    }
+
+private:
+    struct Field {
+        std::string name;
+        std::unique_ptr<value::ViewOfValueAccessor> accessor;
+    };
+
+    // Names of this many bytes or more share the last length bucket.
+    static constexpr size_t kNumLengthBuckets = 64;
+
+    static size_t lengthBucket(size_t length) {
+        return length < kNumLengthBuckets ? length : kNumLengthBuckets - 1;
+    }
+
+    const Field* find(std::string_view name) const {
+        const auto bucket = lengthBucket(name.size());
+        if (!(_lengthMask & (uint64_t{1} << bucket))) {
+            return nullptr;
+        }
+        // A BSON field name is null terminated, so its first byte can be read even when it is
+        // empty.
+        const char firstByte = *name.data();
+        for (auto idx = _bucketBegin[bucket]; idx < _bucketBegin[bucket + 1]; ++idx) {
+            const auto& field = _fields[idx];
+            if (field.name.size() == name.size() && field.name.c_str()[0] == firstByte &&
+                memcmp(field.name.data(), name.data(), name.size()) == 0) {
+                return &field;
+            }
+        }
+        return nullptr;
+    }
+
+    // Sorted by length bucket by compile(), so that the fields of bucket 'i' are those in the range
+    // ['_bucketBegin[i]', '_bucketBegin[i + 1]').
+    std::vector<Field> _fields;
+    uint64_t _lengthMask{0};
+    uint32_t _bucketBegin[kNumLengthBuckets + 1]{};
+};
+}  // namespace bson
+}  // namespace sbe
+}  // namespace mongo
@@ -109,6 +109,16 @@ int Instruction::stackOffset[Instruction::Tags::lastInstruction] = {
     0,   // jmpNothing
 
     -1,  // fail
+
+    0,  // getFieldConst
+    1,  // pushAccessFieldConst
+    0,  // lessConst
+    0,  // lessEqConst
+    0,  // greaterConst
+    0,  // greaterEqConst
+    0,  // eqConst
+    0,  // neqConst
+    0,  // fillEmptyConst
 };
 
 void CodeFragment::adjustStackSimple(const Instruction& i) {
@@ -135,6 +145,12 @@ void CodeFragment::copyCodeAndFixup(const CodeFragment& from) {
         fixUp.offset += _instrs.size();
         _fixUps.push_back(fixUp);
     }
+    for (auto instrOffset : from._instrOffsets) {
+        _instrOffsets.push_back(instrOffset + _instrs.size());
+    }
+    if (from._maxJumpTarget) {
+        _maxJumpTarget = std::max(_maxJumpTarget, from._maxJumpTarget + _instrs.size());
+    }
 
     _instrs.insert(_instrs.end(), from._instrs.begin(), from._instrs.end());
 }
@@ -166,6 +182,7 @@ void CodeFragment::appendConstVal(value::TypeTags tag, value::Value val) {
     i.tag = Instruction::pushConstVal;
     adjustStackSimple(i);
 
+    recordInstruction();
     auto offset = allocateSpace(sizeof(Instruction) + sizeof(tag) + sizeof(val));
 
     offset += value::writeToMemory(offset, i);
@@ -178,6 +195,7 @@ void CodeFragment::appendAccessVal(value::SlotAccessor* accessor) {
     i.tag = Instruction::pushAccessVal;
     adjustStackSimple(i);
 
+    recordInstruction();
     auto offset = allocateSpace(sizeof(Instruction) + sizeof(accessor));
 
     offset += value::writeToMemory(offset, i);
@@ -189,6 +207,7 @@ void CodeFragment::appendMoveVal(value::SlotAccessor* accessor) {
     i.tag = Instruction::pushMoveVal;
     adjustStackSimple(i);
 
+    recordInstruction();
     auto offset = allocateSpace(sizeof(Instruction) + sizeof(accessor));
 
     offset += value::writeToMemory(offset, i);
@@ -203,6 +222,7 @@ void CodeFragment::appendLocalVal(FrameId frameId, int stackOffset) {
     auto fixUpOffset = _instrs.size() + sizeof(Instruction);
     _fixUps.push_back(FixUp{frameId, fixUpOffset});
 
+    recordInstruction();
     auto offset = allocateSpace(sizeof(Instruction) + sizeof(stackOffset));
 
     offset += value::writeToMemory(offset, i);
@@ -218,6 +238,7 @@ void CodeFragment::appendNumericConvert(value::TypeTags targetTag) {
     i.tag = Instruction::numConvert;
     adjustStackSimple(i);
 
+    recordInstruction();
     auto offset = allocateSpace(sizeof(Instruction) + sizeof(targetTag));
 
     offset += value::writeToMemory(offset, i);
@@ -257,13 +278,63 @@ void CodeFragment::appendSimpleInstruction(Instruction::Tags tag) {
     i.tag = tag;
     adjustStackSimple(i);
 
+    recordInstruction();
     auto offset = allocateSpace(sizeof(Instruction));
 
     offset += value::writeToMemory(offset, i);
 }
 
+bool CodeFragment::canFuseLast(Instruction::Tags tag) const {
+    if (_instrOffsets.empty()) {
+        return false;
+    }
+
+    auto start = _instrOffsets.back();
+    return value::readFromMemory<Instruction>(_instrs.data() + start).tag == tag &&
+        _maxJumpTarget <= start;
+}
+
+void CodeFragment::appendConstOperandInstruction(Instruction::Tags tag,
+                                                 Instruction::Tags fusedTag) {
+    if (!canFuseLast(Instruction::pushConstVal)) {
+        appendSimpleInstruction(tag);
+        return;
+    }
+
+    Instruction i;
+    i.tag = tag;
+    adjustStackSimple(i);
+
+    // The fused instruction has the same layout as pushConstVal so only the opcode is rewritten.
+    Instruction fused;
+    fused.tag = fusedTag;
+    value::writeToMemory(_instrs.data() + _instrOffsets.back(), fused);
+}
+
 void CodeFragment::appendGetField() {
-    appendSimpleInstruction(Instruction::getField);
+    if (!canFuseLast(Instruction::pushConstVal)) {
+        appendSimpleInstruction(Instruction::getField);
+        return;
+    }
+
+    Instruction i;
+    i.tag = Instruction::getField;
+    adjustStackSimple(i);
+
+    auto constOffset = _instrOffsets.back();
+    _instrOffsets.pop_back();
+
+    Instruction fused;
+    if (canFuseLast(Instruction::pushAccessVal)) {
+        // Drop the pushConstVal opcode so the field name directly follows the accessor.
+        fused.tag = Instruction::pushAccessFieldConst;
+        value::writeToMemory(_instrs.data() + _instrOffsets.back(), fused);
+        _instrs.erase(_instrs.begin() + constOffset);
+    } else {
+        fused.tag = Instruction::getFieldConst;
+        value::writeToMemory(_instrs.data() + constOffset, fused);
+        _instrOffsets.push_back(constOffset);
+    }
 }
 
 void CodeFragment::appendGetElement() {
@@ -331,6 +402,7 @@ void CodeFragment::appendTypeMatch(uint32_t typeMask) {
     i.tag = Instruction::typeMatch;
     adjustStackSimple(i);
 
+    recordInstruction();
     auto offset = allocateSpace(sizeof(Instruction) + sizeof(typeMask));
 
     offset += value::writeToMemory(offset, i);
@@ -346,6 +418,7 @@ void CodeFragment::appendFunction(Builtin f, uint8_t arity) {
     // and the return value.
     _stackSize += 1;
 
+    recordInstruction();
     auto offset = allocateSpace(sizeof(Instruction) + sizeof(f) + sizeof(arity));
 
     offset += value::writeToMemory(offset, i);
@@ -358,10 +431,13 @@ void CodeFragment::appendJump(int jumpOffset) {
     i.tag = Instruction::jmp;
     adjustStackSimple(i);
 
+    recordInstruction();
     auto offset = allocateSpace(sizeof(Instruction) + sizeof(jumpOffset));
 
     offset += value::writeToMemory(offset, i);
     offset += value::writeToMemory(offset, jumpOffset);
+
+    recordJump(jumpOffset);
 }
 
 void CodeFragment::appendJumpTrue(int jumpOffset) {
@@ -369,10 +445,13 @@ void CodeFragment::appendJumpTrue(int jumpOffset) {
     i.tag = Instruction::jmpTrue;
     adjustStackSimple(i);
 
+    recordInstruction();
     auto offset = allocateSpace(sizeof(Instruction) + sizeof(jumpOffset));
 
     offset += value::writeToMemory(offset, i);
     offset += value::writeToMemory(offset, jumpOffset);
+
+    recordJump(jumpOffset);
 }
 
 void CodeFragment::appendJumpNothing(int jumpOffset) {
@@ -380,10 +459,13 @@ void CodeFragment::appendJumpNothing(int jumpOffset) {
     i.tag = Instruction::jmpNothing;
     adjustStackSimple(i);
 
+    recordInstruction();
     auto offset = allocateSpace(sizeof(Instruction) + sizeof(jumpOffset));
 
     offset += value::writeToMemory(offset, i);
     offset += value::writeToMemory(offset, jumpOffset);
+
+    recordJump(jumpOffset);
 }
 
 ByteCode::~ByteCode() {
@@ -1834,7 +1916,142 @@ std::tuple<bool, value::TypeTags, value::Value> ByteCode::dispatchBuiltin(Builti
     MONGO_UNREACHABLE;
 }
 
+namespace {
+/**
+ * Compares two values of the same primitive type. Returns false if there is no direct comparison
+ * for the type and the generic (type converting) comparison must be used instead.
+ */
+template <typename Op>
+MONGO_COMPILER_ALWAYS_INLINE bool compareSameTypeFast(value::TypeTags tag,
+                                                      value::Value lhsValue,
+                                                      value::Value rhsValue,
+                                                      bool& result,
+                                                      Op op = {}) {
+    switch (tag) {
+        case value::TypeTags::NumberInt32:
+            result = op(value::bitcastTo<int32_t>(lhsValue), value::bitcastTo<int32_t>(rhsValue));
+            return true;
+        case value::TypeTags::NumberInt64:
+        case value::TypeTags::Date:
+            result = op(value::bitcastTo<int64_t>(lhsValue), value::bitcastTo<int64_t>(rhsValue));
+            return true;
+        case value::TypeTags::NumberDouble:
+            result = op(value::bitcastTo<double>(lhsValue), value::bitcastTo<double>(rhsValue));
+            return true;
+        default:
+            return false;
+    }
+}
+}  // namespace
+
+template <typename Op, typename GenericFn>
+void ByteCode::compareTopWithConst(value::TypeTags constTag,
+                                   value::Value constVal,
+                                   GenericFn genericFn) {
+    auto [owned, tag, val] = getFromStack(0);
+
+    bool result;
+    if (tag == constTag && compareSameTypeFast<Op>(tag, val, constVal, result)) {
+        topStack(false, value::TypeTags::Boolean, value::bitcastFrom<bool>(result));
+    } else {
+        auto [resultTag, resultVal] = genericFn(tag, val, constTag, constVal);
+        topStack(false, resultTag, resultVal);
+    }
+
+    if (owned) {
+        value::releaseValue(tag, val);
+    }
+}
+
+/**
+ * On compilers that support it (GCC and clang) the interpreter uses "labels as values" to jump
+ * directly from the end of one instruction to the next one. This gives every instruction its own
+ * indirect branch which the CPU can predict much better than the single shared branch of the
+ * switch. Other compilers fall back to the plain switch dispatch.
+ */
+#if defined(__GNUC__)
+#define SBE_VM_COMPUTED_GOTO
+#endif
+
+#ifdef SBE_VM_COMPUTED_GOTO
+#define SBE_VM_CASE(name)   \
+    case Instruction::name: \
+    label_##name:
+#define SBE_VM_NEXT()                                      \
+    if (MONGO_unlikely(pcPointer == pcEnd)) {              \
+        break;                                             \
+    }                                                      \
+    i = value::readFromMemory<Instruction>(pcPointer);     \
+    pcPointer += sizeof(i);                                \
+    goto* kDispatchTable[i.tag]
+#else
+#define SBE_VM_CASE(name) case Instruction::name:
+#define SBE_VM_NEXT() break
+#endif
+
 std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragment* code) {
+#ifdef SBE_VM_COMPUTED_GOTO
+    // This table must be kept in sync with Instruction::Tags.
+    static const void* const kDispatchTable[] = {
+        &&label_pushConstVal,
+        &&label_pushAccessVal,
+        &&label_pushMoveVal,
+        &&label_pushLocalVal,
+        &&label_pop,
+        &&label_swap,
+        &&label_add,
+        &&label_sub,
+        &&label_mul,
+        &&label_div,
+        &&label_idiv,
+        &&label_mod,
+        &&label_negate,
+        &&label_numConvert,
+        &&label_logicNot,
+        &&label_less,
+        &&label_lessEq,
+        &&label_greater,
+        &&label_greaterEq,
+        &&label_eq,
+        &&label_neq,
+        &&label_cmp3w,
+        &&label_fillEmpty,
+        &&label_getField,
+        &&label_getElement,
+        &&label_aggSum,
+        &&label_aggMin,
+        &&label_aggMax,
+        &&label_aggFirst,
+        &&label_aggLast,
+        &&label_exists,
+        &&label_isNull,
+        &&label_isObject,
+        &&label_isArray,
+        &&label_isString,
+        &&label_isNumber,
+        &&label_isBinData,
+        &&label_isDate,
+        &&label_isNaN,
+        &&label_typeMatch,
+        &&label_function,
+        &&label_jmp,
+        &&label_jmpTrue,
+        &&label_jmpNothing,
+        &&label_fail,
+        &&label_getFieldConst,
+        &&label_pushAccessFieldConst,
+        &&label_lessConst,
+        &&label_lessEqConst,
+        &&label_greaterConst,
+        &&label_greaterEqConst,
+        &&label_eqConst,
+        &&label_neqConst,
+        &&label_fillEmptyConst,
+    };
+    static_assert(sizeof(kDispatchTable) / sizeof(kDispatchTable[0]) ==
+                  Instruction::Tags::lastInstruction);
+#endif
+
     auto pcPointer = code->instrs().data();
     auto pcEnd = pcPointer + code->instrs().size();
 
@@ -1845,7 +2062,7 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
             Instruction i = value::readFromMemory<Instruction>(pcPointer);
             pcPointer += sizeof(i);
             switch (i.tag) {
-                case Instruction::pushConstVal: {
+                SBE_VM_CASE(pushConstVal) {
                     auto tag = value::readFromMemory<value::TypeTags>(pcPointer);
                     pcPointer += sizeof(tag);
                     auto val = value::readFromMemory<value::Value>(pcPointer);
@@ -1853,27 +2070,27 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
 
                     pushStack(false, tag, val);
 
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::pushAccessVal: {
+                SBE_VM_CASE(pushAccessVal) {
                     auto accessor = value::readFromMemory<value::SlotAccessor*>(pcPointer);
                     pcPointer += sizeof(accessor);
 
                     auto [tag, val] = accessor->getViewOfValue();
                     pushStack(false, tag, val);
 
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::pushMoveVal: {
+                SBE_VM_CASE(pushMoveVal) {
                     auto accessor = value::readFromMemory<value::SlotAccessor*>(pcPointer);
                     pcPointer += sizeof(accessor);
 
                     auto [tag, val] = accessor->copyOrMoveValue();
                     pushStack(true, tag, val);
 
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::pushLocalVal: {
+                SBE_VM_CASE(pushLocalVal) {
                     auto stackOffset = value::readFromMemory<int>(pcPointer);
                     pcPointer += sizeof(stackOffset);
 
@@ -1881,9 +2098,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
 
                     pushStack(false, tag, val);
 
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::pop: {
+                SBE_VM_CASE(pop) {
                     auto [owned, tag, val] = getFromStack(0);
                     popStack();
 
@@ -1891,9 +2108,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
                         value::releaseValue(tag, val);
                     }
 
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::swap: {
+                SBE_VM_CASE(swap) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(1);
 
@@ -1909,9 +2126,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
                         invariant(!rhsOwned);
                     }
 
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::add: {
+                SBE_VM_CASE(add) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
@@ -1926,9 +2143,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
                     if (lhsOwned) {
                         value::releaseValue(lhsTag, lhsVal);
                     }
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::sub: {
+                SBE_VM_CASE(sub) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
@@ -1943,9 +2160,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
                     if (lhsOwned) {
                         value::releaseValue(lhsTag, lhsVal);
                     }
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::mul: {
+                SBE_VM_CASE(mul) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
@@ -1960,9 +2177,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
                     if (lhsOwned) {
                         value::releaseValue(lhsTag, lhsVal);
                     }
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::div: {
+                SBE_VM_CASE(div) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
@@ -1977,9 +2194,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
                     if (lhsOwned) {
                         value::releaseValue(lhsTag, lhsVal);
                     }
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::idiv: {
+                SBE_VM_CASE(idiv) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
@@ -1994,9 +2211,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
                     if (lhsOwned) {
                         value::releaseValue(lhsTag, lhsVal);
                     }
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::mod: {
+                SBE_VM_CASE(mod) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
@@ -2011,9 +2228,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
                     if (lhsOwned) {
                         value::releaseValue(lhsTag, lhsVal);
                     }
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::negate: {
+                SBE_VM_CASE(negate) {
                     auto [owned, tag, val] = getFromStack(0);
 
                     auto [resultOwned, resultTag, resultVal] = genericSub(
@@ -2025,9 +2242,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
                         value::releaseValue(resultTag, resultVal);
                     }
 
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::numConvert: {
+                SBE_VM_CASE(numConvert) {
                     auto tag = value::readFromMemory<value::TypeTags>(pcPointer);
                     pcPointer += sizeof(tag);
 
@@ -2041,9 +2258,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
                         value::releaseValue(lhsTag, lhsVal);
                     }
 
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::logicNot: {
+                SBE_VM_CASE(logicNot) {
                     auto [owned, tag, val] = getFromStack(0);
 
                     auto [resultOwned, resultTag, resultVal] = genericNot(tag, val);
@@ -2053,9 +2270,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
                     if (owned) {
                         value::releaseValue(tag, val);
                     }
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::less: {
+                SBE_VM_CASE(less) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
@@ -2070,9 +2287,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
                     if (lhsOwned) {
                         value::releaseValue(lhsTag, lhsVal);
                     }
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::lessEq: {
+                SBE_VM_CASE(lessEq) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
@@ -2088,9 +2305,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
                     if (lhsOwned) {
                         value::releaseValue(lhsTag, lhsVal);
                     }
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::greater: {
+                SBE_VM_CASE(greater) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
@@ -2106,9 +2323,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
                     if (lhsOwned) {
                         value::releaseValue(lhsTag, lhsVal);
                     }
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::greaterEq: {
+                SBE_VM_CASE(greaterEq) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
@@ -2124,9 +2341,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
                     if (lhsOwned) {
                         value::releaseValue(lhsTag, lhsVal);
                     }
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::eq: {
+                SBE_VM_CASE(eq) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
@@ -2141,9 +2358,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
                     if (lhsOwned) {
                         value::releaseValue(lhsTag, lhsVal);
                     }
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::neq: {
+                SBE_VM_CASE(neq) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
@@ -2158,9 +2375,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
                     if (lhsOwned) {
                         value::releaseValue(lhsTag, lhsVal);
                     }
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::cmp3w: {
+                SBE_VM_CASE(cmp3w) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
@@ -2175,9 +2392,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
                     if (lhsOwned) {
                         value::releaseValue(lhsTag, lhsVal);
                     }
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::fillEmpty: {
+                SBE_VM_CASE(fillEmpty) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
@@ -2193,9 +2410,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
                             value::releaseValue(rhsTag, rhsVal);
                         }
                     }
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::getField: {
+                SBE_VM_CASE(getField) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
@@ -2210,9 +2427,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
                     if (lhsOwned) {
                         value::releaseValue(lhsTag, lhsVal);
                     }
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::getElement: {
+                SBE_VM_CASE(getElement) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
@@ -2227,9 +2444,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
                     if (lhsOwned) {
                         value::releaseValue(lhsTag, lhsVal);
                     }
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::aggSum: {
+                SBE_VM_CASE(aggSum) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
@@ -2244,9 +2461,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
                     if (lhsOwned) {
                         value::releaseValue(lhsTag, lhsVal);
                     }
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::aggMin: {
+                SBE_VM_CASE(aggMin) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
@@ -2261,9 +2478,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
                     if (lhsOwned) {
                         value::releaseValue(lhsTag, lhsVal);
                     }
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::aggMax: {
+                SBE_VM_CASE(aggMax) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
@@ -2278,9 +2495,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
                     if (lhsOwned) {
                         value::releaseValue(lhsTag, lhsVal);
                     }
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::aggFirst: {
+                SBE_VM_CASE(aggFirst) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
@@ -2295,9 +2512,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
                     if (lhsOwned) {
                         value::releaseValue(lhsTag, lhsVal);
                     }
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::aggLast: {
+                SBE_VM_CASE(aggLast) {
                     auto [rhsOwned, rhsTag, rhsVal] = getFromStack(0);
                     popStack();
                     auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
@@ -2312,9 +2529,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
                     if (lhsOwned) {
                         value::releaseValue(lhsTag, lhsVal);
                     }
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::exists: {
+                SBE_VM_CASE(exists) {
                     auto [owned, tag, val] = getFromStack(0);
 
                     topStack(false,
@@ -2324,9 +2541,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
                     if (owned) {
                         value::releaseValue(tag, val);
                     }
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::isNull: {
+                SBE_VM_CASE(isNull) {
                     auto [owned, tag, val] = getFromStack(0);
 
                     if (tag != value::TypeTags::Nothing) {
@@ -2338,9 +2555,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
                     if (owned) {
                         value::releaseValue(tag, val);
                     }
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::isObject: {
+                SBE_VM_CASE(isObject) {
                     auto [owned, tag, val] = getFromStack(0);
 
                     if (tag != value::TypeTags::Nothing) {
@@ -2352,9 +2569,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
                     if (owned) {
                         value::releaseValue(tag, val);
                     }
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::isArray: {
+                SBE_VM_CASE(isArray) {
                     auto [owned, tag, val] = getFromStack(0);
 
                     if (tag != value::TypeTags::Nothing) {
@@ -2366,9 +2583,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
                     if (owned) {
                         value::releaseValue(tag, val);
                     }
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::isString: {
+                SBE_VM_CASE(isString) {
                     auto [owned, tag, val] = getFromStack(0);
 
                     if (tag != value::TypeTags::Nothing) {
@@ -2380,9 +2597,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
                     if (owned) {
                         value::releaseValue(tag, val);
                     }
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::isNumber: {
+                SBE_VM_CASE(isNumber) {
                     auto [owned, tag, val] = getFromStack(0);
 
                     if (tag != value::TypeTags::Nothing) {
@@ -2394,9 +2611,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
                     if (owned) {
                         value::releaseValue(tag, val);
                     }
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::isBinData: {
+                SBE_VM_CASE(isBinData) {
                     auto [owned, tag, val] = getFromStack(0);
 
                     if (tag != value::TypeTags::Nothing) {
@@ -2408,9 +2625,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
                     if (owned) {
                         value::releaseValue(tag, val);
                     }
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::isDate: {
+                SBE_VM_CASE(isDate) {
                     auto [owned, tag, val] = getFromStack(0);
 
                     if (tag != value::TypeTags::Nothing) {
@@ -2422,9 +2639,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
                     if (owned) {
                         value::releaseValue(tag, val);
                     }
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::isNaN: {
+                SBE_VM_CASE(isNaN) {
                     auto [owned, tag, val] = getFromStack(0);
 
                     if (tag != value::TypeTags::Nothing) {
@@ -2436,9 +2653,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
                     if (owned) {
                         value::releaseValue(tag, val);
                     }
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::typeMatch: {
+                SBE_VM_CASE(typeMatch) {
                     auto typeMask = value::readFromMemory<uint32_t>(pcPointer);
                     pcPointer += sizeof(typeMask);
 
@@ -2453,9 +2670,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
                     if (owned) {
                         value::releaseValue(tag, val);
                     }
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::function: {
+                SBE_VM_CASE(function) {
                     auto f = value::readFromMemory<Builtin>(pcPointer);
                     pcPointer += sizeof(f);
                     auto arity = value::readFromMemory<uint8_t>(pcPointer);
@@ -2473,16 +2690,16 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
 
                     pushStack(owned, tag, val);
 
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::jmp: {
+                SBE_VM_CASE(jmp) {
                     auto jumpOffset = value::readFromMemory<int>(pcPointer);
                     pcPointer += sizeof(jumpOffset);
 
                     pcPointer += jumpOffset;
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::jmpTrue: {
+                SBE_VM_CASE(jmpTrue) {
                     auto jumpOffset = value::readFromMemory<int>(pcPointer);
                     pcPointer += sizeof(jumpOffset);
 
@@ -2496,9 +2713,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
                     if (owned) {
                         value::releaseValue(tag, val);
                     }
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::jmpNothing: {
+                SBE_VM_CASE(jmpNothing) {
                     auto jumpOffset = value::readFromMemory<int>(pcPointer);
                     pcPointer += sizeof(jumpOffset);
 
@@ -2506,9 +2723,9 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
                     if (tag == value::TypeTags::Nothing) {
                         pcPointer += jumpOffset;
                     }
-                    break;
+                    SBE_VM_NEXT();
                 }
-                case Instruction::fail: {
+                SBE_VM_CASE(fail) {
                     auto [ownedCode, tagCode, valCode] = getFromStack(1);
                     invariant(tagCode == value::TypeTags::NumberInt64);
 
@@ -2521,7 +2738,125 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
 
                     uasserted(code, message);
 
-                    break;
+                    SBE_VM_NEXT();
+                }
+                SBE_VM_CASE(getFieldConst) {
+                    auto fieldTag = value::readFromMemory<value::TypeTags>(pcPointer);
+                    pcPointer += sizeof(fieldTag);
+                    auto fieldVal = value::readFromMemory<value::Value>(pcPointer);
+                    pcPointer += sizeof(fieldVal);
+
+                    auto [lhsOwned, lhsTag, lhsVal] = getFromStack(0);
+
+                    auto [owned, tag, val] = getField(lhsTag, lhsVal, fieldTag, fieldVal);
+
+                    topStack(owned, tag, val);
+
+                    if (lhsOwned) {
+                        value::releaseValue(lhsTag, lhsVal);
+                    }
+                    SBE_VM_NEXT();
+                }
+                SBE_VM_CASE(pushAccessFieldConst) {
+                    auto accessor = value::readFromMemory<value::SlotAccessor*>(pcPointer);
+                    pcPointer += sizeof(accessor);
+                    auto fieldTag = value::readFromMemory<value::TypeTags>(pcPointer);
+                    pcPointer += sizeof(fieldTag);
+                    auto fieldVal = value::readFromMemory<value::Value>(pcPointer);
+                    pcPointer += sizeof(fieldVal);
+
+                    auto [objTag, objVal] = accessor->getViewOfValue();
+                    auto [owned, tag, val] = getField(objTag, objVal, fieldTag, fieldVal);
+
+                    pushStack(owned, tag, val);
+
+                    SBE_VM_NEXT();
+                }
+                SBE_VM_CASE(lessConst) {
+                    auto constTag = value::readFromMemory<value::TypeTags>(pcPointer);
+                    pcPointer += sizeof(constTag);
+                    auto constVal = value::readFromMemory<value::Value>(pcPointer);
+                    pcPointer += sizeof(constVal);
+
+                    compareTopWithConst<std::less<>>(constTag, constVal, [this](auto... args) {
+                        return genericCompare<std::less<>>(args...);
+                    });
+                    SBE_VM_NEXT();
+                }
+                SBE_VM_CASE(lessEqConst) {
+                    auto constTag = value::readFromMemory<value::TypeTags>(pcPointer);
+                    pcPointer += sizeof(constTag);
+                    auto constVal = value::readFromMemory<value::Value>(pcPointer);
+                    pcPointer += sizeof(constVal);
+
+                    compareTopWithConst<std::less_equal<>>(
+                        constTag, constVal, [this](auto... args) {
+                            return genericCompare<std::less_equal<>>(args...);
+                        });
+                    SBE_VM_NEXT();
+                }
+                SBE_VM_CASE(greaterConst) {
+                    auto constTag = value::readFromMemory<value::TypeTags>(pcPointer);
+                    pcPointer += sizeof(constTag);
+                    auto constVal = value::readFromMemory<value::Value>(pcPointer);
+                    pcPointer += sizeof(constVal);
+
+                    compareTopWithConst<std::greater<>>(constTag, constVal, [this](auto... args) {
+                        return genericCompare<std::greater<>>(args...);
+                    });
+                    SBE_VM_NEXT();
+                }
+                SBE_VM_CASE(greaterEqConst) {
+                    auto constTag = value::readFromMemory<value::TypeTags>(pcPointer);
+                    pcPointer += sizeof(constTag);
+                    auto constVal = value::readFromMemory<value::Value>(pcPointer);
+                    pcPointer += sizeof(constVal);
+
+                    compareTopWithConst<std::greater_equal<>>(
+                        constTag, constVal, [this](auto... args) {
+                            return genericCompare<std::greater_equal<>>(args...);
+                        });
+                    SBE_VM_NEXT();
+                }
+                SBE_VM_CASE(eqConst) {
+                    auto constTag = value::readFromMemory<value::TypeTags>(pcPointer);
+                    pcPointer += sizeof(constTag);
+                    auto constVal = value::readFromMemory<value::Value>(pcPointer);
+                    pcPointer += sizeof(constVal);
+
+                    compareTopWithConst<std::equal_to<>>(constTag, constVal, [this](auto... args) {
+                        return genericCompareEq(args...);
+                    });
+                    SBE_VM_NEXT();
+                }
+                SBE_VM_CASE(neqConst) {
+                    auto constTag = value::readFromMemory<value::TypeTags>(pcPointer);
+                    pcPointer += sizeof(constTag);
+                    auto constVal = value::readFromMemory<value::Value>(pcPointer);
+                    pcPointer += sizeof(constVal);
+
+                    compareTopWithConst<std::not_equal_to<>>(
+                        constTag, constVal, [this](auto... args) {
+                            return genericCompareNeq(args...);
+                        });
+                    SBE_VM_NEXT();
+                }
+                SBE_VM_CASE(fillEmptyConst) {
+                    auto constTag = value::readFromMemory<value::TypeTags>(pcPointer);
+                    pcPointer += sizeof(constTag);
+                    auto constVal = value::readFromMemory<value::Value>(pcPointer);
+                    pcPointer += sizeof(constVal);
+
+                    auto [owned, tag, val] = getFromStack(0);
+
+                    if (tag == value::TypeTags::Nothing) {
+                        topStack(false, constTag, constVal);
+
+                        if (owned) {
+                            value::releaseValue(tag, val);
+                        }
+                    }
+                    SBE_VM_NEXT();
                 }
                 default:
                     MONGO_UNREACHABLE;
@@ -2542,6 +2877,10 @@ std::tuple<uint8_t, value::TypeTags, value::Value> ByteCode::run(const CodeFragm
     return {owned, tag, val};
 }
 
+#undef SBE_VM_NEXT
+#undef SBE_VM_CASE
+#undef SBE_VM_COMPUTED_GOTO
+
 bool ByteCode::runPredicate(const CodeFragment* code) {
     auto [owned, tag, val] = run(code);
 
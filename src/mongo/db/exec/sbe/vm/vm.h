@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <vector>
@@ -161,6 +162,19 @@ struct Instruction {
 
         fail,
 
+        // Superinstructions. These are never emitted directly by the expression compiler; the
+        // CodeFragment fuses common instruction sequences into them as code is appended. All of
+        // them carry the constant operand inline in the same layout as pushConstVal.
+        getFieldConst,         // pushConstVal + getField
+        pushAccessFieldConst,  // pushAccessVal + pushConstVal + getField
+        lessConst,             // pushConstVal + less
+        lessEqConst,           // pushConstVal + lessEq
+        greaterConst,          // pushConstVal + greater
+        greaterEqConst,        // pushConstVal + greaterEq
+        eqConst,               // pushConstVal + eq
+        neqConst,              // pushConstVal + neq
+        fillEmptyConst,        // pushConstVal + fillEmpty
+
         lastInstruction  // this is just a marker used to calculate number of instructions
     };
 
@@ -255,28 +269,28 @@ public:
     void appendNegate();
     void appendNot();
     void appendLess() {
-        appendSimpleInstruction(Instruction::less);
+        appendConstOperandInstruction(Instruction::less, Instruction::lessConst);
     }
     void appendLessEq() {
-        appendSimpleInstruction(Instruction::lessEq);
+        appendConstOperandInstruction(Instruction::lessEq, Instruction::lessEqConst);
     }
     void appendGreater() {
-        appendSimpleInstruction(Instruction::greater);
+        appendConstOperandInstruction(Instruction::greater, Instruction::greaterConst);
     }
     void appendGreaterEq() {
-        appendSimpleInstruction(Instruction::greaterEq);
+        appendConstOperandInstruction(Instruction::greaterEq, Instruction::greaterEqConst);
     }
     void appendEq() {
-        appendSimpleInstruction(Instruction::eq);
+        appendConstOperandInstruction(Instruction::eq, Instruction::eqConst);
     }
     void appendNeq() {
-        appendSimpleInstruction(Instruction::neq);
+        appendConstOperandInstruction(Instruction::neq, Instruction::neqConst);
     }
     void appendCmp3w() {
         appendSimpleInstruction(Instruction::cmp3w);
     }
     void appendFillEmpty() {
-        appendSimpleInstruction(Instruction::fillEmpty);
+        appendConstOperandInstruction(Instruction::fillEmpty, Instruction::fillEmptyConst);
     }
     void appendGetField();
     void appendGetElement();
@@ -306,6 +320,26 @@ public:
 
 private:
     void appendSimpleInstruction(Instruction::Tags tag);
+
+    /**
+     * Appends the binary instruction 'tag'. If the right hand side operand was pushed by the
+     * immediately preceding pushConstVal, the two instructions are fused into 'fusedTag' that
+     * carries the constant inline.
+     */
+    void appendConstOperandInstruction(Instruction::Tags tag, Instruction::Tags fusedTag);
+
+    /**
+     * Returns true if the last instruction in this fragment is 'tag' and it can be fused with the
+     * instruction that is about to be appended; i.e. no jump lands anywhere after its start.
+     */
+    bool canFuseLast(Instruction::Tags tag) const;
+    void recordInstruction() {
+        _instrOffsets.push_back(_instrs.size());
+    }
+    void recordJump(int jumpOffset) {
+        _maxJumpTarget = std::max(_maxJumpTarget, _instrs.size() + jumpOffset);
+    }
+
     auto allocateSpace(size_t size) {
         auto oldSize = _instrs.size();
         _instrs.resize(oldSize + size);
@@ -331,6 +365,18 @@ private:
     };
     std::vector<FixUp> _fixUps;
 
+    /**
+     * Offsets of the first byte of every instruction in '_instrs'. Used by the superinstruction
+     * fusion to find the instructions at the tail of the fragment.
+     */
+    std::vector<size_t> _instrOffsets;
+
+    /**
+     * The largest offset in '_instrs' that is a target of a jump, or 0 if there are no jumps. An
+     * instruction boundary that is a jump target must never be fused away.
+     */
+    size_t _maxJumpTarget{0};
+
     int _stackSize{0};
 };
 
@@ -404,6 +450,14 @@ private:
         return genericNumericCompare(lhsTag, lhsValue, rhsTag, rhsValue, op);
     }
 
+    /**
+     * Compares the top of the stack against a constant operand of a fused comparison instruction
+     * and replaces the top of the stack with the result. When both sides have the same primitive
+     * type the comparison is done directly, otherwise it is delegated to 'genericFn'.
+     */
+    template <typename Op, typename GenericFn>
+    void compareTopWithConst(value::TypeTags constTag, value::Value constVal, GenericFn genericFn);
+
     std::pair<value::TypeTags, value::Value> genericCompareEq(value::TypeTags lhsTag,
                                                               value::Value lhsValue,
                                                               value::TypeTags rhsTag,
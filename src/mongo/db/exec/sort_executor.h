@@ -141,6 +141,8 @@ public:
         }
         _output.reset(_sorter->done());
         _stats.wasDiskUsed = _stats.wasDiskUsed || _sorter->usedDisk();
+        _stats.spilledDataSizeBytes += _sorter->spillStats().uncompressedBytes;
+        _stats.spilledBytesWritten += _sorter->spillStats().bytesWritten;
         _sorter.reset();
     }
 
@@ -178,10 +180,18 @@ private:
             opts.limit = _stats.limit;
         }
 
+        // 'sortThreads' keeps its default of 1. Comparing Value sort keys may lazily fill in the
+        // field cache of a DocumentStorage which several keys share, so it is not safe to do from
+        // more than one thread.
         opts.maxMemoryUsageBytes = _stats.maxMemoryUsageBytes;
         if (_diskUseAllowed) {
             opts.extSortAllowed = true;
             opts.tempDir = _tempDir;
+            opts.readAheadBlocks = internalSorterReadAheadBlocks.load();
+            opts.directIO = internalSorterUseDirectIO.load();
+            opts.spillCompressor =
+                uassertStatusOK(parseSorterSpillCompressor(internalSorterSpillCompressor));
+            opts.spillCompressionLevel = internalSorterSpillCompressionLevel.load();
         }
 
         return opts;
@@ -32,12 +32,17 @@
 #include "mongo/db/ftdc/block_compressor.h"
 
 #include <zlib.h>
+#include <zstd.h>
 
 #include "mongo/util/str.h"
 
 namespace mongo {
 
-StatusWith<ConstDataRange> BlockCompressor::compress(ConstDataRange source) {
+StatusWith<ConstDataRange> BlockCompressor::compress(ConstDataRange source, Codec codec) {
+    if (codec == Codec::kZstd) {
+        return _compressZstd(source);
+    }
+
     z_stream stream;
     int level = Z_DEFAULT_COMPRESSION;
 
@@ -78,7 +83,12 @@ StatusWith<ConstDataRange> BlockCompressor::compress(ConstDataRange source) {
 }
 
 StatusWith<ConstDataRange> BlockCompressor::uncompress(ConstDataRange source,
-                                                       size_t uncompressedLength) {
+                                                       size_t uncompressedLength,
+                                                       Codec codec) {
+    if (codec == Codec::kZstd) {
+        return _uncompressZstd(source, uncompressedLength);
+    }
+
     z_stream stream;
 
     stream.next_in = reinterpret_cast<unsigned char*>(const_cast<char*>(source.data()));
@@ -115,4 +125,30 @@ StatusWith<ConstDataRange> BlockCompressor::uncompress(ConstDataRange source,
     return ConstDataRange(_buffer.data(), stream.total_out);
 }
 
+StatusWith<ConstDataRange> BlockCompressor::_compressZstd(ConstDataRange source) {
+    _buffer.resize(ZSTD_compressBound(source.length()));
+
+    size_t ret = ZSTD_compress(
+        _buffer.data(), _buffer.size(), source.data(), source.length(), ZSTD_CLEVEL_DEFAULT);
+    if (ZSTD_isError(ret)) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "ZSTD_compress failed with " << ZSTD_getErrorName(ret)};
+    }
+
+    return ConstDataRange(_buffer.data(), ret);
+}
+
+StatusWith<ConstDataRange> BlockCompressor::_uncompressZstd(ConstDataRange source,
+                                                            size_t uncompressedLength) {
+    _buffer.resize(uncompressedLength);
+
+    size_t ret = ZSTD_decompress(_buffer.data(), _buffer.size(), source.data(), source.length());
+    if (ZSTD_isError(ret)) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "ZSTD_decompress failed with " << ZSTD_getErrorName(ret)};
+    }
+
+    return ConstDataRange(_buffer.data(), ret);
+}
+
 }  // namespace mongo
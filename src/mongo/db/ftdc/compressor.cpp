@@ -37,12 +37,45 @@
 #include "mongo/db/ftdc/varint.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/service_context.h"
+#include "mongo/platform/bits.h"
 #include "mongo/util/assert_util.h"
 
 namespace mongo {
 
 using std::swap;
 
+namespace {
+
+std::uint64_t zigZagEncode(std::uint64_t delta) {
+    return (delta << 1) ^ static_cast<std::uint64_t>(static_cast<std::int64_t>(delta) >> 63);
+}
+
+/**
+ * Returns the number of bits needed to represent 'value'.
+ */
+std::uint32_t significantBits(std::uint64_t value) {
+    return value == 0 ? 0 : 64 - countLeadingZeros64(value);
+}
+
+/**
+ * Packs a group of FTDCCompressor::kColumnarGroupSize values, each of which fits in 'bitWidth'
+ * bits, into the 'bitWidth' bytes at 'out', least significant bit first.
+ */
+void packGroup(const std::uint64_t* values, std::uint32_t bitWidth, char* out) {
+    std::fill(out, out + bitWidth, 0);
+    for (std::uint32_t k = 0; k < FTDCCompressor::kColumnarGroupSize; k++) {
+        const std::uint32_t firstBit = k * bitWidth;
+        std::uint32_t written = 0;
+        while (written < bitWidth) {
+            const std::uint32_t bit = firstBit + written;
+            out[bit / 8] |= static_cast<char>((values[k] >> written) << (bit % 8));
+            written += 8 - bit % 8;
+        }
+    }
+}
+
+}  // namespace
+
 StatusWith<boost::optional<std::tuple<ConstDataRange, FTDCCompressor::CompressorState, Date_t>>>
 FTDCCompressor::addSample(const BSONObj& sample, Date_t date) {
     if (_referenceDoc.isEmpty()) {
@@ -129,58 +162,69 @@ StatusWith<std::tuple<ConstDataRange, Date_t>> FTDCCompressor::getCompressedSamp
     _uncompressedChunkBuffer.appendNum(static_cast<std::uint32_t>(_deltaCount));
 
     if (_metricsCount != 0 && _deltaCount != 0) {
-        // On average, we do not need all 10 bytes for every sample, worst case, we grow the buffer
-        DataBuilder db(_metricsCount * _deltaCount * FTDCVarInt::kMaxSizeBytes64 / 2);
-
-        std::uint32_t zeroesCount = 0;
-
-        // For each set of samples for a particular metric,
-        // we think of it is simple array of 64-bit integers we try to compress into a byte array.
-        // This is done in three steps for each metric
-        // 1. Delta Compression
-        //   - i.e., we store the difference between pairs of samples, not their absolute values
-        //   - this is done in addSamples
-        // 2. Run Length Encoding of zeros
-        //   - We find consecutive sets of zeros and represent them as a tuple of (0, count - 1).
-        //   - Each memeber is stored as VarInt packed integer
-        // 3. Finally, for non-zero members, we store these as VarInt packed
-        //
-        // These byte arrays are added to a buffer which is then concatenated with other chunks and
-        // compressed with ZLIB.
-        for (std::uint32_t i = 0; i < _metricsCount; i++) {
-            for (std::uint32_t j = 0; j < _deltaCount; j++) {
-                std::uint64_t delta = _deltas[getArrayOffset(_maxDeltas, j, i)];
-
-                if (delta == 0) {
-                    ++zeroesCount;
-                    continue;
-                }
+        if (_config->metricChunkFormat == FTDCMetricChunkFormat::kColumnar) {
+            _appendColumnarDeltas();
+        } else {
+            Status status = _appendVarIntDeltas();
+            if (!status.isOK()) {
+                return status;
+            }
+        }
+    }
 
-                // If we have a non-zero sample, then write out all the accumulated zero samples.
-                if (zeroesCount > 0) {
-                    auto s1 = db.writeAndAdvance(FTDCVarInt(0));
-                    if (!s1.isOK()) {
-                        return s1;
-                    }
+    auto swDest = _compressor.compress(
+        ConstDataRange(_uncompressedChunkBuffer.buf(), _uncompressedChunkBuffer.len()),
+        _config->metricChunkFormat == FTDCMetricChunkFormat::kColumnar
+            ? BlockCompressor::Codec::kZstd
+            : BlockCompressor::Codec::kZlib);
 
-                    auto s2 = db.writeAndAdvance(FTDCVarInt(zeroesCount - 1));
-                    if (!s2.isOK()) {
-                        return s2;
-                    }
+    // The only way for compression to fail is if the buffer size calculations are wrong
+    if (!swDest.isOK()) {
+        return swDest.getStatus();
+    }
 
-                    zeroesCount = 0;
-                }
+    _compressedChunkBuffer.setlen(0);
 
-                auto s3 = db.writeAndAdvance(FTDCVarInt(delta));
-                if (!s3.isOK()) {
-                    return s3;
-                }
+    _compressedChunkBuffer.appendNum(static_cast<std::uint32_t>(_uncompressedChunkBuffer.len()));
+
+    _compressedChunkBuffer.appendBuf(swDest.getValue().data(), swDest.getValue().length());
+
+    return std::tuple<ConstDataRange, Date_t>(
+        ConstDataRange(_compressedChunkBuffer.buf(),
+                       static_cast<size_t>(_compressedChunkBuffer.len())),
+        _referenceDocDate);
+}
+
+Status FTDCCompressor::_appendVarIntDeltas() {
+    // On average, we do not need all 10 bytes for every sample, worst case, we grow the buffer
+    DataBuilder db(_metricsCount * _deltaCount * FTDCVarInt::kMaxSizeBytes64 / 2);
+
+    std::uint32_t zeroesCount = 0;
+
+    // For each set of samples for a particular metric,
+    // we think of it is simple array of 64-bit integers we try to compress into a byte array.
+    // This is done in three steps for each metric
+    // 1. Delta Compression
+    //   - i.e., we store the difference between pairs of samples, not their absolute values
+    //   - this is done in addSamples
+    // 2. Run Length Encoding of zeros
+    //   - We find consecutive sets of zeros and represent them as a tuple of (0, count - 1).
+    //   - Each memeber is stored as VarInt packed integer
+    // 3. Finally, for non-zero members, we store these as VarInt packed
+    //
+    // These byte arrays are added to a buffer which is then concatenated with other chunks and
+    // compressed with ZLIB.
+    for (std::uint32_t i = 0; i < _metricsCount; i++) {
+        for (std::uint32_t j = 0; j < _deltaCount; j++) {
+            std::uint64_t delta = _deltas[getArrayOffset(_maxDeltas, j, i)];
+
+            if (delta == 0) {
+                ++zeroesCount;
+                continue;
             }
 
-            // If we are on the last metric, and the previous loop ended in a zero, write out the
-            // RLE
-            // pair of zero information.
-            if ((i == (_metricsCount - 1)) && zeroesCount) {
+            // If we have a non-zero sample, then write out all the accumulated zero samples.
+            if (zeroesCount > 0) {
                 auto s1 = db.writeAndAdvance(FTDCVarInt(0));
                 if (!s1.isOK()) {
                     return s1;
@@ -190,32 +234,78 @@ StatusWith<std::tuple<ConstDataRange, Date_t>> FTDCCompressor::getCompressedSamp
                 if (!s2.isOK()) {
                     return s2;
                 }
+
+                zeroesCount = 0;
+            }
+
+            auto s3 = db.writeAndAdvance(FTDCVarInt(delta));
+            if (!s3.isOK()) {
+                return s3;
             }
         }
 
-        // Append the entire compacted metric chunk into the uncompressed buffer
-        ConstDataRange cdr = db.getCursor();
-        _uncompressedChunkBuffer.appendBuf(cdr.data(), cdr.length());
+        // If we are on the last metric, and the previous loop ended in a zero, write out the
+        // RLE
+        // pair of zero information.
+        if ((i == (_metricsCount - 1)) && zeroesCount) {
+            auto s1 = db.writeAndAdvance(FTDCVarInt(0));
+            if (!s1.isOK()) {
+                return s1;
+            }
+
+            auto s2 = db.writeAndAdvance(FTDCVarInt(zeroesCount - 1));
+            if (!s2.isOK()) {
+                return s2;
+            }
+        }
     }
 
-    auto swDest = _compressor.compress(
-        ConstDataRange(_uncompressedChunkBuffer.buf(), _uncompressedChunkBuffer.len()));
+    // Append the entire compacted metric chunk into the uncompressed buffer
+    ConstDataRange cdr = db.getCursor();
+    _uncompressedChunkBuffer.appendBuf(cdr.data(), cdr.length());
 
-    // The only way for compression to fail is if the buffer size calculations are wrong
-    if (!swDest.isOK()) {
-        return swDest.getStatus();
-    }
+    return Status::OK();
+}
 
-    _compressedChunkBuffer.setlen(0);
+void FTDCCompressor::_appendColumnarDeltas() {
+    const std::uint32_t groupCount = (_deltaCount + kColumnarGroupSize - 1) / kColumnarGroupSize;
+    _column.resize(groupCount * kColumnarGroupSize);
+
+    for (std::uint32_t i = 0; i < _metricsCount; i++) {
+        const std::uint64_t* deltas = &_deltas[getArrayOffset(_maxDeltas, 0, i)];
+
+        // ZigZag encode the deltas so that small negative deltas also have few significant bits,
+        // and find the range of the encoded values.
+        std::uint64_t minValue = std::numeric_limits<std::uint64_t>::max();
+        std::uint64_t maxValue = 0;
+        for (std::uint32_t j = 0; j < _deltaCount; j++) {
+            std::uint64_t value = zigZagEncode(deltas[j]);
+            _column[j] = value;
+            minValue = std::min(minValue, value);
+            maxValue = std::max(maxValue, value);
+        }
 
-    _compressedChunkBuffer.appendNum(static_cast<std::uint32_t>(_uncompressedChunkBuffer.len()));
+        // Each metric column starts with the bit width of its packed values, and the frame of
+        // reference they are relative to. A column whose deltas are all the same is just this
+        // header.
+        const std::uint32_t bitWidth = significantBits(maxValue - minValue);
+        _uncompressedChunkBuffer.appendUChar(static_cast<unsigned char>(bitWidth));
+        _uncompressedChunkBuffer.appendNum(static_cast<unsigned long long>(minValue));
+        if (bitWidth == 0) {
+            continue;
+        }
 
-    _compressedChunkBuffer.appendBuf(swDest.getValue().data(), swDest.getValue().length());
+        for (std::uint32_t j = 0; j < _deltaCount; j++) {
+            _column[j] -= minValue;
+        }
+        std::fill(_column.begin() + _deltaCount, _column.end(), 0);
 
-    return std::tuple<ConstDataRange, Date_t>(
-        ConstDataRange(_compressedChunkBuffer.buf(),
-                       static_cast<size_t>(_compressedChunkBuffer.len())),
-        _referenceDocDate);
+        for (std::uint32_t group = 0; group < groupCount; group++) {
+            packGroup(&_column[group * kColumnarGroupSize],
+                      bitWidth,
+                      _uncompressedChunkBuffer.skip(bitWidth));
+        }
+    }
 }
 
 void FTDCCompressor::reset() {
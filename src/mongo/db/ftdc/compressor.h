@@ -56,6 +56,14 @@ namespace mongo {
  * 4. Encodes zeros in Run Length Encoded pairs of <Count, Zero>
  * 5. ZLIB compresses the final processed array
  *
+ * When the config selects FTDCMetricChunkFormat::kColumnar, steps 3 to 5 are instead:
+ * 3. It ZigZag encodes the deltas of each metric, and subtracts the smallest of them (the frame of
+ *    reference) from all of them.
+ * 4. It bit-packs the results with the fewest bits which fit the largest of them, in groups of
+ *    kColumnarGroupSize values which the decompressor unpacks with a routine specialized for that
+ *    bit width.
+ * 5. ZSTD compresses the final processed array
+ *
  * NOTE: This compression ignores non-number data, and assumes the non-number data is constant
  * across all documents in the series of documents.
  */
@@ -144,12 +152,30 @@ public:
         return metric * sampleCount + sample;
     }
 
+    /**
+     * Number of values bit-packed together in the columnar format. A group of values packed with
+     * N bits each takes exactly N bytes.
+     */
+    static constexpr std::uint32_t kColumnarGroupSize = 8;
+
 private:
     /**
      * Reset the state
      */
     void _reset(const BSONObj& referenceDoc, Date_t date);
 
+    /**
+     * Append the deltas to the uncompressed chunk buffer in the FTDCMetricChunkFormat::kVarInt
+     * format.
+     */
+    Status _appendVarIntDeltas();
+
+    /**
+     * Append the deltas to the uncompressed chunk buffer in the FTDCMetricChunkFormat::kColumnar
+     * format.
+     */
+    void _appendColumnarDeltas();
+
 private:
     // Block Compressor
     BlockCompressor _compressor;
@@ -186,6 +212,10 @@ private:
     // Buffer to hold metrics
     std::vector<std::uint64_t> _metrics;
     std::vector<std::uint64_t> _prevmetrics;
+
+    // Buffer to hold the ZigZag encoded deltas of one metric, rounded up to a whole number of
+    // groups
+    std::vector<std::uint64_t> _column;
 };
 
 }  // namespace mongo
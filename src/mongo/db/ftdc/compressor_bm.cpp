@@ -0,0 +1,152 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <random>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/ftdc/compressor.h"
+#include "mongo/db/ftdc/config.h"
+#include "mongo/db/ftdc/decompressor.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace {
+
+constexpr int kSampleCount = 300;
+
+/**
+ * Builds a deterministic stream of serverStatus-like samples. Like the real thing, most metrics
+ * are constants or zero, some are counters that grow at different rates, and the rest are gauges
+ * that drift around a level.
+ */
+std::vector<BSONObj> makeSamples(int metricCount) {
+    std::mt19937_64 rng(metricCount);
+    std::vector<std::int64_t> values(metricCount);
+    for (auto& value : values) {
+        value = rng() % 1000000;
+    }
+
+    std::vector<BSONObj> samples;
+    samples.reserve(kSampleCount);
+    for (int i = 0; i < kSampleCount; ++i) {
+        BSONObjBuilder builder;
+        builder.append("start", Date_t::fromMillisSinceEpoch(1600000000000LL + i * 1000LL));
+        for (int m = 0; m < metricCount; ++m) {
+            switch (m % 8) {
+                case 0:
+                case 1:
+                    // Constants, configuration values and counters that never move.
+                    break;
+                case 2:
+                case 3:
+                    // Slow counters.
+                    values[m] += rng() % 4;
+                    break;
+                case 4:
+                    // Busy counters.
+                    values[m] += rng() % 100000;
+                    break;
+                default:
+                    // Gauges.
+                    values[m] += static_cast<std::int64_t>(rng() % 2001) - 1000;
+                    break;
+            }
+            builder.append("m" + std::to_string(m), static_cast<long long>(values[m]));
+        }
+        builder.append("end", Date_t::fromMillisSinceEpoch(1600000000010LL + i * 1000LL));
+        samples.push_back(builder.obj());
+    }
+    return samples;
+}
+
+FTDCConfig makeConfig(const benchmark::State& state) {
+    FTDCConfig config;
+    config.maxSamplesPerArchiveMetricChunk = kSampleCount;
+    config.metricChunkFormat = state.range(0) ? FTDCMetricChunkFormat::kColumnar
+                                              : FTDCMetricChunkFormat::kVarInt;
+    return config;
+}
+
+/**
+ * Compresses all samples into one metric chunk and returns a copy of it.
+ */
+std::vector<char> compressSamples(FTDCCompressor* compressor, const std::vector<BSONObj>& samples) {
+    compressor->reset();
+    for (const auto& sample : samples) {
+        auto swFull = compressor->addSample(sample, Date_t());
+        invariant(swFull.isOK());
+        invariant(!swFull.getValue());
+    }
+    auto swBuf = compressor->getCompressedSamples();
+    invariant(swBuf.isOK());
+    const auto& buf = std::get<ConstDataRange>(swBuf.getValue());
+    return std::vector<char>(buf.data(), buf.data() + buf.length());
+}
+
+void BM_FTDCCompress(benchmark::State& state) {
+    const auto samples = makeSamples(state.range(1));
+    const auto config = makeConfig(state);
+    FTDCCompressor compressor(&config);
+
+    size_t chunkBytes = 0;
+    for (auto _ : state) {
+        chunkBytes = compressSamples(&compressor, samples).size();
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * samples.size());
+    state.counters["bytesPerSample"] = static_cast<double>(chunkBytes) / samples.size();
+}
+
+void BM_FTDCDecompress(benchmark::State& state) {
+    const auto samples = makeSamples(state.range(1));
+    const auto config = makeConfig(state);
+    FTDCCompressor compressor(&config);
+    const auto chunk = compressSamples(&compressor, samples);
+
+    FTDCDecompressor decompressor;
+    for (auto _ : state) {
+        auto swSamples = decompressor.uncompress(ConstDataRange(chunk.data(), chunk.size()),
+                                                 config.metricChunkFormat);
+        invariant(swSamples.isOK());
+        benchmark::DoNotOptimize(swSamples.getValue().data());
+    }
+    state.SetItemsProcessed(state.iterations() * samples.size());
+    state.counters["bytesPerSample"] = static_cast<double>(chunk.size()) / samples.size();
+}
+
+// The first argument selects the format (0 for varint, 1 for columnar) and the second the number
+// of metrics in each sample.
+BENCHMARK(BM_FTDCCompress)->Args({0, 500})->Args({1, 500})->Args({0, 3000})->Args({1, 3000});
+BENCHMARK(BM_FTDCDecompress)->Args({0, 500})->Args({1, 500})->Args({0, 3000})->Args({1, 3000});
+
+}  // namespace
+}  // namespace mongo
@@ -39,6 +39,7 @@
 #include "mongo/db/ftdc/config.h"
 #include "mongo/db/ftdc/decompressor.h"
 #include "mongo/db/ftdc/ftdc_test.h"
+#include "mongo/db/ftdc/util.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/assert_util.h"
@@ -122,8 +123,11 @@ TEST_F(FTDCCompressorTest, TestStrings) {
  */
 class TestTie {
 public:
-    TestTie(FTDCValidationMode mode = FTDCValidationMode::kStrict)
-        : _compressor(&_config), _mode(mode) {}
+    TestTie(FTDCValidationMode mode = FTDCValidationMode::kStrict,
+            FTDCMetricChunkFormat format = FTDCMetricChunkFormat::kVarInt)
+        : _compressor(&_config), _mode(mode) {
+        _config.metricChunkFormat = format;
+    }
 
     ~TestTie() {
         validate(boost::none);
@@ -155,13 +159,14 @@ public:
     void validate(boost::optional<ConstDataRange> cdr) {
         std::vector<BSONObj> list;
         if (cdr.is_initialized()) {
-            auto sw = _decompressor.uncompress(cdr.get());
+            auto sw = _decompressor.uncompress(cdr.get(), _config.metricChunkFormat);
             ASSERT_TRUE(sw.isOK());
             list = sw.getValue();
         } else {
             auto swBuf = _compressor.getCompressedSamples();
             ASSERT_TRUE(swBuf.isOK());
-            auto sw = _decompressor.uncompress(std::get<0>(swBuf.getValue()));
+            auto sw = _decompressor.uncompress(std::get<0>(swBuf.getValue()),
+                                               _config.metricChunkFormat);
             ASSERT_TRUE(sw.isOK());
 
             list = sw.getValue();
@@ -542,6 +547,90 @@ TEST_F(FTDCCompressorTest, TestManyMetrics) {
     }
 }
 
+// Test a full buffer in the columnar format, with constant, increasing, and decreasing metrics
+TEST_F(FTDCCompressorTest, TestColumnarFull) {
+    TestTie c(FTDCValidationMode::kStrict, FTDCMetricChunkFormat::kColumnar);
+
+    auto st = c.addSample(BSON("name"
+                               << "joe"
+                               << "key1" << 33 << "key2" << 42 << "key3" << 0LL));
+    ASSERT_HAS_SPACE(st);
+
+    for (size_t i = 0; i != FTDCConfig::kMaxSamplesPerArchiveMetricChunkDefault - 2; i++) {
+        st = c.addSample(BSON("name"
+                              << "joe"
+                              << "key1" << 33 << "key2" << static_cast<long long>(i * i)
+                              << "key3" << -static_cast<long long>(i % 7) * 1000));
+        ASSERT_HAS_SPACE(st);
+    }
+
+    st = c.addSample(BSON("name"
+                          << "joe"
+                          << "key1" << 34 << "key2" << std::numeric_limits<long long>::min()
+                          << "key3" << std::numeric_limits<long long>::max()));
+    ASSERT_FULL(st);
+
+    st = c.addSample(BSON("name"
+                          << "joe"
+                          << "key1" << 34 << "key2" << 45 << "key3" << 0LL));
+    ASSERT_HAS_SPACE(st);
+}
+
+// Test many metrics with random values, which need every bit width, in the columnar format
+TEST_F(FTDCCompressorTest, TestColumnarManyMetrics) {
+    std::random_device rd;
+    std::mt19937 gen(rd());
+
+    std::uniform_int_distribution<long long> genValues(std::numeric_limits<long long>::min(),
+                                                       std::numeric_limits<long long>::max());
+    std::uniform_int_distribution<int> genBits(0, 63);
+    auto generator = [&](std::random_device&) {
+        return genValues(gen) >> genBits(gen);
+    };
+    const size_t metrics = 1000;
+
+    TestTie c(FTDCValidationMode::kStrict, FTDCMetricChunkFormat::kColumnar);
+
+    auto st = c.addSample(generateSample(rd, generator, metrics));
+    ASSERT_HAS_SPACE(st);
+
+    // Stop short of a multiple of the group size, so that the last group is partially filled.
+    for (size_t i = 0; i != 2 * FTDCCompressor::kColumnarGroupSize + 3; i++) {
+        st = c.addSample(generateSample(rd, generator, metrics));
+        ASSERT_HAS_SPACE(st);
+    }
+}
+
+// Test that columnar metric chunks round trip through metric chunk documents
+TEST_F(FTDCCompressorTest, TestColumnarMetricChunkDocument) {
+    FTDCConfig config;
+    config.metricChunkFormat = FTDCMetricChunkFormat::kColumnar;
+    FTDCCompressor c(&config);
+
+    std::vector<BSONObj> docs;
+    for (int i = 0; i < 20; i++) {
+        docs.push_back(BSON("name"
+                            << "joe"
+                            << "key1" << i * 3 << "key2" << 42 - i));
+        auto st = c.addSample(docs.back(), Date_t());
+        ASSERT_HAS_SPACE(st);
+    }
+
+    auto swBuf = c.getCompressedSamples();
+    ASSERT_OK(swBuf.getStatus());
+
+    BSONObj chunkDoc = FTDCBSONUtil::createBSONMetricChunkDocument(
+        std::get<0>(swBuf.getValue()), Date_t(), FTDCMetricChunkFormat::kColumnar);
+    auto swType = FTDCBSONUtil::getBSONDocumentType(chunkDoc);
+    ASSERT_OK(swType.getStatus());
+    ASSERT_TRUE(swType.getValue() == FTDCBSONUtil::FTDCType::kColumnarMetricChunk);
+
+    FTDCDecompressor decompressor;
+    auto swDocs = FTDCBSONUtil::getMetricsFromMetricDoc(chunkDoc, &decompressor);
+    ASSERT_OK(swDocs.getStatus());
+    ValidateDocumentList(swDocs.getValue(), docs, FTDCValidationMode::kStrict);
+}
+
 // Test various non-finite double values
 TEST_F(FTDCCompressorTest, TestDoubleValues) {
     TestTie c;
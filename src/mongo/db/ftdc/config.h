@@ -35,6 +35,21 @@
 
 namespace mongo {
 
+/**
+ * Encoding of the samples in a metric chunk. See FTDCCompressor.
+ */
+enum class FTDCMetricChunkFormat {
+    /**
+     * Run length encoded zeros and VarInt encoded deltas, compressed with zlib.
+     */
+    kVarInt,
+
+    /**
+     * Bit-packed, frame-of-reference encoded deltas for each metric, compressed with zstd.
+     */
+    kColumnar,
+};
+
 /**
  * Configuration settings for full-time diagnostic data capture (FTDC).
  *
@@ -47,7 +62,8 @@ struct FTDCConfig {
           maxFileSizeBytes(kMaxFileSizeBytesDefault),
           period(kPeriodMillisDefault),
           maxSamplesPerArchiveMetricChunk(kMaxSamplesPerArchiveMetricChunkDefault),
-          maxSamplesPerInterimMetricChunk(kMaxSamplesPerInterimMetricChunkDefault) {}
+          maxSamplesPerInterimMetricChunk(kMaxSamplesPerInterimMetricChunkDefault),
+          metricChunkFormat(kMetricChunkFormatDefault) {}
 
     /**
      * True if FTDC is collecting data. False otherwise
@@ -84,6 +100,11 @@ struct FTDCConfig {
      */
     std::uint32_t maxSamplesPerInterimMetricChunk;
 
+    /**
+     * Format in which metric chunks are written.
+     */
+    FTDCMetricChunkFormat metricChunkFormat;
+
     static const bool kEnabledDefault = true;
 
     static const std::int64_t kPeriodMillisDefault;
@@ -94,6 +115,8 @@ struct FTDCConfig {
 
     static const std::uint32_t kMaxSamplesPerArchiveMetricChunkDefault = 300;
     static const std::uint32_t kMaxSamplesPerInterimMetricChunkDefault = 10;
+
+    static const FTDCMetricChunkFormat kMetricChunkFormatDefault = FTDCMetricChunkFormat::kVarInt;
 };
 
 }  // namespace mongo
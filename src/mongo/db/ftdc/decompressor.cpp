@@ -31,8 +31,13 @@
 
 #include "mongo/db/ftdc/decompressor.h"
 
+#include <array>
+#include <cstring>
+#include <utility>
+
 #include "mongo/base/data_range_cursor.h"
 #include "mongo/base/data_type_validated.h"
+#include "mongo/base/data_view.h"
 #include "mongo/db/ftdc/compressor.h"
 #include "mongo/db/ftdc/util.h"
 #include "mongo/db/ftdc/varint.h"
@@ -42,7 +47,109 @@
 
 namespace mongo {
 
-StatusWith<std::vector<BSONObj>> FTDCDecompressor::uncompress(ConstDataRange buf) {
+namespace {
+
+constexpr std::uint32_t kGroupSize = FTDCCompressor::kColumnarGroupSize;
+
+std::uint64_t zigZagDecode(std::uint64_t value) {
+    return (value >> 1) ^ (~(value & 1) + 1);
+}
+
+/**
+ * Unpacks a group of kGroupSize values of 'kBitWidth' bits each from the 'kBitWidth' bytes at
+ * 'in'. Since the bit width is a constant, the compiler unrolls the loop and turns the shifts and
+ * masks into vector instructions where the target has them.
+ */
+template <std::uint32_t kBitWidth>
+void unpackGroup(const char* in, std::uint64_t* out) {
+    // Every value is read with a single 8 byte load, plus one more byte for values which straddle
+    // it, so copy the group where the loads cannot run off the end of the chunk.
+    char group[kBitWidth + 9] = {};
+    std::memcpy(group, in, kBitWidth);
+
+    constexpr std::uint64_t kMask =
+        kBitWidth == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << kBitWidth) - 1;
+    for (std::uint32_t k = 0; k < kGroupSize; k++) {
+        const std::uint32_t bit = k * kBitWidth;
+        const std::uint32_t shift = bit % 8;
+        std::uint64_t value =
+            ConstDataView(group + bit / 8).read<LittleEndian<std::uint64_t>>() >> shift;
+        if (shift + kBitWidth > 64) {
+            value |= static_cast<std::uint64_t>(static_cast<unsigned char>(group[bit / 8 + 8]))
+                << (64 - shift);
+        }
+        out[k] = value & kMask;
+    }
+}
+
+using UnpackGroupFn = void (*)(const char*, std::uint64_t*);
+
+template <std::size_t... kBitWidths>
+constexpr std::array<UnpackGroupFn, sizeof...(kBitWidths)> makeUnpackGroupFns(
+    std::index_sequence<kBitWidths...>) {
+    return {{&unpackGroup<kBitWidths + 1>...}};
+}
+
+// The unpack routine for bit width N is at index N - 1.
+constexpr auto kUnpackGroupFns = makeUnpackGroupFns(std::make_index_sequence<64>());
+
+/**
+ * Decodes the deltas of 'metricsCount' metrics for 'sampleCount' samples from the
+ * FTDCMetricChunkFormat::kColumnar format into 'deltas'. See FTDCCompressor.
+ */
+Status decodeColumnarDeltas(ConstDataRangeCursor* cdrc,
+                            std::uint32_t metricsCount,
+                            std::uint32_t sampleCount,
+                            std::vector<std::uint64_t>* deltas) {
+    const std::uint32_t groupCount = (sampleCount + kGroupSize - 1) / kGroupSize;
+    std::vector<std::uint64_t> column(groupCount * kGroupSize);
+
+    for (std::uint32_t i = 0; i < metricsCount; i++) {
+        auto swBitWidth = cdrc->readAndAdvanceNoThrow<LittleEndian<std::uint8_t>>();
+        if (!swBitWidth.isOK()) {
+            return swBitWidth.getStatus();
+        }
+
+        auto swBase = cdrc->readAndAdvanceNoThrow<LittleEndian<std::uint64_t>>();
+        if (!swBase.isOK()) {
+            return swBase.getStatus();
+        }
+
+        const std::uint32_t bitWidth = swBitWidth.getValue();
+        const std::uint64_t base = swBase.getValue();
+        std::uint64_t* out = &(*deltas)[FTDCCompressor::getArrayOffset(sampleCount, 0, i)];
+
+        if (bitWidth == 0) {
+            std::fill(out, out + sampleCount, zigZagDecode(base));
+            continue;
+        }
+
+        if (bitWidth > 64) {
+            return {ErrorCodes::BadValue, "Metrics chunk has an invalid bit width"};
+        }
+
+        const char* packed = cdrc->data();
+        Status status = cdrc->advanceNoThrow(static_cast<size_t>(groupCount) * bitWidth);
+        if (!status.isOK()) {
+            return status;
+        }
+
+        const UnpackGroupFn unpack = kUnpackGroupFns[bitWidth - 1];
+        for (std::uint32_t group = 0; group < groupCount; group++) {
+            unpack(packed + group * bitWidth, &column[group * kGroupSize]);
+        }
+        for (std::uint32_t j = 0; j < sampleCount; j++) {
+            out[j] = zigZagDecode(column[j] + base);
+        }
+    }
+
+    return Status::OK();
+}
+
+}  // namespace
+
+StatusWith<std::vector<BSONObj>> FTDCDecompressor::uncompress(ConstDataRange buf,
+                                                               FTDCMetricChunkFormat format) {
     ConstDataRangeCursor compressedDataRange(buf);
 
     // Read the length of the uncompressed buffer
@@ -60,7 +167,11 @@ StatusWith<std::vector<BSONObj>> FTDCDecompressor::uncompress(ConstDataRange buf
         return Status(ErrorCodes::InvalidLength, "Metrics chunk has exceeded the allowable size.");
     }
 
-    auto statusUncompress = _compressor.uncompress(compressedDataRange, uncompressedLength);
+    auto statusUncompress = _compressor.uncompress(compressedDataRange,
+                                                   uncompressedLength,
+                                                   format == FTDCMetricChunkFormat::kColumnar
+                                                       ? BlockCompressor::Codec::kZstd
+                                                       : BlockCompressor::Codec::kZlib);
 
     if (!statusUncompress.isOK()) {
         return {statusUncompress.getStatus()};
@@ -126,36 +237,43 @@ StatusWith<std::vector<BSONObj>> FTDCDecompressor::uncompress(ConstDataRange buf
     // Read the samples
     std::vector<std::uint64_t> deltas(metricsCount * sampleCount);
 
-    // decompress the deltas
-    std::uint64_t zeroesCount = 0;
-
     auto cdrc = ConstDataRangeCursor(cdc);
 
-    for (std::uint32_t i = 0; i < metricsCount; i++) {
-        for (std::uint32_t j = 0; j < sampleCount; j++) {
-            if (zeroesCount) {
-                deltas[FTDCCompressor::getArrayOffset(sampleCount, j, i)] = 0;
-                zeroesCount--;
-                continue;
-            }
+    // decompress the deltas
+    if (format == FTDCMetricChunkFormat::kColumnar) {
+        Status status = decodeColumnarDeltas(&cdrc, metricsCount, sampleCount, &deltas);
+        if (!status.isOK()) {
+            return status;
+        }
+    } else {
+        std::uint64_t zeroesCount = 0;
+
+        for (std::uint32_t i = 0; i < metricsCount; i++) {
+            for (std::uint32_t j = 0; j < sampleCount; j++) {
+                if (zeroesCount) {
+                    deltas[FTDCCompressor::getArrayOffset(sampleCount, j, i)] = 0;
+                    zeroesCount--;
+                    continue;
+                }
 
-            auto swDelta = cdrc.readAndAdvanceNoThrow<FTDCVarInt>();
+                auto swDelta = cdrc.readAndAdvanceNoThrow<FTDCVarInt>();
 
-            if (!swDelta.isOK()) {
-                return swDelta.getStatus();
-            }
+                if (!swDelta.isOK()) {
+                    return swDelta.getStatus();
+                }
+
+                if (swDelta.getValue() == 0) {
+                    auto swZero = cdrc.readAndAdvanceNoThrow<FTDCVarInt>();
 
-            if (swDelta.getValue() == 0) {
-                auto swZero = cdrc.readAndAdvanceNoThrow<FTDCVarInt>();
+                    if (!swZero.isOK()) {
+                        return swZero.getStatus();
+                    }
 
-                if (!swZero.isOK()) {
-                    return swZero.getStatus();
+                    zeroesCount = swZero.getValue();
                 }
 
-                zeroesCount = swZero.getValue();
+                deltas[FTDCCompressor::getArrayOffset(sampleCount, j, i)] = swDelta.getValue();
             }
-
-            deltas[FTDCCompressor::getArrayOffset(sampleCount, j, i)] = swDelta.getValue();
         }
     }
 
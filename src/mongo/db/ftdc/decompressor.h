@@ -34,6 +34,7 @@
 #include "mongo/base/data_range.h"
 #include "mongo/base/status_with.h"
 #include "mongo/db/ftdc/block_compressor.h"
+#include "mongo/db/ftdc/config.h"
 #include "mongo/db/jsobj.h"
 
 namespace mongo {
@@ -55,7 +56,8 @@ public:
      *
      * Returns N samples where N = sample count + 1. The 1 is the reference document.
      */
-    StatusWith<std::vector<BSONObj>> uncompress(ConstDataRange buf);
+    StatusWith<std::vector<BSONObj>> uncompress(
+        ConstDataRange buf, FTDCMetricChunkFormat format = FTDCMetricChunkFormat::kVarInt);
 
 private:
     BlockCompressor _compressor;
@@ -91,7 +91,8 @@ StatusWith<bool> FTDCFileReader::hasNext() {
                 }
 
                 _metadata = swMetadata.getValue();
-            } else if (type == FTDCBSONUtil::FTDCType::kMetricChunk) {
+            } else if (type == FTDCBSONUtil::FTDCType::kMetricChunk ||
+                       type == FTDCBSONUtil::FTDCType::kColumnarMetricChunk) {
                 _state = State::kMetricChunk;
 
                 auto swDocs = FTDCBSONUtil::getMetricsFromMetricDoc(_parent, &_decompressor);
@@ -260,6 +260,9 @@ void startFTDC(boost::filesystem::path& path,
         ftdcStartupParams.maxSamplesPerArchiveMetricChunk.load();
     config.maxSamplesPerInterimMetricChunk =
         ftdcStartupParams.maxSamplesPerInterimMetricChunk.load();
+    config.metricChunkFormat = ftdcStartupParams.columnarMetricChunks.load()
+        ? FTDCMetricChunkFormat::kColumnar
+        : FTDCMetricChunkFormat::kVarInt;
 
     ftdcDirectoryPathParameter = path;
 
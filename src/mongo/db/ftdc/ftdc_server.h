@@ -111,6 +111,7 @@ struct FTDCStartupParams {
     AtomicWord<int> maxFileSizeMB;
     AtomicWord<int> maxSamplesPerArchiveMetricChunk;
     AtomicWord<int> maxSamplesPerInterimMetricChunk;
+    AtomicWord<bool> columnarMetricChunks;
 
     FTDCStartupParams()
         : enabled(FTDCConfig::kEnabledDefault),
@@ -119,7 +120,9 @@ struct FTDCStartupParams {
           maxDirectorySizeMB(FTDCConfig::kMaxDirectorySizeBytesDefault / (1024 * 1024)),
           maxFileSizeMB(FTDCConfig::kMaxFileSizeBytesDefault / (1024 * 1024)),
           maxSamplesPerArchiveMetricChunk(FTDCConfig::kMaxSamplesPerArchiveMetricChunkDefault),
-          maxSamplesPerInterimMetricChunk(FTDCConfig::kMaxSamplesPerInterimMetricChunkDefault) {}
+          maxSamplesPerInterimMetricChunk(FTDCConfig::kMaxSamplesPerInterimMetricChunkDefault),
+          columnarMetricChunks(FTDCConfig::kMetricChunkFormatDefault ==
+                               FTDCMetricChunkFormat::kColumnar) {}
 };
 
 extern FTDCStartupParams ftdcStartupParams;
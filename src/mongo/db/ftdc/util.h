@@ -34,6 +34,7 @@
 
 #include "mongo/base/status.h"
 #include "mongo/base/status_with.h"
+#include "mongo/db/ftdc/config.h"
 #include "mongo/db/ftdc/decompressor.h"
 #include "mongo/db/jsobj.h"
 
@@ -63,6 +64,12 @@ enum class FTDCType : std::int32_t {
      * See createBSONMetricChunkDocument
      */
     kMetricChunk = 1,
+
+    /**
+     * A metrics chunk whose compressed metric chunk is in the FTDCMetricChunkFormat::kColumnar
+     * format. It has the same structure as kMetricChunk.
+     */
+    kColumnarMetricChunk = 2,
 };
 
 
@@ -139,6 +146,7 @@ BSONObj createBSONMetadataDocument(const BSONObj& metadata, Date_t date);
  * Create a BSON metric chunk document for storage. The passed in document is embedded as the
  * data field in the example above. For the _id field, the date is specified by the caller
  * since the metric chunk usually composed of multiple samples gathered over a period of time.
+ * The type is 2 instead if the chunk is in the FTDCMetricChunkFormat::kColumnar format.
  *
  * Example:
  * {
@@ -147,7 +155,10 @@ BSONObj createBSONMetadataDocument(const BSONObj& metadata, Date_t date);
  *  "data" : BinData(...)
  * }
  */
-BSONObj createBSONMetricChunkDocument(ConstDataRange buf, Date_t now);
+BSONObj createBSONMetricChunkDocument(
+    ConstDataRange buf,
+    Date_t now,
+    FTDCMetricChunkFormat format = FTDCMetricChunkFormat::kVarInt);
 
 /**
  * Get the _id field of a BSON document
@@ -33,9 +33,12 @@
 
 #include "mongo/db/index/btree_access_method.h"
 
+#include <algorithm>
+#include <cstring>
 #include <utility>
 #include <vector>
 
+#include "mongo/base/checked_cast.h"
 #include "mongo/base/error_codes.h"
 #include "mongo/base/status.h"
 #include "mongo/db/catalog/index_catalog.h"
@@ -54,6 +57,7 @@
 #include "mongo/db/storage/execution_context.h"
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/logv2/log.h"
+#include "mongo/platform/endian.h"
 #include "mongo/util/progress_meter.h"
 #include "mongo/util/scopeguard.h"
 #include "mongo/util/stacktrace.h"
@@ -88,7 +92,12 @@ SortOptions makeSortOptions(size_t maxMemoryUsageBytes) {
     return SortOptions()
         .TempDir(storageGlobalParams.dbpath + "/_tmp")
         .ExtSortAllowed()
-        .MaxMemoryUsageBytes(maxMemoryUsageBytes);
+        .MaxMemoryUsageBytes(maxMemoryUsageBytes)
+        .SortThreads(internalSorterMaxSortThreads.load())
+        .ReadAheadBlocks(internalSorterReadAheadBlocks.load())
+        .DirectIO(internalSorterUseDirectIO.load())
+        .SpillCompressor(uassertStatusOK(parseSorterSpillCompressor(internalSorterSpillCompressor)))
+        .SpillCompressionLevel(internalSorterSpillCompressionLevel.load());
 }
 
 MultikeyPaths createMultikeyPaths(const std::vector<MultikeyPath>& multikeyPathsVec) {
@@ -109,6 +118,16 @@ struct BtreeExternalSortComparison {
     int operator()(const Data& l, const Data& r) const {
         return l.first.compare(r.first);
     }
+
+    /**
+     * KeyStrings compare bytewise, so their first 8 bytes read as a big-endian integer (zero
+     * padded) order the keys wherever they differ.
+     */
+    uint64_t normalizedKeyPrefix(const KeyString::Value& key) const {
+        uint64_t prefix = 0;
+        std::memcpy(&prefix, key.getBuffer(), std::min(key.getSize(), sizeof(prefix)));
+        return endian::nativeToBig(prefix);
+    }
 };
 
 AbstractIndexAccessMethod::AbstractIndexAccessMethod(IndexCatalogEntry* btreeState,
@@ -500,17 +519,27 @@ public:
 
     Sorter::PersistedState persistDataForShutdown() final;
 
+    std::unique_ptr<BulkBuilder> makePartition(size_t maxMemoryUsageBytes) const final;
+
+    void mergePartition(OperationContext* opCtx, std::unique_ptr<BulkBuilder> partition) final;
+
 private:
     void _insertMultikeyMetadataKeysIntoSorter();
 
+    void _insertPartitionsIntoSorter();
+
+    void _mergeMultikeyPaths(const MultikeyPaths& multikeyPaths);
+
     Sorter* _makeSorter(
         size_t maxMemoryUsageBytes,
         boost::optional<StringData> fileName = boost::none,
-        const boost::optional<std::vector<SorterRange>>& ranges = boost::none) const;
+        const boost::optional<std::vector<SorterRange>>& ranges = boost::none,
+        boost::optional<StringData> spillCompressor = boost::none) const;
 
     Sorter::Settings _makeSorterSettings() const;
 
     IndexCatalogEntry* _indexCatalogEntry;
+    const size_t _maxMemoryUsageBytes;
     std::unique_ptr<Sorter> _sorter;
     int64_t _keysInserted = 0;
 
@@ -525,6 +554,17 @@ private:
     // These are inserted into the sorter after all normal data keys have been added, just
     // before the bulk build is committed.
     KeyStringSet _multikeyMetadataKeys;
+
+    // Set on the BulkBuilders returned by makePartition(). A partition may be filled on another
+    // thread than the one owning the index build, so it keeps the RecordIds of the documents whose
+    // key generation errors were suppressed in '_skippedRecords' until it is merged.
+    bool _isPartition = false;
+    std::vector<RecordId> _skippedRecords;
+
+    // The Sorters of the partitions merged into this BulkBuilder, and whether done() has merged
+    // their keys with the keys of '_sorter'.
+    std::vector<std::unique_ptr<Sorter>> _partitionSorters;
+    bool _mergedPartitionSorters = false;
 };
 
 std::unique_ptr<IndexAccessMethod::BulkBuilder> AbstractIndexAccessMethod::initiateBulk(
@@ -536,13 +576,19 @@ std::unique_ptr<IndexAccessMethod::BulkBuilder> AbstractIndexAccessMethod::initi
 
 AbstractIndexAccessMethod::BulkBuilderImpl::BulkBuilderImpl(IndexCatalogEntry* index,
                                                             size_t maxMemoryUsageBytes)
-    : _indexCatalogEntry(index), _sorter(_makeSorter(maxMemoryUsageBytes)) {}
+    : _indexCatalogEntry(index),
+      _maxMemoryUsageBytes(maxMemoryUsageBytes),
+      _sorter(_makeSorter(maxMemoryUsageBytes)) {}
 
 AbstractIndexAccessMethod::BulkBuilderImpl::BulkBuilderImpl(IndexCatalogEntry* index,
                                                             size_t maxMemoryUsageBytes,
                                                             const IndexStateInfo& stateInfo)
     : _indexCatalogEntry(index),
-      _sorter(_makeSorter(maxMemoryUsageBytes, stateInfo.getFileName(), stateInfo.getRanges())),
+      _maxMemoryUsageBytes(maxMemoryUsageBytes),
+      _sorter(_makeSorter(maxMemoryUsageBytes,
+                          stateInfo.getFileName(),
+                          stateInfo.getRanges(),
+                          stateInfo.getSpillCompressor())),
       _keysInserted(stateInfo.getNumKeys().value_or(0)),
       _isMultiKey(stateInfo.getIsMultikey()),
       _indexMultikeyPaths(createMultikeyPaths(stateInfo.getMultikeyPaths())) {}
@@ -578,25 +624,18 @@ Status AbstractIndexAccessMethod::BulkBuilderImpl::insert(OperationContext* opCt
                                 "error"_attr = status,
                                 "loc"_attr = loc,
                                 "obj"_attr = redact(obj));
-                    interceptor->getSkippedRecordTracker()->record(opCtx, loc);
+                    if (_isPartition) {
+                        _skippedRecords.push_back(loc);
+                    } else {
+                        interceptor->getSkippedRecordTracker()->record(opCtx, loc);
+                    }
                 }
             });
     } catch (...) {
         return exceptionToStatus();
     }
 
-    if (!multikeyPaths->empty()) {
-        if (_indexMultikeyPaths.empty()) {
-            _indexMultikeyPaths = *multikeyPaths;
-        } else {
-            invariant(_indexMultikeyPaths.size() == multikeyPaths->size());
-            for (size_t i = 0; i < multikeyPaths->size(); ++i) {
-                _indexMultikeyPaths[i].insert(boost::container::ordered_unique_range_t(),
-                                              (*multikeyPaths)[i].begin(),
-                                              (*multikeyPaths)[i].end());
-            }
-        }
-    }
+    _mergeMultikeyPaths(*multikeyPaths);
 
     for (const auto& keyString : *keys) {
         _sorter->add(keyString, mongo::NullValue());
@@ -621,7 +660,19 @@ bool AbstractIndexAccessMethod::BulkBuilderImpl::isMultikey() const {
 IndexAccessMethod::BulkBuilder::Sorter::Iterator*
 AbstractIndexAccessMethod::BulkBuilderImpl::done() {
     _insertMultikeyMetadataKeysIntoSorter();
-    return _sorter->done();
+    if (_partitionSorters.empty()) {
+        return _sorter->done();
+    }
+
+    std::vector<std::shared_ptr<Sorter::Iterator>> iters;
+    iters.reserve(_partitionSorters.size() + 1);
+    iters.emplace_back(_sorter->done());
+    for (auto&& partitionSorter : _partitionSorters) {
+        iters.emplace_back(partitionSorter->done());
+    }
+    _mergedPartitionSorters = true;
+    return Sorter::Iterator::merge(
+        iters, makeSortOptions(_maxMemoryUsageBytes), BtreeExternalSortComparison());
 }
 
 int64_t AbstractIndexAccessMethod::BulkBuilderImpl::getKeysInserted() const {
@@ -630,10 +681,78 @@ int64_t AbstractIndexAccessMethod::BulkBuilderImpl::getKeysInserted() const {
 
 AbstractIndexAccessMethod::BulkBuilder::Sorter::PersistedState
 AbstractIndexAccessMethod::BulkBuilderImpl::persistDataForShutdown() {
+    invariant(!_mergedPartitionSorters);
+    _insertPartitionsIntoSorter();
     _insertMultikeyMetadataKeysIntoSorter();
     return _sorter->persistDataForShutdown();
 }
 
+std::unique_ptr<IndexAccessMethod::BulkBuilder>
+AbstractIndexAccessMethod::BulkBuilderImpl::makePartition(size_t maxMemoryUsageBytes) const {
+    invariant(!_isPartition);
+    auto partition = std::make_unique<BulkBuilderImpl>(_indexCatalogEntry, maxMemoryUsageBytes);
+    partition->_isPartition = true;
+    return partition;
+}
+
+void AbstractIndexAccessMethod::BulkBuilderImpl::mergePartition(
+    OperationContext* opCtx, std::unique_ptr<BulkBuilder> partition) {
+    auto bulk = checked_cast<BulkBuilderImpl*>(partition.get());
+    invariant(bulk->_isPartition);
+    invariant(bulk->_indexCatalogEntry == _indexCatalogEntry);
+    invariant(!_mergedPartitionSorters);
+
+    if (!bulk->_skippedRecords.empty()) {
+        auto tracker = _indexCatalogEntry->indexBuildInterceptor()->getSkippedRecordTracker();
+        for (const auto& loc : bulk->_skippedRecords) {
+            tracker->record(opCtx, loc);
+        }
+    }
+
+    _mergeMultikeyPaths(bulk->_indexMultikeyPaths);
+    _isMultiKey = _isMultiKey || bulk->_isMultiKey;
+
+    // Multikey metadata keys may have been generated by several partitions, and are only inserted
+    // into the Sorter once by done().
+    _multikeyMetadataKeys.insert(bulk->_multikeyMetadataKeys.begin(),
+                                 bulk->_multikeyMetadataKeys.end());
+
+    _keysInserted += bulk->_keysInserted;
+    _partitionSorters.push_back(std::move(bulk->_sorter));
+}
+
+void AbstractIndexAccessMethod::BulkBuilderImpl::_insertPartitionsIntoSorter() {
+    // The persisted state of a BulkBuilder describes a single Sorter, so the keys of the merged
+    // partitions are copied into '_sorter' first.
+    for (auto&& partitionSorter : _partitionSorters) {
+        std::unique_ptr<Sorter::Iterator> it(partitionSorter->done());
+        while (it->more()) {
+            auto data = it->next();
+            _sorter->emplace(std::move(data.first), std::move(data.second));
+        }
+    }
+    _partitionSorters.clear();
+}
+
+void AbstractIndexAccessMethod::BulkBuilderImpl::_mergeMultikeyPaths(
+    const MultikeyPaths& multikeyPaths) {
+    if (multikeyPaths.empty()) {
+        return;
+    }
+
+    if (_indexMultikeyPaths.empty()) {
+        _indexMultikeyPaths = multikeyPaths;
+        return;
+    }
+
+    invariant(_indexMultikeyPaths.size() == multikeyPaths.size());
+    for (size_t i = 0; i < multikeyPaths.size(); ++i) {
+        _indexMultikeyPaths[i].insert(boost::container::ordered_unique_range_t(),
+                                      multikeyPaths[i].begin(),
+                                      multikeyPaths[i].end());
+    }
+}
+
 void AbstractIndexAccessMethod::BulkBuilderImpl::_insertMultikeyMetadataKeysIntoSorter() {
     for (const auto& keyString : _multikeyMetadataKeys) {
         _sorter->add(keyString, mongo::NullValue());
@@ -656,15 +775,20 @@ AbstractIndexAccessMethod::BulkBuilderImpl::Sorter*
 AbstractIndexAccessMethod::BulkBuilderImpl::_makeSorter(
     size_t maxMemoryUsageBytes,
     boost::optional<StringData> fileName,
-    const boost::optional<std::vector<SorterRange>>& ranges) const {
+    const boost::optional<std::vector<SorterRange>>& ranges,
+    boost::optional<StringData> spillCompressor) const {
+    auto opts = makeSortOptions(maxMemoryUsageBytes);
+    // A resumed build keeps spilling with the codec that its file was written with, so that the
+    // codec recorded for the file on the next shutdown covers all of its blocks.
+    if (spillCompressor) {
+        opts.SpillCompressor(uassertStatusOK(parseSorterSpillCompressor(*spillCompressor)));
+    }
     return fileName ? Sorter::makeFromExistingRanges(fileName->toString(),
                                                      *ranges,
-                                                     makeSortOptions(maxMemoryUsageBytes),
+                                                     opts,
                                                      BtreeExternalSortComparison(),
                                                      _makeSorterSettings())
-                    : Sorter::make(makeSortOptions(maxMemoryUsageBytes),
-                                   BtreeExternalSortComparison(),
-                                   _makeSorterSettings());
+                    : Sorter::make(opts, BtreeExternalSortComparison(), _makeSorterSettings());
 }
 
 Status AbstractIndexAccessMethod::commitBulk(OperationContext* opCtx,
@@ -262,6 +262,25 @@ public:
          * state of the underlying Sorter.
          */
         virtual Sorter::PersistedState persistDataForShutdown() = 0;
+
+        /**
+         * Returns a new BulkBuilder with its own Sorter, which accumulates the keys of a part of
+         * the collection. Partitions of the same BulkBuilder may be filled concurrently on
+         * different threads. Key generation errors suppressed while filling a partition are only
+         * recorded once the partition is merged back with mergePartition().
+         */
+        virtual std::unique_ptr<BulkBuilder> makePartition(size_t maxMemoryUsageBytes) const = 0;
+
+        /**
+         * Takes over the keys, multikey state and suppressed key generation errors of a partition
+         * returned by makePartition(). The keys of all merged partitions are merged with the keys
+         * of this BulkBuilder by done().
+         *
+         * Once done() has merged partitions, persistDataForShutdown() may no longer be called, as
+         * their keys are spread over several Sorters.
+         */
+        virtual void mergePartition(OperationContext* opCtx,
+                                    std::unique_ptr<BulkBuilder> partition) = 0;
     };
 
     /**
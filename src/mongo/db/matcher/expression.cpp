@@ -29,8 +29,11 @@
 
 #include "mongo/db/matcher/expression.h"
 
+#include <cmath>
+
 #include "mongo/bson/bsonmisc.h"
 #include "mongo/bson/bsonobj.h"
+#include "mongo/db/matcher/expression_leaf.h"
 
 namespace mongo {
 
@@ -110,6 +113,52 @@ void MatchExpression::sortTree(MatchExpression* tree) {
     }
 }
 
+// static
+std::vector<const MatchExpression*> MatchExpression::parameterize(MatchExpression* tree) {
+    // Only the types whose index bounds and index bounds tightness don't depend on the value are
+    // parameterized. Null and NaN are excluded, since both have special bounds; so are arrays and
+    // objects, whose comparisons are planned in a different way.
+    auto isParameterizable = [](const BSONElement& elem) {
+        switch (elem.type()) {
+            case BSONType::NumberInt:
+            case BSONType::NumberLong:
+            case BSONType::String:
+            case BSONType::Bool:
+            case BSONType::Date:
+            case BSONType::jstOID:
+                return true;
+            case BSONType::NumberDouble:
+                return !std::isnan(elem.numberDouble());
+            case BSONType::NumberDecimal:
+                return !elem.numberDecimal().isNaN();
+            default:
+                return false;
+        }
+    };
+
+    std::vector<const MatchExpression*> params;
+    auto parameterizeLeaf = [&](MatchExpression* expr) {
+        if (!ComparisonMatchExpression::isComparisonMatchExpression(expr)) {
+            return;
+        }
+        auto comparison = static_cast<ComparisonMatchExpression*>(expr);
+        if (!isParameterizable(comparison->getData())) {
+            return;
+        }
+        comparison->setInputParamId(static_cast<InputParamId>(params.size()));
+        params.push_back(comparison);
+    };
+
+    if (tree->matchType() == MatchExpression::AND) {
+        for (size_t i = 0; i < tree->numChildren(); ++i) {
+            parameterizeLeaf(tree->getChild(i));
+        }
+    } else {
+        parameterizeLeaf(tree);
+    }
+    return params;
+}
+
 std::string MatchExpression::toString() const {
     return serialize().toString();
 }
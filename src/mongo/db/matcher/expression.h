@@ -203,6 +203,12 @@ public:
     using Iterator = MatchExpressionIterator<false>;
     using ConstIterator = MatchExpressionIterator<true>;
 
+    /**
+     * Identifies a constant of a query which plans read at runtime instead of embedding it. See
+     * parameterize().
+     */
+    using InputParamId = int32_t;
+
     /**
      * Tracks the information needed to generate a document validation error for a
      * MatchExpression node.
@@ -290,6 +296,15 @@ public:
         return tree;
     }
 
+    /**
+     * Assigns an InputParamId to each comparison of the normalized 'tree' whose constant can be
+     * replaced by the constant of another query of the same shape without changing the shape of
+     * the plans built for it: the comparisons against a scalar value which are either the root of
+     * the tree or a child of its top-level $and. Returns the parameterized comparisons, indexed by
+     * their InputParamId.
+     */
+    static std::vector<const MatchExpression*> parameterize(MatchExpression* tree);
+
     MatchExpression(MatchType type, clonable_ptr<ErrorAnnotation> annotation = nullptr);
     virtual ~MatchExpression() {}
 
@@ -193,6 +193,21 @@ public:
     virtual ~ComparisonMatchExpression() = default;
 
     bool matchesSingleElement(const BSONElement&, MatchDetails* details = nullptr) const final;
+
+    /**
+     * The id of the input parameter holding the constant of this comparison, if the comparison was
+     * parameterized. See MatchExpression::parameterize().
+     */
+    boost::optional<InputParamId> getInputParamId() const {
+        return _inputParamId;
+    }
+
+    void setInputParamId(boost::optional<InputParamId> paramId) {
+        _inputParamId = paramId;
+    }
+
+private:
+    boost::optional<InputParamId> _inputParamId;
 };
 
 class EqualityMatchExpression final : public ComparisonMatchExpression {
@@ -221,6 +236,7 @@ public:
             e->setTag(getTag()->clone());
         }
         e->setCollator(_collator);
+        e->setInputParamId(getInputParamId());
         return e;
     }
 
@@ -257,6 +273,7 @@ public:
             e->setTag(getTag()->clone());
         }
         e->setCollator(_collator);
+        e->setInputParamId(getInputParamId());
         return e;
     }
 
@@ -293,6 +310,7 @@ public:
             e->setTag(getTag()->clone());
         }
         e->setCollator(_collator);
+        e->setInputParamId(getInputParamId());
         return e;
     }
 
@@ -334,6 +352,7 @@ public:
             e->setTag(getTag()->clone());
         }
         e->setCollator(_collator);
+        e->setInputParamId(getInputParamId());
         return e;
     }
 
@@ -374,6 +393,7 @@ public:
             e->setTag(getTag()->clone());
         }
         e->setCollator(_collator);
+        e->setInputParamId(getInputParamId());
         return e;
     }
 
@@ -0,0 +1,195 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kWrite
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/ops/insert_group_committer.h"
+
+#include <algorithm>
+
+#include "mongo/base/counter.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/ops/write_ops.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/logv2/log.h"
+#include "mongo/util/fail_point.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+MONGO_FAIL_POINT_DEFINE(hangInsertGroupCommitLeader);
+
+// Counts the storage transactions which inserted the documents of more than one operation, and the
+// documents which they inserted.
+Counter64 groupedCommitsCounter;
+Counter64 groupedInsertsCounter;
+ServerStatusMetricField<Counter64> displayGroupedCommits("insertGroupCommit.groupedCommits",
+                                                         &groupedCommitsCounter);
+ServerStatusMetricField<Counter64> displayGroupedInserts("insertGroupCommit.groupedInserts",
+                                                         &groupedInsertsCounter);
+
+const auto getInsertGroupCommitter = ServiceContext::declareDecoration<InsertGroupCommitter>();
+
+}  // namespace
+
+InsertGroupCommitter& InsertGroupCommitter::get(ServiceContext* serviceContext) {
+    return getInsertGroupCommitter(serviceContext);
+}
+
+bool InsertGroupCommitter::insert(OperationContext* opCtx,
+                                  const UUID& collectionUUID,
+                                  InsertStatement* stmt,
+                                  const InsertBatchFn& insertBatch) {
+    auto& partition = _getPartition(collectionUUID);
+    Waiter self(stmt);
+
+    stdx::unique_lock<Latch> lk(partition.mutex);
+    // The group stays in the map for as long as it has a leader, and it always has one while there
+    // are waiters, so this reference is valid until a leader takes our document.
+    auto& group = partition.groups[collectionUUID];
+    group.waiters.push_back(&self);
+    if (!group.hasLeader) {
+        group.hasLeader = true;
+        self.state = WaiterState::kLeader;
+    }
+
+    try {
+        opCtx->waitForConditionOrInterrupt(
+            self.cv, lk, [&] { return self.state != WaiterState::kQueued; });
+    } catch (const DBException&) {
+        if (self.state == WaiterState::kQueued) {
+            group.waiters.erase(std::find(group.waiters.begin(), group.waiters.end(), &self));
+            throw;
+        }
+    }
+
+    if (self.state == WaiterState::kLeader) {
+        return _lead(opCtx, collectionUUID, lk, partition, group, insertBatch);
+    }
+
+    // A leader is inserting our document, so we have to wait for it even if we are killed.
+    self.cv.wait(lk, [&] { return self.state == WaiterState::kDone; });
+    return self.inserted;
+}
+
+size_t InsertGroupCommitter::numQueuedForTest(const UUID& collectionUUID) {
+    auto& partition = _getPartition(collectionUUID);
+    stdx::lock_guard<Latch> lk(partition.mutex);
+    auto it = partition.groups.find(collectionUUID);
+    if (it == partition.groups.end()) {
+        return 0;
+    }
+    return std::count_if(it->second.waiters.begin(), it->second.waiters.end(), [](auto waiter) {
+        return waiter->state == WaiterState::kQueued;
+    });
+}
+
+bool InsertGroupCommitter::_lead(OperationContext* opCtx,
+                                 const UUID& collectionUUID,
+                                 stdx::unique_lock<Latch>& lk,
+                                 Partition& partition,
+                                 PendingGroup& group,
+                                 const InsertBatchFn& insertBatch) {
+    std::vector<Waiter*> batch;
+    std::vector<InsertStatement> stmts;
+    bool inserted = false;
+
+    // However the leader leaves, every waiter it took must learn the outcome of its insert, and the
+    // waiters behind them need a new leader. Otherwise they would wait forever.
+    ON_BLOCK_EXIT([&] {
+        if (!lk.owns_lock()) {
+            lk.lock();
+        }
+        for (size_t i = 0; i < batch.size(); ++i) {
+            if (inserted) {
+                batch[i]->stmt->oplogSlot = stmts[i].oplogSlot;
+            }
+            batch[i]->inserted = inserted;
+            batch[i]->state = WaiterState::kDone;
+            batch[i]->cv.notify_one();
+        }
+
+        // The leader's own waiter is still queued if it left before taking any documents.
+        auto self = std::find_if(group.waiters.begin(), group.waiters.end(), [](auto waiter) {
+            return waiter->state == WaiterState::kLeader;
+        });
+        if (self != group.waiters.end()) {
+            group.waiters.erase(self);
+        }
+
+        if (group.waiters.empty()) {
+            partition.groups.erase(collectionUUID);
+        } else {
+            group.waiters.front()->state = WaiterState::kLeader;
+            group.waiters.front()->cv.notify_one();
+        }
+    });
+
+    if (MONGO_unlikely(hangInsertGroupCommitLeader.shouldFail())) {
+        lk.unlock();
+        hangInsertGroupCommitLeader.pauseWhileSet(opCtx);
+        lk.lock();
+    }
+
+    const size_t maxBatchSize = internalInsertMaxBatchSize.load();
+    size_t bytesInBatch = 0;
+    while (!group.waiters.empty() && batch.size() < maxBatchSize &&
+           bytesInBatch < write_ops::insertVectorMaxBytes) {
+        auto waiter = group.waiters.front();
+        stmts.push_back(*waiter->stmt);
+        group.waiters.pop_front();
+        waiter->state = WaiterState::kInProgress;
+        batch.push_back(waiter);
+        bytesInBatch += waiter->stmt->doc.objsize();
+    }
+    lk.unlock();
+
+    try {
+        insertBatch(stmts.begin(), stmts.end());
+        inserted = true;
+    } catch (const DBException& ex) {
+        LOGV2_DEBUG(5189101,
+                    2,
+                    "Group commit of inserts failed, inserting the documents one at a time",
+                    "collectionUUID"_attr = collectionUUID,
+                    "numDocuments"_attr = stmts.size(),
+                    "error"_attr = ex.toStatus());
+    }
+
+    if (inserted && batch.size() > 1) {
+        groupedCommitsCounter.increment();
+        groupedInsertsCounter.increment(batch.size());
+    }
+    return inserted;
+}
+
+}  // namespace mongo
@@ -0,0 +1,127 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include "mongo/db/operation_context.h"
+#include "mongo/db/repl/oplog.h"
+#include "mongo/db/service_context.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/uuid.h"
+
+namespace mongo {
+
+/**
+ * Coalesces concurrent single-document inserts into the same collection so that they share one
+ * storage transaction, one reservation of oplog slots and one advance of oplog visibility. The
+ * first operation to arrive for a collection becomes the leader and inserts its own document
+ * together with every document queued behind it. Operations that arrive while a leader is
+ * inserting queue up, and the first of them leads the next group.
+ *
+ * Every participant keeps holding its own lock on the collection while it waits, so the collection
+ * cannot be dropped or renamed under the leader. If the group's transaction fails, nothing was
+ * inserted and each participant inserts its document by itself. This way an error such as a
+ * duplicate key is only reported to the operation whose document caused it.
+ */
+class InsertGroupCommitter {
+public:
+    /**
+     * Inserts the documents in [begin, end) in one storage transaction, on behalf of the leader of
+     * a group. Throws if the transaction fails, in which case none of the documents was inserted.
+     */
+    using InsertBatchFn = std::function<void(std::vector<InsertStatement>::iterator begin,
+                                             std::vector<InsertStatement>::iterator end)>;
+
+    static InsertGroupCommitter& get(ServiceContext* serviceContext);
+
+    /**
+     * Inserts 'stmt' into the collection 'collectionUUID', which the caller holds locked, together
+     * with the documents of other concurrent callers. If the caller becomes the leader of a group,
+     * the documents of the group are inserted through its 'insertBatch'. Returns true if the
+     * document was inserted, and false if the group's transaction failed and the caller must insert
+     * the document on its own. Throws if the operation is interrupted before a leader took its
+     * document.
+     */
+    bool insert(OperationContext* opCtx,
+                const UUID& collectionUUID,
+                InsertStatement* stmt,
+                const InsertBatchFn& insertBatch);
+
+    /**
+     * Returns the number of inserts into the collection 'collectionUUID' which wait for a leader to
+     * take their documents.
+     */
+    size_t numQueuedForTest(const UUID& collectionUUID);
+
+private:
+    enum class WaiterState { kQueued, kLeader, kInProgress, kDone };
+
+    struct Waiter {
+        explicit Waiter(InsertStatement* stmt) : stmt(stmt) {}
+
+        InsertStatement* const stmt;
+        WaiterState state = WaiterState::kQueued;
+        bool inserted = false;
+        stdx::condition_variable cv;
+    };
+
+    struct PendingGroup {
+        bool hasLeader = false;
+        std::deque<Waiter*> waiters;
+    };
+
+    struct Partition {
+        Mutex mutex = MONGO_MAKE_LATCH("InsertGroupCommitter::Partition::mutex");
+        stdx::unordered_map<UUID, PendingGroup, UUID::Hash> groups;
+    };
+
+    static constexpr size_t kNumPartitions = 16;
+
+    Partition& _getPartition(const UUID& collectionUUID) {
+        return _partitions[UUID::Hash()(collectionUUID) % kNumPartitions];
+    }
+
+    bool _lead(OperationContext* opCtx,
+               const UUID& collectionUUID,
+               stdx::unique_lock<Latch>& lk,
+               Partition& partition,
+               PendingGroup& group,
+               const InsertBatchFn& insertBatch);
+
+    std::array<Partition, kNumPartitions> _partitions;
+};
+
+}  // namespace mongo
@@ -0,0 +1,239 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/client.h"
+#include "mongo/db/ops/insert_group_committer.h"
+#include "mongo/db/service_context_test_fixture.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/notification.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+class InsertGroupCommitterTest : public ServiceContextTest {
+protected:
+    /**
+     * An operation inserting a single document on a thread of its own.
+     */
+    struct Participant {
+        ServiceContext::UniqueClient client;
+        ServiceContext::UniqueOperationContext opCtx;
+        InsertStatement stmt;
+        stdx::thread thread;
+        boost::optional<bool> inserted;
+        Status status = Status::OK();
+
+        void join() {
+            thread.join();
+        }
+    };
+
+    /**
+     * Starts an insert of the document {_id: 'id'}. If the insert leads a group, the group is
+     * recorded and then 'onInsert' is run in place of the storage transaction.
+     */
+    std::unique_ptr<Participant> startInsert(int id, std::function<void()> onInsert = [] {}) {
+        auto p = std::make_unique<Participant>();
+        p->client = getServiceContext()->makeClient(str::stream() << "insert" << id);
+        p->opCtx = p->client->makeOperationContext();
+        p->stmt = InsertStatement(BSON("_id" << id));
+        p->thread = stdx::thread([this, p = p.get(), onInsert = std::move(onInsert)] {
+            auto insertBatch = [&](std::vector<InsertStatement>::iterator begin,
+                                   std::vector<InsertStatement>::iterator end) {
+                std::vector<int> ids;
+                for (auto it = begin; it != end; ++it) {
+                    ids.push_back(it->doc["_id"].numberInt());
+                }
+                {
+                    stdx::lock_guard<Latch> lk(_mutex);
+                    _groups.push_back(std::move(ids));
+                }
+                onInsert();
+            };
+            try {
+                p->inserted = _committer.insert(p->opCtx.get(), _uuid, &p->stmt, insertBatch);
+            } catch (const DBException& ex) {
+                p->status = ex.toStatus();
+            } catch (const std::exception& ex) {
+                p->status = Status(ErrorCodes::UnknownError, ex.what());
+            }
+        });
+        return p;
+    }
+
+    void waitForQueued(size_t numQueued) {
+        while (_committer.numQueuedForTest(_uuid) != numQueued) {
+            sleepmillis(1);
+        }
+    }
+
+    std::vector<std::vector<int>> groups() {
+        stdx::lock_guard<Latch> lk(_mutex);
+        return _groups;
+    }
+
+    InsertGroupCommitter _committer;
+    const UUID _uuid = UUID::gen();
+
+    Mutex _mutex = MONGO_MAKE_LATCH("InsertGroupCommitterTest::_mutex");
+    std::vector<std::vector<int>> _groups;
+};
+
+TEST_F(InsertGroupCommitterTest, FirstQueuedInsertLeadsTheNextGroup) {
+    Notification<void> leaderInserting;
+    Notification<void> releaseLeader;
+    auto leader = startInsert(1, [&] {
+        leaderInserting.set();
+        releaseLeader.get();
+    });
+    leaderInserting.get();
+
+    // Both inserts queue up behind the leader, and the first of them inserts both documents.
+    auto second = startInsert(2);
+    waitForQueued(1);
+    auto third = startInsert(3);
+    waitForQueued(2);
+    releaseLeader.set();
+
+    leader->join();
+    second->join();
+    third->join();
+
+    ASSERT_TRUE(groups() == (std::vector<std::vector<int>>{{1}, {2, 3}}));
+    for (auto&& p : {leader.get(), second.get(), third.get()}) {
+        ASSERT_OK(p->status);
+        ASSERT_TRUE(*p->inserted);
+    }
+    ASSERT_EQ(_committer.numQueuedForTest(_uuid), 0U);
+}
+
+TEST_F(InsertGroupCommitterTest, InterruptedQueuedInsertWithdrawsItsDocument) {
+    Notification<void> leaderInserting;
+    Notification<void> releaseLeader;
+    auto leader = startInsert(1, [&] {
+        leaderInserting.set();
+        releaseLeader.get();
+    });
+    leaderInserting.get();
+
+    auto queued = startInsert(2);
+    waitForQueued(1);
+    {
+        stdx::lock_guard<Client> lk(*queued->client);
+        queued->opCtx->markKilled(ErrorCodes::Interrupted);
+    }
+    queued->join();
+    ASSERT_EQ(queued->status, ErrorCodes::Interrupted);
+    ASSERT_FALSE(queued->inserted);
+    ASSERT_EQ(_committer.numQueuedForTest(_uuid), 0U);
+
+    releaseLeader.set();
+    leader->join();
+    ASSERT_OK(leader->status);
+    ASSERT_TRUE(*leader->inserted);
+
+    // The group is gone once its leader finishes, so the next insert leads a group of its own.
+    auto next = startInsert(3);
+    next->join();
+    ASSERT_OK(next->status);
+    ASSERT_TRUE(*next->inserted);
+    ASSERT_TRUE(groups() == (std::vector<std::vector<int>>{{1}, {3}}));
+}
+
+TEST_F(InsertGroupCommitterTest, FailedGroupLeavesEachInsertToItsOperation) {
+    Notification<void> leaderInserting;
+    Notification<void> releaseLeader;
+    auto leader = startInsert(1, [&] {
+        leaderInserting.set();
+        releaseLeader.get();
+    });
+    leaderInserting.get();
+
+    auto second =
+        startInsert(2, [] { uasserted(ErrorCodes::InternalError, "group insert failed"); });
+    waitForQueued(1);
+    auto third = startInsert(3);
+    waitForQueued(2);
+    releaseLeader.set();
+
+    leader->join();
+    second->join();
+    third->join();
+
+    ASSERT_TRUE(groups() == (std::vector<std::vector<int>>{{1}, {2, 3}}));
+    ASSERT_TRUE(*leader->inserted);
+    // Neither document of the failed group was inserted, so both operations are told to insert
+    // their documents one at a time, and neither sees the error of the group.
+    for (auto&& p : {second.get(), third.get()}) {
+        ASSERT_OK(p->status);
+        ASSERT_FALSE(*p->inserted);
+    }
+}
+
+TEST_F(InsertGroupCommitterTest, LeaderFailingWithAnyExceptionReleasesItsGroup) {
+    Notification<void> leaderInserting;
+    Notification<void> releaseLeader;
+    auto leader = startInsert(1, [&] {
+        leaderInserting.set();
+        releaseLeader.get();
+    });
+    leaderInserting.get();
+
+    auto second = startInsert(2, [] { throw std::runtime_error("not a DBException"); });
+    waitForQueued(1);
+    auto third = startInsert(3);
+    waitForQueued(2);
+    releaseLeader.set();
+
+    leader->join();
+    second->join();
+    third->join();
+
+    // The exception reaches the leader only. The other member of its group is not left waiting.
+    ASSERT_EQ(second->status, ErrorCodes::UnknownError);
+    ASSERT_OK(third->status);
+    ASSERT_FALSE(*third->inserted);
+    ASSERT_EQ(_committer.numQueuedForTest(_uuid), 0U);
+
+    auto next = startInsert(4);
+    next->join();
+    ASSERT_TRUE(*next->inserted);
+}
+
+}  // namespace
+}  // namespace mongo
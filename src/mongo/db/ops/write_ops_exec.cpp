@@ -53,6 +53,7 @@
 #include "mongo/db/matcher/extensions_callback_real.h"
 #include "mongo/db/ops/delete_request_gen.h"
 #include "mongo/db/ops/insert.h"
+#include "mongo/db/ops/insert_group_committer.h"
 #include "mongo/db/ops/parsed_delete.h"
 #include "mongo/db/ops/parsed_update.h"
 #include "mongo/db/ops/update_request.h"
@@ -62,6 +63,7 @@
 #include "mongo/db/query/collection_query_info.h"
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/repl/repl_client_info.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/retryable_writes_stats.h"
@@ -346,6 +348,19 @@ Status checkIfTransactionOnCappedColl(OperationContext* opCtx, const CollectionP
     return Status::OK();
 }
 
+/**
+ * Returns true if the single-document insert of the current operation may share a storage
+ * transaction with the inserts of other operations. Retryable writes and writes in transactions
+ * are excluded because their oplog entries must carry the session that performed them.
+ */
+bool canGroupCommitInsert(OperationContext* opCtx,
+                          const CollectionPtr& collection,
+                          bool fromMigrate) {
+    return internalInsertGroupCommit.load() && !fromMigrate && !opCtx->getTxnNumber() &&
+        !opCtx->getClient()->isInDirectClient() && opCtx->writesAreReplicated() &&
+        !documentValidationDisabled(opCtx) && !collection->isCapped();
+}
+
 /**
  * Returns true if caller should try to insert more documents. Does nothing else if batch is empty.
  */
@@ -448,6 +463,42 @@ bool insertBatchAndHandleErrors(OperationContext* opCtx,
         }
     }
 
+    if (shouldProceedWithBatchInsert && batch.size() == 1 && !inTxn &&
+        canGroupCommitInsert(opCtx, collection->getCollection(), fromMigrate)) {
+        try {
+            lastOpFixer->startingOp();
+            const auto& coll = collection->getCollection();
+            auto insertBatch = [&](std::vector<InsertStatement>::iterator begin,
+                                   std::vector<InsertStatement>::iterator end) {
+                writeConflictRetry(opCtx, "groupCommitInsert", coll->ns().ns(), [&] {
+                    insertDocuments(opCtx, coll, begin, end, false);
+                });
+            };
+            if (InsertGroupCommitter::get(opCtx->getServiceContext())
+                    .insert(opCtx, coll->uuid(), &batch.front(), insertBatch)) {
+                // The leader of the group wrote the oplog entry of our document, so the client's
+                // last op has to be advanced here for write concern to wait for it.
+                auto& replClientInfo = repl::ReplClientInfo::forClient(opCtx->getClient());
+                const auto& opTime = batch.front().oplogSlot;
+                if (!opTime.isNull() && replClientInfo.getLastOp() < opTime) {
+                    replClientInfo.setLastOp(opCtx, opTime);
+                }
+                lastOpFixer->finishedOpSuccessfully();
+                globalOpCounters.gotInsert();
+                ServerWriteConcernMetrics::get(opCtx)->recordWriteConcernForInsert(
+                    opCtx->getWriteConcern());
+                SingleWriteResult result;
+                result.setN(1);
+                out->results.emplace_back(std::move(result));
+                curOp.debug().additiveMetrics.incrementNinserted(1);
+                return true;
+            }
+        } catch (const DBException&) {
+            // Behave as if we never tried to join a group. The loop below reports the error.
+            collection.reset();
+        }
+    }
+
     // Try to insert the batch one-at-a-time. This path is executed for singular batches,
     // multi-statement transactions, capped collections, and if we failed all-at-once inserting.
     for (auto it = batch.begin(); it != batch.end(); ++it) {
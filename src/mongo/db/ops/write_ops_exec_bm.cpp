@@ -0,0 +1,152 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/catalog/collection_impl.h"
+#include "mongo/db/catalog/database_holder_impl.h"
+#include "mongo/db/client.h"
+#include "mongo/db/dbmessage.h"
+#include "mongo/db/index/index_access_method_factory_impl.h"
+#include "mongo/db/index_builds_coordinator_mongod.h"
+#include "mongo/db/op_observer_impl.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/read_write_concern_defaults.h"
+#include "mongo/db/read_write_concern_defaults_cache_lookup_mock.h"
+#include "mongo/db/repl/oplog.h"
+#include "mongo/db/repl/replication_coordinator_mock.h"
+#include "mongo/db/repl/storage_interface_impl.h"
+#include "mongo/db/s/collection_sharding_state_factory_shard.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/service_entry_point_mongod.h"
+#include "mongo/db/storage/control/storage_control.h"
+#include "mongo/db/storage/storage_engine_init.h"
+#include "mongo/db/storage/storage_options.h"
+#include "mongo/rpc/get_status_from_command_result.h"
+#include "mongo/rpc/op_msg.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/util/periodic_runner_factory.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("test.write_ops_exec_bm");
+
+/**
+ * Starts the storage engine and the services the insert command depends on, once per process. The
+ * replication coordinator is a primary, so inserts reserve oplog slots and write oplog entries as
+ * they do on a replica set.
+ */
+void setUpMongoD() {
+    static const bool initialized = [] {
+        static unittest::TempDir tempDir("write_ops_exec_bm");
+        static ReadWriteConcernDefaultsLookupMock lookupMock;
+
+        // (Generic FCV reference): This FCV reference should exist across LTS binary versions.
+        serverGlobalParams.mutableFeatureCompatibility.setVersion(
+            ServerGlobalParams::FeatureCompatibility::kLatest);
+        serverGlobalParams.enableMajorityReadConcern = false;
+        storageGlobalParams.engine = "ephemeralForTest";
+        storageGlobalParams.engineSetByUser = true;
+        storageGlobalParams.dbpath = tempDir.path();
+
+        auto service = getGlobalServiceContext();
+        ThreadClient tc("write_ops_exec_bm", service);
+        service->setServiceEntryPoint(std::make_unique<ServiceEntryPointMongod>(service));
+        service->setPeriodicRunner(makePeriodicRunner(service));
+
+        auto opCtx = cc().makeOperationContext();
+        initializeStorageEngine(opCtx.get(),
+                                StorageEngineInitFlags::kAllowNoLockFile |
+                                    StorageEngineInitFlags::kSkipMetadataFile);
+        StorageControl::startStorageControls(service, true /*forTestOnly*/);
+        DatabaseHolder::set(service, std::make_unique<DatabaseHolderImpl>());
+        IndexAccessMethodFactory::set(service, std::make_unique<IndexAccessMethodFactoryImpl>());
+        Collection::Factory::set(service, std::make_unique<CollectionImpl::FactoryImpl>());
+        IndexBuildsCoordinator::set(service, std::make_unique<IndexBuildsCoordinatorMongod>());
+        CollectionShardingStateFactory::set(
+            service, std::make_unique<CollectionShardingStateFactoryShard>(service));
+        service->getStorageEngine()->notifyStartupComplete();
+
+        repl::StorageInterface::set(service, std::make_unique<repl::StorageInterfaceImpl>());
+        repl::ReplSettings replSettings;
+        replSettings.setOplogSizeBytes(1024 * 1024 * 1024);
+        replSettings.setReplSetString("rs0/host1");
+        auto replCoord = std::make_unique<repl::ReplicationCoordinatorMock>(service, replSettings);
+        invariant(replCoord->setFollowerMode(repl::MemberState::RS_PRIMARY));
+        repl::ReplicationCoordinator::set(service, std::move(replCoord));
+        repl::setOplogCollectionName(service);
+        repl::createOplog(opCtx.get());
+        service->setOpObserver(std::make_unique<OpObserverImpl>());
+        ReadWriteConcernDefaults::create(service, lookupMock.getFetchDefaultsFn());
+        return true;
+    }();
+    invariant(initialized);
+}
+
+/**
+ * Every benchmark thread is a client that inserts one document per insert command, the way many
+ * application connections do. The argument turns group commit of these inserts on or off.
+ */
+void BM_ConcurrentSingleDocumentInserts(benchmark::State& state) {
+    setUpMongoD();
+    internalInsertGroupCommit.store(state.range(0));
+
+    auto service = getGlobalServiceContext();
+    ThreadClient tc("write_ops_exec_bm-" + std::to_string(state.thread_index), service);
+    const auto request =
+        OpMsgRequest::fromDBAndBody(
+            kNss.db(),
+            BSON("insert" << kNss.coll() << "documents"
+                          << BSON_ARRAY(BSON("thread" << state.thread_index << "payload"
+                                                      << std::string(100, 'x')))))
+            .serialize();
+
+    for (auto keepRunning : state) {
+        auto opCtx = cc().makeOperationContext();
+        auto dbResponse =
+            service->getServiceEntryPoint()->handleRequest(opCtx.get(), request).get();
+        invariant(getStatusFromWriteCommandReply(OpMsg::parse(dbResponse.response).body));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_ConcurrentSingleDocumentInserts)
+    ->Arg(0)
+    ->Arg(1)
+    ->Threads(1)
+    ->Threads(64)
+    ->Threads(1000)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace mongo
@@ -49,9 +49,9 @@ const char* AccumulatorAddToSet::getOpName() const {
 
 void AccumulatorAddToSet::processInternal(const Value& input, bool merging) {
     auto addValue = [this](auto&& val) {
-        bool inserted = _set.insert(val).second;
+        auto [it, inserted] = _set.insert(val.getOwned());
         if (inserted) {
-            _memUsageBytes += val.getApproximateSize();
+            _memUsageBytes += it->getApproximateSize();
             uassert(ErrorCodes::ExceededMemoryLimit,
                     str::stream()
                         << "$addToSet used too much memory and cannot spill to disk. Memory limit: "
@@ -49,8 +49,8 @@ void AccumulatorFirst::processInternal(const Value& input, bool merging) {
     if (!_haveFirst) {
         // can't use pValue.missing() since we want the first value even if missing
         _haveFirst = true;
-        _first = input;
-        _memUsageBytes = sizeof(*this) + input.getApproximateSize() - sizeof(Value);
+        _first = input.getOwned();
+        _memUsageBytes = sizeof(*this) + _first.getApproximateSize() - sizeof(Value);
     }
 }
 
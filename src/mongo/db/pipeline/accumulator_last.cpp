@@ -46,7 +46,7 @@ const char* AccumulatorLast::getOpName() const {
 
 void AccumulatorLast::processInternal(const Value& input, bool merging) {
     /* always remember the last value seen */
-    _last = input;
+    _last = input.getOwned();
     _memUsageBytes = sizeof(*this) + _last.getApproximateSize() - sizeof(Value);
 }
 
@@ -56,8 +56,8 @@ void AccumulatorMinMax::processInternal(const Value& input, bool merging) {
         /* compare with the current value; swap if appropriate */
         int cmp = getExpressionContext()->getValueComparator().compare(_val, input) * _sense;
         if (cmp > 0 || _val.missing()) {  // missing is lower than all other values
-            _val = input;
-            _memUsageBytes = sizeof(*this) + input.getApproximateSize() - sizeof(Value);
+            _val = input.getOwned();
+            _memUsageBytes = sizeof(*this) + _val.getApproximateSize() - sizeof(Value);
         }
     }
 }
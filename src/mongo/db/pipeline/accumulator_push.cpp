@@ -50,8 +50,8 @@ const char* AccumulatorPush::getOpName() const {
 void AccumulatorPush::processInternal(const Value& input, bool merging) {
     if (!merging) {
         if (!input.missing()) {
-            _array.push_back(input);
-            _memUsageBytes += input.getApproximateSize();
+            _array.push_back(input.getOwned());
+            _memUsageBytes += _array.back().getApproximateSize();
             uassert(ErrorCodes::ExceededMemoryLimit,
                     str::stream()
                         << "$push used too much memory and cannot spill to disk. Memory limit: "
@@ -64,16 +64,15 @@ void AccumulatorPush::processInternal(const Value& input, bool merging) {
         // array from each merge source.
         invariant(input.getType() == Array);
 
-        const vector<Value>& vec = input.getArray();
-        for (auto&& val : vec) {
-            _memUsageBytes += val.getApproximateSize();
+        for (auto&& val : input.getArray()) {
+            _array.push_back(val.getOwned());
+            _memUsageBytes += _array.back().getApproximateSize();
             uassert(ErrorCodes::ExceededMemoryLimit,
                     str::stream()
                         << "$push used too much memory and cannot spill to disk. Memory limit: "
                         << _maxMemUsageBytes << " bytes",
                     _memUsageBytes < _maxMemUsageBytes);
         }
-        _array.insert(_array.end(), vec.begin(), vec.end());
     }
 }
 
@@ -368,6 +368,26 @@ TEST(Accumulators, PushRespectsMaxMemoryConstraint) {
         ErrorCodes::ExceededMemoryLimit);
 }
 
+TEST(Accumulators, PushDoesNotKeepSourceDocumentsAlive) {
+    auto expCtx = ExpressionContextForTest{};
+    const std::string padding(1000, 'x');
+    const BSONObj source =
+        BSON("sub" << BSON("padding" << padding) << "rest" << padding << "more" << padding);
+
+    auto push = AccumulatorPush::create(&expCtx);
+    for (int i = 0; i < 100; ++i) {
+        // Each input is a view of its own copy of 'source', as if read from a different document.
+        const Value sub = Document(source.copy())["sub"];
+        ASSERT_TRUE(sub.sharesLargerBuffer());
+
+        // The pushed value only accounts for the subobject, not the whole source document.
+        const int before = push->memUsageForSorter();
+        push->process(sub, false);
+        ASSERT_LT(push->memUsageForSorter() - before, source.objsize() / 2);
+    }
+    ASSERT_EQ(push->getValue(false).getArrayLength(), 100U);
+}
+
 /* ------------------------- AccumulatorMergeObjects -------------------------- */
 
 TEST(AccumulatorMergeObjects, MergingZeroObjectsShouldReturnEmptyDocument) {
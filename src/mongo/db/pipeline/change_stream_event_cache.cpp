@@ -0,0 +1,93 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/change_stream_event_cache.h"
+
+#include "mongo/db/service_context.h"
+
+namespace mongo {
+
+namespace {
+const auto getChangeStreamEventCache = ServiceContext::declareDecoration<ChangeStreamEventCache>();
+}  // namespace
+
+ChangeStreamEventCache& ChangeStreamEventCache::get(ServiceContext* serviceContext) {
+    return getChangeStreamEventCache(serviceContext);
+}
+
+boost::optional<ChangeStreamEventCache::Event> ChangeStreamEventCache::find(
+    const Key& key, const std::vector<FieldPath>& documentKeyFields) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    auto it = _events.find(key);
+    if (it == _events.end() || it->second.documentKeyFields != documentKeyFields) {
+        return boost::none;
+    }
+    ++_numHits;
+    return it->second.event;
+}
+
+void ChangeStreamEventCache::insert(const Key& key,
+                                    std::vector<FieldPath> documentKeyFields,
+                                    Event event,
+                                    size_t maxMemoryUsageBytes) {
+    size_t memoryUsageBytes = sizeof(Key) + sizeof(Entry) + event.bson.objsize();
+    for (auto&& name : event.fieldNames) {
+        memoryUsageBytes += sizeof(std::string) + name.size();
+    }
+    for (auto&& field : documentKeyFields) {
+        memoryUsageBytes += sizeof(FieldPath) + field.fullPath().size();
+    }
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    auto [it, inserted] = _events.try_emplace(key);
+    if (!inserted) {
+        _memoryUsageBytes -= it->second.memoryUsageBytes;
+    }
+    it->second = {std::move(documentKeyFields), std::move(event), memoryUsageBytes};
+    _memoryUsageBytes += memoryUsageBytes;
+
+    while (_memoryUsageBytes > maxMemoryUsageBytes) {
+        _memoryUsageBytes -= _events.begin()->second.memoryUsageBytes;
+        _events.erase(_events.begin());
+    }
+}
+
+size_t ChangeStreamEventCache::getMemoryUsageBytes() const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    return _memoryUsageBytes;
+}
+
+long long ChangeStreamEventCache::getNumHits() const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    return _numHits;
+}
+
+}  // namespace mongo
@@ -0,0 +1,132 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/pipeline/field_path.h"
+#include "mongo/db/repl/optime.h"
+#include "mongo/platform/mutex.h"
+
+namespace mongo {
+
+class ServiceContext;
+
+/**
+ * Holds the change stream events most recently built from the oplog, so that the change streams
+ * open on this node which read the same oplog entries with the same options share each event
+ * instead of each transforming every entry. Streams which keep up with the oplog all read its
+ * newest entries, so once the cache exceeds its memory limit it evicts the events of the oldest
+ * entries first.
+ *
+ * Events are held as BSON rather than as Documents, since a Document caches the fields it reads
+ * from its BSON and so cannot be read by several streams at once. BSON leaves out the fields of an
+ * event whose values are missing, such as the 'fullDocument' of an update, which later stages set
+ * in place. So the names of all fields of the event are kept alongside it, in order.
+ *
+ * This class is thread-safe.
+ */
+class ChangeStreamEventCache {
+public:
+    /**
+     * Identifies an event by the position of its change in the oplog and by the options of the
+     * stream which affect how the change is transformed. An OpTime is never reused for another
+     * entry, even across rollbacks, since the term is part of it.
+     */
+    struct Key {
+        bool operator<(const Key& other) const {
+            return std::tie(opTime, txnOpIndex, includePreImageOptime) <
+                std::tie(other.opTime, other.txnOpIndex, other.includePreImageOptime);
+        }
+
+        // The OpTime of the oplog entry, or of the entry which committed the transaction the
+        // change is part of.
+        repl::OpTime opTime;
+
+        // The position of the change in its transaction, or 0 if it is not part of one.
+        size_t txnOpIndex = 0;
+
+        // Whether the event holds the OpTime of the pre-image of the change.
+        bool includePreImageOptime = false;
+    };
+
+    struct Event {
+        // The fields of the event which have values.
+        BSONObj bson;
+
+        // The names of all fields of the event in order, including those missing from 'bson'.
+        std::vector<std::string> fieldNames;
+    };
+
+    static ChangeStreamEventCache& get(ServiceContext* serviceContext);
+
+    /**
+     * Returns the event cached for 'key', if it was built with the same 'documentKeyFields'.
+     */
+    boost::optional<Event> find(const Key& key, const std::vector<FieldPath>& documentKeyFields);
+
+    /**
+     * Caches 'event', which was built with 'documentKeyFields', for 'key', then evicts the events
+     * of the oldest oplog entries until the cache uses no more than 'maxMemoryUsageBytes'.
+     */
+    void insert(const Key& key,
+                std::vector<FieldPath> documentKeyFields,
+                Event event,
+                size_t maxMemoryUsageBytes);
+
+    /**
+     * Returns the approximate amount of memory used by the cached events.
+     */
+    size_t getMemoryUsageBytes() const;
+
+    /**
+     * Returns the number of calls to find() which returned an event.
+     */
+    long long getNumHits() const;
+
+private:
+    struct Entry {
+        std::vector<FieldPath> documentKeyFields;
+        Event event;
+        size_t memoryUsageBytes;
+    };
+
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("ChangeStreamEventCache::_mutex");
+
+    std::map<Key, Entry> _events;
+    size_t _memoryUsageBytes = 0;
+    long long _numHits = 0;
+};
+
+}  // namespace mongo
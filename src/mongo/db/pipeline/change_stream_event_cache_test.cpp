@@ -0,0 +1,122 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <limits>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/pipeline/change_stream_event_cache.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const size_t kNoMemoryLimit = std::numeric_limits<size_t>::max();
+
+// An event whose "fullDocument" is missing, as it is for a delete.
+ChangeStreamEventCache::Event makeEvent(int id) {
+    return {BSON("_id" << id), {"_id", "fullDocument"}};
+}
+
+ChangeStreamEventCache::Key makeKey(unsigned int secs, long long term, size_t txnOpIndex = 0) {
+    return {repl::OpTime(Timestamp(secs, 1), term), txnOpIndex};
+}
+
+TEST(ChangeStreamEventCacheTest, FindReturnsInsertedEvent) {
+    ChangeStreamEventCache cache;
+    const std::vector<FieldPath> documentKeyFields{FieldPath("_id")};
+    cache.insert(makeKey(1, 1), documentKeyFields, makeEvent(1), kNoMemoryLimit);
+
+    auto event = cache.find(makeKey(1, 1), documentKeyFields);
+    ASSERT_TRUE(event);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 1), event->bson);
+    ASSERT(event->fieldNames == (std::vector<std::string>{"_id", "fullDocument"}));
+    ASSERT_EQ(1, cache.getNumHits());
+}
+
+TEST(ChangeStreamEventCacheTest, FindMissesOnDifferentKey) {
+    ChangeStreamEventCache cache;
+    const std::vector<FieldPath> documentKeyFields{FieldPath("_id")};
+    cache.insert(makeKey(1, 1), documentKeyFields, makeEvent(1), kNoMemoryLimit);
+
+    // An entry rewritten after a rollback has the same timestamp but a different term.
+    ASSERT_FALSE(cache.find(makeKey(1, 2), documentKeyFields));
+    ASSERT_FALSE(cache.find(makeKey(1, 1, 1), documentKeyFields));
+    ASSERT_FALSE(cache.find(makeKey(2, 1), documentKeyFields));
+
+    auto includePreImageKey = makeKey(1, 1);
+    includePreImageKey.includePreImageOptime = true;
+    ASSERT_FALSE(cache.find(includePreImageKey, documentKeyFields));
+    ASSERT_EQ(0, cache.getNumHits());
+}
+
+TEST(ChangeStreamEventCacheTest, FindMissesOnDifferentDocumentKeyFields) {
+    ChangeStreamEventCache cache;
+    cache.insert(makeKey(1, 1), {FieldPath("_id")}, makeEvent(1), kNoMemoryLimit);
+
+    ASSERT_FALSE(cache.find(makeKey(1, 1), {FieldPath("x"), FieldPath("_id")}));
+    ASSERT_FALSE(cache.find(makeKey(1, 1), {}));
+    ASSERT_EQ(0, cache.getNumHits());
+}
+
+TEST(ChangeStreamEventCacheTest, InsertReplacesExistingEvent) {
+    ChangeStreamEventCache cache;
+    const std::vector<FieldPath> documentKeyFields{FieldPath("_id")};
+    cache.insert(makeKey(1, 1), documentKeyFields, makeEvent(1), kNoMemoryLimit);
+    const auto memoryUsageBytes = cache.getMemoryUsageBytes();
+    cache.insert(makeKey(1, 1), documentKeyFields, makeEvent(2), kNoMemoryLimit);
+
+    ASSERT_EQ(memoryUsageBytes, cache.getMemoryUsageBytes());
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 2), cache.find(makeKey(1, 1), documentKeyFields)->bson);
+}
+
+TEST(ChangeStreamEventCacheTest, InsertEvictsOldestEventsOverMemoryLimit) {
+    ChangeStreamEventCache cache;
+    const std::vector<FieldPath> documentKeyFields{FieldPath("_id")};
+    cache.insert(makeKey(2, 1), documentKeyFields, makeEvent(2), kNoMemoryLimit);
+    const auto entryMemoryUsageBytes = cache.getMemoryUsageBytes();
+    cache.insert(makeKey(1, 1), documentKeyFields, makeEvent(1), kNoMemoryLimit);
+    ASSERT_EQ(2 * entryMemoryUsageBytes, cache.getMemoryUsageBytes());
+
+    // The limit fits two of the events, so adding a third evicts the one with the earliest optime.
+    cache.insert(makeKey(3, 1), documentKeyFields, makeEvent(3), 2 * entryMemoryUsageBytes);
+    ASSERT_EQ(2 * entryMemoryUsageBytes, cache.getMemoryUsageBytes());
+    ASSERT_FALSE(cache.find(makeKey(1, 1), documentKeyFields));
+    ASSERT_TRUE(cache.find(makeKey(2, 1), documentKeyFields));
+    ASSERT_TRUE(cache.find(makeKey(3, 1), documentKeyFields));
+
+    // An event which does not fit on its own is not kept.
+    cache.insert(makeKey(4, 1), documentKeyFields, makeEvent(4), 0);
+    ASSERT_EQ(0U, cache.getMemoryUsageBytes());
+    ASSERT_FALSE(cache.find(makeKey(4, 1), documentKeyFields));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -42,6 +42,7 @@
 #include "mongo/db/exec/document_value/value.h"
 #include "mongo/db/exec/document_value/value_comparator.h"
 #include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/change_stream_event_cache.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_change_stream.h"
 #include "mongo/db/pipeline/document_source_change_stream_transform.h"
@@ -51,6 +52,7 @@
 #include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/document_source_sort.h"
 #include "mongo/db/pipeline/process_interface/stub_mongo_process_interface.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/repl/oplog_entry.h"
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/db/transaction_history_iterator.h"
@@ -82,7 +84,18 @@ class ChangeStreamStageTestNoSetup : public AggregationContextFixture {
 public:
     ChangeStreamStageTestNoSetup() : ChangeStreamStageTestNoSetup(nss) {}
     explicit ChangeStreamStageTestNoSetup(NamespaceString nsString)
-        : AggregationContextFixture(nsString) {}
+        : AggregationContextFixture(nsString) {
+        // Many tests transform different entries with the same optime, so the events they build
+        // must not be shared through the event cache unless a test asks for it.
+        internalChangeStreamEventCacheMaxBytes.store(0);
+    }
+
+    ~ChangeStreamStageTestNoSetup() {
+        internalChangeStreamEventCacheMaxBytes.store(_originalEventCacheMaxBytes);
+    }
+
+private:
+    const long long _originalEventCacheMaxBytes = internalChangeStreamEventCacheMaxBytes.load();
 };
 
 struct MockMongoInterface final : public StubMongoProcessInterface {
@@ -598,6 +611,101 @@ TEST_F(ChangeStreamStageTest, TransformInsertDocKeyXAndId) {
     checkTransformation(insert2, expectedInsert, {{"x"}, {"_id"}});
 }
 
+TEST_F(ChangeStreamStageTest, TransformInsertSharesEventBetweenStreams) {
+    internalChangeStreamEventCacheMaxBytes.store(1024 * 1024);
+    auto insert = makeOplogEntry(OpTypeEnum::kInsert,           // op type
+                                 nss,                           // namespace
+                                 BSON("_id" << 1 << "x" << 2),  // o
+                                 testUuid(),                    // uuid
+                                 boost::none,                   // fromMigrate
+                                 boost::none);                  // o2
+
+    const auto resumeToken = makeResumeToken(kDefaultTs, testUuid(), BSON("x" << 2 << "_id" << 1));
+    Document expectedInsert{
+        {DSChangeStream::kIdField, resumeToken},
+        {DSChangeStream::kOperationTypeField, DSChangeStream::kInsertOpType},
+        {DSChangeStream::kClusterTimeField, kDefaultTs},
+        {DSChangeStream::kFullDocumentField, D{{"_id", 1}, {"x", 2}}},
+        {DSChangeStream::kNamespaceField, D{{"db", nss.db()}, {"coll", nss.coll()}}},
+        {DSChangeStream::kDocumentKeyField, D{{"x", 2}, {"_id", 1}}},
+    };
+    auto& eventCache = ChangeStreamEventCache::get(getExpCtx()->opCtx->getServiceContext());
+    checkTransformation(insert, expectedInsert, {{"x"}, {"_id"}});
+    ASSERT_EQ(0, eventCache.getNumHits());
+
+    // A second stream transforming the same entry is given the event built by the first, along
+    // with its resume token as the sort key.
+    auto stages = makeStages(insert.toBSON(), kDefaultSpec);
+    getExpCtx()->mongoProcessInterface =
+        std::make_unique<MockMongoInterface>(std::vector<FieldPath>{{"x"}, {"_id"}});
+    auto next = stages.back()->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_EQ(1, eventCache.getNumHits());
+    ASSERT_VALUE_EQ(Value(resumeToken), next.getDocument().metadata().getSortKey());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(), expectedInsert);
+
+    // A stream with a different document key builds its own event.
+    Document expectedInsertIdOnly{
+        {DSChangeStream::kIdField, makeResumeToken(kDefaultTs, testUuid(), BSON("_id" << 1))},
+        {DSChangeStream::kOperationTypeField, DSChangeStream::kInsertOpType},
+        {DSChangeStream::kClusterTimeField, kDefaultTs},
+        {DSChangeStream::kFullDocumentField, D{{"_id", 1}, {"x", 2}}},
+        {DSChangeStream::kNamespaceField, D{{"db", nss.db()}, {"coll", nss.coll()}}},
+        {DSChangeStream::kDocumentKeyField, D{{"_id", 1}}},
+    };
+    checkTransformation(insert, expectedInsertIdOnly, {{"_id"}});
+    ASSERT_EQ(1, eventCache.getNumHits());
+}
+
+TEST_F(ChangeStreamStageTest, UpdateLookupEventFromEventCacheHasSameFieldOrder) {
+    internalChangeStreamEventCacheMaxBytes.store(1024 * 1024);
+    BSONObj o = BSON("$set" << BSON("y" << 1));
+    BSONObj o2 = BSON("_id" << 1);
+    auto updateField = makeOplogEntry(OpTypeEnum::kUpdate,  // op type
+                                      nss,                  // namespace
+                                      o,                    // o
+                                      testUuid(),           // uuid
+                                      boost::none,          // fromMigrate
+                                      o2);                  // o2
+    const auto spec = BSON("$changeStream" << BSON("fullDocument"
+                                                   << "updateLookup"));
+
+    auto nextEvent = [&] {
+        auto stages = makeStages(updateField.toBSON(), spec);
+        getExpCtx()->mongoProcessInterface = std::make_unique<MockMongoInterface>(
+            std::vector<FieldPath>{},
+            std::vector<repl::OplogEntry>{},
+            std::vector<Document>{Document{{"_id", 1}, {"y", 1}}});
+        auto next = stages.back()->getNext();
+        ASSERT_TRUE(next.isAdvanced());
+        return next.releaseDocument();
+    };
+
+    // The looked up post-image takes the place of the missing 'fullDocument' of the event, both
+    // when the stream builds the event and when it takes the event from the cache.
+    Document expectedUpdateField{
+        {DSChangeStream::kIdField, makeResumeToken(kDefaultTs, testUuid(), o2)},
+        {DSChangeStream::kOperationTypeField, DSChangeStream::kUpdateOpType},
+        {DSChangeStream::kClusterTimeField, kDefaultTs},
+        {DSChangeStream::kFullDocumentField, D{{"_id", 1}, {"y", 1}}},
+        {DSChangeStream::kNamespaceField, D{{"db", nss.db()}, {"coll", nss.coll()}}},
+        {DSChangeStream::kDocumentKeyField, D{{"_id", 1}}},
+        {
+            "updateDescription",
+            D{{"updatedFields", D{{"y", 1}}}, {"removedFields", vector<V>()}},
+        },
+    };
+    auto& eventCache = ChangeStreamEventCache::get(getExpCtx()->opCtx->getServiceContext());
+    auto builtEvent = nextEvent();
+    ASSERT_EQ(0, eventCache.getNumHits());
+    auto cachedEvent = nextEvent();
+    ASSERT_EQ(1, eventCache.getNumHits());
+
+    // BSON comparisons take the order of the fields into account.
+    ASSERT_BSONOBJ_EQ(builtEvent.toBson(), expectedUpdateField.toBson());
+    ASSERT_BSONOBJ_EQ(cachedEvent.toBson(), builtEvent.toBson());
+}
+
 TEST_F(ChangeStreamStageTest, TransformInsertDocKeyIdAndX) {
     auto insert = makeOplogEntry(OpTypeEnum::kInsert,           // op type
                                  nss,                           // namespace
@@ -49,6 +49,7 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
 #include "mongo/db/pipeline/resume_token.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/repl/bson_extract_optime.h"
 #include "mongo/db/repl/oplog_entry.h"
 #include "mongo/db/repl/oplog_entry_gen.h"
@@ -67,6 +68,54 @@ using std::vector;
 
 namespace {
 constexpr auto checkValueType = &DocumentSourceChangeStream::checkValueType;
+
+// The fields of a change stream event, in the order in which buildEvent() adds them.
+const std::vector<StringData> kEventFieldNames{
+    DocumentSourceChangeStream::kRenameTargetNssField,
+    DocumentSourceChangeStream::kTxnNumberField,
+    DocumentSourceChangeStream::kLsidField,
+    DocumentSourceChangeStream::kIdField,
+    DocumentSourceChangeStream::kOperationTypeField,
+    DocumentSourceChangeStream::kClusterTimeField,
+    DocumentSourceChangeStream::kFullDocumentField,
+    DocumentSourceChangeStream::kFullDocumentBeforeChangeField,
+    DocumentSourceChangeStream::kNamespaceField,
+    DocumentSourceChangeStream::kDocumentKeyField,
+    DocumentSourceChangeStream::kUpdateDescriptionField,
+};
+
+/**
+ * Returns 'event' in the form it is kept in the change stream event cache.
+ */
+ChangeStreamEventCache::Event toCachedEvent(const Document& event) {
+    ChangeStreamEventCache::Event cachedEvent{event.toBson(), {}};
+    for (auto&& name : kEventFieldNames) {
+        // Fields whose values are missing are found too.
+        if (event.positionOf(name).found()) {
+            cachedEvent.fieldNames.push_back(name.toString());
+        }
+    }
+    dassert(cachedEvent.fieldNames.size() >= static_cast<size_t>(cachedEvent.bson.nFields()));
+    return cachedEvent;
+}
+
+/**
+ * Rebuilds an event from the change stream event cache with the same fields in the same order as
+ * the event built from the oplog entry, so that the stages after the transformation set the
+ * missing fields in place rather than append them.
+ */
+Document fromCachedEvent(const ChangeStreamEventCache::Event& cachedEvent) {
+    MutableDocument event(cachedEvent.fieldNames.size());
+    auto it = Document(cachedEvent.bson).fieldIterator();
+    for (auto&& name : cachedEvent.fieldNames) {
+        if (it.more() && it.fieldName() == name) {
+            event.addField(name, it.next().second);
+        } else {
+            event.addField(name, Value());
+        }
+    }
+    return event.freeze();
+}
 }  // namespace
 
 boost::intrusive_ptr<DocumentSourceChangeStreamTransform>
@@ -180,8 +229,6 @@ Document DocumentSourceChangeStreamTransform::applyTransformation(const Document
         invariant(pExpCtx->needsMerge);
     }
 
-    MutableDocument doc;
-
     // Extract the fields we need.
     checkValueType(input[repl::OplogEntry::kOpTypeFieldName],
                    repl::OplogEntry::kOpTypeFieldName,
@@ -191,7 +238,6 @@ Document DocumentSourceChangeStreamTransform::applyTransformation(const Document
     Value ns = input[repl::OplogEntry::kNssFieldName];
     checkValueType(ns, repl::OplogEntry::kNssFieldName, BSONType::String);
     Value uuid = input[repl::OplogEntry::kUuidFieldName];
-    Value preImageOpTime = input[repl::OplogEntry::kPreImageOpTimeFieldName];
     std::vector<FieldPath> documentKeyFields;
 
     // Deal with CRUD operations and commands.
@@ -217,6 +263,67 @@ Document DocumentSourceChangeStreamTransform::applyTransformation(const Document
 
         documentKeyFields = _documentKeyCache.find(uuid.getUuid())->second.documentKeyFields;
     }
+
+    // Change streams which read the same oplog entry with the same options build the same event
+    // from it, so use the event built by another stream if there is one.
+    auto eventCacheKey = getEventCacheKey(input, ts);
+    if (!eventCacheKey) {
+        return buildEvent(input, opType, std::move(nss), ts, uuid, documentKeyFields);
+    }
+
+    auto& eventCache = ChangeStreamEventCache::get(pExpCtx->opCtx->getServiceContext());
+    if (auto cachedEvent = eventCache.find(*eventCacheKey, documentKeyFields)) {
+        // The resume token is the sort key of the event, as it is for the events built below.
+        MutableDocument event{fromCachedEvent(*cachedEvent)};
+        const bool isSingleElementKey = true;
+        event.metadata().setSortKey(event.peek()[DocumentSourceChangeStream::kIdField],
+                                    isSingleElementKey);
+        return event.freeze();
+    }
+
+    auto event = buildEvent(input, opType, std::move(nss), ts, uuid, documentKeyFields);
+    // Events which may not fit in a BSON object are left for each stream to build, so that
+    // serializing them here cannot fail a stream which would have reduced them.
+    if (event.getApproximateSize() <= BSONObjMaxUserSize) {
+        eventCache.insert(*eventCacheKey,
+                          std::move(documentKeyFields),
+                          toCachedEvent(event),
+                          internalChangeStreamEventCacheMaxBytes.load());
+    }
+    return event;
+}
+
+boost::optional<ChangeStreamEventCache::Key> DocumentSourceChangeStreamTransform::getEventCacheKey(
+    const Document& input, Value ts) {
+    if (internalChangeStreamEventCacheMaxBytes.load() == 0) {
+        return boost::none;
+    }
+
+    ChangeStreamEventCache::Key key;
+    key.includePreImageOptime = _includePreImageOptime;
+    if (_txnIterator) {
+        key.opTime = _txnIterator->txnOpTime();
+        key.txnOpIndex = _txnIterator->txnOpIndex();
+        return key;
+    }
+
+    Value term = input[repl::OplogEntry::kTermFieldName];
+    if (ts.getType() != BSONType::bsonTimestamp || !term.integral64Bit()) {
+        return boost::none;
+    }
+    key.opTime = repl::OpTime(ts.getTimestamp(), term.coerceToLong());
+    return key;
+}
+
+Document DocumentSourceChangeStreamTransform::buildEvent(
+    const Document& input,
+    repl::OpTypeEnum opType,
+    NamespaceString nss,
+    Value ts,
+    Value uuid,
+    const std::vector<FieldPath>& documentKeyFields) {
+    MutableDocument doc;
+    Value preImageOpTime = input[repl::OplogEntry::kPreImageOpTimeFieldName];
     Value id = input.getNestedField("o._id");
     // Non-replace updates have the _id in field "o2".
     StringData operationType;
@@ -499,7 +606,7 @@ DocumentSourceChangeStreamTransform::TransactionOpIterator::TransactionOpIterato
                                                       << input[repl::OpTime::kTimestampFieldName]
                                                       << repl::OpTime::kTermFieldName
                                                       << input[repl::OpTime::kTermFieldName]));
-    _clusterTime = txnOpTime.getTimestamp();
+    _txnOpTime = txnOpTime;
 
     auto commandObj = input["o"].getDocument();
     Value applyOps = commandObj["applyOps"];
@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include "mongo/db/pipeline/change_stream_event_cache.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_change_stream.h"
 #include "mongo/db/pipeline/document_source_change_stream_gen.h"
@@ -126,7 +127,11 @@ private:
         }
 
         Timestamp clusterTime() const {
-            return _clusterTime;
+            return _txnOpTime.getTimestamp();
+        }
+
+        repl::OpTime txnOpTime() const {
+            return _txnOpTime;
         }
 
         Document lsid() const {
@@ -181,8 +186,9 @@ private:
         // arrays.
         size_t _txnOpIndex;
 
-        // The clusterTime of the _applyOps.
-        Timestamp _clusterTime;
+        // The OpTime of the _applyOps, or of the commit of a prepared transaction. Its timestamp is
+        // the clusterTime of every operation in the transaction.
+        repl::OpTime _txnOpTime;
 
         // Fields that were taken from the '_applyOps' oplog entry.
         Document _lsid;
@@ -200,6 +206,23 @@ private:
      */
     ResumeTokenData getResumeToken(Value ts, Value uuid, Value documentKey);
 
+    /**
+     * Returns the key of the event for the oplog entry 'input', whose timestamp is 'ts', in the
+     * change stream event cache, or boost::none if the cache is disabled or the entry has no term.
+     */
+    boost::optional<ChangeStreamEventCache::Key> getEventCacheKey(const Document& input, Value ts);
+
+    /**
+     * Builds the change stream event for the oplog entry 'input', from which the operation type,
+     * namespace, timestamp and uuid have already been extracted.
+     */
+    Document buildEvent(const Document& input,
+                        repl::OpTypeEnum opType,
+                        NamespaceString nss,
+                        Value ts,
+                        Value uuid,
+                        const std::vector<FieldPath>& documentKeyFields);
+
     BSONObj _changeStreamSpec;
 
     // Map of collection UUID to document key fields.
@@ -298,7 +298,12 @@ Value DocumentSourceGroup::serialize(boost::optional<ExplainOptions::Verbosity>
         insides["$doingMerge"] = Value(true);
     }
 
-    return Value(DOC(getSourceName() << insides.freeze()));
+    MutableDocument out;
+    out[getSourceName()] = insides.freezeToValue();
+    if (explain && *explain >= ExplainOptions::Verbosity::kExecStats && _usedDisk) {
+        out["spillCompressionRatio"] = Value(_spillStats.compressionRatio());
+    }
+    return out.freezeToValue();
 }
 
 DepsTracker::State DocumentSourceGroup::getDependencies(DepsTracker* deps) const {
@@ -522,7 +527,8 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
         // We release the result document here so that it does not outlive the end of this loop
         // iteration. Not releasing could lead to an array copy when this group follows an unwind.
         auto rootDocument = input.releaseDocument();
-        Value id = computeId(rootDocument);
+        // The _id may be kept as a key of '_groups', so it must not pin the input document.
+        Value id = computeId(rootDocument).getOwned();
 
         // Look for the _id value in the map. If it's not there, add a new entry with a blank
         // accumulator. This is done in a somewhat odd way in order to avoid hashing 'id' and
@@ -635,7 +641,13 @@ shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill() {
     stable_sort(ptrs.begin(), ptrs.end(), SpillSTLComparator(pExpCtx->getValueComparator()));
 
     SortedFileWriter<Value, Value> writer(
-        SortOptions().TempDir(pExpCtx->tempDir), _fileName, _nextSortedFileWriterOffset);
+        SortOptions()
+            .TempDir(pExpCtx->tempDir)
+            .SpillCompressor(
+                uassertStatusOK(parseSorterSpillCompressor(internalSorterSpillCompressor)))
+            .SpillCompressionLevel(internalSorterSpillCompressionLevel.load()),
+        _fileName,
+        _nextSortedFileWriterOffset);
     switch (_accumulatedFields.size()) {  // same as ptrs[i]->second.size() for all i.
         case 0:                           // no values, essentially a distinct
             for (size_t i = 0; i < ptrs.size(); i++) {
@@ -665,6 +677,7 @@ shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill() {
 
     Sorter<Value, Value>::Iterator* iteratorPtr = writer.done();
     _nextSortedFileWriterOffset = writer.getFileEndOffset();
+    _spillStats.add(writer.spillStats());
     return shared_ptr<Sorter<Value, Value>::Iterator>(iteratorPtr);
 }
 
@@ -256,6 +256,7 @@ private:
     std::vector<AccumulationStatement> _accumulatedFields;
 
     bool _usedDisk;  // Keeps track of whether this $group spilled to disk.
+    SorterSpillStats _spillStats;
     bool _doingMerge;
 
     MemoryUsageTracker _memoryTracker;
@@ -27,6 +27,8 @@
  *    it in the license file.
  */
 
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kQuery
+
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/pipeline/document_source_lookup.h"
@@ -40,10 +42,12 @@
 #include "mongo/db/matcher/expression_algo.h"
 #include "mongo/db/pipeline/document_path_support.h"
 #include "mongo/db/pipeline/document_source_merge_gen.h"
+#include "mongo/db/pipeline/document_source_queue.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/variable_validation.h"
 #include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/logv2/log.h"
 #include "mongo/platform/overflow_arithmetic.h"
 #include "mongo/util/fail_point.h"
 
@@ -87,6 +91,50 @@ bool foreignShardedLookupAllowed() {
     return getTestCommandsEnabled() && internalQueryAllowShardedLookup.load();
 }
 
+/**
+ * Calls 'buildForeignPipeline' and returns its result. If lookup on a sharded collection is
+ * disallowed and the foreign collection is sharded, throws a custom exception.
+ */
+template <typename BuildFn>
+auto checkForeignCollectionIsUnsharded(BuildFn&& buildForeignPipeline) {
+    try {
+        return buildForeignPipeline();
+    } catch (const ExceptionForCat<ErrorCategory::StaleShardVersionError>& ex) {
+        if (auto staleInfo = ex.extraInfo<StaleConfigInfo>()) {
+            uassert(51069,
+                    "Cannot run $lookup with sharded foreign collection",
+                    foreignShardedLookupAllowed() || !staleInfo->getVersionWanted() ||
+                        staleInfo->getVersionWanted() == ChunkVersion::UNSHARDED());
+        }
+        throw;
+    }
+}
+
+/**
+ * Constructs a $match stage of the following shape, which finds the foreign documents joining
+ * with any document of a batch whose local values are 'values':
+ *  {$match: {$and: [{'foreignFieldName': {$in: ['values']}}, 'additionalFilter']}}
+ */
+BSONObj buildBatchMatchStage(const std::string& foreignFieldName,
+                             const ValueSet& values,
+                             const BSONObj& additionalFilter) {
+    BSONObjBuilder match;
+    BSONObjBuilder query(match.subobjStart("$match"));
+    BSONArrayBuilder andObj(query.subarrayStart("$and"));
+    {
+        BSONObjBuilder joiningObj(andObj.subobjStart());
+        BSONObjBuilder subObj(joiningObj.subobjStart(foreignFieldName));
+        BSONArrayBuilder inList(subObj.subarrayStart("$in"));
+        for (auto&& value : values) {
+            inList << value;
+        }
+    }
+    andObj.append(additionalFilter);
+    andObj.doneFast();
+    query.doneFast();
+    return match.obj();
+}
+
 // Parses $lookup 'from' field. The 'from' field must be a string or an object in the form of
 // {from: {db: "config", coll: "cache.chunks.*}, ...}.
 NamespaceString parseLookupFromAndResolveNamespace(const BSONElement& elem, StringData defaultDb) {
@@ -276,38 +324,19 @@ DocumentSource::GetNextResult DocumentSourceLookUp::doGetNext() {
         return unwindResult();
     }
 
-    auto nextInput = pSource->getNext();
-    if (!nextInput.isAdvanced()) {
-        return nextInput;
-    }
-
-    auto inputDoc = nextInput.releaseDocument();
-
     // If we have not absorbed a $unwind, we cannot absorb a $match. If we have absorbed a $unwind,
     // '_unwindSrc' would be non-null, and we would not have made it here.
     invariant(!_matchSrc);
 
-    if (!wasConstructedWithPipelineSyntax()) {
-        auto matchStage =
-            makeMatchStageFromInput(inputDoc, *_localField, _foreignField->fullPath(), BSONObj());
-        // We've already allocated space for the trailing $match stage in '_resolvedPipeline'.
-        _resolvedPipeline.back() = matchStage;
+    auto nextInput = getNextInput(BSONObj());
+    if (!nextInput.isAdvanced()) {
+        return nextInput;
     }
 
-    std::unique_ptr<Pipeline, PipelineDeleter> pipeline;
-    try {
-        pipeline = buildPipeline(inputDoc);
-    } catch (const ExceptionForCat<ErrorCategory::StaleShardVersionError>& ex) {
-        // If lookup on a sharded collection is disallowed and the foreign collection is sharded,
-        // throw a custom exception.
-        if (auto staleInfo = ex.extraInfo<StaleConfigInfo>()) {
-            uassert(51069,
-                    "Cannot run $lookup with sharded foreign collection",
-                    foreignShardedLookupAllowed() || !staleInfo->getVersionWanted() ||
-                        staleInfo->getVersionWanted() == ChunkVersion::UNSHARDED());
-        }
-        throw;
-    }
+    auto inputDoc = nextInput.releaseDocument();
+
+    auto pipeline =
+        checkForeignCollectionIsUnsharded([&] { return buildJoinPipeline(inputDoc, BSONObj()); });
 
     std::vector<Value> results;
     long long objsize = 0;
@@ -395,6 +424,206 @@ std::unique_ptr<Pipeline, PipelineDeleter> DocumentSourceLookUp::buildPipeline(
     return pipeline;
 }
 
+std::unique_ptr<Pipeline, PipelineDeleter> DocumentSourceLookUp::buildJoinPipeline(
+    const Document& inputDoc, const BSONObj& additionalFilter) {
+    if (wasConstructedWithPipelineSyntax()) {
+        return buildPipeline(inputDoc);
+    }
+
+    if (auto table = _hashTable ? _hashTable.get_ptr() : _batchTable.get_ptr()) {
+        if (auto matches = probeHashTable(*table, inputDoc)) {
+            auto queue = DocumentSourceQueue::create(_fromExpCtx);
+            for (auto&& match : *matches) {
+                queue->emplace_back(std::move(match));
+            }
+            return Pipeline::create({queue}, _fromExpCtx);
+        }
+    }
+
+    auto matchStage = makeMatchStageFromInput(
+        inputDoc, *_localField, _foreignField->fullPath(), additionalFilter);
+    // We've already allocated space for the trailing $match stage in '_resolvedPipeline'.
+    _resolvedPipeline.back() = matchStage;
+    return buildPipeline(inputDoc);
+}
+
+DocumentSource::GetNextResult DocumentSourceLookUp::getNextInput(const BSONObj& additionalFilter) {
+    if (!_inputBatch.empty()) {
+        auto next = std::move(_inputBatch.front());
+        _inputBatch.pop_front();
+        return next;
+    }
+
+    if (_inputBatchEnd) {
+        auto next = std::move(*_inputBatchEnd);
+        _inputBatchEnd.reset();
+        return next;
+    }
+
+    // The documents in '_batchTable' only join with the batch they were queried for.
+    _batchTable.reset();
+
+    auto nextInput = pSource->getNext();
+    if (!nextInput.isAdvanced() || wasConstructedWithPipelineSyntax()) {
+        return nextInput;
+    }
+
+    // A small input is joined by querying the foreign collection, so that it does not pay for
+    // reading the whole foreign collection into the hash table.
+    if (!_triedHashJoin &&
+        ++_numInputDocuments > internalDocumentSourceLookupHashJoinMinInputDocuments.load()) {
+        _triedHashJoin = true;
+        if (canUseHashJoin()) {
+            buildHashTable(additionalFilter);
+        }
+    }
+
+    if (!canBatchInput()) {
+        recordJoinStrategy(_hashTable ? JoinStrategy::kHashJoin : JoinStrategy::kNestedLoopJoin);
+        return nextInput;
+    }
+
+    _inputBatch.push_back(nextInput.releaseDocument());
+    fillInputBatch(additionalFilter);
+    // The documents of a batch whose foreign documents could not be read into '_batchTable' are
+    // queried for one at a time.
+    recordJoinStrategy(_batchTable ? JoinStrategy::kBatchedNestedLoopJoin
+                                   : JoinStrategy::kNestedLoopJoin);
+    auto next = std::move(_inputBatch.front());
+    _inputBatch.pop_front();
+    return next;
+}
+
+bool DocumentSourceLookUp::canBatchInput() const {
+    return !_hashTable && internalDocumentSourceLookupBatchSize.load() > 1 &&
+        LookupHashTable::canIndexPath(*_foreignField);
+}
+
+void DocumentSourceLookUp::fillInputBatch(const BSONObj& additionalFilter) {
+    // Query for the distinct local values of the whole batch at once. The $in list is sorted, so
+    // an index on the foreign field is read as a single pass over ordered ranges of keys. Documents
+    // with values which cannot be looked up in '_batchTable' are queried for on their own.
+    auto localValues = _fromExpCtx->getValueComparator().makeOrderedValueSet();
+    size_t localValuesBytes = 0;
+    auto addLocalValues = [&](const Document& inputDoc) {
+        document_path_support::visitAllValuesAtPath(
+            inputDoc, *_localField, [&](const Value& nextValue) {
+                if (LookupHashTable::canProbe(nextValue) && localValues.insert(nextValue).second) {
+                    localValuesBytes += nextValue.getApproximateSize();
+                }
+            });
+    };
+    addLocalValues(_inputBatch.front());
+
+    // The batch ends early once its $in list reaches the size limit, so that the query stays well
+    // within the maximum BSON object size, and once the input is large enough to try a hash join.
+    const size_t batchSize = internalDocumentSourceLookupBatchSize.load();
+    const size_t maxQueryBytes = internalDocumentSourceLookupBatchMaxQueryBytes.load();
+    const auto minHashJoinInputDocuments =
+        internalDocumentSourceLookupHashJoinMinInputDocuments.load();
+    while (_inputBatch.size() < batchSize && localValuesBytes < maxQueryBytes &&
+           (_triedHashJoin || _numInputDocuments < minHashJoinInputDocuments)) {
+        auto nextInput = pSource->getNext();
+        if (!nextInput.isAdvanced()) {
+            // Pauses and EOF are returned once the documents read before them have been joined.
+            _inputBatchEnd = std::move(nextInput);
+            break;
+        }
+        ++_numInputDocuments;
+        _inputBatch.push_back(nextInput.releaseDocument());
+        addLocalValues(_inputBatch.back());
+    }
+    if (localValues.empty()) {
+        return;
+    }
+
+    _resolvedPipeline.back() =
+        buildBatchMatchStage(_foreignField->fullPath(), localValues, additionalFilter);
+    auto pipeline =
+        checkForeignCollectionIsUnsharded([&] { return buildPipeline(_inputBatch.front()); });
+
+    const auto maxMemoryBytes = internalDocumentSourceLookupBatchMaxMemoryBytes.load();
+    _batchTable.emplace(_fromExpCtx->getValueComparator(), *_foreignField, maxMemoryBytes);
+    while (auto next = pipeline->getNext()) {
+        if (!_batchTable->insert(std::move(*next))) {
+            _batchTable.reset();
+            break;
+        }
+    }
+    _usedDisk = _usedDisk || pipeline->usedDisk();
+}
+
+bool DocumentSourceLookUp::canUseHashJoin() const {
+    // The hash table is built from a single read of the foreign collection, which must therefore
+    // be local and unsharded. Like the other stages which hold their whole input in memory, it is
+    // only built for operations which allow the use of disk.
+    if (!internalDocumentSourceLookupEnableHashJoin.load() || !pExpCtx->allowDiskUse ||
+        pExpCtx->inMongos || foreignShardedLookupAllowed() ||
+        !LookupHashTable::canIndexPath(*_foreignField)) {
+        return false;
+    }
+
+    // Do not read a foreign collection into the table which is already known not to fit, so that
+    // a large collection keeps being looked up through its indexes.
+    BSONObjBuilder stats;
+    auto status = _fromExpCtx->mongoProcessInterface->appendStorageStats(
+        _fromExpCtx->opCtx, _resolvedNs, BSONObj(), &stats);
+    auto dataSize = stats.done()["size"];
+    return status.isOK() && dataSize.isNumber() &&
+        dataSize.safeNumberLong() <= internalDocumentSourceLookupCacheSizeBytes.load();
+}
+
+void DocumentSourceLookUp::buildHashTable(const BSONObj& additionalFilter) {
+    // Read the foreign collection through any view pipeline, replacing the trailing $match on the
+    // join predicate with one on the filter absorbed from a subsequent $match alone.
+    auto foreignPipeline = _resolvedPipeline;
+    foreignPipeline.back() = BSON("$match" << additionalFilter);
+
+    _variables.copyToExpCtx(_variablesParseState, _fromExpCtx.get());
+    _fromExpCtx->mongoProcessInterface->setExpectedShardVersion(
+        _fromExpCtx->opCtx, _fromExpCtx->ns, ChunkVersion::UNSHARDED());
+
+    MakePipelineOptions pipelineOpts;
+    pipelineOpts.optimize = true;
+    pipelineOpts.attachCursorSource = true;
+    pipelineOpts.validator = lookupPipeValidator;
+    auto pipeline = Pipeline::makePipeline(foreignPipeline, _fromExpCtx, pipelineOpts);
+
+    const auto maxMemoryBytes = internalDocumentSourceLookupCacheSizeBytes.load();
+    _hashTable.emplace(_fromExpCtx->getValueComparator(), *_foreignField, maxMemoryBytes);
+    while (auto next = pipeline->getNext()) {
+        if (!_hashTable->insert(std::move(*next))) {
+            LOGV2_DEBUG(5189102,
+                        1,
+                        "$lookup foreign collection exceeds the hash join memory limit, falling "
+                        "back to querying it for each input document",
+                        "ns"_attr = _resolvedNs,
+                        "maxMemoryBytes"_attr = maxMemoryBytes);
+            _hashTable.reset();
+            break;
+        }
+    }
+    _usedDisk = _usedDisk || pipeline->usedDisk();
+}
+
+boost::optional<std::vector<Document>> DocumentSourceLookUp::probeHashTable(
+    const LookupHashTable& table, const Document& inputDoc) const {
+    // Missing and null local values also join with foreign documents which are missing the
+    // foreign field, which the hash table does not index.
+    std::vector<Value> localValues;
+    bool canProbe = true;
+    document_path_support::visitAllValuesAtPath(
+        inputDoc, *_localField, [&](const Value& nextValue) {
+            canProbe = canProbe && LookupHashTable::canProbe(nextValue);
+            localValues.push_back(nextValue);
+        });
+    if (!canProbe || localValues.empty()) {
+        return boost::none;
+    }
+
+    return table.probe(localValues);
+}
+
 DocumentSource::GetModPathsReturn DocumentSourceLookUp::getModifiedPaths() const {
     std::set<std::string> modifiedPaths{_as.fullPath()};
     if (_unwindSrc) {
@@ -536,6 +765,10 @@ void DocumentSourceLookUp::doDispose() {
         _pipeline->dispose(pExpCtx->opCtx);
         _pipeline.reset();
     }
+    _hashTable.reset();
+    _batchTable.reset();
+    _inputBatch.clear();
+    _inputBatchEnd.reset();
 }
 
 BSONObj DocumentSourceLookUp::makeMatchStageFromInput(const Document& input,
@@ -629,27 +862,19 @@ DocumentSource::GetNextResult DocumentSourceLookUp::unwindResult() {
     // Note we may return early from this loop if our source stage is exhausted or if the unwind
     // source was asked to return empty arrays and we get a document without a match.
     while (!_pipeline || !_nextValue) {
-        auto nextInput = pSource->getNext();
+        auto nextInput = getNextInput(_additionalFilter.value_or(BSONObj()));
         if (!nextInput.isAdvanced()) {
             return nextInput;
         }
 
         _input = nextInput.releaseDocument();
 
-        if (!wasConstructedWithPipelineSyntax()) {
-            BSONObj filter = _additionalFilter.value_or(BSONObj());
-            auto matchStage =
-                makeMatchStageFromInput(*_input, *_localField, _foreignField->fullPath(), filter);
-            // We've already allocated space for the trailing $match stage in '_resolvedPipeline'.
-            _resolvedPipeline.back() = matchStage;
-        }
-
         if (_pipeline) {
             _usedDisk = _usedDisk || _pipeline->usedDisk();
             _pipeline->dispose(pExpCtx->opCtx);
         }
 
-        _pipeline = buildPipeline(*_input);
+        _pipeline = buildJoinPipeline(*_input, _additionalFilter.value_or(BSONObj()));
 
         // The $lookup stage takes responsibility for disposing of its Pipeline, since it will
         // potentially be used by multiple OperationContexts, and the $lookup stage is part of an
@@ -757,6 +982,22 @@ void DocumentSourceLookUp::serializeToArray(
             output[getSourceName()]["matching"] = Value(*_additionalFilter);
         }
 
+        if (_strategy && *explain >= ExplainOptions::Verbosity::kExecStats) {
+            StringData strategy;
+            switch (*_strategy) {
+                case JoinStrategy::kNestedLoopJoin:
+                    strategy = "NestedLoopJoin"_sd;
+                    break;
+                case JoinStrategy::kBatchedNestedLoopJoin:
+                    strategy = "BatchedNestedLoopJoin"_sd;
+                    break;
+                case JoinStrategy::kHashJoin:
+                    strategy = "HashJoin"_sd;
+                    break;
+            }
+            output[getSourceName()]["strategy"] = Value(strategy);
+        }
+
         array.push_back(Value(output.freeze()));
     } else {
         array.push_back(Value(output.freeze()));
@@ -30,6 +30,7 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <deque>
 
 #include "mongo/db/exec/document_value/value_comparator.h"
 #include "mongo/db/pipeline/document_source.h"
@@ -38,6 +39,7 @@
 #include "mongo/db/pipeline/document_source_unwind.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/lite_parsed_pipeline.h"
+#include "mongo/db/pipeline/lookup_hash_table.h"
 #include "mongo/db/pipeline/lookup_set_cache.h"
 
 namespace mongo {
@@ -256,6 +258,69 @@ private:
      */
     std::unique_ptr<Pipeline, PipelineDeleter> buildPipeline(const Document& inputDoc);
 
+    /**
+     * Returns a pipeline producing the foreign documents which join with 'inputDoc'. For a $lookup
+     * with localField/foreignField syntax, the documents are taken from the hash table over the
+     * foreign collection or over the results for the current batch when there is one, and
+     * otherwise queried with a $match on the join predicate and 'additionalFilter'.
+     */
+    std::unique_ptr<Pipeline, PipelineDeleter> buildJoinPipeline(const Document& inputDoc,
+                                                                 const BSONObj& additionalFilter);
+
+    /**
+     * Returns true if this $lookup may join its input against a hash table over the foreign
+     * collection rather than querying the foreign collection for each input document. Consults the
+     * storage statistics of the foreign collection to rule out collections too large for the
+     * table.
+     */
+    bool canUseHashJoin() const;
+
+    /**
+     * Reads the documents of the foreign collection which pass 'additionalFilter' into
+     * '_hashTable'. Leaves '_hashTable' empty if they do not fit in the memory limit.
+     */
+    void buildHashTable(const BSONObj& additionalFilter);
+
+    /**
+     * Returns the next input document, or the pause or EOF from the source. For a $lookup with
+     * localField/foreignField syntax which is not using a hash join, reads the input in batches
+     * and queries the foreign collection for each batch as a whole.
+     */
+    GetNextResult getNextInput(const BSONObj& additionalFilter);
+
+    /**
+     * Returns true if this $lookup may query the foreign collection for a batch of input documents
+     * at once.
+     */
+    bool canBatchInput() const;
+
+    // The ways the input documents of a $lookup with localField/foreignField syntax are joined,
+    // from the slowest to the fastest.
+    enum class JoinStrategy { kNestedLoopJoin, kBatchedNestedLoopJoin, kHashJoin };
+
+    /**
+     * Records that an input document is joined with 'strategy', for explain.
+     */
+    void recordJoinStrategy(JoinStrategy strategy) {
+        if (!_strategy || *_strategy < strategy) {
+            _strategy = strategy;
+        }
+    }
+
+    /**
+     * Reads input documents into '_inputBatch' until it is full, and reads the foreign documents
+     * which join with any of them and pass 'additionalFilter' into '_batchTable'. Leaves
+     * '_batchTable' empty if they do not fit in the memory limit.
+     */
+    void fillInputBatch(const BSONObj& additionalFilter);
+
+    /**
+     * Returns the documents in 'table' which join with 'inputDoc', or boost::none if the values of
+     * 'inputDoc' at the local field cannot be looked up in a hash table.
+     */
+    boost::optional<std::vector<Document>> probeHashTable(const LookupHashTable& table,
+                                                          const Document& inputDoc) const;
+
     /**
      * Reinitialize the cache with a new max size. May only be called if this DSLookup was created
      * with pipeline syntax, the cache has not been frozen or abandoned, and no data has been added
@@ -289,6 +354,25 @@ private:
     // from a cursor source.
     boost::optional<SequentialDocumentCache> _cache;
 
+    // For use when $lookup is specified with localField/foreignField syntax. Once enough input
+    // documents have been joined by querying the foreign collection, holds the foreign collection
+    // indexed by 'foreignField', unless it does not fit in the memory limit.
+    boost::optional<LookupHashTable> _hashTable;
+    bool _triedHashJoin = false;
+    long long _numInputDocuments = 0;
+
+    // The fastest strategy which has joined an input document so far, reported by explain. A
+    // batched or hash join still queries for some input documents one at a time, which does not
+    // change the strategy reported.
+    boost::optional<JoinStrategy> _strategy;
+
+    // For use when $lookup is specified with localField/foreignField syntax and is not using a
+    // hash join. Holds the input documents which have been read but not yet returned, and the
+    // foreign documents joining with them, together with the pause or EOF which ended the batch.
+    std::deque<Document> _inputBatch;
+    boost::optional<LookupHashTable> _batchTable;
+    boost::optional<GetNextResult> _inputBatchEnd;
+
     // The ExpressionContext used when performing aggregation pipelines against the '_resolvedNs'
     // namespace.
     boost::intrusive_ptr<ExpressionContext> _fromExpCtx;
@@ -50,6 +50,7 @@
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/db/repl/storage_interface_mock.h"
 #include "mongo/db/server_options.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -687,9 +688,22 @@ public:
         return pipeline;
     }
 
+    Status appendStorageStats(OperationContext* opCtx,
+                              const NamespaceString& nss,
+                              const BSONObj& param,
+                              BSONObjBuilder* builder) const final {
+        builder->appendNumber("size", _dataSize);
+        return Status::OK();
+    }
+
+    void setDataSize(long long dataSize) {
+        _dataSize = dataSize;
+    }
+
 private:
     deque<DocumentSource::GetNextResult> _mockResults;
     bool _removeLeadingQueryStages = false;
+    long long _dataSize = 0;
 };
 
 TEST_F(DocumentSourceLookUpTest, ShouldPropagatePauses) {
@@ -798,6 +812,163 @@ TEST_F(DocumentSourceLookUpTest, ShouldPropagatePausesWhileUnwinding) {
     lookup->dispose();
 }
 
+TEST_F(DocumentSourceLookUpTest, HashAndBatchedJoinsReturnSameResultsAsNestedLoopJoin) {
+    auto expCtx = getExpCtx();
+    NamespaceString fromNs("test", "foreign");
+    expCtx->setResolvedNamespaces(StringMap<ExpressionContext::ResolvedNamespace>{
+        {fromNs.coll().toString(), {fromNs, std::vector<BSONObj>()}}});
+
+    // Mock out the foreign collection. The $match on the join predicate is left in the pipeline,
+    // so that it filters the mocked contents as the query would.
+    deque<DocumentSource::GetNextResult> mockForeignContents{
+        Document{{"_id", 0}, {"a", 1}},
+        Document{{"_id", 1}, {"a", BSON_ARRAY(1 << 2)}},
+        Document{{"_id", 2}, {"a", BSONNULL}},
+        Document{{"_id", 3}}};
+    auto mockInterface = std::make_shared<MockMongoInterface>(std::move(mockForeignContents));
+    expCtx->mongoProcessInterface = mockInterface;
+    expCtx->allowDiskUse = true;
+
+    auto lookupSpec = Document{{"$lookup",
+                                Document{{"from", fromNs.coll()},
+                                         {"localField", "x"_sd},
+                                         {"foreignField", "a"_sd},
+                                         {"as", "foreignDocs"_sd}}}}
+                          .toBson();
+
+    auto runLookup = [&](long long minInputDocuments, int batchSize, StringData expectedStrategy) {
+        internalDocumentSourceLookupHashJoinMinInputDocuments.store(minInputDocuments);
+        internalDocumentSourceLookupBatchSize.store(batchSize);
+        auto parsed = DocumentSourceLookUp::createFromBson(lookupSpec.firstElement(), expCtx);
+        auto lookup = static_cast<DocumentSourceLookUp*>(parsed.get());
+        auto mockLocalSource =
+            DocumentSourceMock::createForTest({Document{{"x", 1}},
+                                               Document{{"x", BSON_ARRAY(2 << 3)}},
+                                               Document{{"x", BSONNULL}},
+                                               Document{}},
+                                              expCtx);
+        lookup->setSource(mockLocalSource.get());
+
+        std::vector<Document> results;
+        for (auto next = lookup->getNext(); next.isAdvanced(); next = lookup->getNext()) {
+            results.push_back(next.releaseDocument());
+        }
+
+        std::vector<Value> explain;
+        lookup->serializeToArray(explain, ExplainOptions::Verbosity::kExecStats);
+        ASSERT_VALUE_EQ(explain[0]["$lookup"]["strategy"], Value(expectedStrategy));
+        lookup->dispose();
+        return results;
+    };
+
+    const auto defaultEnableHashJoin = internalDocumentSourceLookupEnableHashJoin.load();
+    const auto defaultMinInputDocuments =
+        internalDocumentSourceLookupHashJoinMinInputDocuments.load();
+    const auto defaultBatchSize = internalDocumentSourceLookupBatchSize.load();
+    const auto defaultBatchMaxQueryBytes = internalDocumentSourceLookupBatchMaxQueryBytes.load();
+    ON_BLOCK_EXIT([&] {
+        internalDocumentSourceLookupEnableHashJoin.store(defaultEnableHashJoin);
+        internalDocumentSourceLookupHashJoinMinInputDocuments.store(defaultMinInputDocuments);
+        internalDocumentSourceLookupBatchSize.store(defaultBatchSize);
+        internalDocumentSourceLookupBatchMaxQueryBytes.store(defaultBatchMaxQueryBytes);
+    });
+
+    internalDocumentSourceLookupEnableHashJoin.store(true);
+    auto nestedLoopResults = runLookup(1000, 0, "NestedLoopJoin"_sd);
+    auto hashJoinResults = runLookup(0, 0, "HashJoin"_sd);
+    auto batchedResults = runLookup(1000, 3, "BatchedNestedLoopJoin"_sd);
+
+    // The hash join is not used for a foreign collection which is too large for the memory limit,
+    // nor for an operation which does not allow the use of disk.
+    mockInterface->setDataSize(internalDocumentSourceLookupCacheSizeBytes.load() + 1);
+    runLookup(0, 3, "BatchedNestedLoopJoin"_sd);
+    mockInterface->setDataSize(0);
+    expCtx->allowDiskUse = false;
+    runLookup(0, 3, "BatchedNestedLoopJoin"_sd);
+    expCtx->allowDiskUse = true;
+
+    // A size limit which any local value reaches ends every batch after its first document.
+    internalDocumentSourceLookupBatchMaxQueryBytes.store(1);
+    auto sizeLimitedBatchResults = runLookup(1000, 3, "BatchedNestedLoopJoin"_sd);
+
+    ASSERT_EQ(4U, hashJoinResults.size());
+    ASSERT_DOCUMENT_EQ(hashJoinResults[0],
+                       (Document{{"x", 1},
+                                 {"foreignDocs",
+                                  {Document{{"_id", 0}, {"a", 1}},
+                                   Document{{"_id", 1}, {"a", BSON_ARRAY(1 << 2)}}}}}));
+    ASSERT_EQ(nestedLoopResults.size(), hashJoinResults.size());
+    ASSERT_EQ(nestedLoopResults.size(), batchedResults.size());
+    for (size_t i = 0; i < hashJoinResults.size(); ++i) {
+        ASSERT_DOCUMENT_EQ(nestedLoopResults[i], hashJoinResults[i]);
+        ASSERT_DOCUMENT_EQ(nestedLoopResults[i], batchedResults[i]);
+        ASSERT_DOCUMENT_EQ(nestedLoopResults[i], sizeLimitedBatchResults[i]);
+    }
+}
+
+TEST_F(DocumentSourceLookUpTest, BatchedJoinSwitchesToHashJoinAfterMinInputDocuments) {
+    auto expCtx = getExpCtx();
+    NamespaceString fromNs("test", "foreign");
+    expCtx->setResolvedNamespaces(StringMap<ExpressionContext::ResolvedNamespace>{
+        {fromNs.coll().toString(), {fromNs, std::vector<BSONObj>()}}});
+
+    deque<DocumentSource::GetNextResult> mockForeignContents{Document{{"_id", 0}, {"a", 1}}};
+    expCtx->mongoProcessInterface =
+        std::make_shared<MockMongoInterface>(std::move(mockForeignContents));
+    expCtx->allowDiskUse = true;
+
+    const auto defaultEnableHashJoin = internalDocumentSourceLookupEnableHashJoin.load();
+    const auto defaultMinInputDocuments =
+        internalDocumentSourceLookupHashJoinMinInputDocuments.load();
+    const auto defaultBatchSize = internalDocumentSourceLookupBatchSize.load();
+    ON_BLOCK_EXIT([&] {
+        internalDocumentSourceLookupEnableHashJoin.store(defaultEnableHashJoin);
+        internalDocumentSourceLookupHashJoinMinInputDocuments.store(defaultMinInputDocuments);
+        internalDocumentSourceLookupBatchSize.store(defaultBatchSize);
+    });
+    internalDocumentSourceLookupEnableHashJoin.store(true);
+    internalDocumentSourceLookupHashJoinMinInputDocuments.store(4);
+    internalDocumentSourceLookupBatchSize.store(3);
+
+    auto lookupSpec = Document{{"$lookup",
+                                Document{{"from", fromNs.coll()},
+                                         {"localField", "x"_sd},
+                                         {"foreignField", "a"_sd},
+                                         {"as", "foreignDocs"_sd}}}}
+                          .toBson();
+    auto parsed = DocumentSourceLookUp::createFromBson(lookupSpec.firstElement(), expCtx);
+    auto lookup = static_cast<DocumentSourceLookUp*>(parsed.get());
+    std::deque<DocumentSource::GetNextResult> inputDocs;
+    for (int i = 0; i < 8; ++i) {
+        inputDocs.push_back(Document{{"x", 1}});
+    }
+    auto mockLocalSource = DocumentSourceMock::createForTest(std::move(inputDocs), expCtx);
+    lookup->setSource(mockLocalSource.get());
+
+    auto strategy = [&] {
+        std::vector<Value> explain;
+        lookup->serializeToArray(explain, ExplainOptions::Verbosity::kExecStats);
+        return explain[0]["$lookup"]["strategy"];
+    };
+
+    // Every input document counts towards the minimum, including those read to fill a batch, so
+    // the first four documents are looked up in batches and the fifth is joined by the hash join.
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(lookup->getNext().isAdvanced());
+        ASSERT_VALUE_EQ(strategy(), Value("BatchedNestedLoopJoin"_sd));
+    }
+    for (int i = 4; i < 8; ++i) {
+        ASSERT_TRUE(lookup->getNext().isAdvanced());
+        ASSERT_VALUE_EQ(strategy(), Value("HashJoin"_sd));
+    }
+    ASSERT_TRUE(lookup->getNext().isEOF());
+
+    // The strategy is recorded as the input is joined, so it is still reported once the hash table
+    // is gone.
+    lookup->dispose();
+    ASSERT_VALUE_EQ(strategy(), Value("HashJoin"_sd));
+}
+
 TEST_F(DocumentSourceLookUpTest, LookupReportsAsFieldIsModified) {
     auto expCtx = getExpCtx();
     NamespaceString fromNs("test", "foreign");
@@ -44,27 +44,34 @@ boost::intrusive_ptr<DocumentSource> DocumentSourcePlanCacheStats::createFromBso
                           << " value must be an object. Found: " << typeName(spec.type()),
             spec.type() == BSONType::Object);
 
-    uassert(ErrorCodes::FailedToParse,
-            str::stream() << kStageName
-                          << " parameters object must be empty. Found: " << typeName(spec.type()),
-            spec.embeddedObject().isEmpty());
+    bool summary = false;
+    for (auto&& elem : spec.embeddedObject()) {
+        uassert(ErrorCodes::FailedToParse,
+                str::stream() << kStageName << " parameters object may only contain a boolean '"
+                              << kSummaryFieldName << "' field. Found: " << elem.fieldName(),
+                elem.fieldNameStringData() == kSummaryFieldName && elem.type() == BSONType::Bool);
+        summary = elem.boolean();
+    }
 
-    return new DocumentSourcePlanCacheStats(pExpCtx);
+    return new DocumentSourcePlanCacheStats(pExpCtx, summary);
 }
 
 DocumentSourcePlanCacheStats::DocumentSourcePlanCacheStats(
-    const boost::intrusive_ptr<ExpressionContext>& expCtx)
-    : DocumentSource(kStageName, expCtx) {}
+    const boost::intrusive_ptr<ExpressionContext>& expCtx, bool summary)
+    : DocumentSource(kStageName, expCtx), _summary(summary) {}
 
 void DocumentSourcePlanCacheStats::serializeToArray(
     std::vector<Value>& array, boost::optional<ExplainOptions::Verbosity> explain) const {
+    MutableDocument spec;
+    if (_summary) {
+        spec.addField(kSummaryFieldName, Value{true});
+    }
+
     if (explain) {
-        array.push_back(Value{
-            Document{{kStageName,
-                      Document{{"match"_sd,
-                                _absorbedMatch ? Value{_absorbedMatch->getQuery()} : Value{}}}}}});
+        spec.addField("match"_sd, _absorbedMatch ? Value{_absorbedMatch->getQuery()} : Value{});
+        array.push_back(Value{Document{{kStageName, spec.freeze()}}});
     } else {
-        array.push_back(Value{Document{{kStageName, Document{}}}});
+        array.push_back(Value{Document{{kStageName, spec.freeze()}}});
         if (_absorbedMatch) {
             _absorbedMatch->serializeToArray(array);
         }
@@ -74,7 +81,7 @@ void DocumentSourcePlanCacheStats::serializeToArray(
 Pipeline::SourceContainer::iterator DocumentSourcePlanCacheStats::doOptimizeAt(
     Pipeline::SourceContainer::iterator itr, Pipeline::SourceContainer* container) {
     auto itrToNext = std::next(itr);
-    if (itrToNext == container->end()) {
+    if (_summary || itrToNext == container->end()) {
         return itrToNext;
     }
 
@@ -89,9 +96,15 @@ Pipeline::SourceContainer::iterator DocumentSourcePlanCacheStats::doOptimizeAt(
 
 DocumentSource::GetNextResult DocumentSourcePlanCacheStats::doGetNext() {
     if (!_haveRetrievedStats) {
-        const auto matchExpr = _absorbedMatch ? _absorbedMatch->getMatchExpression() : nullptr;
-        _results = pExpCtx->mongoProcessInterface->getMatchingPlanCacheEntryStats(
-            pExpCtx->opCtx, pExpCtx->ns, matchExpr);
+        if (_summary) {
+            _results = {pExpCtx->mongoProcessInterface->getPlanCacheSummaryStats(pExpCtx->opCtx,
+                                                                                 pExpCtx->ns)};
+        } else {
+            const auto matchExpr =
+                _absorbedMatch ? _absorbedMatch->getMatchExpression() : nullptr;
+            _results = pExpCtx->mongoProcessInterface->getMatchingPlanCacheEntryStats(
+                pExpCtx->opCtx, pExpCtx->ns, matchExpr);
+        }
 
         _resultsIter = _results.begin();
         _haveRetrievedStats = true;
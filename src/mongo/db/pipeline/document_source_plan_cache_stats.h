@@ -37,6 +37,7 @@ namespace mongo {
 class DocumentSourcePlanCacheStats final : public DocumentSource {
 public:
     static constexpr StringData kStageName = "$planCacheStats"_sd;
+    static constexpr StringData kSummaryFieldName = "summary"_sd;
 
     class LiteParsed final : public LiteParsedDocumentSource {
     public:
@@ -109,7 +110,7 @@ public:
 
     /**
      * Absorbs a subsequent $match, in order to avoid copying the entire contents of the plan cache
-     * prior to filtering.
+     * prior to filtering. In summary mode there is only one document, so nothing is absorbed.
      */
     Pipeline::SourceContainer::iterator doOptimizeAt(Pipeline::SourceContainer::iterator itr,
                                                      Pipeline::SourceContainer* container) override;
@@ -119,7 +120,8 @@ public:
         boost::optional<ExplainOptions::Verbosity> explain = boost::none) const override;
 
 private:
-    DocumentSourcePlanCacheStats(const boost::intrusive_ptr<ExpressionContext>& expCtx);
+    DocumentSourcePlanCacheStats(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                 bool summary);
 
     GetNextResult doGetNext() final;
 
@@ -128,6 +130,10 @@ private:
         MONGO_UNREACHABLE;  // Should call serializeToArray instead.
     }
 
+    // When true, a single document summarizing the whole plan cache (its size and its hit, miss and
+    // eviction counters) is produced instead of one document per cache entry.
+    const bool _summary;
+
     // If running through mongos in a sharded cluster, stores the shard name so that it can be
     // appended to each plan cache entry document.
     std::string _shardName;
@@ -65,6 +65,11 @@ public:
         return filteredStats;
     }
 
+    BSONObj getPlanCacheSummaryStats(OperationContext* opCtx,
+                                     const NamespaceString& nss) const override {
+        return BSON("numEntries" << static_cast<long long>(_planCacheStats.size()));
+    }
+
     std::string getShardName(OperationContext* opCtx) const override {
         return "testShardName";
     }
@@ -93,6 +98,23 @@ TEST_F(DocumentSourcePlanCacheStatsTest, ShouldFailToParseIfSpecIsANonEmptyObjec
         ErrorCodes::FailedToParse);
 }
 
+TEST_F(DocumentSourcePlanCacheStatsTest, ShouldFailToParseIfSummaryIsNotBoolean) {
+    const auto specObj = fromjson("{$planCacheStats: {summary: 1}}");
+    ASSERT_THROWS_CODE(
+        DocumentSourcePlanCacheStats::createFromBson(specObj.firstElement(), getExpCtx()),
+        AssertionException,
+        ErrorCodes::FailedToParse);
+}
+
+TEST_F(DocumentSourcePlanCacheStatsTest, CanParseAndSerializeSummarySuccessfully) {
+    const auto specObj = fromjson("{$planCacheStats: {summary: true}}");
+    auto stage = DocumentSourcePlanCacheStats::createFromBson(specObj.firstElement(), getExpCtx());
+    std::vector<Value> serialized;
+    stage->serializeToArray(serialized);
+    ASSERT_EQ(1u, serialized.size());
+    ASSERT_BSONOBJ_EQ(specObj, serialized[0].getDocument().toBson());
+}
+
 TEST_F(DocumentSourcePlanCacheStatsTest, CanParseAndSerializeSuccessfully) {
     const auto specObj = fromjson("{$planCacheStats: {}}");
     auto stage = DocumentSourcePlanCacheStats::createFromBson(specObj.firstElement(), getExpCtx());
@@ -241,4 +263,26 @@ TEST_F(DocumentSourcePlanCacheStatsTest, ReturnsShardAndHostNameWhenFromMongos)
     ASSERT(!pipeline->getNext());
 }
 
+TEST_F(DocumentSourcePlanCacheStatsTest, ReturnsSingleSummaryDocumentAndDoesNotAbsorbMatch) {
+    std::vector<BSONObj> stats{BSON("foo"
+                                    << "bar"),
+                               BSON("foo"
+                                    << "baz")};
+    getExpCtx()->mongoProcessInterface =
+        std::make_shared<PlanCacheStatsMongoProcessInterface>(stats);
+
+    const auto specObj = fromjson("{$planCacheStats: {summary: true}}");
+    auto planCacheStats =
+        DocumentSourcePlanCacheStats::createFromBson(specObj.firstElement(), getExpCtx());
+    auto match = DocumentSourceMatch::create(fromjson("{numEntries: 2}"), getExpCtx());
+    auto pipeline = Pipeline::create({planCacheStats, match}, getExpCtx());
+    pipeline->optimizePipeline();
+    ASSERT_EQ(2u, pipeline->getSources().size());
+
+    ASSERT_BSONOBJ_EQ(pipeline->getNext()->toBson(),
+                      BSON("numEntries" << 2LL << "host"
+                                        << "testHostName"));
+    ASSERT(!pipeline->getNext());
+}
+
 }  // namespace mongo
@@ -97,13 +97,17 @@ void DocumentSourceSort::serializeToArray(
     std::vector<Value>& array, boost::optional<ExplainOptions::Verbosity> explain) const {
     uint64_t limit = _sortExecutor->getLimit();
     if (explain) {  // always one Value for combined $sort + $limit
-        array.push_back(Value(DOC(
+        MutableDocument out(DOC(
             kStageName << DOC("sortKey"
                               << _sortExecutor->sortPattern().serialize(
                                      SortPattern::SortKeySerialization::kForExplain)
                               << "limit"
                               << (_sortExecutor->hasLimit() ? Value(static_cast<long long>(limit))
-                                                            : Value())))));
+                                                            : Value()))));
+        if (*explain >= ExplainOptions::Verbosity::kExecStats && _sortExecutor->wasDiskUsed()) {
+            out["spillCompressionRatio"] = Value(_sortExecutor->stats().spillCompressionRatio());
+        }
+        array.push_back(out.freezeToValue());
     } else {  // one Value for $sort and maybe a Value for $limit
         MutableDocument inner(_sortExecutor->sortPattern().serialize(
             SortPattern::SortKeySerialization::kForPipelineSerialization));
@@ -32,11 +32,46 @@
 #include <string>
 #include <vector>
 
+#include <third_party/murmurhash3/MurmurHash3.h>
+
 #include "mongo/base/string_data.h"
 #include "mongo/util/assert_util.h"
 
 namespace mongo {
 
+/**
+ * A field name paired with its hash. Documents index their fields by this hash, so callers which
+ * look up the same name over and over (for example, a FieldPath evaluated against every document
+ * of a pipeline) can compute it once and skip rehashing the name on each lookup.
+ *
+ * The referenced string must outlive this object.
+ */
+class HashedFieldName {
+public:
+    static unsigned hash(StringData name) {
+        unsigned out;
+        MurmurHash3_x86_32(name.rawData(), name.size(), 0, &out);
+        return out;
+    }
+
+    explicit HashedFieldName(StringData name) : _name(name), _hash(hash(name)) {}
+    HashedFieldName(StringData name, unsigned hash) : _name(name), _hash(hash) {
+        dassert(hash == HashedFieldName::hash(name));
+    }
+
+    StringData name() const {
+        return _name;
+    }
+
+    unsigned hash() const {
+        return _hash;
+    }
+
+private:
+    StringData _name;
+    unsigned _hash;
+};
+
 /**
  * Utility class which represents a field path with nested paths separated by dots.
  */
@@ -109,6 +144,15 @@ public:
         return StringData(&_fieldPath[begin], end - begin);
     }
 
+    /**
+     * Same as getFieldName(), but also returns the hash of the field name, which was computed when
+     * this path was constructed.
+     */
+    HashedFieldName getFieldNameHashed(size_t i) const {
+        dassert(i < getPathLength());
+        return HashedFieldName(getFieldName(i), _fieldHash[i]);
+    }
+
     /**
      * Returns the full path, not including the prefix 'FieldPath::prefix'.
      */
@@ -141,8 +185,10 @@ public:
     FieldPath concat(const FieldPath& tail) const;
 
 private:
-    FieldPath(std::string string, std::vector<size_t> dots)
-        : _fieldPath(std::move(string)), _fieldPathDotPosition(std::move(dots)) {}
+    FieldPath(std::string string, std::vector<size_t> dots, std::vector<unsigned> hashes)
+        : _fieldPath(std::move(string)),
+          _fieldPathDotPosition(std::move(dots)),
+          _fieldHash(std::move(hashes)) {}
 
     static const char prefix = '$';
 
@@ -153,6 +199,9 @@ private:
     // string::npos (which evaluates to -1) and the last contains _fieldPath.size() to facilitate
     // lookup.
     std::vector<size_t> _fieldPathDotPosition;
+
+    // Contains the hash of each field name in '_fieldPath', as given by HashedFieldName::hash().
+    std::vector<unsigned> _fieldHash;
 };
 
 inline bool operator<(const FieldPath& lhs, const FieldPath& rhs) {
@@ -214,6 +214,8 @@ void checkConcatWorks(const FieldPath& head, const FieldPath& tail) {
             ? head.getFieldName(i)
             : tail.getFieldName(i - head.getPathLength());
         ASSERT_EQ(concat.getFieldName(i), expected);
+        ASSERT_EQ(concat.getFieldNameHashed(i).name(), expected);
+        ASSERT_EQ(concat.getFieldNameHashed(i).hash(), HashedFieldName::hash(expected));
     }
 }
 
@@ -0,0 +1,136 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/lookup_hash_table.h"
+
+#include <algorithm>
+
+#include "mongo/util/str.h"
+
+namespace mongo {
+
+LookupHashTable::LookupHashTable(const ValueComparator& comparator,
+                                 FieldPath foreignField,
+                                 size_t maxMemoryUsageBytes)
+    : _foreignField(std::move(foreignField)),
+      _maxMemoryUsageBytes(maxMemoryUsageBytes),
+      _index(comparator.makeUnorderedValueMap<std::vector<size_t>>()) {}
+
+bool LookupHashTable::canIndexPath(const FieldPath& path) {
+    for (size_t i = 0; i < path.getPathLength(); ++i) {
+        if (str::parseUnsignedBase10Integer(path.getFieldName(i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool LookupHashTable::canProbe(const Value& value) {
+    return !value.nullish() && value.getType() != BSONType::RegEx;
+}
+
+bool LookupHashTable::insert(Document document) {
+    _memoryUsageBytes += document.getApproximateSize();
+    _documents.push_back(std::move(document));
+    addValuesAtPath(Value(_documents.back()), 0, _documents.size() - 1);
+    return _memoryUsageBytes <= _maxMemoryUsageBytes;
+}
+
+void LookupHashTable::addValuesAtPath(const Value& value, size_t pathIndex, size_t docIndex) {
+    if (pathIndex == _foreignField.getPathLength()) {
+        addKey(value, docIndex);
+        if (value.isArray()) {
+            for (auto&& element : value.getArray()) {
+                addKey(element, docIndex);
+            }
+        }
+        return;
+    }
+
+    if (value.getType() == BSONType::Object) {
+        addValuesAtPath(value.getDocument()[_foreignField.getFieldNameHashed(pathIndex)],
+                        pathIndex + 1,
+                        docIndex);
+    } else if (value.isArray()) {
+        // Only the objects in the array are traversed. Neither scalars nor arrays nested directly
+        // within the array have any value at the rest of the path.
+        for (auto&& element : value.getArray()) {
+            if (element.getType() == BSONType::Object) {
+                addValuesAtPath(element, pathIndex, docIndex);
+            }
+        }
+    }
+}
+
+void LookupHashTable::addKey(const Value& key, size_t docIndex) {
+    if (key.missing()) {
+        return;
+    }
+
+    auto& docIndexes = _index[key];
+    // A document reaches the same key through several paths when, for example, it has an array of
+    // equal values. Since documents are inserted in order, its index can only be the last one.
+    if (!docIndexes.empty() && docIndexes.back() == docIndex) {
+        return;
+    }
+    if (docIndexes.empty()) {
+        _memoryUsageBytes += key.getApproximateSize();
+    }
+    docIndexes.push_back(docIndex);
+    _memoryUsageBytes += sizeof(size_t);
+}
+
+std::vector<Document> LookupHashTable::probe(const std::vector<Value>& values) const {
+    std::vector<size_t> docIndexes;
+    for (auto&& value : values) {
+        dassert(canProbe(value));
+        auto it = _index.find(value);
+        if (it != _index.end()) {
+            docIndexes.insert(docIndexes.end(), it->second.begin(), it->second.end());
+        }
+    }
+
+    // A document may match more than one of the values, but is returned once, as it would be by
+    // the {$in: [<value>, ...]} query of the nested-loop strategy.
+    if (values.size() > 1) {
+        std::sort(docIndexes.begin(), docIndexes.end());
+        docIndexes.erase(std::unique(docIndexes.begin(), docIndexes.end()), docIndexes.end());
+    }
+
+    std::vector<Document> documents;
+    documents.reserve(docIndexes.size());
+    for (auto docIndex : docIndexes) {
+        documents.push_back(_documents[docIndex]);
+    }
+    return documents;
+}
+
+}  // namespace mongo
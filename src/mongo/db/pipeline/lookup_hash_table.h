@@ -0,0 +1,117 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/db/exec/document_value/document.h"
+#include "mongo/db/exec/document_value/value.h"
+#include "mongo/db/exec/document_value/value_comparator.h"
+#include "mongo/db/pipeline/field_path.h"
+
+namespace mongo {
+
+/**
+ * Holds the documents of the foreign collection of a localField/foreignField $lookup, indexed by
+ * the values they have at 'foreignField', so that the documents joining with an input document can
+ * be found without running a query against the foreign collection for each input document.
+ *
+ * The values are indexed the same way the {<foreignField>: {$eq: <value>}} predicate of the
+ * nested-loop strategy matches them: a document is found by probing with its value at
+ * 'foreignField' and, where that value is an array, with each of its elements. Arrays met along
+ * the path are traversed, but arrays directly nested in them are not.
+ *
+ * Memory usage includes the approximate size of the documents and of the keys at the time of
+ * insertion, not the overhead of the data structures in use.
+ */
+class LookupHashTable {
+public:
+    /**
+     * Constructs an empty table whose keys are compared by 'comparator', which must outlive it.
+     */
+    LookupHashTable(const ValueComparator& comparator,
+                    FieldPath foreignField,
+                    size_t maxMemoryUsageBytes);
+
+    /**
+     * Returns whether documents can be indexed by 'path'. Paths with a component which could be
+     * interpreted as an array index are not supported, since an equality predicate on such a path
+     * may match an array element by position as well as a field of that name.
+     */
+    static bool canIndexPath(const FieldPath& path);
+
+    /**
+     * Returns whether a local value can be looked up by probing the table. Nullish values also
+     * match documents which are missing 'foreignField', and regular expressions need the matching
+     * rules of the query system, so these must be looked up with a query instead.
+     */
+    static bool canProbe(const Value& value);
+
+    /**
+     * Adds 'document' to the table. Returns false, leaving the table in an unspecified state which
+     * should be discarded, if doing so would take the memory usage over the limit.
+     */
+    bool insert(Document document);
+
+    /**
+     * Returns the documents which have any of 'values' at 'foreignField', in the order in which
+     * they were inserted and without duplicates. Each of 'values' must satisfy canProbe().
+     */
+    std::vector<Document> probe(const std::vector<Value>& values) const;
+
+    size_t getMemoryUsageBytes() const {
+        return _memoryUsageBytes;
+    }
+
+    size_t size() const {
+        return _documents.size();
+    }
+
+private:
+    /**
+     * Adds an entry for each value found at the component 'pathIndex' of the foreign field of
+     * 'value' to the index, pointing at the document in position 'docIndex'.
+     */
+    void addValuesAtPath(const Value& value, size_t pathIndex, size_t docIndex);
+
+    void addKey(const Value& key, size_t docIndex);
+
+    const FieldPath _foreignField;
+    const size_t _maxMemoryUsageBytes;
+    size_t _memoryUsageBytes = 0;
+
+    std::vector<Document> _documents;
+
+    // Maps each key to the positions in '_documents' of the documents with that key, in
+    // increasing order.
+    ValueUnorderedMap<std::vector<size_t>> _index;
+};
+
+}  // namespace mongo
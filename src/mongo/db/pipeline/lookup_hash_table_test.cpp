@@ -0,0 +1,162 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <limits>
+#include <vector>
+
+#include "mongo/db/exec/document_value/document_value_test_util.h"
+#include "mongo/db/exec/document_value/value_comparator.h"
+#include "mongo/db/pipeline/lookup_hash_table.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const ValueComparator defaultComparator{nullptr};
+const size_t kNoMemoryLimit = std::numeric_limits<size_t>::max();
+
+/**
+ * Returns the ids of the documents in 'table' which match any of 'values'.
+ */
+std::vector<Value> probeIds(const LookupHashTable& table, std::vector<Value> values) {
+    std::vector<Value> ids;
+    for (auto&& doc : table.probe(values)) {
+        ids.push_back(doc["_id"]);
+    }
+    return ids;
+}
+
+LookupHashTable makeTable(const std::string& foreignField,
+                          const std::vector<BSONObj>& docs,
+                          const ValueComparator& comparator = defaultComparator) {
+    LookupHashTable table(comparator, FieldPath(foreignField), kNoMemoryLimit);
+    for (auto&& doc : docs) {
+        ASSERT_TRUE(table.insert(Document(doc)));
+    }
+    return table;
+}
+
+TEST(LookupHashTableTest, ProbeReturnsDocumentsWithEqualValue) {
+    auto table = makeTable("a", {BSON("_id" << 0 << "a" << 1), BSON("_id" << 1 << "a" << 2),
+                                 BSON("_id" << 2 << "a" << 1.0), BSON("_id" << 3)});
+
+    ASSERT_EQ(4U, table.size());
+    auto ids = probeIds(table, {Value(1)});
+    ASSERT_EQ(2U, ids.size());
+    ASSERT_VALUE_EQ(Value(0), ids[0]);
+    ASSERT_VALUE_EQ(Value(2), ids[1]);
+    ASSERT_TRUE(probeIds(table, {Value(3)}).empty());
+}
+
+TEST(LookupHashTableTest, ArrayValuesAreIndexedByElementAndAsAWhole) {
+    auto table = makeTable("a", {BSON("_id" << 0 << "a" << BSON_ARRAY(1 << 2)),
+                                 BSON("_id" << 1 << "a" << BSON_ARRAY(BSON_ARRAY(1) << 3))});
+
+    auto ids = probeIds(table, {Value(1)});
+    ASSERT_EQ(1U, ids.size());
+    ASSERT_VALUE_EQ(Value(0), ids[0]);
+
+    ids = probeIds(table, {Value(BSON_ARRAY(1 << 2))});
+    ASSERT_EQ(1U, ids.size());
+    ASSERT_VALUE_EQ(Value(0), ids[0]);
+
+    ids = probeIds(table, {Value(BSON_ARRAY(1))});
+    ASSERT_EQ(1U, ids.size());
+    ASSERT_VALUE_EQ(Value(1), ids[0]);
+}
+
+TEST(LookupHashTableTest, DottedPathTraversesArraysOfObjects) {
+    auto table =
+        makeTable("a.b",
+                  {BSON("_id" << 0 << "a" << BSON("b" << 1)),
+                   BSON("_id" << 1 << "a" << BSON_ARRAY(BSON("b" << 1) << BSON("b" << 2))),
+                   BSON("_id" << 2 << "a" << BSON_ARRAY(BSON_ARRAY(BSON("b" << 1)))),
+                   BSON("_id" << 3 << "a" << BSON_ARRAY(BSON("b" << BSON_ARRAY(2 << 1))))});
+
+    auto ids = probeIds(table, {Value(1)});
+    ASSERT_EQ(3U, ids.size());
+    ASSERT_VALUE_EQ(Value(0), ids[0]);
+    ASSERT_VALUE_EQ(Value(1), ids[1]);
+    ASSERT_VALUE_EQ(Value(3), ids[2]);
+}
+
+TEST(LookupHashTableTest, ProbeWithSeveralValuesReturnsEachDocumentOnceInInsertionOrder) {
+    auto table = makeTable("a", {BSON("_id" << 0 << "a" << BSON_ARRAY(2 << 1)),
+                                 BSON("_id" << 1 << "a" << 1), BSON("_id" << 2 << "a" << 2)});
+
+    auto ids = probeIds(table, {Value(2), Value(1)});
+    ASSERT_EQ(3U, ids.size());
+    ASSERT_VALUE_EQ(Value(0), ids[0]);
+    ASSERT_VALUE_EQ(Value(1), ids[1]);
+    ASSERT_VALUE_EQ(Value(2), ids[2]);
+}
+
+TEST(LookupHashTableTest, KeysRespectCollation) {
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kToLowerString);
+    ValueComparator comparator{&collator};
+    auto table = makeTable(
+        "a", {BSON("_id" << 0 << "a" << "foo"), BSON("_id" << 1 << "a" << "FOO")}, comparator);
+
+    ASSERT_EQ(2U, probeIds(table, {Value("FoO"_sd)}).size());
+}
+
+TEST(LookupHashTableTest, InsertFailsOnceOverMemoryLimit) {
+    LookupHashTable table(defaultComparator, FieldPath("a"), 1024);
+
+    bool inserted = true;
+    int i = 0;
+    while (inserted) {
+        inserted = table.insert(Document{{"_id", i}, {"a", std::string(100, 'x')}});
+        ++i;
+    }
+    ASSERT_GT(i, 1);
+    ASSERT_GT(table.getMemoryUsageBytes(), 1024U);
+}
+
+TEST(LookupHashTableTest, CanIndexPathRejectsNumericComponents) {
+    ASSERT_TRUE(LookupHashTable::canIndexPath(FieldPath("a.b")));
+    ASSERT_TRUE(LookupHashTable::canIndexPath(FieldPath("a.b1")));
+    ASSERT_FALSE(LookupHashTable::canIndexPath(FieldPath("a.0")));
+    ASSERT_FALSE(LookupHashTable::canIndexPath(FieldPath("a.0.b")));
+}
+
+TEST(LookupHashTableTest, CanProbeRejectsNullishAndRegexValues) {
+    ASSERT_TRUE(LookupHashTable::canProbe(Value(1)));
+    ASSERT_TRUE(LookupHashTable::canProbe(Value(BSON_ARRAY(BSONNULL))));
+    ASSERT_FALSE(LookupHashTable::canProbe(Value(BSONNULL)));
+    ASSERT_FALSE(LookupHashTable::canProbe(Value(BSONUndefined)));
+    ASSERT_FALSE(LookupHashTable::canProbe(Value()));
+    ASSERT_FALSE(LookupHashTable::canProbe(Value(BSONRegEx("^a"))));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -143,6 +143,16 @@ bool supportsUniqueKey(const boost::intrusive_ptr<ExpressionContext>& expCtx,
             CollatorInterface::collatorsMatch(index->getCollator(), expCtx->getCollator()));
 }
 
+// Returns the plan cache of 'collection', which must be held for as long as the cache is in use.
+PlanCache* getPlanCache(const AutoGetCollection& collection, const NamespaceString& nss) {
+    uassert(
+        50933, str::stream() << "collection '" << nss.toString() << "' does not exist", collection);
+
+    const auto planCache = CollectionQueryInfo::get(collection.getCollection()).getPlanCache();
+    invariant(planCache);
+    return planCache;
+}
+
 }  // namespace
 
 std::unique_ptr<TransactionHistoryIteratorBase>
@@ -416,15 +426,21 @@ std::vector<BSONObj> CommonMongodProcessInterface::getMatchingPlanCacheEntryStat
     };
 
     AutoGetCollection collection(opCtx, nss, MODE_IS);
-    uassert(
-        50933, str::stream() << "collection '" << nss.toString() << "' does not exist", collection);
-
-    const auto planCache = CollectionQueryInfo::get(collection.getCollection()).getPlanCache();
-    invariant(planCache);
+    const auto planCache = getPlanCache(collection, nss);
 
     return planCache->getMatchingStats(serializer, predicate);
 }
 
+BSONObj CommonMongodProcessInterface::getPlanCacheSummaryStats(OperationContext* opCtx,
+                                                              const NamespaceString& nss) const {
+    AutoGetCollection collection(opCtx, nss, MODE_IS);
+    const auto planCache = getPlanCache(collection, nss);
+
+    BSONObjBuilder builder;
+    planCache->appendSummaryStats(&builder);
+    return builder.obj();
+}
+
 bool CommonMongodProcessInterface::fieldsHaveSupportingUniqueIndex(
     const boost::intrusive_ptr<ExpressionContext>& expCtx,
     const NamespaceString& nss,
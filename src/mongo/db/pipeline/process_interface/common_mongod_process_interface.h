@@ -100,6 +100,8 @@ public:
                                                         const NamespaceString&,
                                                         const MatchExpression*) const final;
 
+    BSONObj getPlanCacheSummaryStats(OperationContext*, const NamespaceString&) const final;
+
     bool fieldsHaveSupportingUniqueIndex(const boost::intrusive_ptr<ExpressionContext>& expCtx,
                                          const NamespaceString& nss,
                                          const std::set<FieldPath>& fieldPaths) const;
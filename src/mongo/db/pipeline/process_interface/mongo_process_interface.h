@@ -386,6 +386,12 @@ public:
                                                                 const NamespaceString&,
                                                                 const MatchExpression*) const = 0;
 
+    /**
+     * Returns a BSON object describing the plan cache for the given namespace as a whole: its size
+     * and its lookup and eviction counters.
+     */
+    virtual BSONObj getPlanCacheSummaryStats(OperationContext*, const NamespaceString&) const = 0;
+
     /**
      * Returns true if there is an index on 'nss' with properties that will guarantee that a
      * document with non-array values for each of 'fieldPaths' will have at most one matching
@@ -201,6 +201,10 @@ public:
         MONGO_UNREACHABLE;
     }
 
+    BSONObj getPlanCacheSummaryStats(OperationContext*, const NamespaceString&) const final {
+        MONGO_UNREACHABLE;
+    }
+
     bool fieldsHaveSupportingUniqueIndex(const boost::intrusive_ptr<ExpressionContext>&,
                                          const NamespaceString&,
                                          const std::set<FieldPath>& fieldPaths) const;
@@ -226,6 +226,10 @@ public:
         MONGO_UNREACHABLE;
     }
 
+    BSONObj getPlanCacheSummaryStats(OperationContext*, const NamespaceString&) const override {
+        MONGO_UNREACHABLE;
+    }
+
     bool fieldsHaveSupportingUniqueIndex(const boost::intrusive_ptr<ExpressionContext>& expCtx,
                                          const NamespaceString& nss,
                                          const std::set<FieldPath>& fieldPaths) const override {
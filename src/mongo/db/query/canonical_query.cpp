@@ -44,6 +44,7 @@
 #include "mongo/db/query/collation/collator_factory_interface.h"
 #include "mongo/db/query/indexability.h"
 #include "mongo/db/query/projection_parser.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner_common.h"
 
 namespace mongo {
@@ -147,6 +148,13 @@ StatusWith<std::unique_ptr<CanonicalQuery>> CanonicalQuery::canonicalize(
     if (!initStatus.isOK()) {
         return initStatus;
     }
+
+    // Mark the constants of the filter as input parameters. Queries canonicalized from a subtree
+    // of another query, like the branches of a rooted $or, are not parameterized, so that their
+    // parameter ids can't be confused with one another.
+    if (internalQueryEnableAutoParameterization.load()) {
+        cq->_inputParamIdToExpressionMap = MatchExpression::parameterize(cq->_root.get());
+    }
     return std::move(cq);
 }
 
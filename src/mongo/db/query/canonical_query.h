@@ -139,6 +139,14 @@ public:
         return *_qr;
     }
 
+    /**
+     * Returns the comparisons of the filter whose constants were made input parameters, indexed by
+     * their InputParamId. Empty if the query was not auto-parameterized.
+     */
+    const std::vector<const MatchExpression*>& getInputParamIdToMatchExpressionMap() const {
+        return _inputParamIdToExpressionMap;
+    }
+
     /**
      * Returns the projection, or nullptr if none.
      */
@@ -239,6 +247,9 @@ private:
 
     std::unique_ptr<MatchExpression> _root;
 
+    // The parameterized comparisons of '_root', indexed by their InputParamId.
+    std::vector<const MatchExpression*> _inputParamIdToExpressionMap;
+
     boost::optional<projection_ast::Projection> _proj;
 
     boost::optional<SortPattern> _sortPattern;
@@ -33,8 +33,11 @@
 #include "mongo/db/pipeline/expression_context_for_test.h"
 #include "mongo/db/query/collation/collator_factory_interface.h"
 #include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_test_service_context.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -286,6 +289,41 @@ TEST(CanonicalQueryTest, CanonicalizeFromBaseQuery) {
     ASSERT_TRUE(childCq->getQueryRequest().isExplain());
 }
 
+TEST(CanonicalQueryTest, AutoParameterizesTopLevelComparisonsAgainstScalars) {
+    auto cq = canonicalize(
+        "{a: 1, b: {$gt: 'x'}, c: {$in: [1, 2]}, d: null, e: {$lt: NaN}, $or: [{f: 1}, {g: 1}]}");
+
+    const auto& params = cq->getInputParamIdToMatchExpressionMap();
+    ASSERT_EQ(2U, params.size());
+    for (size_t paramId = 0; paramId < params.size(); ++paramId) {
+        auto comparison = dynamic_cast<const ComparisonMatchExpression*>(params[paramId]);
+        ASSERT(comparison);
+        ASSERT_EQ(static_cast<MatchExpression::InputParamId>(paramId),
+                  *comparison->getInputParamId());
+    }
+    ASSERT_EQ("a", params[0]->path());
+    ASSERT_EQ("b", params[1]->path());
+
+    // Clones of a parameterized comparison are parameterized too.
+    auto clone = params[0]->shallowClone();
+    ASSERT_EQ(0, *static_cast<ComparisonMatchExpression*>(clone.get())->getInputParamId());
+}
+
+TEST(CanonicalQueryTest, DoesNotAutoParameterizeSubqueriesOrWhenDisabled) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+
+    auto baseCq = canonicalize("{$or: [{a: 1}, {b: 1}]}");
+    ASSERT(baseCq->getInputParamIdToMatchExpressionMap().empty());
+    auto childCq =
+        assertGet(CanonicalQuery::canonicalize(opCtx.get(), *baseCq, baseCq->root()->getChild(0)));
+    ASSERT(childCq->getInputParamIdToMatchExpressionMap().empty());
+
+    internalQueryEnableAutoParameterization.store(false);
+    ON_BLOCK_EXIT([] { internalQueryEnableAutoParameterization.store(true); });
+    ASSERT(canonicalize("{a: 1}")->getInputParamIdToMatchExpressionMap().empty());
+}
+
 TEST(CanonicalQueryTest, CanonicalQueryFromQRWithNoCollation) {
     QueryTestServiceContext serviceContext;
     auto opCtx = serviceContext.makeOperationContext();
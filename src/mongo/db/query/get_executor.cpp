@@ -82,6 +82,7 @@
 #include "mongo/db/query/query_planner_common.h"
 #include "mongo/db/query/query_settings.h"
 #include "mongo/db/query/query_settings_decoration.h"
+#include "mongo/db/query/sbe_cached_plan.h"
 #include "mongo/db/query/sbe_cached_solution_planner.h"
 #include "mongo/db/query/sbe_multi_planner.h"
 #include "mongo/db/query/sbe_sub_planner.h"
@@ -600,8 +601,7 @@ public:
                                     "query"_attr = redact(_cq->toStringShort()));
                     }
 
-                    return buildCachedPlan(
-                        std::move(querySolution), plannerParams, cs->decisionWorks);
+                    return buildCachedPlan(std::move(querySolution), plannerParams, *cs);
                 }
             }
         }
@@ -696,10 +696,13 @@ protected:
      *       deactivated and we use multi-planning to select an entirely new  winning plan.
      *     * Or stores additional information in the result object, in case runtime planning is
      *       implemented as a standalone component, rather than as part of the execution tree.
+     *
+     * The tree may be copied from the execution plan cached in 'cachedSolution', if it has one
+     * which fits the query.
      */
     virtual std::unique_ptr<ResultType> buildCachedPlan(std::unique_ptr<QuerySolution> solution,
                                                         const QueryPlannerParams& plannerParams,
-                                                        size_t decisionWorks) = 0;
+                                                        const CachedSolution& cachedSolution) = 0;
 
     /**
      * Constructs a special PlanStage tree for rooted $or queries. Each clause of the $or is planned
@@ -821,7 +824,7 @@ protected:
     std::unique_ptr<ClassicPrepareExecutionResult> buildCachedPlan(
         std::unique_ptr<QuerySolution> solution,
         const QueryPlannerParams& plannerParams,
-        size_t decisionWorks) final {
+        const CachedSolution& cachedSolution) final {
         auto result = makeResult();
         auto&& root = buildExecutableTree(*solution);
 
@@ -834,7 +837,7 @@ protected:
                                                           _ws,
                                                           _cq,
                                                           plannerParams,
-                                                          decisionWorks,
+                                                          cachedSolution.decisionWorks,
                                                           std::move(root)),
                         std::move(solution));
         return result;
@@ -917,11 +920,24 @@ protected:
     std::unique_ptr<SlotBasedPrepareExecutionResult> buildCachedPlan(
         std::unique_ptr<QuerySolution> solution,
         const QueryPlannerParams& plannerParams,
-        size_t decisionWorks) final {
+        const CachedSolution& cachedSolution) final {
         auto result = makeResult();
-        auto execTree = buildExecutableTree(*solution, true);
+        auto execTree = [&] {
+            // Copy the cached tree if it was built for a query which only differs from this one in
+            // the values of its input parameters, rather than building it again from the solution.
+            auto cachedPlan =
+                dynamic_cast<const sbe::CachedSbePlan*>(cachedSolution.cachedPlan.get());
+            if (cachedPlan &&
+                cachedPlan->matches(sbe::CachedSbePlan::computeQueryFingerprint(*_cq))) {
+                if (auto execTree = cachedPlan->makeExecutableTree(
+                        _opCtx, _collection, *_cq, *solution, _yieldPolicy)) {
+                    return std::move(*execTree);
+                }
+            }
+            return buildExecutableTree(*solution, true);
+        }();
         result->emplace(std::move(execTree), std::move(solution));
-        result->setDecisionWorks(decisionWorks);
+        result->setDecisionWorks(cachedSolution.decisionWorks);
         return result;
     }
 
@@ -98,8 +98,8 @@ TEST(LRUKeyValueTest, EvictionTest) {
     int maxSize = 10;
     LRUKeyValue<int, int> cache(maxSize);
     for (int i = 0; i < maxSize; ++i) {
-        std::unique_ptr<int> evicted = cache.add(i, new int(i));
-        ASSERT(nullptr == evicted.get());
+        auto evicted = cache.add(i, new int(i));
+        ASSERT(evicted.empty());
     }
     ASSERT_EQUALS(cache.size(), (size_t)maxSize);
 
@@ -113,10 +113,10 @@ TEST(LRUKeyValueTest, EvictionTest) {
     }
 
     // Adding another entry causes an eviction.
-    std::unique_ptr<int> evicted = cache.add(maxSize + 1, new int(maxSize + 1));
+    auto evicted = cache.add(maxSize + 1, new int(maxSize + 1));
     ASSERT_EQUALS(cache.size(), (size_t)maxSize);
-    ASSERT(nullptr != evicted.get());
-    ASSERT_EQUALS(*evicted, evictKey);
+    ASSERT_EQUALS(evicted.size(), 1U);
+    ASSERT_EQUALS(*evicted[0], evictKey);
 
     // Check that the least recently accessed has been evicted.
     for (int i = 0; i < maxSize; ++i) {
@@ -138,8 +138,8 @@ TEST(LRUKeyValueTest, PromotionTest) {
     int maxSize = 10;
     LRUKeyValue<int, int> cache(maxSize);
     for (int i = 0; i < maxSize; ++i) {
-        std::unique_ptr<int> evicted = cache.add(i, new int(i));
-        ASSERT(nullptr == evicted.get());
+        auto evicted = cache.add(i, new int(i));
+        ASSERT(evicted.empty());
     }
     ASSERT_EQUALS(cache.size(), (size_t)maxSize);
 
@@ -149,8 +149,8 @@ TEST(LRUKeyValueTest, PromotionTest) {
 
     // Evict all but one of the original entries.
     for (int i = maxSize; i < (maxSize + maxSize - 1); ++i) {
-        std::unique_ptr<int> evicted = cache.add(i, new int(i));
-        ASSERT(nullptr != evicted.get());
+        auto evicted = cache.add(i, new int(i));
+        ASSERT_EQUALS(evicted.size(), 1U);
     }
     ASSERT_EQUALS(cache.size(), (size_t)maxSize);
 
@@ -195,4 +195,89 @@ TEST(LRUKeyValueTest, IterationTest) {
     ASSERT(i == cache.end());
 }
 
+/**
+ * Budget estimator which uses the value of an entry as its budget.
+ */
+struct IntValueBudgetEstimator {
+    size_t operator()(const int& value) const {
+        return value;
+    }
+};
+
+using BudgetedLRUKeyValue = LRUKeyValue<int, int, std::hash<int>, IntValueBudgetEstimator>;
+
+/**
+ * Test that least recently used entries are evicted until the kv-store fits within its budget,
+ * however many entries that takes.
+ */
+TEST(LRUKeyValueTest, BudgetEvictionTest) {
+    BudgetedLRUKeyValue cache(100, 10);
+    ASSERT(cache.add(1, new int(3)).empty());
+    ASSERT(cache.add(2, new int(3)).empty());
+    ASSERT(cache.add(3, new int(3)).empty());
+    ASSERT_EQUALS(cache.budget(), 9U);
+
+    // Promote the first entry, so that the next two are the least recently used.
+    ASSERT_TRUE(cache.hasKey(1));
+    int* value = nullptr;
+    ASSERT_OK(cache.get(1, &value));
+
+    auto evicted = cache.add(4, new int(6));
+    ASSERT_EQUALS(evicted.size(), 2U);
+    ASSERT_EQUALS(*evicted[0], 3);
+    ASSERT_EQUALS(cache.size(), 2U);
+    ASSERT_EQUALS(cache.budget(), 9U);
+    ASSERT_FALSE(cache.hasKey(2));
+    ASSERT_FALSE(cache.hasKey(3));
+
+    // Replacing an entry accounts for the budget of the replaced entry.
+    ASSERT(cache.add(4, new int(1)).empty());
+    ASSERT_EQUALS(cache.budget(), 4U);
+
+    ASSERT_OK(cache.remove(1));
+    ASSERT_EQUALS(cache.budget(), 1U);
+
+    // An entry which does not fit in the budget on its own is evicted right away.
+    evicted = cache.add(5, new int(11));
+    ASSERT_EQUALS(evicted.size(), 2U);
+    ASSERT_EQUALS(cache.size(), 0U);
+    ASSERT_EQUALS(cache.budget(), 0U);
+
+    cache.add(6, new int(2));
+    cache.clear();
+    ASSERT_EQUALS(cache.budget(), 0U);
+}
+
+/**
+ * Test that evicting the least recently used entry on demand follows the order of use and updates
+ * the size and budget of the kv-store.
+ */
+TEST(LRUKeyValueTest, EvictLeastRecentlyUsedTest) {
+    BudgetedLRUKeyValue cache(100);
+    ASSERT_FALSE(cache.evictLeastRecentlyUsed());
+
+    ASSERT(cache.add(1, new int(1)).empty());
+    ASSERT(cache.add(2, new int(2)).empty());
+    ASSERT(cache.add(3, new int(3)).empty());
+
+    // Promote the first entry, so that the second one is the least recently used.
+    int* value = nullptr;
+    ASSERT_OK(cache.get(1, &value));
+
+    auto evicted = cache.evictLeastRecentlyUsed();
+    ASSERT(evicted);
+    ASSERT_EQUALS(*evicted, 2);
+    ASSERT_FALSE(cache.hasKey(2));
+    ASSERT_EQUALS(cache.size(), 2U);
+    ASSERT_EQUALS(cache.budget(), 4U);
+
+    evicted = cache.evictLeastRecentlyUsed();
+    ASSERT_EQUALS(*evicted, 3);
+    evicted = cache.evictLeastRecentlyUsed();
+    ASSERT_EQUALS(*evicted, 1);
+    ASSERT_FALSE(cache.evictLeastRecentlyUsed());
+    ASSERT_EQUALS(cache.size(), 0U);
+    ASSERT_EQUALS(cache.budget(), 0U);
+}
+
 }  // namespace
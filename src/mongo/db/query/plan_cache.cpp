@@ -36,6 +36,7 @@
 #include <boost/iterator/transform_iterator.hpp>
 
 #include <algorithm>
+#include <limits>
 #include <math.h>
 #include <memory>
 #include <vector>
@@ -62,6 +63,12 @@ namespace {
 
 ServerStatusMetricField<Counter64> totalPlanCacheSizeEstimateBytesMetric(
     "query.planCacheTotalSizeEstimateBytes", &PlanCacheEntry::planCacheTotalSizeEstimateBytes);
+ServerStatusMetricField<Counter64> planCacheHitsMetric("query.planCache.hits",
+                                                       &PlanCache::planCacheHits);
+ServerStatusMetricField<Counter64> planCacheMissesMetric("query.planCache.misses",
+                                                         &PlanCache::planCacheMisses);
+ServerStatusMetricField<Counter64> planCacheEvictionsMetric("query.planCache.evictions",
+                                                            &PlanCache::planCacheEvictions);
 
 // Delimiters for cache key encoding.
 const char kEncodeDiscriminatorsBegin = '<';
@@ -175,7 +182,8 @@ CachedSolution::CachedSolution(const PlanCacheKey& key, const PlanCacheEntry& en
       sort(entry.sort.getOwned()),
       projection(entry.projection.getOwned()),
       collation(entry.collation.getOwned()),
-      decisionWorks(entry.works) {
+      decisionWorks(entry.works),
+      cachedPlan(entry.cachedPlan) {
     // CachedSolution should not having any references into
     // cache entry. All relevant data should be cloned/copied.
     for (size_t i = 0; i < entry.plannerData.size(); ++i) {
@@ -205,7 +213,8 @@ std::unique_ptr<PlanCacheEntry> PlanCacheEntry::create(
     uint32_t planCacheKey,
     Date_t timeOfCreation,
     bool isActive,
-    size_t works) {
+    size_t works,
+    std::shared_ptr<const CachedExecutionPlan> cachedPlan) {
     invariant(decision);
 
     // The caller of this constructor is responsible for ensuring
@@ -242,7 +251,8 @@ std::unique_ptr<PlanCacheEntry> PlanCacheEntry::create(
         planCacheKey,
         std::move(decision),
         isActive,
-        works));
+        works,
+        std::move(cachedPlan)));
 }
 
 PlanCacheEntry::PlanCacheEntry(std::vector<std::unique_ptr<const SolutionCacheData>> plannerData,
@@ -255,7 +265,8 @@ PlanCacheEntry::PlanCacheEntry(std::vector<std::unique_ptr<const SolutionCacheDa
                                const uint32_t planCacheKey,
                                std::unique_ptr<const plan_ranker::PlanRankingDecision> decision,
                                const bool isActive,
-                               const size_t works)
+                               const size_t works,
+                               std::shared_ptr<const CachedExecutionPlan> cachedPlan)
     : plannerData(std::move(plannerData)),
       query(query),
       sort(sort),
@@ -264,6 +275,7 @@ PlanCacheEntry::PlanCacheEntry(std::vector<std::unique_ptr<const SolutionCacheDa
       timeOfCreation(timeOfCreation),
       queryHash(queryHash),
       planCacheKey(planCacheKey),
+      cachedPlan(std::move(cachedPlan)),
       decision(std::move(decision)),
       isActive(isActive),
       works(works),
@@ -295,7 +307,8 @@ std::unique_ptr<PlanCacheEntry> PlanCacheEntry::clone() const {
                                                               planCacheKey,
                                                               std::move(decisionPtr),
                                                               isActive,
-                                                              works));
+                                                              works,
+                                                              cachedPlan));
 }
 
 uint64_t PlanCacheEntry::_estimateObjectSizeInBytes() const {
@@ -306,6 +319,9 @@ uint64_t PlanCacheEntry::_estimateObjectSizeInBytes() const {
             true) +
         // Add the entire size of 'decision' object.
         (decision ? decision->estimateObjectSizeInBytes() : 0) +
+        // Add the size of the cached execution plan. Copies of this entry share it, but each
+        // accounts for it, as the copies handed out by the cache are short-lived.
+        (cachedPlan ? cachedPlan->estimateObjectSizeInBytes() : 0) +
         // Add the size of all the owned BSON objects.
         query.objsize() + sort.objsize() + projection.objsize() + collation.objsize() +
         // Add size of the object.
@@ -317,6 +333,7 @@ std::string PlanCacheEntry::toString() const {
                          << ";projection: " << projection.toString()
                          << ";collation: " << collation.toString()
                          << ";solutions: " << plannerData.size()
+                         << ";cachedPlan: " << (cachedPlan ? "yes" : "no")
                          << ";timeOfCreation: " << timeOfCreation.toString() << ")";
 }
 
@@ -423,9 +440,24 @@ std::string SolutionCacheData::toString() const {
 // PlanCache
 //
 
-PlanCache::PlanCache() : PlanCache(internalQueryCacheSize.load()) {}
+PlanCache::PlanCache()
+    : PlanCache(internalQueryCacheSize.load(),
+                internalQueryCacheMaxSizeBytes.load(),
+                internalQueryCacheNumPartitions.load()) {}
 
-PlanCache::PlanCache(size_t size) : _cache(size) {}
+PlanCache::PlanCache(size_t size)
+    : PlanCache(size, std::numeric_limits<size_t>::max(), 1 /* numPartitions */) {}
+
+PlanCache::PlanCache(size_t maxEntries, size_t maxSizeBytes, size_t numPartitions)
+    : _maxSizeBytes(maxSizeBytes) {
+    invariant(numPartitions > 0);
+    // Round the share of each partition up, so that a small cache can still hold an entry in each.
+    const auto partitionMaxEntries = (maxEntries + numPartitions - 1) / numPartitions;
+    _partitions.reserve(numPartitions);
+    for (size_t i = 0; i < numPartitions; ++i) {
+        _partitions.push_back(std::make_unique<Partition>(partitionMaxEntries));
+    }
+}
 
 PlanCache::~PlanCache() {}
 
@@ -545,7 +577,8 @@ Status PlanCache::set(const CanonicalQuery& query,
                       const std::vector<QuerySolution*>& solns,
                       std::unique_ptr<plan_ranker::PlanRankingDecision> why,
                       Date_t now,
-                      boost::optional<double> worksGrowthCoefficient) {
+                      boost::optional<double> worksGrowthCoefficient,
+                      std::shared_ptr<const CachedExecutionPlan> cachedPlan) {
     invariant(why);
 
     if (solns.empty()) {
@@ -577,7 +610,8 @@ Status PlanCache::set(const CanonicalQuery& query,
                                  }},
         why->stats);
     const auto key = computeKey(query);
-    stdx::lock_guard<Latch> cacheLock(_cacheMutex);
+    auto& partition = _getPartition(key);
+    stdx::unique_lock<Latch> cacheLock(partition.mutex);
     bool isNewEntryActive = false;
     uint32_t queryHash;
     uint32_t planCacheKey;
@@ -588,7 +622,7 @@ Status PlanCache::set(const CanonicalQuery& query,
         queryHash = canonical_query_encoder::computeHash(key.getStableKeyStringData());
     } else {
         PlanCacheEntry* oldEntry = nullptr;
-        Status cacheStatus = _cache.get(key, &oldEntry);
+        Status cacheStatus = partition.cache.get(key, &oldEntry);
         invariant(cacheStatus.isOK() || cacheStatus == ErrorCodes::NoSuchKey);
         if (oldEntry) {
             queryHash = oldEntry->queryHash;
@@ -612,18 +646,32 @@ Status PlanCache::set(const CanonicalQuery& query,
         isNewEntryActive = newState.shouldBeActive;
     }
 
-    auto newEntry(PlanCacheEntry::create(
-        solns, std::move(why), query, queryHash, planCacheKey, now, isNewEntryActive, newWorks));
+    auto newEntry(PlanCacheEntry::create(solns,
+                                         std::move(why),
+                                         query,
+                                         queryHash,
+                                         planCacheKey,
+                                         now,
+                                         isNewEntryActive,
+                                         newWorks,
+                                         std::move(cachedPlan)));
 
-    std::unique_ptr<PlanCacheEntry> evictedEntry = _cache.add(key, newEntry.release());
+    auto evictedEntries = partition.cache.add(key, newEntry.release());
+    cacheLock.unlock();
+
+    for (auto&& evictedEntry : _evictToMaxSizeBytes()) {
+        evictedEntries.push_back(std::move(evictedEntry));
+    }
 
-    if (nullptr != evictedEntry.get()) {
+    for (auto&& evictedEntry : evictedEntries) {
         LOGV2_DEBUG(20942,
                     1,
                     "Plan cache maximum size exceeded - removed least recently used entry",
                     "namespace"_attr = query.nss(),
                     "evictedEntry"_attr = redact(evictedEntry->toString()));
     }
+    _evictions.fetchAndAdd(evictedEntries.size());
+    planCacheEvictions.increment(evictedEntries.size());
 
     return Status::OK();
 }
@@ -635,9 +683,10 @@ void PlanCache::deactivate(const CanonicalQuery& query) {
     }
 
     PlanCacheKey key = computeKey(query);
-    stdx::lock_guard<Latch> cacheLock(_cacheMutex);
+    auto& partition = _getPartition(key);
+    stdx::lock_guard<Latch> cacheLock(partition.mutex);
     PlanCacheEntry* entry = nullptr;
-    Status cacheStatus = _cache.get(key, &entry);
+    Status cacheStatus = partition.cache.get(key, &entry);
     if (!cacheStatus.isOK()) {
         invariant(cacheStatus == ErrorCodes::NoSuchKey);
         return;
@@ -652,28 +701,44 @@ PlanCache::GetResult PlanCache::get(const CanonicalQuery& query) const {
 }
 
 PlanCache::GetResult PlanCache::get(const PlanCacheKey& key) const {
-    stdx::lock_guard<Latch> cacheLock(_cacheMutex);
+    auto& partition = _getPartition(key);
+    stdx::lock_guard<Latch> cacheLock(partition.mutex);
     PlanCacheEntry* entry = nullptr;
-    Status cacheStatus = _cache.get(key, &entry);
+    Status cacheStatus = partition.cache.get(key, &entry);
     if (!cacheStatus.isOK()) {
         invariant(cacheStatus == ErrorCodes::NoSuchKey);
+        _misses.fetchAndAdd(1);
+        planCacheMisses.increment();
         return {CacheEntryState::kNotPresent, nullptr};
     }
     invariant(entry);
 
+    // Inactive entries are not used for planning, so looking one up counts as a miss.
+    if (entry->isActive) {
+        _hits.fetchAndAdd(1);
+        planCacheHits.increment();
+    } else {
+        _misses.fetchAndAdd(1);
+        planCacheMisses.increment();
+    }
+
     auto state =
         entry->isActive ? CacheEntryState::kPresentActive : CacheEntryState::kPresentInactive;
     return {state, std::make_unique<CachedSolution>(key, *entry)};
 }
 
 Status PlanCache::remove(const CanonicalQuery& canonicalQuery) {
-    stdx::lock_guard<Latch> cacheLock(_cacheMutex);
-    return _cache.remove(computeKey(canonicalQuery));
+    const auto key = computeKey(canonicalQuery);
+    auto& partition = _getPartition(key);
+    stdx::lock_guard<Latch> cacheLock(partition.mutex);
+    return partition.cache.remove(key);
 }
 
 void PlanCache::clear() {
-    stdx::lock_guard<Latch> cacheLock(_cacheMutex);
-    _cache.clear();
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<Latch> cacheLock(partition->mutex);
+        partition->cache.clear();
+    }
 }
 
 PlanCacheKey PlanCache::computeKey(const CanonicalQuery& cq) const {
@@ -687,9 +752,10 @@ PlanCacheKey PlanCache::computeKey(const CanonicalQuery& cq) const {
 StatusWith<std::unique_ptr<PlanCacheEntry>> PlanCache::getEntry(const CanonicalQuery& query) const {
     PlanCacheKey key = computeKey(query);
 
-    stdx::lock_guard<Latch> cacheLock(_cacheMutex);
+    auto& partition = _getPartition(key);
+    stdx::lock_guard<Latch> cacheLock(partition.mutex);
     PlanCacheEntry* entry;
-    Status cacheStatus = _cache.get(key, &entry);
+    Status cacheStatus = partition.cache.get(key, &entry);
     if (!cacheStatus.isOK()) {
         return cacheStatus;
     }
@@ -699,20 +765,80 @@ StatusWith<std::unique_ptr<PlanCacheEntry>> PlanCache::getEntry(const CanonicalQ
 }
 
 std::vector<std::unique_ptr<PlanCacheEntry>> PlanCache::getAllEntries() const {
-    stdx::lock_guard<Latch> cacheLock(_cacheMutex);
     std::vector<std::unique_ptr<PlanCacheEntry>> entries;
 
-    for (auto&& cacheEntry : _cache) {
-        auto entry = cacheEntry.second;
-        entries.push_back(std::unique_ptr<PlanCacheEntry>(entry->clone()));
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<Latch> cacheLock(partition->mutex);
+        for (auto&& cacheEntry : partition->cache) {
+            auto entry = cacheEntry.second;
+            entries.push_back(std::unique_ptr<PlanCacheEntry>(entry->clone()));
+        }
     }
 
     return entries;
 }
 
 size_t PlanCache::size() const {
-    stdx::lock_guard<Latch> cacheLock(_cacheMutex);
-    return _cache.size();
+    size_t size = 0;
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<Latch> cacheLock(partition->mutex);
+        size += partition->cache.size();
+    }
+    return size;
+}
+
+void PlanCache::appendSummaryStats(BSONObjBuilder* builder) const {
+    long long numEntries = 0;
+    long long numCachedPlans = 0;
+    long long estimatedSizeBytes = 0;
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<Latch> cacheLock(partition->mutex);
+        numEntries += partition->cache.size();
+        estimatedSizeBytes += partition->cache.budget();
+        for (auto&& cacheEntry : partition->cache) {
+            numCachedPlans += cacheEntry.second->cachedPlan ? 1 : 0;
+        }
+    }
+
+    builder->append("numEntries", numEntries);
+    builder->append("numCachedExecutionPlans", numCachedPlans);
+    builder->append("estimatedSizeBytes", estimatedSizeBytes);
+    builder->append("numPartitions", static_cast<long long>(_partitions.size()));
+    builder->append("hits", _hits.load());
+    builder->append("misses", _misses.load());
+    builder->append("evictions", _evictions.load());
+}
+
+PlanCache::Partition& PlanCache::_getPartition(const PlanCacheKey& key) const {
+    return *_partitions[PlanCacheKeyHasher{}(key) % _partitions.size()];
+}
+
+std::vector<std::unique_ptr<PlanCacheEntry>> PlanCache::_evictToMaxSizeBytes() {
+    std::vector<std::unique_ptr<PlanCacheEntry>> evictedEntries;
+    while (true) {
+        // The partitions are locked one at a time, so concurrent writers may each evict an entry
+        // for the same excess. The cache never stays above its maximum size though.
+        size_t sizeBytes = 0;
+        Partition* largestPartition = nullptr;
+        size_t largestPartitionSizeBytes = 0;
+        for (auto&& partition : _partitions) {
+            stdx::lock_guard<Latch> cacheLock(partition->mutex);
+            const auto partitionSizeBytes = partition->cache.budget();
+            sizeBytes += partitionSizeBytes;
+            if (partitionSizeBytes > largestPartitionSizeBytes) {
+                largestPartition = partition.get();
+                largestPartitionSizeBytes = partitionSizeBytes;
+            }
+        }
+        if (sizeBytes <= _maxSizeBytes || !largestPartition) {
+            return evictedEntries;
+        }
+
+        stdx::lock_guard<Latch> cacheLock(largestPartition->mutex);
+        if (auto evictedEntry = largestPartition->cache.evictLeastRecentlyUsed()) {
+            evictedEntries.push_back(std::move(evictedEntry));
+        }
+    }
 }
 
 void PlanCache::notifyOfIndexUpdates(const std::vector<CoreIndexInfo>& indexCores) {
@@ -723,13 +849,15 @@ std::vector<BSONObj> PlanCache::getMatchingStats(
     const std::function<BSONObj(const PlanCacheEntry&)>& serializationFunc,
     const std::function<bool(const BSONObj&)>& filterFunc) const {
     std::vector<BSONObj> results;
-    stdx::lock_guard<Latch> cacheLock(_cacheMutex);
 
-    for (auto&& cacheEntry : _cache) {
-        const auto entry = cacheEntry.second;
-        auto serializedEntry = serializationFunc(*entry);
-        if (filterFunc(serializedEntry)) {
-            results.push_back(serializedEntry);
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<Latch> cacheLock(partition->mutex);
+        for (auto&& cacheEntry : partition->cache) {
+            const auto entry = cacheEntry.second;
+            auto serializedEntry = serializationFunc(*entry);
+            if (filterFunc(serializedEntry)) {
+                results.push_back(serializedEntry);
+            }
         }
     }
 
@@ -264,6 +264,18 @@ struct SolutionCacheData {
     bool indexFilterApplied;
 };
 
+/**
+ * An execution plan built by a query engine from the winning solution of a query, which is cached
+ * together with the SolutionCacheData so that the plan does not have to be built again when the
+ * cache entry is used. Cached execution plans are immutable, and can be shared between threads.
+ */
+class CachedExecutionPlan {
+public:
+    virtual ~CachedExecutionPlan() = default;
+
+    virtual uint64_t estimateObjectSizeInBytes() const = 0;
+};
+
 class PlanCacheEntry;
 
 /**
@@ -298,6 +310,9 @@ public:
     // The number of work cycles taken to decide on a winning plan when the plan was first
     // cached.
     size_t decisionWorks;
+
+    // The execution plan built for the first of 'plannerData', if the cache entry has one.
+    std::shared_ptr<const CachedExecutionPlan> cachedPlan;
 };
 
 /**
@@ -319,7 +334,8 @@ public:
         uint32_t planCacheKey,
         Date_t timeOfCreation,
         bool isActive,
-        size_t works);
+        size_t works,
+        std::shared_ptr<const CachedExecutionPlan> cachedPlan = nullptr);
 
     ~PlanCacheEntry();
 
@@ -331,6 +347,13 @@ public:
     // For debugging.
     std::string toString() const;
 
+    /**
+     * Returns the estimated deep size of this entry in bytes.
+     */
+    uint64_t estimateObjectSizeInBytes() const {
+        return _entireObjectSize;
+    }
+
     //
     // Planner data
     //
@@ -358,6 +381,10 @@ public:
     // Hash of the "stable" PlanCacheKey, which is the same regardless of what indexes are around.
     const uint32_t planCacheKey;
 
+    // The execution plan built for the first of 'plannerData', if the query engine which chose it
+    // caches execution plans. Shared by the copies of this entry handed out by the cache.
+    const std::shared_ptr<const CachedExecutionPlan> cachedPlan;
+
     //
     // Performance stats
     //
@@ -394,7 +421,8 @@ private:
                    uint32_t planCacheKey,
                    std::unique_ptr<const plan_ranker::PlanRankingDecision> decision,
                    bool isActive,
-                   size_t works);
+                   size_t works,
+                   std::shared_ptr<const CachedExecutionPlan> cachedPlan);
 
     // Ensure that PlanCacheEntry is non-copyable.
     PlanCacheEntry(const PlanCacheEntry&) = delete;
@@ -407,10 +435,25 @@ private:
     const uint64_t _entireObjectSize;
 };
 
+/**
+ * Budget estimator which bounds the plan cache by the estimated size of its entries in bytes.
+ */
+struct PlanCacheEntryBudgetEstimator {
+    size_t operator()(const PlanCacheEntry& entry) const {
+        return entry.estimateObjectSizeInBytes();
+    }
+};
+
 /**
  * Caches the best solution to a query.  Aside from the (CanonicalQuery -> QuerySolution)
  * mapping, the cache contains information on why that mapping was made and statistics on the
  * cache entry's actual performance on subsequent runs.
+ *
+ * The cache is split into partitions by the hash of the cache key, each with its own lock and its
+ * own share of the maximum number of entries, so that queries of different shapes do not contend
+ * on a single lock. The maximum number of bytes is shared by all the partitions: once the entries
+ * of the cache exceed it, least recently used entries are evicted from the partitions which hold
+ * the most bytes. Each partition keeps its own order of use.
  */
 class PlanCache {
 private:
@@ -453,12 +496,25 @@ public:
     static bool shouldCacheQuery(const CanonicalQuery& query);
 
     /**
-     * If omitted, namespace set to empty string.
+     * Counters for the cache lookups and evictions of all the plan caches, reported in
+     * serverStatus.
+     */
+    inline static Counter64 planCacheHits;
+    inline static Counter64 planCacheMisses;
+    inline static Counter64 planCacheEvictions;
+
+    /**
+     * Creates a cache sized by the 'internalQueryCache*' server parameters.
      */
     PlanCache();
 
+    /**
+     * Creates a cache with a single partition holding at most 'size' entries, whatever their size.
+     */
     PlanCache(size_t size);
 
+    PlanCache(size_t maxEntries, size_t maxSizeBytes, size_t numPartitions);
+
     ~PlanCache();
 
     /**
@@ -473,13 +529,17 @@ public:
      * an inactive cache entry.  If boost::none is provided, the function will use
      * 'internalQueryCacheWorksGrowthCoefficient'.
      *
+     * 'cachedPlan' is the execution plan built for the best solution, if the query engine which
+     * ran the multi planner caches execution plans.
+     *
      * If the mapping was set successfully, returns Status::OK(), even if it evicted another entry.
      */
     Status set(const CanonicalQuery& query,
                const std::vector<QuerySolution*>& solns,
                std::unique_ptr<plan_ranker::PlanRankingDecision> why,
                Date_t now,
-               boost::optional<double> worksGrowthCoefficient = boost::none);
+               boost::optional<double> worksGrowthCoefficient = boost::none,
+               std::shared_ptr<const CachedExecutionPlan> cachedPlan = nullptr);
 
     /**
      * Set a cache entry back to the 'inactive' state. Rather than completely evicting an entry
@@ -553,6 +613,12 @@ public:
      */
     size_t size() const;
 
+    /**
+     * Appends the lookup and eviction counters of this cache, along with its number of entries
+     * and their estimated size, to 'builder'.
+     */
+    void appendSummaryStats(BSONObjBuilder* builder) const;
+
     /**
      * Updates internal state kept about the collection's indexes.  Must be called when the set
      * of indexes on the associated collection have changed.
@@ -582,10 +648,39 @@ private:
                                    size_t newWorks,
                                    double growthCoefficient);
 
-    LRUKeyValue<PlanCacheKey, PlanCacheEntry, PlanCacheKeyHasher> _cache;
+    using Cache = LRUKeyValue<PlanCacheKey,
+                              PlanCacheEntry,
+                              PlanCacheKeyHasher,
+                              PlanCacheEntryBudgetEstimator>;
+
+    struct Partition {
+        Partition(size_t maxEntries) : cache(maxEntries) {}
+
+        Cache cache;
+
+        // Protects 'cache'.
+        mutable Mutex mutex = MONGO_MAKE_LATCH("PlanCache::Partition::mutex");
+    };
+
+    Partition& _getPartition(const PlanCacheKey& key) const;
+
+    /**
+     * Evicts least recently used entries until the entries of all partitions fit within
+     * '_maxSizeBytes', and returns them. Must be called without holding the lock of any partition.
+     */
+    std::vector<std::unique_ptr<PlanCacheEntry>> _evictToMaxSizeBytes();
+
+    // The partitions of the cache, each holding the keys whose hash modulo the number of
+    // partitions is its index.
+    std::vector<std::unique_ptr<Partition>> _partitions;
+
+    // The maximum estimated size of the entries of all partitions together.
+    const size_t _maxSizeBytes;
 
-    // Protects _cache.
-    mutable Mutex _cacheMutex = MONGO_MAKE_LATCH("PlanCache::_cacheMutex");
+    // Lookup and eviction counters of this cache.
+    mutable AtomicWord<long long> _hits;
+    mutable AtomicWord<long long> _misses;
+    AtomicWord<long long> _evictions;
 
     // Holds computed information about the collection's indexes.  Used for generating plan
     // cache keys.
@@ -50,6 +50,7 @@
 #include "mongo/db/query/query_planner_test_lib.h"
 #include "mongo/db/query/query_solution.h"
 #include "mongo/db/query/query_test_service_context.h"
+#include "mongo/db/query/sbe_cached_plan.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/scopeguard.h"
@@ -865,6 +866,137 @@ TEST(PlanCacheTest, GetMatchingStatsMatchesAndSerializesCorrectly) {
     ASSERT_BSONOBJ_EQ(BSON("works" << 5), getStatsResult[0]);
 }
 
+TEST(PlanCacheTest, PartitionedCacheSupportsGetSetAndRemove) {
+    const size_t kNumPartitions = 4;
+    PlanCache planCache(100 /* maxEntries */, 1024 * 1024 /* maxSizeBytes */, kNumPartitions);
+    QueryTestServiceContext serviceContext;
+
+    std::vector<unique_ptr<CanonicalQuery>> queries;
+    for (auto&& field : {"a", "b", "c", "d", "e", "f", "g", "h"}) {
+        queries.push_back(canonicalize(BSON(field << 1)));
+        addCacheEntryForShape(*queries.back(), &planCache);
+    }
+    ASSERT_EQ(queries.size(), planCache.size());
+
+    for (auto&& cq : queries) {
+        ASSERT_EQ(planCache.get(*cq).state, PlanCache::CacheEntryState::kPresentInactive);
+    }
+
+    ASSERT_OK(planCache.remove(*queries[0]));
+    ASSERT_EQ(planCache.get(*queries[0]).state, PlanCache::CacheEntryState::kNotPresent);
+    ASSERT_EQ(queries.size() - 1, planCache.size());
+
+    planCache.clear();
+    ASSERT_EQ(0U, planCache.size());
+}
+
+TEST(PlanCacheTest, EvictsLeastRecentlyUsedEntriesWhenOverBudget) {
+    QueryTestServiceContext serviceContext;
+    unique_ptr<CanonicalQuery> cqA(canonicalize("{a: 1}"));
+    unique_ptr<CanonicalQuery> cqB(canonicalize("{b: 1}"));
+
+    // Measure the footprint of a single entry, then size a cache to hold one entry but not two.
+    long long entrySize;
+    {
+        PlanCache unbounded;
+        addCacheEntryForShape(*cqA, &unbounded);
+        BSONObjBuilder bob;
+        unbounded.appendSummaryStats(&bob);
+        entrySize = bob.obj()["estimatedSizeBytes"].numberLong();
+        ASSERT_GT(entrySize, 0);
+    }
+
+    PlanCache planCache(100 /* maxEntries */, entrySize + entrySize / 2, 1 /* numPartitions */);
+    addCacheEntryForShape(*cqA, &planCache);
+    addCacheEntryForShape(*cqB, &planCache);
+
+    ASSERT_EQ(1U, planCache.size());
+    ASSERT_EQ(planCache.get(*cqA).state, PlanCache::CacheEntryState::kNotPresent);
+    ASSERT_EQ(planCache.get(*cqB).state, PlanCache::CacheEntryState::kPresentInactive);
+
+    BSONObjBuilder bob;
+    planCache.appendSummaryStats(&bob);
+    auto stats = bob.obj();
+    ASSERT_EQ(1, stats["numEntries"].numberLong());
+    ASSERT_EQ(1, stats["evictions"].numberLong());
+    ASSERT_LTE(stats["estimatedSizeBytes"].numberLong(), entrySize + entrySize / 2);
+}
+
+TEST(PlanCacheTest, MaxSizeBytesIsSharedByAllPartitions) {
+    QueryTestServiceContext serviceContext;
+    std::vector<unique_ptr<CanonicalQuery>> queries;
+    for (auto&& field : {"a", "b", "c", "d", "e", "f", "g", "h"}) {
+        queries.push_back(canonicalize(BSON(field << 1)));
+    }
+
+    long long entrySize;
+    {
+        PlanCache unbounded;
+        addCacheEntryForShape(*queries[0], &unbounded);
+        BSONObjBuilder bob;
+        unbounded.appendSummaryStats(&bob);
+        entrySize = bob.obj()["estimatedSizeBytes"].numberLong();
+        ASSERT_GT(entrySize, 0);
+    }
+
+    // The cache can hold two entries, whichever partitions they fall in, even though a quarter of
+    // its maximum size is less than the size of one entry.
+    const long long maxSizeBytes = 2 * entrySize + entrySize / 2;
+    PlanCache planCache(100 /* maxEntries */, maxSizeBytes, 4 /* numPartitions */);
+    for (auto&& cq : queries) {
+        addCacheEntryForShape(*cq, &planCache);
+    }
+
+    BSONObjBuilder bob;
+    planCache.appendSummaryStats(&bob);
+    auto stats = bob.obj();
+    ASSERT_EQ(2, stats["numEntries"].numberLong());
+    ASSERT_EQ(static_cast<long long>(queries.size()) - 2, stats["evictions"].numberLong());
+    ASSERT_LTE(stats["estimatedSizeBytes"].numberLong(), maxSizeBytes);
+}
+
+TEST(PlanCacheTest, SbeFingerprintIgnoresValuesOfInputParameters) {
+    auto fingerprint = [](StringData query) {
+        return sbe::CachedSbePlan::computeQueryFingerprint(*canonicalize(query));
+    };
+
+    // Queries which only differ in the values of their parameters share the cached SBE plan.
+    ASSERT_BSONOBJ_EQ(fingerprint("{a: 1, b: {$lt: 5}}"), fingerprint("{a: 2, b: {$lt: 7.5}}"));
+
+    // The canonical types of the parameters, and the constants which are not parameterized, are
+    // part of the fingerprint.
+    ASSERT_BSONOBJ_NE(fingerprint("{a: 1, b: {$lt: 5}}"), fingerprint("{a: 'x', b: {$lt: 5}}"));
+    ASSERT_BSONOBJ_NE(fingerprint("{a: 1, b: {$size: 1}}"), fingerprint("{a: 1, b: {$size: 2}}"));
+    ASSERT_BSONOBJ_NE(fingerprint("{a: 1}"), fingerprint("{a: null}"));
+}
+
+TEST(PlanCacheTest, SummaryStatsCountHitsAndMisses) {
+    PlanCache planCache;
+    QueryTestServiceContext serviceContext;
+    unique_ptr<CanonicalQuery> cq(canonicalize("{a: 1}"));
+    auto qs = getQuerySolutionForCaching();
+    std::vector<QuerySolution*> solns = {qs.get()};
+
+    // A lookup of a missing entry and of an inactive entry both count as misses.
+    ASSERT_EQ(planCache.get(*cq).state, PlanCache::CacheEntryState::kNotPresent);
+    ASSERT_OK(planCache.set(*cq, solns, createDecision(1U, 10), Date_t{}));
+    ASSERT_EQ(planCache.get(*cq).state, PlanCache::CacheEntryState::kPresentInactive);
+
+    // Activate the entry; subsequent lookups count as hits.
+    ASSERT_OK(planCache.set(*cq, solns, createDecision(1U, 10), Date_t{}));
+    ASSERT_EQ(planCache.get(*cq).state, PlanCache::CacheEntryState::kPresentActive);
+    ASSERT_EQ(planCache.get(*cq).state, PlanCache::CacheEntryState::kPresentActive);
+
+    BSONObjBuilder bob;
+    planCache.appendSummaryStats(&bob);
+    auto stats = bob.obj();
+    ASSERT_EQ(1, stats["numEntries"].numberLong());
+    ASSERT_EQ(0, stats["numCachedExecutionPlans"].numberLong());
+    ASSERT_EQ(2, stats["hits"].numberLong());
+    ASSERT_EQ(2, stats["misses"].numberLong());
+    ASSERT_EQ(0, stats["evictions"].numberLong());
+}
+
 /**
  * Each test in the CachePlanSelectionTest suite goes through
  * the following flow:
@@ -457,6 +457,9 @@ void statsToBSON(const PlanStageStats& stats,
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
             bob->appendIntOrLL("totalDataSizeSorted", spec->totalDataSizeBytes);
             bob->appendBool("usedDisk", spec->wasDiskUsed);
+            if (spec->wasDiskUsed) {
+                bob->append("spillCompressionRatio", spec->spillCompressionRatio());
+            }
         }
     } else if (STAGE_SORT_MERGE == stats.stageType) {
         MergeSortStats* spec = static_cast<MergeSortStats*>(stats.specific.get());
@@ -0,0 +1,171 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/sbe_cached_plan.h"
+
+#include "mongo/db/exec/sbe/values/bson.h"
+#include "mongo/db/exec/trial_period_utils.h"
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/query/plan_yield_policy_sbe.h"
+#include "mongo/db/query/sbe_stage_builder_helpers.h"
+#include "mongo/db/query/sbe_stage_builder_index_scan.h"
+
+namespace mongo::sbe {
+namespace {
+/**
+ * Copies 'data', except for the trial run tracker, giving the copy its own runtime environment.
+ */
+stage_builder::PlanStageData copyPlanStageData(const stage_builder::PlanStageData& data) {
+    stage_builder::PlanStageData copy{data.env->makeDeepCopy()};
+    copy.resultSlot = data.resultSlot;
+    copy.recordIdSlot = data.recordIdSlot;
+    copy.oplogTsSlot = data.oplogTsSlot;
+    copy.shouldTrackLatestOplogTimestamp = data.shouldTrackLatestOplogTimestamp;
+    copy.shouldTrackResumeToken = data.shouldTrackResumeToken;
+    copy.shouldUseTailableScan = data.shouldUseTailableScan;
+    return copy;
+}
+
+/**
+ * Calls 'fn' on each parameterized comparison of the filter 'root', which are either the root
+ * itself or children of a top-level $and.
+ */
+template <typename Fn>
+void forEachInputParam(MatchExpression* root, Fn&& fn) {
+    auto visit = [&](MatchExpression* expr) {
+        if (ComparisonMatchExpression::isComparisonMatchExpression(expr)) {
+            auto comparison = static_cast<ComparisonMatchExpression*>(expr);
+            if (auto paramId = comparison->getInputParamId()) {
+                fn(*paramId, comparison);
+            }
+        }
+    };
+
+    if (root->matchType() == MatchExpression::AND) {
+        for (size_t i = 0; i < root->numChildren(); ++i) {
+            visit(root->getChild(i));
+        }
+    } else {
+        visit(root);
+    }
+}
+
+/**
+ * Resets the slots of 'env' which hold input parameters to the constants of the input parameters
+ * of 'cq'.
+ */
+void bindInputParams(const CanonicalQuery& cq, RuntimeEnvironment* env) {
+    const auto& params = cq.getInputParamIdToMatchExpressionMap();
+    for (size_t paramId = 0; paramId < params.size(); ++paramId) {
+        // A comparison which only contributes to index bounds doesn't have a slot of its own.
+        auto slot = env->getSlotIfExists(stage_builder::makeInputParamSlotName(paramId));
+        if (!slot) {
+            continue;
+        }
+
+        const auto& rhs = static_cast<const ComparisonMatchExpression*>(params[paramId])->getData();
+        auto [tagView, valView] = bson::convertFrom(
+            true, rhs.rawdata(), rhs.rawdata() + rhs.size(), rhs.fieldNameSize() - 1);
+        auto [tag, val] = value::copyValue(tagView, valView);
+        env->resetSlot(*slot, tag, val, true /* owned */);
+    }
+}
+}  // namespace
+
+CachedSbePlan::CachedSbePlan(const CanonicalQuery& cq,
+                             const PlanStage& root,
+                             const stage_builder::PlanStageData& data)
+    : _queryFingerprint(computeQueryFingerprint(cq)),
+      _root(root.clone()),
+      _data(copyPlanStageData(data)),
+      _estimatedSizeBytes(sizeof(*this) + _queryFingerprint.objsize() +
+                          _root->estimateCompileTimeSize()) {}
+
+BSONObj CachedSbePlan::computeQueryFingerprint(const CanonicalQuery& cq) {
+    auto findCommand = cq.getQueryRequest().asFindCommand();
+    const auto numParams = cq.getInputParamIdToMatchExpressionMap().size();
+    if (numParams == 0) {
+        return findCommand;
+    }
+
+    // Replace the parameterized constants of the filter by placeholders. Their canonical types
+    // still matter, since index bounds and the comparisons of a plan depend on them.
+    const auto placeholder = BSON("" << BSON("$inputParam" << true));
+    std::vector<int> paramTypes(numParams);
+    auto filter = cq.root()->shallowClone();
+    forEachInputParam(filter.get(), [&](auto paramId, ComparisonMatchExpression* comparison) {
+        paramTypes[paramId] = canonicalizeBSONType(comparison->getData().type());
+        comparison->setData(placeholder.firstElement());
+    });
+
+    BSONObjBuilder bob;
+    for (auto&& elem : findCommand) {
+        if (elem.fieldNameStringData() == QueryRequest::kFilterField) {
+            BSONObjBuilder filterBob(bob.subobjStart(QueryRequest::kFilterField));
+            filter->serialize(&filterBob, true);
+        } else {
+            bob.append(elem);
+        }
+    }
+    bob.append("inputParamTypes", paramTypes);
+    return bob.obj();
+}
+
+boost::optional<std::pair<std::unique_ptr<PlanStage>, stage_builder::PlanStageData>>
+CachedSbePlan::makeExecutableTree(OperationContext* opCtx,
+                                  const CollectionPtr& collection,
+                                  const CanonicalQuery& cq,
+                                  const QuerySolution& solution,
+                                  PlanYieldPolicy* yieldPolicy) const {
+    auto sbeYieldPolicy = dynamic_cast<PlanYieldPolicySBE*>(yieldPolicy);
+    invariant(sbeYieldPolicy);
+
+    auto data = copyPlanStageData(_data);
+    if (!cq.getInputParamIdToMatchExpressionMap().empty()) {
+        bindInputParams(cq, data.env);
+        if (!stage_builder::bindIndexBounds(opCtx, collection, solution.root(), data.env)) {
+            return boost::none;
+        }
+    }
+
+    auto root = _root->clone();
+    data.trialRunProgressTracker = std::make_unique<TrialRunProgressTracker>(
+        trial_period::getTrialPeriodNumToReturn(cq),
+        trial_period::getTrialPeriodMaxWorks(opCtx, collection));
+    root->attachNewYieldPolicy(sbeYieldPolicy);
+    root->attachToTrialRunTracker(data.trialRunProgressTracker.get());
+
+    // Register this plan to yield according to the configured policy.
+    sbeYieldPolicy->registerPlan(root.get());
+
+    return std::make_pair(std::move(root), std::move(data));
+}
+}  // namespace mongo::sbe
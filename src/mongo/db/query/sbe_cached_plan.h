@@ -0,0 +1,107 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+
+#include "mongo/db/query/plan_cache.h"
+#include "mongo/db/query/plan_yield_policy.h"
+#include "mongo/db/query/query_solution.h"
+#include "mongo/db/query/sbe_stage_builder.h"
+
+namespace mongo::sbe {
+/**
+ * An SBE plan stage tree kept in the plan cache together with the SolutionCacheData of the
+ * solution it was built from, so that a query which hits the cache entry can clone the tree rather
+ * than build it again from a QuerySolution.
+ *
+ * The cached tree is never prepared, since a prepared tree is bound to the accessors, the runtime
+ * environment and the yield policy of the query it runs for. A query which hits the entry saves
+ * the work of the stage builder, but still prepares its copy, and so compiles its expressions.
+ *
+ * A cached tree can only be reused by a query whose fingerprint, as computed by
+ * computeQueryFingerprint(), is the same as that of the query the tree was built for. The constants
+ * of a query which were not auto-parameterized are compiled into its SBE plan, and so are part of
+ * the fingerprint. The parameterized ones, and the index bounds derived from them, are held in the
+ * runtime environment of the plan, and are rebound to the values of the query which reuses it.
+ * Other queries of the same shape build their tree from the cached solution as before.
+ */
+class CachedSbePlan final : public CachedExecutionPlan {
+public:
+    /**
+     * Copies the plan stage tree rooted at 'root', and its 'data', built for 'cq'.
+     */
+    CachedSbePlan(const CanonicalQuery& cq,
+                  const PlanStage& root,
+                  const stage_builder::PlanStageData& data);
+
+    /**
+     * Returns what identifies the SBE plans built for 'cq': its find command, with the constants of
+     * its input parameters replaced by placeholders, and the canonical types of these constants.
+     */
+    static BSONObj computeQueryFingerprint(const CanonicalQuery& cq);
+
+    uint64_t estimateObjectSizeInBytes() const final {
+        return _estimatedSizeBytes;
+    }
+
+    /**
+     * Returns true if this plan can be run for the query with the given 'queryFingerprint'.
+     */
+    bool matches(const BSONObj& queryFingerprint) const {
+        return _queryFingerprint.binaryEqual(queryFingerprint);
+    }
+
+    /**
+     * Returns a copy of the cached tree and of its data, which yields according to 'yieldPolicy'
+     * and tracks the progress of its trial run in a tracker owned by the copied data, like a tree
+     * built for the cached plan trial run. The copy is bound to the input parameters of 'cq' and to
+     * the index bounds of 'solution', the solution planned for 'cq' from this cache entry.
+     *
+     * Returns boost::none if the index bounds of 'solution' can't be bound to the cached tree, in
+     * which case the tree must be built from 'solution'.
+     */
+    boost::optional<std::pair<std::unique_ptr<PlanStage>, stage_builder::PlanStageData>>
+    makeExecutableTree(OperationContext* opCtx,
+                       const CollectionPtr& collection,
+                       const CanonicalQuery& cq,
+                       const QuerySolution& solution,
+                       PlanYieldPolicy* yieldPolicy) const;
+
+private:
+    const BSONObj _queryFingerprint;
+    const std::unique_ptr<PlanStage> _root;
+
+    // A copy of the data the tree was built with, without a trial run tracker.
+    const stage_builder::PlanStageData _data;
+
+    const uint64_t _estimatedSizeBytes;
+};
+}  // namespace mongo::sbe
@@ -33,6 +33,7 @@
 
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/exec/sbe/stages/co_scan.h"
+#include "mongo/db/exec/sbe/stages/exchange.h"
 #include "mongo/db/exec/sbe/stages/filter.h"
 #include "mongo/db/exec/sbe/stages/hash_agg.h"
 #include "mongo/db/exec/sbe/stages/limit_skip.h"
@@ -48,13 +49,88 @@
 #include "mongo/db/fts/fts_query_impl.h"
 #include "mongo/db/fts/fts_spec.h"
 #include "mongo/db/index/fts_access_method.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/sbe_stage_builder_coll_scan.h"
 #include "mongo/db/query/sbe_stage_builder_filter.h"
 #include "mongo/db/query/sbe_stage_builder_index_scan.h"
 #include "mongo/db/query/sbe_stage_builder_projection.h"
 #include "mongo/db/query/util/make_data_structure.h"
+#include "mongo/db/repl/read_concern_args.h"
+#include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/storage/storage_engine.h"
 
 namespace mongo::stage_builder {
+namespace {
+/**
+ * Reserves the threads the collection scan of the given query should be split across, or returns
+ * an empty reservation if it should run on the calling thread only. The producer threads of a
+ * parallel scan all read at the read timestamp of the operation, so only queries which don't ask
+ * for a particular order and which already read at a timestamp may be run in parallel. These are
+ * snapshot reads, and reads on secondaries, which read at lastApplied or at the no-overlap
+ * timestamp. A "local" read on a primary reads the latest data without a timestamp. No timestamp
+ * would show the producers the same data: the all-durable timestamp, for one, can be behind writes
+ * which were already acknowledged to the client.
+ */
+sbe::ExchangeWorkerReservation reserveCollScanWorkers(OperationContext* opCtx,
+                                                      const CanonicalQuery& cq,
+                                                      const CollectionPtr& collection) {
+    auto maxDegree =
+        static_cast<size_t>(internalQuerySlotBasedExecutionMaxDegreeOfParallelism.load());
+    if (maxDegree < 2) {
+        return {};
+    }
+
+    const auto& qr = cq.getQueryRequest();
+    if (qr.isTailable() || qr.getHint().hasField(QueryRequest::kNaturalSortField) ||
+        qr.getSort().hasField(QueryRequest::kNaturalSortField)) {
+        return {};
+    }
+
+    const auto readConcernLevel = repl::ReadConcernArgs::get(opCtx).getLevel();
+    if (opCtx->inMultiDocumentTransaction() ||
+        (readConcernLevel != repl::ReadConcernLevel::kLocalReadConcern &&
+         readConcernLevel != repl::ReadConcernLevel::kSnapshotReadConcern)) {
+        return {};
+    }
+
+    if (!repl::ReplicationCoordinator::get(opCtx)->isReplEnabled() ||
+        !opCtx->getServiceContext()->getStorageEngine()->supportsReadConcernSnapshot()) {
+        return {};
+    }
+
+    auto recoveryUnit = opCtx->recoveryUnit();
+    switch (recoveryUnit->getTimestampReadSource()) {
+        case RecoveryUnit::ReadSource::kProvided:
+        case RecoveryUnit::ReadSource::kLastApplied:
+        case RecoveryUnit::ReadSource::kNoOverlap:
+            break;
+        default:
+            return {};
+    }
+    // Before a secondary has applied its first batch, it has no lastApplied timestamp to read at.
+    auto readTimestamp = recoveryUnit->getPointInTimeReadTimestamp();
+    if (!readTimestamp || readTimestamp->isNull()) {
+        return {};
+    }
+
+    auto minRecords = internalQuerySlotBasedExecutionParallelScanMinRecords.load();
+    if (collection->numRecords(opCtx) < static_cast<uint64_t>(minRecords)) {
+        return {};
+    }
+
+    // Only use the threads which are not reserved by the parallel scans of other operations. The
+    // threads are reserved here rather than counted, since the producers only start once the plan
+    // is opened and other operations may be building plans in the meantime.
+    auto maxWorkers =
+        static_cast<size_t>(internalQuerySlotBasedExecutionMaxParallelWorkers.load());
+    auto workers = sbe::ExchangeWorkerReservation::reserve(maxDegree, maxWorkers);
+    if (workers.count() < 2) {
+        return {};
+    }
+    return workers;
+}
+}  // namespace
+
 std::unique_ptr<sbe::RuntimeEnvironment> makeRuntimeEnvironment(
     OperationContext* opCtx, sbe::value::SlotIdGenerator* slotIdGenerator) {
     auto env = std::make_unique<sbe::RuntimeEnvironment>();
@@ -80,7 +156,8 @@ std::unique_ptr<sbe::PlanStage> SlotBasedStageBuilder::buildCollScan(
                          _yieldPolicy,
                          _data.env,
                          _isTailableCollScanResumeBranch,
-                         _data.trialRunProgressTracker.get());
+                         _data.trialRunProgressTracker.get(),
+                         reserveCollScanWorkers(_opCtx, _cq, _collection));
     _data.resultSlot = resultSlot;
     _data.recordIdSlot = recordIdSlot;
     _data.oplogTsSlot = oplogTsSlot;
@@ -102,6 +179,9 @@ std::unique_ptr<sbe::PlanStage> SlotBasedStageBuilder::buildCollScan(
 std::unique_ptr<sbe::PlanStage> SlotBasedStageBuilder::buildIndexScan(
     const QuerySolutionNode* root) {
     auto ixn = static_cast<const IndexScanNode*>(root);
+    // The index bounds of an auto-parameterized query are derived from its parameters, so they are
+    // held in the runtime environment for the plan to be rebound to the bounds of another query.
+    auto boundsEnv = _cq.getInputParamIdToMatchExpressionMap().empty() ? nullptr : _data.env;
     auto [slot, stage] = generateIndexScan(_opCtx,
                                            _collection,
                                            ixn,
@@ -109,7 +189,8 @@ std::unique_ptr<sbe::PlanStage> SlotBasedStageBuilder::buildIndexScan(
                                            &_slotIdGenerator,
                                            &_spoolIdGenerator,
                                            _yieldPolicy,
-                                           _data.trialRunProgressTracker.get());
+                                           _data.trialRunProgressTracker.get(),
+                                           boundsEnv);
     _data.recordIdSlot = slot;
     return std::move(stage);
 }
@@ -42,6 +42,7 @@
 #include "mongo/db/exec/sbe/stages/project.h"
 #include "mongo/db/exec/sbe/stages/scan.h"
 #include "mongo/db/exec/sbe/stages/union.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/sbe_stage_builder_filter.h"
 #include "mongo/db/query/util/make_data_structure.h"
 #include "mongo/db/storage/oplog_hack.h"
@@ -443,6 +444,69 @@ generateGenericCollScan(OperationContext* opCtx,
 
     return {resultSlot, recordIdSlot, tsSlot, std::move(stage)};
 }
+
+/**
+ * Generates a collection scan sub-tree which splits the RecordId space of the collection into
+ * ranges and scans them on the threads of 'parallelWorkers'. Every producer thread applies the
+ * filter to its own share of the records, and an exchange on top gathers the matching records back
+ * into a single stream, in no particular order.
+ */
+std::tuple<sbe::value::SlotId,
+           sbe::value::SlotId,
+           boost::optional<sbe::value::SlotId>,
+           std::unique_ptr<sbe::PlanStage>>
+generateParallelCollScan(OperationContext* opCtx,
+                         const CollectionPtr& collection,
+                         const CollectionScanNode* csn,
+                         sbe::value::SlotIdGenerator* slotIdGenerator,
+                         sbe::value::FrameIdGenerator* frameIdGenerator,
+                         sbe::RuntimeEnvironment* env,
+                         sbe::ExchangeWorkerReservation parallelWorkers) {
+    const auto degreeOfParallelism = parallelWorkers.count();
+    invariant(degreeOfParallelism > 1);
+    invariant(csn->direction == CollectionScanParams::FORWARD);
+    invariant(!csn->resumeAfterRecordId && !csn->tailable && !csn->shouldTrackLatestOplogTimestamp);
+
+    auto resultSlot = slotIdGenerator->generate();
+    auto recordIdSlot = slotIdGenerator->generate();
+
+    // The producers run under operation contexts of their own, so they cannot take part in the
+    // yielding of the main plan and are not given a yield policy.
+    NamespaceStringOrUUID nss{collection->ns().db().toString(), collection->uuid()};
+    std::unique_ptr<sbe::PlanStage> stage =
+        sbe::makeS<sbe::ParallelScanStage>(nss,
+                                           resultSlot,
+                                           recordIdSlot,
+                                           std::vector<std::string>{},
+                                           sbe::makeSV(),
+                                           nullptr,
+                                           csn->nodeId());
+
+    if (csn->filter) {
+        stage = generateFilter(opCtx,
+                               csn->filter.get(),
+                               std::move(stage),
+                               slotIdGenerator,
+                               frameIdGenerator,
+                               resultSlot,
+                               env,
+                               sbe::makeSV(resultSlot, recordIdSlot),
+                               csn->nodeId());
+    }
+
+    auto exchange = std::make_unique<sbe::ExchangeConsumer>(std::move(stage),
+                                                            degreeOfParallelism,
+                                                            sbe::makeSV(resultSlot, recordIdSlot),
+                                                            sbe::ExchangePolicy::roundrobin,
+                                                            nullptr,
+                                                            nullptr,
+                                                            csn->nodeId());
+    exchange->setWorkerReservation(
+        std::move(parallelWorkers),
+        static_cast<size_t>(internalQuerySlotBasedExecutionMaxParallelWorkers.load()));
+
+    return {resultSlot, recordIdSlot, boost::none, std::move(exchange)};
+}
 }  // namespace
 
 std::tuple<sbe::value::SlotId,
@@ -457,10 +521,24 @@ generateCollScan(OperationContext* opCtx,
                  PlanYieldPolicy* yieldPolicy,
                  sbe::RuntimeEnvironment* env,
                  bool isTailableResumeBranch,
-                 TrialRunProgressTracker* tracker) {
+                 TrialRunProgressTracker* tracker,
+                 sbe::ExchangeWorkerReservation parallelWorkers) {
+    const bool canScanInParallel = csn->direction == CollectionScanParams::FORWARD &&
+        !csn->minTs && !csn->maxTs && !csn->resumeAfterRecordId && !csn->requestResumeToken &&
+        !csn->tailable && !csn->shouldTrackLatestOplogTimestamp &&
+        !csn->shouldWaitForOplogVisibility && !isTailableResumeBranch && !tracker &&
+        !collection->ns().isOplog();
 
     auto [resultSlot, recordIdSlot, oplogTsSlot, stage] = [&]() {
-        if (csn->minTs || csn->maxTs) {
+        if (parallelWorkers.count() > 1 && canScanInParallel) {
+            return generateParallelCollScan(opCtx,
+                                            collection,
+                                            csn,
+                                            slotIdGenerator,
+                                            frameIdGenerator,
+                                            env,
+                                            std::move(parallelWorkers));
+        } else if (csn->minTs || csn->maxTs) {
             return generateOptimizedOplogScan(opCtx,
                                               collection,
                                               csn,
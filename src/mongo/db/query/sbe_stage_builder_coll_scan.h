@@ -30,6 +30,7 @@
 #pragma once
 
 #include "mongo/db/exec/sbe/expressions/expression.h"
+#include "mongo/db/exec/sbe/stages/exchange.h"
 #include "mongo/db/exec/sbe/stages/stages.h"
 #include "mongo/db/exec/sbe/values/value.h"
 #include "mongo/db/exec/trial_run_progress_tracker.h"
@@ -46,6 +47,11 @@ namespace mongo::stage_builder {
  *     were requested to track this data.
  *   * A generated PlanStage sub-tree.
  *
+ * If 'parallelWorkers' holds more than one thread, a plain forward scan is split into that many
+ * ranges of RecordIds which are scanned and filtered concurrently by an exchange, in no particular
+ * order, which gives each thread back as its producer finishes. Scans which need to produce records
+ * in order, or to track their position, give the threads back straight away.
+ *
  * In cases of an error, throws.
  */
 std::tuple<sbe::value::SlotId,
@@ -60,5 +66,6 @@ generateCollScan(OperationContext* opCtx,
                  PlanYieldPolicy* yieldPolicy,
                  sbe::RuntimeEnvironment* env,
                  bool isTailableResumeBranch,
-                 TrialRunProgressTracker* tracker);
+                 TrialRunProgressTracker* tracker,
+                 sbe::ExchangeWorkerReservation parallelWorkers = {});
 }  // namespace mongo::stage_builder
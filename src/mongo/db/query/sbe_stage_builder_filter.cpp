@@ -660,8 +660,8 @@ void generateArraySize(MatchExpressionVisitorContext* context,
 void generateComparison(MatchExpressionVisitorContext* context,
                         const ComparisonMatchExpression* expr,
                         sbe::EPrimBinary::Op binaryOp) {
-    auto makePredicate = [expr, binaryOp](sbe::value::SlotId inputSlot,
-                                          EvalStage inputStage) -> EvalExprStagePair {
+    auto makePredicate = [context, expr, binaryOp](sbe::value::SlotId inputSlot,
+                                                   EvalStage inputStage) -> EvalExprStagePair {
         const auto& rhs = expr->getData();
         auto [tagView, valView] = sbe::bson::convertFrom(
             true, rhs.rawdata(), rhs.rawdata() + rhs.size(), rhs.fieldNameSize() - 1);
@@ -669,11 +669,29 @@ void generateComparison(MatchExpressionVisitorContext* context,
         // SBE EConstant assumes ownership of the value so we have to make a copy here.
         auto [tag, val] = sbe::value::copyValue(tagView, valView);
 
-        return {
-            makeFillEmptyFalse(sbe::makeE<sbe::EPrimBinary>(binaryOp,
-                                                            sbe::makeE<sbe::EVariable>(inputSlot),
-                                                            sbe::makeE<sbe::EConstant>(tag, val))),
-            std::move(inputStage)};
+        // The constant of a parameterized comparison is read from a runtime environment slot, so
+        // that the plan can be rebound to the constant of another query of the same shape. The
+        // slot may have been registered already by a copy of this comparison elsewhere in the plan.
+        auto rhsExpr = [&, tag = tag, val = val]() -> std::unique_ptr<sbe::EExpression> {
+            auto paramId = expr->getInputParamId();
+            if (!paramId || !context->env) {
+                return sbe::makeE<sbe::EConstant>(tag, val);
+            }
+
+            auto slotName = makeInputParamSlotName(*paramId);
+            auto slot = context->env->getSlotIfExists(slotName);
+            if (slot) {
+                sbe::value::releaseValue(tag, val);
+            } else {
+                slot = context->env->registerSlot(
+                    slotName, tag, val, true /* owned */, context->slotIdGenerator);
+            }
+            return sbe::makeE<sbe::EVariable>(*slot);
+        }();
+
+        return {makeFillEmptyFalse(sbe::makeE<sbe::EPrimBinary>(
+                    binaryOp, sbe::makeE<sbe::EVariable>(inputSlot), std::move(rhsExpr))),
+                std::move(inputStage)};
     };
 
     generatePredicate(context, expr->path(), std::move(makePredicate));
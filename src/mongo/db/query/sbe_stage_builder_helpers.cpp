@@ -121,4 +121,12 @@ std::unique_ptr<sbe::EExpression> makeFillEmptyFalse(std::unique_ptr<sbe::EExpre
                                                sbe::value::bitcastFrom<bool>(false))));
 }
 
+std::string makeInputParamSlotName(MatchExpression::InputParamId paramId) {
+    return str::stream() << "inputParam" << paramId;
+}
+
+std::string makeIndexBoundsSlotName(StringData indexName, PlanNodeId nodeId, StringData bound) {
+    return str::stream() << "indexBounds." << indexName << "." << nodeId << "." << bound;
+}
+
 }  // namespace mongo::stage_builder
@@ -34,6 +34,7 @@
 #include <utility>
 
 #include "mongo/db/exec/sbe/expressions/expression.h"
+#include "mongo/db/matcher/expression.h"
 #include "mongo/db/query/stage_types.h"
 
 namespace mongo::stage_builder {
@@ -122,4 +123,17 @@ std::unique_ptr<sbe::EExpression> makeNot(std::unique_ptr<sbe::EExpression> e);
  */
 std::unique_ptr<sbe::EExpression> makeFillEmptyFalse(std::unique_ptr<sbe::EExpression> e);
 
+/**
+ * Returns the name of the runtime environment slot which holds the value of the input parameter
+ * 'paramId' in a plan built for an auto-parameterized query.
+ */
+std::string makeInputParamSlotName(MatchExpression::InputParamId paramId);
+
+/**
+ * Returns the name of the runtime environment slot which holds the 'bound' ("lowKey", "highKey" or
+ * "intervals") of the scan of index 'indexName' built for the QuerySolutionNode 'nodeId' in a plan
+ * built for an auto-parameterized query.
+ */
+std::string makeIndexBoundsSlotName(StringData indexName, PlanNodeId nodeId, StringData bound);
+
 }  // namespace mongo::stage_builder
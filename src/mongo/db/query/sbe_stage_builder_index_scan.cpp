@@ -49,6 +49,7 @@
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/query/sbe_stage_builder_helpers.h"
 #include "mongo/db/query/util/make_data_structure.h"
 #include "mongo/logv2/log.h"
 #include "mongo/util/str.h"
@@ -241,6 +242,51 @@ makeIntervalsFromIndexBounds(const IndexBounds& bounds,
     return result;
 }
 
+/**
+ * Returns the intervals of an index scan as an array of objects holding the low and high keys of
+ * each interval, e.g.:
+ *    [ {l: KS(...), h: KS(...)},
+ *      {l: KS(...), h: KS(...)}, ... ]
+ */
+std::pair<sbe::value::TypeTags, sbe::value::Value> makeIntervalsArray(
+    std::vector<std::pair<std::unique_ptr<KeyString::Value>, std::unique_ptr<KeyString::Value>>>
+        intervals) {
+    using namespace std::literals;
+
+    auto [boundsTag, boundsVal] = sbe::value::makeNewArray();
+    auto arr = sbe::value::getArrayView(boundsVal);
+    for (auto&& [lowKey, highKey] : intervals) {
+        auto [tag, val] = sbe::value::makeNewObject();
+        auto obj = sbe::value::getObjectView(val);
+        obj->push_back("l"sv,
+                       sbe::value::TypeTags::ksValue,
+                       sbe::value::bitcastFrom<KeyString::Value*>(lowKey.release()));
+        obj->push_back("h"sv,
+                       sbe::value::TypeTags::ksValue,
+                       sbe::value::bitcastFrom<KeyString::Value*>(highKey.release()));
+        arr->push_back(tag, val);
+    }
+    return {boundsTag, boundsVal};
+}
+
+/**
+ * Returns an expression evaluating to the value 'tag'/'val', which it takes ownership of. If 'env'
+ * is not null, the value is held in a slot named 'slotName' registered in this environment, so that
+ * it can be reset when the plan is rebound to the parameters of another query. Otherwise, the
+ * value is a constant.
+ */
+std::unique_ptr<sbe::EExpression> makeBoundExpr(sbe::value::TypeTags tag,
+                                                sbe::value::Value val,
+                                                sbe::RuntimeEnvironment* env,
+                                                const std::string& slotName,
+                                                sbe::value::SlotIdGenerator* slotIdGenerator) {
+    if (!env) {
+        return sbe::makeE<sbe::EConstant>(tag, val);
+    }
+    return sbe::makeE<sbe::EVariable>(
+        env->registerSlot(slotName, tag, val, true /* owned */, slotIdGenerator));
+}
+
 /**
  * Constructs an optimized version of an index scan for multi-interval index bounds for the case
  * when the bounds can be decomposed in a number of single-interval bounds. In this case, instead
@@ -276,6 +322,7 @@ generateOptimizedMultiIntervalIndexScan(
     sbe::value::SlotIdGenerator* slotIdGenerator,
     PlanYieldPolicy* yieldPolicy,
     TrialRunProgressTracker* tracker,
+    sbe::RuntimeEnvironment* env,
     PlanNodeId planNodeId) {
     using namespace std::literals;
 
@@ -283,22 +330,13 @@ generateOptimizedMultiIntervalIndexScan(
     auto lowKeySlot = slotIdGenerator->generate();
     auto highKeySlot = slotIdGenerator->generate();
 
-    // Construct an array containing objects with the low and high keys for each interval. E.g.,
-    //    [ {l: KS(...), h: KS(...)},
-    //      {l: KS(...), h: KS(...)}, ... ]
-    auto [boundsTag, boundsVal] = sbe::value::makeNewArray();
-    auto arr = sbe::value::getArrayView(boundsVal);
-    for (auto&& [lowKey, highKey] : intervals) {
-        auto [tag, val] = sbe::value::makeNewObject();
-        auto obj = sbe::value::getObjectView(val);
-        obj->push_back("l"sv,
-                       sbe::value::TypeTags::ksValue,
-                       sbe::value::bitcastFrom<KeyString::Value*>(lowKey.release()));
-        obj->push_back("h"sv,
-                       sbe::value::TypeTags::ksValue,
-                       sbe::value::bitcastFrom<KeyString::Value*>(highKey.release()));
-        arr->push_back(tag, val);
-    }
+    // Construct an array containing objects with the low and high keys for each interval.
+    auto [boundsTag, boundsVal] = makeIntervalsArray(std::move(intervals));
+    auto boundsExpr = makeBoundExpr(boundsTag,
+                                    boundsVal,
+                                    env,
+                                    makeIndexBoundsSlotName(indexName, planNodeId, "intervals"_sd),
+                                    slotIdGenerator);
 
     auto boundsSlot = slotIdGenerator->generate();
     auto unwindSlot = slotIdGenerator->generate();
@@ -311,7 +349,7 @@ generateOptimizedMultiIntervalIndexScan(
                 sbe::makeS<sbe::CoScanStage>(planNodeId), 1, boost::none, planNodeId),
             planNodeId,
             boundsSlot,
-            sbe::makeE<sbe::EConstant>(boundsTag, boundsVal)),
+            std::move(boundsExpr)),
         boundsSlot,
         unwindSlot,
         slotIdGenerator->generate(), /* We don't need an index slot but must to provide it. */
@@ -616,12 +654,17 @@ generateGenericMultiIntervalIndexScan(const CollectionPtr& collection,
 }
 }  // namespace
 
-std::pair<sbe::value::SlotId, std::unique_ptr<sbe::PlanStage>> generateSingleIntervalIndexScan(
+namespace {
+/**
+ * Implements generateSingleIntervalIndexScan(), with the low and high keys given by the
+ * expressions 'lowKeyExpr' and 'highKeyExpr'.
+ */
+std::pair<sbe::value::SlotId, std::unique_ptr<sbe::PlanStage>> makeSingleIntervalIndexScan(
     const CollectionPtr& collection,
     const std::string& indexName,
     bool forward,
-    std::unique_ptr<KeyString::Value> lowKey,
-    std::unique_ptr<KeyString::Value> highKey,
+    std::unique_ptr<sbe::EExpression> lowKeyExpr,
+    std::unique_ptr<sbe::EExpression> highKeyExpr,
     sbe::IndexKeysInclusionSet indexKeysToInclude,
     sbe::value::SlotVector vars,
     boost::optional<sbe::value::SlotId> recordSlot,
@@ -640,11 +683,9 @@ std::pair<sbe::value::SlotId, std::unique_ptr<sbe::PlanStage>> generateSingleInt
             sbe::makeS<sbe::CoScanStage>(planNodeId), 1, boost::none, planNodeId),
         planNodeId,
         lowKeySlot,
-        sbe::makeE<sbe::EConstant>(sbe::value::TypeTags::ksValue,
-                                   sbe::value::bitcastFrom<KeyString::Value*>(lowKey.release())),
+        std::move(lowKeyExpr),
         highKeySlot,
-        sbe::makeE<sbe::EConstant>(sbe::value::TypeTags::ksValue,
-                                   sbe::value::bitcastFrom<KeyString::Value*>(highKey.release())));
+        std::move(highKeyExpr));
 
     // Scan the index in the range {'lowKeySlot', 'highKeySlot'} (subject to inclusive or
     // exclusive boundaries), and produce a single field recordIdSlot that can be used to
@@ -672,6 +713,37 @@ std::pair<sbe::value::SlotId, std::unique_ptr<sbe::PlanStage>> generateSingleInt
                                            nullptr,
                                            planNodeId)};
 }
+}  // namespace
+
+std::pair<sbe::value::SlotId, std::unique_ptr<sbe::PlanStage>> generateSingleIntervalIndexScan(
+    const CollectionPtr& collection,
+    const std::string& indexName,
+    bool forward,
+    std::unique_ptr<KeyString::Value> lowKey,
+    std::unique_ptr<KeyString::Value> highKey,
+    sbe::IndexKeysInclusionSet indexKeysToInclude,
+    sbe::value::SlotVector vars,
+    boost::optional<sbe::value::SlotId> recordSlot,
+    sbe::value::SlotIdGenerator* slotIdGenerator,
+    PlanYieldPolicy* yieldPolicy,
+    TrialRunProgressTracker* tracker,
+    PlanNodeId planNodeId) {
+    return makeSingleIntervalIndexScan(
+        collection,
+        indexName,
+        forward,
+        sbe::makeE<sbe::EConstant>(sbe::value::TypeTags::ksValue,
+                                   sbe::value::bitcastFrom<KeyString::Value*>(lowKey.release())),
+        sbe::makeE<sbe::EConstant>(sbe::value::TypeTags::ksValue,
+                                   sbe::value::bitcastFrom<KeyString::Value*>(highKey.release())),
+        indexKeysToInclude,
+        std::move(vars),
+        recordSlot,
+        slotIdGenerator,
+        yieldPolicy,
+        tracker,
+        planNodeId);
+}
 
 
 std::pair<sbe::value::SlotId, std::unique_ptr<sbe::PlanStage>> generateIndexScan(
@@ -682,7 +754,8 @@ std::pair<sbe::value::SlotId, std::unique_ptr<sbe::PlanStage>> generateIndexScan
     sbe::value::SlotIdGenerator* slotIdGenerator,
     sbe::value::SpoolIdGenerator* spoolIdGenerator,
     PlanYieldPolicy* yieldPolicy,
-    TrialRunProgressTracker* tracker) {
+    TrialRunProgressTracker* tracker,
+    sbe::RuntimeEnvironment* env) {
     invariant(returnKeySlot || !ixn->addKeyMetadata);
     uassert(4822864, "Index scans with a filter are not supported in SBE", !ixn->filter);
 
@@ -732,18 +805,31 @@ std::pair<sbe::value::SlotId, std::unique_ptr<sbe::PlanStage>> generateIndexScan
         if (intervals.size() == 1) {
             // If we have just a single interval, we can construct a simplified sub-tree.
             auto&& [lowKey, highKey] = intervals[0];
-            return generateSingleIntervalIndexScan(collection,
-                                                   ixn->index.identifier.catalogName,
-                                                   ixn->direction == 1,
-                                                   std::move(lowKey),
-                                                   std::move(highKey),
-                                                   indexKeysToInclude,
-                                                   vars,
-                                                   boost::none,  // recordSlot
-                                                   slotIdGenerator,
-                                                   yieldPolicy,
-                                                   tracker,
-                                                   ixn->nodeId());
+            const auto& indexName = ixn->index.identifier.catalogName;
+            auto lowKeyExpr = makeBoundExpr(
+                sbe::value::TypeTags::ksValue,
+                sbe::value::bitcastFrom<KeyString::Value*>(lowKey.release()),
+                env,
+                makeIndexBoundsSlotName(indexName, ixn->nodeId(), "lowKey"_sd),
+                slotIdGenerator);
+            auto highKeyExpr = makeBoundExpr(
+                sbe::value::TypeTags::ksValue,
+                sbe::value::bitcastFrom<KeyString::Value*>(highKey.release()),
+                env,
+                makeIndexBoundsSlotName(indexName, ixn->nodeId(), "highKey"_sd),
+                slotIdGenerator);
+            return makeSingleIntervalIndexScan(collection,
+                                               indexName,
+                                               ixn->direction == 1,
+                                               std::move(lowKeyExpr),
+                                               std::move(highKeyExpr),
+                                               indexKeysToInclude,
+                                               vars,
+                                               boost::none,  // recordSlot
+                                               slotIdGenerator,
+                                               yieldPolicy,
+                                               tracker,
+                                               ixn->nodeId());
         } else if (intervals.size() > 1) {
             // Or, if we were able to decompose multi-interval index bounds into a number of
             // single-interval bounds, we can also built an optimized sub-tree to perform an index
@@ -757,9 +843,12 @@ std::pair<sbe::value::SlotId, std::unique_ptr<sbe::PlanStage>> generateIndexScan
                                                            slotIdGenerator,
                                                            yieldPolicy,
                                                            tracker,
+                                                           env,
                                                            ixn->nodeId());
         } else {
-            // Otherwise, build a generic index scan for multi-interval index bounds.
+            // Otherwise, build a generic index scan for multi-interval index bounds. Its bounds
+            // are always embedded into the plan, so the plan can't be rebound by
+            // bindIndexBounds().
             return generateGenericMultiIntervalIndexScan(
                 collection,
                 ixn,
@@ -793,4 +882,67 @@ std::pair<sbe::value::SlotId, std::unique_ptr<sbe::PlanStage>> generateIndexScan
 
     return {slot, std::move(stage)};
 }
+
+bool bindIndexBounds(OperationContext* opCtx,
+                     const CollectionPtr& collection,
+                     const QuerySolutionNode* root,
+                     sbe::RuntimeEnvironment* env) {
+    for (auto&& child : root->children) {
+        if (!bindIndexBounds(opCtx, collection, child, env)) {
+            return false;
+        }
+    }
+
+    if (root->getType() != STAGE_IXSCAN) {
+        return true;
+    }
+
+    auto ixn = static_cast<const IndexScanNode*>(root);
+    const auto& indexName = ixn->index.identifier.catalogName;
+    auto descriptor = collection->getIndexCatalog()->findIndexByName(opCtx, indexName);
+    if (!descriptor) {
+        return false;
+    }
+    auto accessMethod = collection->getIndexCatalog()->getEntry(descriptor)->accessMethod();
+    auto intervals =
+        makeIntervalsFromIndexBounds(ixn->bounds,
+                                     ixn->direction == 1,
+                                     accessMethod->getSortedDataInterface()->getKeyStringVersion(),
+                                     accessMethod->getSortedDataInterface()->getOrdering());
+
+    // The new bounds must take the form the scan was built for: a single interval, or a number of
+    // single intervals.
+    if (auto lowKeySlot =
+            env->getSlotIfExists(makeIndexBoundsSlotName(indexName, ixn->nodeId(), "lowKey"_sd))) {
+        auto highKeySlot =
+            env->getSlotIfExists(makeIndexBoundsSlotName(indexName, ixn->nodeId(), "highKey"_sd));
+        if (!highKeySlot || intervals.size() != 1) {
+            return false;
+        }
+
+        auto&& [lowKey, highKey] = intervals[0];
+        env->resetSlot(*lowKeySlot,
+                       sbe::value::TypeTags::ksValue,
+                       sbe::value::bitcastFrom<KeyString::Value*>(lowKey.release()),
+                       true /* owned */);
+        env->resetSlot(*highKeySlot,
+                       sbe::value::TypeTags::ksValue,
+                       sbe::value::bitcastFrom<KeyString::Value*>(highKey.release()),
+                       true /* owned */);
+        return true;
+    }
+
+    if (auto intervalsSlot = env->getSlotIfExists(
+            makeIndexBoundsSlotName(indexName, ixn->nodeId(), "intervals"_sd))) {
+        if (intervals.empty()) {
+            return false;
+        }
+
+        auto [tag, val] = makeIntervalsArray(std::move(intervals));
+        env->resetSlot(*intervalsSlot, tag, val, true /* owned */);
+        return true;
+    }
+
+    return false;
+}
 }  // namespace mongo::stage_builder
@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include "mongo/db/exec/sbe/expressions/expression.h"
 #include "mongo/db/exec/sbe/stages/stages.h"
 #include "mongo/db/exec/sbe/values/value.h"
 #include "mongo/db/exec/trial_run_progress_tracker.h"
@@ -37,6 +38,9 @@
 namespace mongo::stage_builder {
 /**
  * Generates an SBE plan stage sub-tree implementing an index scan.
+ *
+ * If 'env' is not null, the bounds of the scan are held in slots of this runtime environment rather
+ * than embedded into the plan, when the bounds can be expressed as low/high keys.
  */
 std::pair<sbe::value::SlotId, std::unique_ptr<sbe::PlanStage>> generateIndexScan(
     OperationContext* opCtx,
@@ -46,7 +50,23 @@ std::pair<sbe::value::SlotId, std::unique_ptr<sbe::PlanStage>> generateIndexScan
     sbe::value::SlotIdGenerator* slotIdGenerator,
     sbe::value::SpoolIdGenerator* spoolIdGenerator,
     PlanYieldPolicy* yieldPolicy,
-    TrialRunProgressTracker* tracker);
+    TrialRunProgressTracker* tracker,
+    sbe::RuntimeEnvironment* env);
+
+/**
+ * Resets the index bounds of the index scans built by generateIndexScan() with a runtime
+ * environment, which are held in slots of 'env', to the bounds of the IXSCAN nodes of the same ids
+ * in the QuerySolution tree rooted at 'root'. This is how a plan built for an auto-parameterized
+ * query is rebound to the index bounds of another query of the same shape.
+ *
+ * Returns false if the bounds of some scan can't be rebound: the scan was built with constant
+ * bounds, or the new bounds take a different form (e.g., several intervals for a scan built for a
+ * single interval). The plan must be built again from 'root' in this case.
+ */
+bool bindIndexBounds(OperationContext* opCtx,
+                     const CollectionPtr& collection,
+                     const QuerySolutionNode* root,
+                     sbe::RuntimeEnvironment* env);
 
 /**
  * Constructs the most simple version of an index scan from the single interval index bounds. The
@@ -46,12 +46,14 @@ AllDatabaseCloner::AllDatabaseCloner(InitialSyncSharedData* sharedData,
                                      const HostAndPort& source,
                                      DBClientConnection* client,
                                      StorageInterface* storageInterface,
-                                     ThreadPool* dbPool)
+                                     ThreadPool* dbPool,
+                                     std::vector<DBClientConnection*> collectionClonerClients)
     : InitialSyncBaseCloner(
           "AllDatabaseCloner"_sd, sharedData, source, client, storageInterface, dbPool),
       _connectStage("connect", this, &AllDatabaseCloner::connectStage),
       _getInitialSyncIdStage("getInitialSyncId", this, &AllDatabaseCloner::getInitialSyncIdStage),
-      _listDatabasesStage("listDatabases", this, &AllDatabaseCloner::listDatabasesStage) {}
+      _listDatabasesStage("listDatabases", this, &AllDatabaseCloner::listDatabasesStage),
+      _collectionClonerClients(std::move(collectionClonerClients)) {}
 
 BaseCloner::ClonerStages AllDatabaseCloner::getStages() {
     return {&_connectStage, &_getInitialSyncIdStage, &_listDatabasesStage};
@@ -103,20 +105,26 @@ Status AllDatabaseCloner::ensurePrimaryOrSecondary(
 }
 
 BaseCloner::AfterStageBehavior AllDatabaseCloner::connectStage() {
-    auto* client = getClient();
-    // If the client already has the address (from a previous attempt), we must allow it to
-    // handle the reconnect itself. This is necessary to get correct backoff behavior.
-    if (client->getServerHostAndPort() != getSource()) {
-        client->setHandshakeValidationHook(
-            [this](const executor::RemoteCommandResponse& isMasterReply) {
-                return ensurePrimaryOrSecondary(isMasterReply);
-            });
-        uassertStatusOK(client->connect(getSource(), StringData()));
-    } else {
-        client->checkConnection();
+    auto connect = [this](DBClientConnection* client) {
+        // If the client already has the address (from a previous attempt), we must allow it to
+        // handle the reconnect itself. This is necessary to get correct backoff behavior.
+        if (client->getServerHostAndPort() != getSource()) {
+            client->setHandshakeValidationHook(
+                [this](const executor::RemoteCommandResponse& isMasterReply) {
+                    return ensurePrimaryOrSecondary(isMasterReply);
+                });
+            uassertStatusOK(client->connect(getSource(), StringData()));
+        } else {
+            client->checkConnection();
+        }
+        uassertStatusOK(replAuthenticate(client).withContext(
+            str::stream() << "Failed to authenticate to " << getSource()));
+    };
+
+    connect(getClient());
+    for (auto* client : _collectionClonerClients) {
+        connect(client);
     }
-    uassertStatusOK(replAuthenticate(client).withContext(
-        str::stream() << "Failed to authenticate to " << getSource()));
     return kContinueNormally;
 }
 
@@ -195,7 +203,8 @@ void AllDatabaseCloner::postStage() {
                                                                       getSource(),
                                                                       getClient(),
                                                                       getStorageInterface(),
-                                                                      getDBPool());
+                                                                      getDBPool(),
+                                                                      _collectionClonerClients);
         }
         auto dbStatus = _currentDatabaseCloner->run();
         if (dbStatus.isOK()) {
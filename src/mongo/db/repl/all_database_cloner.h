@@ -50,11 +50,16 @@ public:
         void append(BSONObjBuilder* builder) const;
     };
 
+    /**
+     * 'collectionClonerClients' are additional connections to the sync source, which the
+     * DatabaseCloners use to clone several collections concurrently.
+     */
     AllDatabaseCloner(InitialSyncSharedData* sharedData,
                       const HostAndPort& source,
                       DBClientConnection* client,
                       StorageInterface* storageInterface,
-                      ThreadPool* dbPool);
+                      ThreadPool* dbPool,
+                      std::vector<DBClientConnection*> collectionClonerClients = {});
 
     virtual ~AllDatabaseCloner() = default;
 
@@ -100,7 +105,7 @@ private:
     Status ensurePrimaryOrSecondary(const executor::RemoteCommandResponse& isMasterReply);
 
     /**
-     * Stage function that makes a connection to the sync source.
+     * Stage function that makes the connections to the sync source.
      */
     AfterStageBehavior connectStage();
 
@@ -134,12 +139,13 @@ private:
     // (X)  Access only allowed from the main flow of control called from run() or constructor.
     // (MX) Write access with mutex from main flow of control, read access with mutex from other
     //      threads, read access allowed from main flow without mutex.
-    ConnectStage _connectStage;                              // (R)
-    ConnectStage _getInitialSyncIdStage;                     // (R)
-    ClonerStage<AllDatabaseCloner> _listDatabasesStage;      // (R)
-    std::vector<std::string> _databases;                     // (X)
-    std::unique_ptr<DatabaseCloner> _currentDatabaseCloner;  // (MX)
-    Stats _stats;                                            // (MX)
+    ConnectStage _connectStage;                                       // (R)
+    ConnectStage _getInitialSyncIdStage;                              // (R)
+    ClonerStage<AllDatabaseCloner> _listDatabasesStage;               // (R)
+    const std::vector<DBClientConnection*> _collectionClonerClients;  // (X)
+    std::vector<std::string> _databases;                              // (X)
+    std::unique_ptr<DatabaseCloner> _currentDatabaseCloner;           // (MX)
+    Stats _stats;                                                     // (MX)
 };
 
 }  // namespace repl
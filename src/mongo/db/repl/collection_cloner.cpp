@@ -437,7 +437,11 @@ void CollectionCloner::insertDocumentsCallback(const executor::TaskExecutor::Cal
         }
         _documentsToInsert.swap(docs);
         _stats.documentsCopied += docs.size();
+        for (const auto& doc : docs) {
+            _stats.bytesCopied += doc.objsize();
+        }
         ++_stats.fetchedBatches;
+        _stats.lastBatchInserted = getSharedData()->getClock()->now();
         _progressMeter.hit(int(docs.size()));
         invariant(_collLoader);
 
@@ -515,6 +519,20 @@ void CollectionCloner::Stats::append(BSONObjBuilder* builder) const {
         }
     }
     builder->appendNumber("receivedBatches", receivedBatches);
+    builder->appendNumber("bytesCopied", static_cast<long long>(bytesCopied));
+
+    // The throughput is measured up to the last inserted batch, so that it does not drop while
+    // waiting for the next batch nor once the collection is cloned.
+    if (start != Date_t() && lastBatchInserted > start) {
+        long long elapsedMillis = durationCount<Milliseconds>(lastBatchInserted - start);
+        if (elapsedMillis > 0) {
+            builder->appendNumber(
+                "documentsCopiedPerSecond",
+                static_cast<long long>(documentsCopied * 1000 / elapsedMillis));
+            builder->appendNumber("bytesCopiedPerSecond",
+                                  static_cast<long long>(bytesCopied * 1000 / elapsedMillis));
+        }
+    }
 }
 
 }  // namespace repl
@@ -60,6 +60,8 @@ public:
         size_t indexes{0};
         size_t fetchedBatches{0};  // This is actually inserted batches.
         size_t receivedBatches{0};
+        size_t bytesCopied{0};
+        Date_t lastBatchInserted;
 
         std::string toString() const;
         BSONObj toBSON() const;
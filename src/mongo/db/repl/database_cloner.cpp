@@ -36,7 +36,9 @@
 #include "mongo/db/repl/database_cloner.h"
 #include "mongo/db/repl/database_cloner_common.h"
 #include "mongo/db/repl/database_cloner_gen.h"
+#include "mongo/db/client.h"
 #include "mongo/logv2/log.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 
 namespace mongo {
@@ -47,11 +49,13 @@ DatabaseCloner::DatabaseCloner(const std::string& dbName,
                                const HostAndPort& source,
                                DBClientConnection* client,
                                StorageInterface* storageInterface,
-                               ThreadPool* dbPool)
+                               ThreadPool* dbPool,
+                               std::vector<DBClientConnection*> collectionClonerClients)
     : InitialSyncBaseCloner(
           "DatabaseCloner"_sd, sharedData, source, client, storageInterface, dbPool),
       _dbName(dbName),
-      _listCollectionsStage("listCollections", this, &DatabaseCloner::listCollectionsStage) {
+      _listCollectionsStage("listCollections", this, &DatabaseCloner::listCollectionsStage),
+      _collectionClonerClients(std::move(collectionClonerClients)) {
     invariant(!dbName.empty());
     _stats.dbname = dbName;
 }
@@ -127,20 +131,54 @@ void DatabaseCloner::postStage() {
             _stats.collectionStats.back().ns = coll.first.ns();
         }
     }
-    for (const auto& coll : _collections) {
-        auto& sourceNss = coll.first;
-        auto& collectionOptions = coll.second;
+
+    // The collections are cloned over the main connection of this cloner and, concurrently, over
+    // each of the additional connections on threads of their own.
+    std::vector<stdx::thread> threads;
+    threads.reserve(_collectionClonerClients.size());
+    for (size_t i = 0; i < _collectionClonerClients.size(); ++i) {
+        threads.emplace_back([this, i] {
+            ThreadClient tc("DatabaseCloner-" + _dbName + "-" + std::to_string(i),
+                            getGlobalServiceContext());
+            runCollectionCloners(_collectionClonerClients[i]);
+        });
+    }
+    runCollectionCloners(getClient());
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (_collectionCloneFailed) {
+        return;
+    }
+    _stats.end = getSharedData()->getClock()->now();
+}
+
+void DatabaseCloner::runCollectionCloners(DBClientConnection* client) {
+    while (true) {
+        size_t collectionIndex;
+        CollectionCloner* collectionCloner;
         {
             stdx::lock_guard<Latch> lk(_mutex);
-            _currentCollectionCloner = std::make_unique<CollectionCloner>(sourceNss,
-                                                                          collectionOptions,
-                                                                          getSharedData(),
-                                                                          getSource(),
-                                                                          getClient(),
-                                                                          getStorageInterface(),
-                                                                          getDBPool());
+            // Stop cloning as soon as the clone of any collection fails.
+            if (_collectionCloneFailed || _nextCollection == _collections.size()) {
+                return;
+            }
+            collectionIndex = _nextCollection++;
+            auto& cloner = _currentCollectionCloners[collectionIndex];
+            cloner = std::make_unique<CollectionCloner>(_collections[collectionIndex].first,
+                                                        _collections[collectionIndex].second,
+                                                        getSharedData(),
+                                                        getSource(),
+                                                        client,
+                                                        getStorageInterface(),
+                                                        getDBPool());
+            collectionCloner = cloner.get();
         }
-        auto collStatus = _currentCollectionCloner->run();
+
+        const auto& sourceNss = _collections[collectionIndex].first;
+        auto collStatus = collectionCloner->run();
         if (collStatus.isOK()) {
             LOGV2_DEBUG(21148,
                         1,
@@ -159,25 +197,24 @@ void DatabaseCloner::postStage() {
                                                                 << sourceNss.toString() << "'")
                                      .toString()});
         }
-        {
-            stdx::lock_guard<Latch> lk(_mutex);
-            _stats.collectionStats[_stats.clonedCollections] = _currentCollectionCloner->getStats();
-            _currentCollectionCloner = nullptr;
-            // Abort the database cloner if the collection clone failed.
-            if (!collStatus.isOK())
-                return;
-            _stats.clonedCollections++;
+
+        stdx::lock_guard<Latch> lk(_mutex);
+        _stats.collectionStats[collectionIndex] = collectionCloner->getStats();
+        _currentCollectionCloners.erase(collectionIndex);
+        // Abort the database cloner if the collection clone failed.
+        if (!collStatus.isOK()) {
+            _collectionCloneFailed = true;
+            return;
         }
+        _stats.clonedCollections++;
     }
-    stdx::lock_guard<Latch> lk(_mutex);
-    _stats.end = getSharedData()->getClock()->now();
 }
 
 DatabaseCloner::Stats DatabaseCloner::getStats() const {
     stdx::lock_guard<Latch> lk(_mutex);
     DatabaseCloner::Stats stats = _stats;
-    if (_currentCollectionCloner) {
-        stats.collectionStats[_stats.clonedCollections] = _currentCollectionCloner->getStats();
+    for (const auto& [collectionIndex, collectionCloner] : _currentCollectionCloners) {
+        stats.collectionStats[collectionIndex] = collectionCloner->getStats();
     }
     return stats;
 }
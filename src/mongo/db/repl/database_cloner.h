@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <map>
 #include <vector>
 
 #include "mongo/db/repl/base_cloner.h"
@@ -54,12 +55,17 @@ public:
         void append(BSONObjBuilder* builder) const;
     };
 
+    /**
+     * Each connection of 'collectionClonerClients' clones one collection at a time, concurrently
+     * with the collections cloned over 'client'.
+     */
     DatabaseCloner(const std::string& dbName,
                    InitialSyncSharedData* sharedData,
                    const HostAndPort& source,
                    DBClientConnection* client,
                    StorageInterface* storageInterface,
-                   ThreadPool* dbPool);
+                   ThreadPool* dbPool,
+                   std::vector<DBClientConnection*> collectionClonerClients = {});
 
     virtual ~DatabaseCloner() = default;
 
@@ -93,6 +99,12 @@ private:
      */
     void postStage() final;
 
+    /**
+     * Clones the collections not yet claimed by another connection over 'client', one after the
+     * other, until all of them are cloned or the clone of one of them fails.
+     */
+    void runCollectionCloners(DBClientConnection* client);
+
     std::string describeForFuzzer(BaseClonerStage* stage) const final {
         return _dbName + " db: { " + stage->getName() + ": 1 } ";
     }
@@ -108,9 +120,13 @@ private:
     //      threads, read access allowed from main flow without mutex.
     const std::string _dbName;                                                // (R)
     ClonerStage<DatabaseCloner> _listCollectionsStage;                        // (R)
+    const std::vector<DBClientConnection*> _collectionClonerClients;          // (R)
     std::vector<std::pair<NamespaceString, CollectionOptions>> _collections;  // (X)
-    std::unique_ptr<CollectionCloner> _currentCollectionCloner;               // (MX)
-    Stats _stats;                                                             // (MX)
+    // The CollectionCloners currently running, by position of their collection in _collections.
+    std::map<size_t, std::unique_ptr<CollectionCloner>> _currentCollectionCloners;  // (M)
+    size_t _nextCollection = 0;                                                      // (M)
+    bool _collectionCloneFailed = false;                                             // (M)
+    Stats _stats;                                                                    // (MX)
 };
 
 }  // namespace repl
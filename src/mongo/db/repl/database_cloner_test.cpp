@@ -494,5 +494,80 @@ TEST_F(DatabaseClonerTest, DatabaseAndCollectionStats) {
     ASSERT_EQ(_clock.now(), stats.collectionStats[1].end);
 }
 
+TEST_F(DatabaseClonerTest, ClonesCollectionsConcurrentlyOverAdditionalConnections) {
+    const BSONObj idIndexSpec = BSON("v" << 1 << "key" << BSON("_id" << 1) << "name"
+                                         << "_id_");
+    const std::vector<std::string> collectionNames{"a", "b", "c", "d"};
+    std::vector<BSONObj> sourceInfos;
+    for (const auto& name : collectionNames) {
+        sourceInfos.push_back(BSON("name" << name << "type"
+                                          << "collection"
+                                          << "options" << BSONObj() << "info"
+                                          << BSON("readOnly" << false << "uuid" << UUID::gen())));
+    }
+    _mockServer->setCommandReply("listCollections", createListCollectionsResponse(sourceInfos));
+    // The collections are cloned in no particular order, so they all get the same replies.
+    _mockServer->setCommandReply("count", createCountResponse(0));
+    _mockServer->setCommandReply("listIndexes",
+                                 createCursorResponse(_dbName + ".a", BSON_ARRAY(idIndexSpec)));
+
+    // The collections are created concurrently by the CollectionCloners.
+    auto mutex = MONGO_MAKE_LATCH();
+    auto createCollectionForBulkFn = std::move(_storageInterface.createCollectionForBulkFn);
+    _storageInterface.createCollectionForBulkFn =
+        [&](const NamespaceString& nss,
+            const CollectionOptions& options,
+            const BSONObj& idIndexSpec,
+            const std::vector<BSONObj>& secondaryIndexSpecs) {
+            stdx::lock_guard<Latch> lk(mutex);
+            return createCollectionForBulkFn(nss, options, idIndexSpec, secondaryIndexSpecs);
+        };
+
+    const bool autoReconnect = true;
+    MockDBClientConnection client1(_mockServer.get(), autoReconnect);
+    MockDBClientConnection client2(_mockServer.get(), autoReconnect);
+    auto cloner = std::make_unique<DatabaseCloner>(_dbName,
+                                                   getSharedData(),
+                                                   _source,
+                                                   _mockClient.get(),
+                                                   &_storageInterface,
+                                                   _dbWorkThreadPool.get(),
+                                                   std::vector<DBClientConnection*>{&client1,
+                                                                                    &client2});
+
+    // Hang every CollectionCloner before its first stage, until three of them run at once.
+    auto collClonerBeforeFailPoint = globalFailPointRegistry().find("hangBeforeClonerStage");
+    auto timesEntered = collClonerBeforeFailPoint->setMode(
+        FailPoint::alwaysOn, 0, fromjson("{cloner: 'CollectionCloner', stage: 'count'}"));
+
+    stdx::thread clonerThread([&] {
+        Client::initThread("ClonerRunner");
+        ASSERT_OK(cloner->run());
+    });
+    collClonerBeforeFailPoint->waitForTimesEntered(timesEntered + 3);
+
+    auto stats = cloner->getStats();
+    ASSERT_EQ(4, stats.collections);
+    ASSERT_EQ(0, stats.clonedCollections);
+    ASSERT_EQ(3,
+              std::count_if(stats.collectionStats.begin(),
+                            stats.collectionStats.end(),
+                            [](const auto& collectionStats) {
+                                return collectionStats.start != Date_t();
+                            }));
+
+    collClonerBeforeFailPoint->setMode(FailPoint::off, 0);
+    clonerThread.join();
+
+    stats = cloner->getStats();
+    ASSERT_EQ(4, stats.clonedCollections);
+    ASSERT_EQ(4U, _collections.size());
+    for (size_t i = 0; i < collectionNames.size(); ++i) {
+        ASSERT_EQ(_dbName + "." + collectionNames[i], stats.collectionStats[i].ns);
+        ASSERT_NE(Date_t(), stats.collectionStats[i].end);
+        ASSERT(_collections[NamespaceString(_dbName, collectionNames[i])].stats->commitCalled);
+    }
+}
+
 }  // namespace repl
 }  // namespace mongo
@@ -338,6 +338,9 @@ void InitialSyncer::_cancelRemainingWork_inlock() {
     if (_client) {
         _client->shutdownAndDisallowReconnect();
     }
+    for (auto&& client : _collectionClonerClients) {
+        client->shutdownAndDisallowReconnect();
+    }
     _shutdownComponent_inlock(_applier);
     _shutdownComponent_inlock(_fCVFetcher);
     _shutdownComponent_inlock(_lastOplogEntryFetcher);
@@ -1108,8 +1111,19 @@ void InitialSyncer::_fcvFetcherCallback(const StatusWith<Fetcher::QueryResponse>
                                                 _allowedOutageDuration,
                                                 getGlobalServiceContext()->getFastClockSource());
     _client = _createClientFn();
-    _initialSyncState = std::make_unique<InitialSyncState>(std::make_unique<AllDatabaseCloner>(
-        _sharedData.get(), _syncSource, _client.get(), _storage, _writerPool));
+    _collectionClonerClients.clear();
+    std::vector<DBClientConnection*> collectionClonerClients;
+    for (int i = 1; i < initialSyncCollectionClonerConcurrency.load(); ++i) {
+        _collectionClonerClients.push_back(_createClientFn());
+        collectionClonerClients.push_back(_collectionClonerClients.back().get());
+    }
+    _initialSyncState = std::make_unique<InitialSyncState>(
+        std::make_unique<AllDatabaseCloner>(_sharedData.get(),
+                                            _syncSource,
+                                            _client.get(),
+                                            _storage,
+                                            _writerPool,
+                                            std::move(collectionClonerClients)));
 
     // Create oplog applier.
     auto consistencyMarkers = _replicationProcess->getConsistencyMarkers();
@@ -1295,6 +1309,9 @@ void InitialSyncer::_allDatabaseClonerCallback(
           "Finished cloning data. Beginning oplog replay",
           "databaseClonerFinishStatus"_attr = redact(databaseClonerFinishStatus));
     _client->shutdownAndDisallowReconnect();
+    for (auto&& client : _collectionClonerClients) {
+        client->shutdownAndDisallowReconnect();
+    }
 
     if (MONGO_unlikely(initialSyncHangAfterDataCloning.shouldFail())) {
         // This could have been done with a scheduleWorkAt but this is used only by JS tests where
@@ -1310,6 +1327,7 @@ void InitialSyncer::_allDatabaseClonerCallback(
 
     stdx::lock_guard<Latch> lock(_mutex);
     _client.reset();
+    _collectionClonerClients.clear();
     auto status = _checkForShutdownAndConvertStatus_inlock(databaseClonerFinishStatus,
                                                            "error cloning databases");
     if (!status.isOK()) {
@@ -742,6 +742,8 @@ private:
     std::unique_ptr<MultiApplier> _applier;                // (M)
     HostAndPort _syncSource;                               // (M)
     std::unique_ptr<DBClientConnection> _client;           // (M)
+    // Additional connections over which the cloners clone collections concurrently.
+    std::vector<std::unique_ptr<DBClientConnection>> _collectionClonerClients;  // (M)
     OpTime _lastFetched;                                   // (MX)
     OpTimeAndWallTime _lastApplied;                        // (MX)
 
@@ -0,0 +1,106 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/repl/oplog_applier_utils.h"
+#include "mongo/db/repl/oplog_entry_test_helpers.h"
+#include "mongo/db/service_context.h"
+
+namespace mongo {
+namespace repl {
+namespace {
+
+const NamespaceString kHotNss("test.hot");
+const NamespaceString kColdNss("test.cold");
+
+/**
+ * Builds a batch that replays a write burst against one hot collection: inserts of new documents
+ * interleaved with updates to a small set of hot documents, with an occasional write to another
+ * collection.
+ */
+std::vector<OplogEntry> makeHotCollectionBatch(int batchSize, int numHotDocs) {
+    std::vector<OplogEntry> ops;
+    ops.reserve(batchSize);
+    for (int i = 0; i < batchSize; ++i) {
+        OpTime opTime(Timestamp(Seconds(1), i + 1), 1LL);
+        if (i % 16 == 0) {
+            ops.push_back(makeInsertDocumentOplogEntry(opTime, kColdNss, BSON("_id" << i)));
+        } else if (i % 4 == 0) {
+            ops.push_back(makeUpdateDocumentOplogEntry(opTime,
+                                                       kHotNss,
+                                                       BSON("_id" << (i % numHotDocs)),
+                                                       BSON("$inc" << BSON("n" << 1))));
+        } else {
+            ops.push_back(makeInsertDocumentOplogEntry(opTime, kHotNss, BSON("_id" << i)));
+        }
+    }
+    return ops;
+}
+
+void BM_FillWriterVectorsHotCollection(benchmark::State& state) {
+    const auto numWriters = static_cast<size_t>(state.range(0));
+    const int batchSize = 5000;
+
+    auto client = getGlobalServiceContext()->makeClient("oplog_application_bm");
+    auto opCtx = client->makeOperationContext();
+    auto ops = makeHotCollectionBatch(batchSize, 8);
+
+    size_t maxWriterOps = 0;
+    for (auto keepRunning : state) {
+        std::vector<std::vector<const OplogEntry*>> writerVectors(numWriters);
+        CachedCollectionProperties collPropertiesCache;
+        WriterAssignments writerAssignments;
+        for (auto&& op : ops) {
+            OplogApplierUtils::addToWriterVector(
+                opCtx.get(), &op, &writerVectors, &collPropertiesCache, &writerAssignments);
+        }
+
+        maxWriterOps = 0;
+        for (auto&& writerVector : writerVectors) {
+            maxWriterOps = std::max(maxWriterOps, writerVector.size());
+        }
+        benchmark::DoNotOptimize(writerVectors.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * batchSize);
+    // The batch takes as long to apply as its longest writer vector, so the closer this is to
+    // batchSize / numWriters, the better the batch is spread.
+    state.counters["maxWriterOps"] = maxWriterOps;
+    state.counters["idealWriterOps"] = static_cast<double>(batchSize) / numWriters;
+}
+
+BENCHMARK(BM_FillWriterVectorsHotCollection)->Arg(4)->Arg(16)->Arg(64);
+
+}  // namespace
+}  // namespace repl
+}  // namespace mongo
@@ -115,6 +115,7 @@ void _addOplogChainOpsToWriterVectors(OperationContext* opCtx,
                                       std::vector<std::vector<OplogEntry>>* derivedOps,
                                       OplogEntry* op,
                                       CachedCollectionProperties* collPropertiesCache,
+                                      WriterAssignments* writerAssignments,
                                       std::vector<std::vector<const OplogEntry*>>* writerVectors) {
     std::vector<OplogEntry> txnOps;
     bool shouldSerialize = false;
@@ -124,8 +125,12 @@ void _addOplogChainOpsToWriterVectors(OperationContext* opCtx,
     partialTxnList->clear();
 
     // Transaction entries cannot have different session updates.
-    OplogApplierUtils::addDerivedOps(
-        opCtx, &derivedOps->back(), writerVectors, collPropertiesCache, shouldSerialize);
+    OplogApplierUtils::addDerivedOps(opCtx,
+                                     &derivedOps->back(),
+                                     writerVectors,
+                                     collPropertiesCache,
+                                     writerAssignments,
+                                     shouldSerialize);
 }
 
 }  // namespace
@@ -614,16 +619,19 @@ StatusWith<OpTime> OplogApplierImpl::_applyOplogBatch(OperationContext* opCtx,
  *      and instructions for updating the transactions table.  Required if processing oplogs
  *      with transactions.
  * sessionUpdateTracker - if provided, keeps track of session info from ops.
+ * collPropertiesCache - Properties of the collections the ops write to.
+ * writerAssignments - Writer vector of each conflict key seen so far in the batch.
  */
 void OplogApplierImpl::_deriveOpsAndFillWriterVectors(
     OperationContext* opCtx,
     std::vector<OplogEntry>* ops,
     std::vector<std::vector<const OplogEntry*>>* writerVectors,
     std::vector<std::vector<OplogEntry>>* derivedOps,
-    SessionUpdateTracker* sessionUpdateTracker) noexcept {
+    SessionUpdateTracker* sessionUpdateTracker,
+    CachedCollectionProperties* collPropertiesCache,
+    WriterAssignments* writerAssignments) noexcept {
 
     LogicalSessionIdMap<std::vector<OplogEntry*>> partialTxnOps;
-    CachedCollectionProperties collPropertiesCache;
     for (auto&& op : *ops) {
         // If the operation's optime is before or the same as the beginApplyingOpTime we don't want
         // to apply it, so don't include it in writerVectors.
@@ -639,7 +647,8 @@ void OplogApplierImpl::_deriveOpsAndFillWriterVectors(
                 OplogApplierUtils::addDerivedOps(opCtx,
                                                  &derivedOps->back(),
                                                  writerVectors,
-                                                 &collPropertiesCache,
+                                                 collPropertiesCache,
+                                                 writerAssignments,
                                                  false /*serial*/);
             }
         }
@@ -676,8 +685,13 @@ void OplogApplierImpl::_deriveOpsAndFillWriterVectors(
                 // oplog and fill writers with those operations.
                 // Flush partialTxnList operations for current transaction.
                 auto& partialTxnList = partialTxnOps[*logicalSessionId];
-                _addOplogChainOpsToWriterVectors(
-                    opCtx, &partialTxnList, derivedOps, &op, &collPropertiesCache, writerVectors);
+                _addOplogChainOpsToWriterVectors(opCtx,
+                                                 &partialTxnList,
+                                                 derivedOps,
+                                                 &op,
+                                                 collPropertiesCache,
+                                                 writerAssignments,
+                                                 writerVectors);
             } else {
                 // The applyOps entry was not generated as part of a transaction.
                 invariant(!op.getPrevWriteOpTimeInTransaction());
@@ -688,7 +702,8 @@ void OplogApplierImpl::_deriveOpsAndFillWriterVectors(
                 OplogApplierUtils::addDerivedOps(opCtx,
                                                  &derivedOps->back(),
                                                  writerVectors,
-                                                 &collPropertiesCache,
+                                                 collPropertiesCache,
+                                                 writerAssignments,
                                                  false /*serial*/);
             }
             continue;
@@ -700,12 +715,18 @@ void OplogApplierImpl::_deriveOpsAndFillWriterVectors(
         if (op.isPreparedCommit() && (getOptions().mode == OplogApplication::Mode::kInitialSync)) {
             auto logicalSessionId = op.getSessionId();
             auto& partialTxnList = partialTxnOps[*logicalSessionId];
-            _addOplogChainOpsToWriterVectors(
-                opCtx, &partialTxnList, derivedOps, &op, &collPropertiesCache, writerVectors);
+            _addOplogChainOpsToWriterVectors(opCtx,
+                                             &partialTxnList,
+                                             derivedOps,
+                                             &op,
+                                             collPropertiesCache,
+                                             writerAssignments,
+                                             writerVectors);
             continue;
         }
 
-        OplogApplierUtils::addToWriterVector(opCtx, &op, writerVectors, &collPropertiesCache);
+        OplogApplierUtils::addToWriterVector(
+            opCtx, &op, writerVectors, collPropertiesCache, writerAssignments);
     }
 }
 
@@ -716,13 +737,28 @@ void OplogApplierImpl::fillWriterVectors(
     std::vector<std::vector<OplogEntry>>* derivedOps) noexcept {
 
     SessionUpdateTracker sessionUpdateTracker;
-    _deriveOpsAndFillWriterVectors(opCtx, ops, writerVectors, derivedOps, &sessionUpdateTracker);
+    CachedCollectionProperties collPropertiesCache;
+    // Shared by both passes so that the session table updates flushed below follow the writes to
+    // the same documents made earlier in the batch.
+    WriterAssignments writerAssignments;
+    _deriveOpsAndFillWriterVectors(opCtx,
+                                   ops,
+                                   writerVectors,
+                                   derivedOps,
+                                   &sessionUpdateTracker,
+                                   &collPropertiesCache,
+                                   &writerAssignments);
 
     auto newOplogWrites = sessionUpdateTracker.flushAll();
     if (!newOplogWrites.empty()) {
         derivedOps->emplace_back(std::move(newOplogWrites));
-        _deriveOpsAndFillWriterVectors(
-            opCtx, &derivedOps->back(), writerVectors, derivedOps, nullptr);
+        _deriveOpsAndFillWriterVectors(opCtx,
+                                       &derivedOps->back(),
+                                       writerVectors,
+                                       derivedOps,
+                                       nullptr,
+                                       &collPropertiesCache,
+                                       &writerAssignments);
     }
 }
 
@@ -35,6 +35,7 @@
 #include "mongo/db/concurrency/replication_state_transition_lock_guard.h"
 #include "mongo/db/repl/initial_syncer.h"
 #include "mongo/db/repl/oplog_applier.h"
+#include "mongo/db/repl/oplog_applier_utils.h"
 #include "mongo/db/repl/replication_consistency_markers.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/replication_metrics.h"
@@ -102,7 +103,9 @@ private:
                                         std::vector<OplogEntry>* ops,
                                         std::vector<std::vector<const OplogEntry*>>* writerVectors,
                                         std::vector<std::vector<OplogEntry>>* derivedOps,
-                                        SessionUpdateTracker* sessionUpdateTracker) noexcept;
+                                        SessionUpdateTracker* sessionUpdateTracker,
+                                        CachedCollectionProperties* collPropertiesCache,
+                                        WriterAssignments* writerAssignments) noexcept;
 
     // Not owned by us.
     ReplicationCoordinator* const _replCoord;
@@ -458,6 +458,96 @@ TEST_F(OplogApplierImplTest,
                                                      createOplogCollectionOptions()));
 }
 
+/**
+ * Adds 'ops' to 'numWriters' writer vectors the way a batch is split for application and returns
+ * the writer vectors.
+ */
+std::vector<std::vector<const OplogEntry*>> _fillWriterVectorsForTest(
+    OperationContext* opCtx, std::vector<OplogEntry>* ops, size_t numWriters) {
+    std::vector<std::vector<const OplogEntry*>> writerVectors(numWriters);
+    CachedCollectionProperties collPropertiesCache;
+    WriterAssignments writerAssignments;
+    for (auto&& op : *ops) {
+        OplogApplierUtils::addToWriterVector(
+            opCtx, &op, &writerVectors, &collPropertiesCache, &writerAssignments);
+    }
+    return writerVectors;
+}
+
+TEST_F(OplogApplierImplTest, WriterVectorsSpreadSingleCollectionWritesEvenly) {
+    NamespaceString nss("test." + _agent.getSuiteName() + "_" + _agent.getTestName());
+    createCollection(_opCtx.get(), nss, CollectionOptions());
+
+    const size_t numWriters = 4;
+    std::vector<OplogEntry> ops;
+    for (int i = 0; i < 64; ++i) {
+        ops.push_back(makeInsertDocumentOplogEntry(
+            {Timestamp(Seconds(1), i + 1), 1LL}, nss, BSON("_id" << i)));
+    }
+
+    auto writerVectors = _fillWriterVectorsForTest(_opCtx.get(), &ops, numWriters);
+    for (auto&& writerVector : writerVectors) {
+        ASSERT_EQUALS(ops.size() / numWriters, writerVector.size());
+    }
+}
+
+TEST_F(OplogApplierImplTest, WriterVectorsKeepWritesToOneDocumentOnOneWriterInOrder) {
+    NamespaceString nss("test." + _agent.getSuiteName() + "_" + _agent.getTestName());
+    createCollection(_opCtx.get(), nss, CollectionOptions());
+
+    std::vector<OplogEntry> ops;
+    ops.push_back(
+        makeInsertDocumentOplogEntry({Timestamp(Seconds(1), 1), 1LL}, nss, BSON("_id" << 0)));
+    for (int i = 1; i < 16; ++i) {
+        // Interleave writes to other documents so that the least loaded writer keeps changing.
+        ops.push_back(makeInsertDocumentOplogEntry(
+            {Timestamp(Seconds(1), 2 * i), 1LL}, nss, BSON("_id" << i)));
+        ops.push_back(makeUpdateDocumentOplogEntry({Timestamp(Seconds(1), 2 * i + 1), 1LL},
+                                                   nss,
+                                                   BSON("_id" << 0),
+                                                   BSON("$set" << BSON("x" << i))));
+    }
+
+    auto writerVectors = _fillWriterVectorsForTest(_opCtx.get(), &ops, 4);
+    std::vector<const OplogEntry*> hotDocumentOps;
+    for (auto&& writerVector : writerVectors) {
+        for (auto op : writerVector) {
+            if (op->getIdElement().numberInt() == 0) {
+                hotDocumentOps.push_back(op);
+            }
+        }
+        if (!hotDocumentOps.empty()) {
+            break;
+        }
+    }
+
+    ASSERT_EQUALS(16U, hotDocumentOps.size());
+    for (size_t i = 1; i < hotDocumentOps.size(); ++i) {
+        ASSERT_LESS_THAN(hotDocumentOps[i - 1]->getOpTime(), hotDocumentOps[i]->getOpTime());
+    }
+}
+
+TEST_F(OplogApplierImplTest, WriterVectorsKeepCappedCollectionWritesOnOneWriter) {
+    NamespaceString nss("local." + _agent.getSuiteName() + "_" + _agent.getTestName());
+    createCollection(_opCtx.get(), nss, createOplogCollectionOptions());
+
+    std::vector<OplogEntry> ops;
+    for (int i = 0; i < 16; ++i) {
+        ops.push_back(makeInsertDocumentOplogEntry(
+            {Timestamp(Seconds(1), i + 1), 1LL}, nss, BSON("_id" << i)));
+    }
+
+    auto writerVectors = _fillWriterVectorsForTest(_opCtx.get(), &ops, 4);
+    size_t nonEmptyWriters = 0;
+    for (auto&& writerVector : writerVectors) {
+        if (!writerVector.empty()) {
+            ASSERT_EQUALS(ops.size(), writerVector.size());
+            ++nonEmptyWriters;
+        }
+    }
+    ASSERT_EQUALS(1U, nonEmptyWriters);
+}
+
 TEST_F(OplogApplierImplTest,
        OplogApplicationThreadFuncUsesApplyOplogEntryOrGroupedInsertsToApplyOperation) {
     NamespaceString nss("local." + _agent.getSuiteName() + "_" + _agent.getTestName());
@@ -31,6 +31,8 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
+
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/collection_catalog.h"
 #include "mongo/db/catalog/document_validation.h"
@@ -74,6 +76,19 @@ CachedCollectionProperties::getCollectionPropertiesImpl(OperationContext* opCtx,
     return collProperties;
 }
 
+uint32_t WriterAssignments::getWriterId(
+    uint32_t conflictKey, const std::vector<std::vector<const OplogEntry*>>& writerVectors) {
+    auto [it, inserted] = _writerIds.emplace(conflictKey, 0);
+    if (inserted) {
+        auto leastLoaded = std::min_element(
+            writerVectors.begin(), writerVectors.end(), [](const auto& lhs, const auto& rhs) {
+                return lhs.size() < rhs.size();
+            });
+        it->second = leastLoaded - writerVectors.begin();
+    }
+    return it->second;
+}
+
 void OplogApplierUtils::processCrudOp(OperationContext* opCtx,
                                       OplogEntry* op,
                                       uint32_t* hash,
@@ -106,6 +121,7 @@ uint32_t OplogApplierUtils::addToWriterVector(
     OplogEntry* op,
     std::vector<std::vector<const OplogEntry*>>* writerVectors,
     CachedCollectionProperties* collPropertiesCache,
+    WriterAssignments* writerAssignments,
     boost::optional<uint32_t> forceWriterId) {
     auto hashedNs = StringMapHasher().hashed_key(op->getNss().ns());
 
@@ -114,11 +130,20 @@ uint32_t OplogApplierUtils::addToWriterVector(
     // The hash function should provide entropy in the lower bits as it's used in hash tables.
     uint32_t hash = static_cast<uint32_t>(hashedNs.hash());
 
-    if (op->isCrudOpType())
-        processCrudOp(opCtx, op, &hash, &hashedNs, collPropertiesCache);
-
     const uint32_t numWriters = writerVectors->size();
-    auto writerId = (forceWriterId ? *forceWriterId : hash) % numWriters;
+    uint32_t writerId;
+    if (op->isCrudOpType()) {
+        // The hash now identifies the ops that conflict with this one.
+        processCrudOp(opCtx, op, &hash, &hashedNs, collPropertiesCache);
+        if (forceWriterId) {
+            writerId = *forceWriterId % numWriters;
+            writerAssignments->setWriterId(hash, writerId);
+        } else {
+            writerId = writerAssignments->getWriterId(hash, *writerVectors);
+        }
+    } else {
+        writerId = (forceWriterId ? *forceWriterId : hash) % numWriters;
+    }
     auto& writer = (*writerVectors)[writerId];
     if (writer.empty()) {
         writer.reserve(8);  // Skip a few growth rounds
@@ -148,13 +173,14 @@ void OplogApplierUtils::addDerivedOps(OperationContext* opCtx,
                                       std::vector<OplogEntry>* derivedOps,
                                       std::vector<std::vector<const OplogEntry*>>* writerVectors,
                                       CachedCollectionProperties* collPropertiesCache,
+                                      WriterAssignments* writerAssignments,
                                       bool serial) {
     boost::optional<uint32_t>
         serialWriterId;  // Used to determine which writer vector to assign serial ops.
 
     for (auto&& op : *derivedOps) {
-        auto writerId =
-            addToWriterVector(opCtx, &op, writerVectors, collPropertiesCache, serialWriterId);
+        auto writerId = addToWriterVector(
+            opCtx, &op, writerVectors, collPropertiesCache, writerAssignments, serialWriterId);
         if (serial && !serialWriterId) {
             serialWriterId.emplace(writerId);
         }
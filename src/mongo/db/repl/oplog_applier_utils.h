@@ -30,6 +30,7 @@
 #pragma once
 
 #include "mongo/db/repl/insert_group.h"
+#include "mongo/stdx/unordered_map.h"
 
 namespace mongo {
 class CollatorInterface;
@@ -58,6 +59,36 @@ private:
     StringMap<CollectionProperties> _cache;
 };
 
+/**
+ * Assigns the CRUD ops of a batch to writer vectors. Ops that can conflict share a conflict key:
+ * ops on one document of a regular collection share the hash of its namespace and _id, and all ops
+ * on a capped collection share the hash of its namespace. The first op with a key goes to the
+ * writer vector that has the fewest ops so far, and every later op with that key follows it to the
+ * same writer vector. Conflicting ops are therefore applied in oplog order, while independent ops
+ * spread evenly across the writers even when they all target one collection. Distinct keys that
+ * hash alike are simply treated as conflicting.
+ */
+class WriterAssignments {
+public:
+    /**
+     * Returns the writer vector for an op with 'conflictKey', choosing one if this is the first op
+     * of the batch with that key.
+     */
+    uint32_t getWriterId(uint32_t conflictKey,
+                         const std::vector<std::vector<const OplogEntry*>>& writerVectors);
+
+    /**
+     * Records that an op with 'conflictKey' was placed in 'writerId', so that later ops with that
+     * key follow it.
+     */
+    void setWriterId(uint32_t conflictKey, uint32_t writerId) {
+        _writerIds[conflictKey] = writerId;
+    }
+
+private:
+    stdx::unordered_map<uint32_t, uint32_t> _writerIds;
+};
+
 /**
  * This class contains some static methods common to ordinary oplog application and oplog
  * application as part of tenant migration.
@@ -91,6 +122,7 @@ public:
                                       OplogEntry* op,
                                       std::vector<std::vector<const OplogEntry*>>* writerVectors,
                                       CachedCollectionProperties* collPropertiesCache,
+                                      WriterAssignments* writerAssignments,
                                       boost::optional<uint32_t> forceWriterId = boost::none);
     /**
      * Adds a set of derivedOps to writerVectors.
@@ -101,6 +133,7 @@ public:
                               std::vector<OplogEntry>* derivedOps,
                               std::vector<std::vector<const OplogEntry*>>* writerVectors,
                               CachedCollectionProperties* collPropertiesCache,
+                              WriterAssignments* writerAssignments,
                               bool serial);
 
     /**
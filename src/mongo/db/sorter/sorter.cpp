@@ -49,13 +49,14 @@
 #include "mongo/db/sorter/sorter.h"
 
 #include <boost/filesystem/operations.hpp>
-#include <snappy.h>
 #include <vector>
 
 #include "mongo/base/string_data.h"
 #include "mongo/config.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/sorter/sorter_file_reader.h"
+#include "mongo/db/sorter/sorter_sort_helpers.h"
 #include "mongo/db/storage/encryption_hooks.h"
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/platform/atomic_word.h"
@@ -119,6 +120,13 @@ inline std::string myErrnoWithDescription() {
     return sb.str();
 }
 
+inline SortedFileReader::Options makeReaderOptions(const SortOptions& opts) {
+    SortedFileReader::Options readerOptions;
+    readerOptions.readAheadBlocks = opts.readAheadBlocks;
+    readerOptions.directIO = opts.directIO;
+    return readerOptions;
+}
+
 template <typename Data, typename Comparator>
 void dassertCompIsSane(const Comparator& comp, const Data& lhs, const Data& rhs) {
 #if defined(MONGO_CONFIG_DEBUG_BUILD) && !defined(_MSC_VER)
@@ -197,38 +205,21 @@ public:
                  std::streampos fileStartOffset,
                  std::streampos fileEndOffset,
                  const Settings& settings,
-                 const uint32_t checksum)
+                 const uint32_t checksum,
+                 const SortedFileReader::Options& readerOptions = {})
         : _settings(settings),
           _done(false),
-          _fileFullPath(fileFullPath),
+          _reader(fileFullPath, fileStartOffset, fileEndOffset, readerOptions),
           _fileStartOffset(fileStartOffset),
           _fileEndOffset(fileEndOffset),
-          _originalChecksum(checksum) {
-        uassert(16815,
-                str::stream() << "unexpected empty file: " << _fileFullPath,
-                boost::filesystem::file_size(_fileFullPath) != 0);
-    }
+          _originalChecksum(checksum) {}
 
     void openSource() {
-        _file.open(_fileFullPath.c_str(), std::ios::in | std::ios::binary);
-        uassert(16814,
-                str::stream() << "error opening file \"" << _fileFullPath
-                              << "\": " << myErrnoWithDescription(),
-                _file.good());
-        _file.seekg(_fileStartOffset);
-        uassert(50979,
-                str::stream() << "error seeking starting offset of '" << _fileStartOffset
-                              << "' in file \"" << _fileFullPath
-                              << "\": " << myErrnoWithDescription(),
-                _file.good());
+        _reader.open();
     }
 
     void closeSource() {
-        _file.close();
-        uassert(50969,
-                str::stream() << "error closing file \"" << _fileFullPath
-                              << "\": " << myErrnoWithDescription(),
-                !_file.fail());
+        _reader.close();
 
         // If the file iterator reads through all data objects, we can ensure non-corrupt data
         // by comparing the newly calculated checksum with the original checksum from the data
@@ -288,87 +279,16 @@ private:
     }
 
     /**
-     * Tries to read from disk and places any results in _bufferReader. If there is no more data to
-     * read, then _done is set to true and the function returns immediately.
+     * Takes the next decoded block from the reader and places it in _bufferReader. If there is no
+     * more data to read, then _done is set to true and the function returns immediately.
      */
     void fillBufferFromDisk() {
-        int32_t rawSize;
-        read(&rawSize, sizeof(rawSize));
-        if (_done)
-            return;
-
-        // negative size means compressed
-        const bool compressed = rawSize < 0;
-        int32_t blockSize = std::abs(rawSize);
-
-        _buffer.reset(new char[blockSize]);
-        read(_buffer.get(), blockSize);
-        uassert(16816, "file too short?", !_done);
-
-        if (auto encryptionHooks = getEncryptionHooksIfEnabled()) {
-            std::unique_ptr<char[]> out(new char[blockSize]);
-            size_t outLen;
-            Status status =
-                encryptionHooks->unprotectTmpData(reinterpret_cast<uint8_t*>(_buffer.get()),
-                                                  blockSize,
-                                                  reinterpret_cast<uint8_t*>(out.get()),
-                                                  blockSize,
-                                                  &outLen);
-            uassert(28841,
-                    str::stream() << "Failed to unprotect data: " << status.toString(),
-                    status.isOK());
-            blockSize = outLen;
-            _buffer.swap(out);
-        }
-
-        if (!compressed) {
-            _bufferReader.reset(new BufReader(_buffer.get(), blockSize));
-            return;
-        }
-
-        dassert(snappy::IsValidCompressedBuffer(_buffer.get(), blockSize));
-
-        size_t uncompressedSize;
-        uassert(17061,
-                "couldn't get uncompressed length",
-                snappy::GetUncompressedLength(_buffer.get(), blockSize, &uncompressedSize));
-
-        std::unique_ptr<char[]> decompressionBuffer(new char[uncompressedSize]);
-        uassert(17062,
-                "decompression failed",
-                snappy::RawUncompress(_buffer.get(), blockSize, decompressionBuffer.get()));
-
-        // hold on to decompressed data and throw out compressed data at block exit
-        _buffer.swap(decompressionBuffer);
-        _bufferReader.reset(new BufReader(_buffer.get(), uncompressedSize));
-    }
-
-    /**
-     * Attempts to read data from disk. Sets _done to true when file offset reaches _fileEndOffset.
-     *
-     * Masserts on any file errors
-     */
-    void read(void* out, size_t size) {
-        invariant(_file.is_open());
-
-        const std::streampos offset = _file.tellg();
-        uassert(51049,
-                str::stream() << "error reading file \"" << _fileFullPath
-                              << "\": " << myErrnoWithDescription(),
-                offset >= 0);
-
-        if (offset >= _fileEndOffset) {
-            invariant(offset == _fileEndOffset);
+        size_t blockSize;
+        if (!_reader.nextBlock(&_buffer, &blockSize)) {
             _done = true;
             return;
         }
-
-        _file.read(reinterpret_cast<char*>(out), size);
-        uassert(16817,
-                str::stream() << "error reading file \"" << _fileFullPath
-                              << "\": " << myErrnoWithDescription(),
-                _file.good());
-        verify(_file.gcount() == static_cast<std::streamsize>(size));
+        _bufferReader.reset(new BufReader(_buffer.get(), blockSize));
     }
 
     const Settings _settings;
@@ -376,10 +296,9 @@ private:
 
     std::unique_ptr<char[]> _buffer;
     std::unique_ptr<BufReader> _bufferReader;
-    std::string _fileFullPath;        // File containing the sorted data range.
+    SortedFileReader _reader;         // Reads the blocks of the sorted data range from the file.
     std::streampos _fileStartOffset;  // File offset at which the sorted data range starts.
     std::streampos _fileEndOffset;    // File offset at which the sorted data range ends.
-    std::ifstream _file;
 
     // Checksum value that is updated with each read of a data object from disk. We can compare
     // this value with _originalChecksum to check for data corruption if and only if the
@@ -392,10 +311,77 @@ private:
     const uint32_t _originalChecksum;
 };
 
+// The smallest number of elements each thread gets when sorting in memory on several threads.
+// Below this the cost of handing the runs to other threads outweighs the gain.
+constexpr size_t kMinParallelSortRunSize = 16 * 1024;
+
+/**
+ * Stable sorts [begin, end) using up to 'numThreads' threads. The range is cut into 'numThreads'
+ * runs of equal size which are sorted concurrently, on as many of the sort helper threads shared
+ * by the node as are free. Adjacent runs are then merged pairwise, all pairs of a round at once,
+ * until a single run is left.
+ */
+template <typename RandomIt, typename Less>
+void parallelStableSort(RandomIt begin, RandomIt end, size_t numThreads, const Less& less) {
+    const size_t size = end - begin;
+
+    // The runs are [bounds[i], bounds[i + 1]).
+    std::vector<size_t> bounds;
+    for (size_t i = 0; i <= numThreads; ++i) {
+        bounds.push_back(size * i / numThreads);
+    }
+
+    const size_t maxBusyHelpers = internalSorterMaxSortHelperThreads.load();
+    runConcurrently(numThreads, maxBusyHelpers, [&](size_t i) {
+        std::stable_sort(begin + bounds[i], begin + bounds[i + 1], less);
+    });
+
+    while (bounds.size() > 2) {
+        const size_t numRuns = bounds.size() - 1;
+        runConcurrently(numRuns / 2, maxBusyHelpers, [&](size_t i) {
+            std::inplace_merge(
+                begin + bounds[2 * i], begin + bounds[2 * i + 1], begin + bounds[2 * i + 2], less);
+        });
+
+        // Keep every other bound. With an odd number of runs the last one was not merged and its
+        // end bound has to be kept as well.
+        std::vector<size_t> merged;
+        for (size_t i = 0; i < bounds.size(); i += 2) {
+            merged.push_back(bounds[i]);
+        }
+        if (numRuns % 2) {
+            merged.push_back(bounds.back());
+        }
+        bounds = std::move(merged);
+    }
+}
+
+/**
+ * Detects whether a Comparator provides the optional normalizedKeyPrefix() member described in
+ * sorter.h.
+ */
+template <typename Comparator, typename Key, typename = void>
+struct HasNormalizedKeyPrefix : std::false_type {};
+
+template <typename Comparator, typename Key>
+struct HasNormalizedKeyPrefix<Comparator,
+                              Key,
+                              std::void_t<decltype(std::declval<const Comparator&>()
+                                                       .normalizedKeyPrefix(
+                                                           std::declval<const Key&>()))>>
+    : std::true_type {};
+
 /**
  * Merge-sorts results from 0 or more FileIterators, all of which should be iterating over sorted
  * ranges within the same file. This class is given the data source file name upon construction and
  * is responsible for deleting the data source file upon destruction.
+ *
+ * The inputs are merged with a tournament (loser) tree: every internal node of the tree remembers
+ * the input that lost the match played at that node, so replacing the winner only replays the
+ * matches on the path from its leaf to the root. This takes log2(N) comparisons per result instead
+ * of the up to 2 * log2(N) comparisons of a binary heap. If the Comparator can produce a normalized
+ * key prefix, the prefix of each input's current key is cached and most matches are decided
+ * without comparing the full keys.
  */
 template <typename Key, typename Value, typename Comparator>
 class MergeIterator : public SortIteratorInterface<Key, Value> {
@@ -409,39 +395,47 @@ public:
         : _opts(opts),
           _remaining(opts.limit ? opts.limit : std::numeric_limits<unsigned long long>::max()),
           _first(true),
-          _greater(comp) {
+          _comp(comp) {
+        // Open every source before reading from any of them, so that sources which read ahead fetch
+        // their first blocks concurrently rather than one after another.
+        for (auto&& iter : iters) {
+            iter->openSource();
+        }
         for (size_t i = 0; i < iters.size(); i++) {
-            iters[i]->openSource();
             if (iters[i]->more()) {
-                _heap.push_back(std::make_shared<Stream>(i, iters[i]->next(), iters[i]));
+                _streams.push_back(std::make_unique<Stream>(i, iters[i]->next(), iters[i]));
             } else {
                 iters[i]->closeSource();
             }
         }
 
-        if (_heap.empty()) {
+        if (_streams.empty()) {
             _remaining = 0;
             return;
         }
 
-        std::make_heap(_heap.begin(), _heap.end(), _greater);
-        std::pop_heap(_heap.begin(), _heap.end(), _greater);
-        _current = _heap.back();
-        _heap.pop_back();
+        _prefixes.resize(_streams.size());
+        for (size_t i = 0; i < _streams.size(); i++) {
+            updatePrefix(i);
+        }
+
+        _numActive = _streams.size();
+        _tree.resize(_streams.size());
+        _tree[0] = _streams.size() == 1 ? 0 : initTree(1);
     }
 
     ~MergeIterator() {
         // Clear the remaining Stream objects to close the file handles. Some systems will error
         // closing the file if any file handles are still open.
-        _current.reset();
-        _heap.clear();
+        _streams.clear();
     }
 
     void openSource() {}
     void closeSource() {}
 
     bool more() {
-        if (_remaining > 0 && (_first || !_heap.empty() || _current->more()))
+        if (_remaining > 0 &&
+            (_first || _numActive > 1 || (_numActive == 1 && _streams[_tree[0]]->more())))
             return true;
 
         _remaining = 0;
@@ -455,21 +449,21 @@ public:
 
         if (_first) {
             _first = false;
-            return _current->current();
+            return _streams[_tree[0]]->current();
         }
 
-        if (!_current->advance()) {
-            verify(!_heap.empty());
-            std::pop_heap(_heap.begin(), _heap.end(), _greater);
-            _current = _heap.back();
-            _heap.pop_back();
-        } else if (!_heap.empty() && _greater(_current, _heap.front())) {
-            std::pop_heap(_heap.begin(), _heap.end(), _greater);
-            std::swap(_current, _heap.back());
-            std::push_heap(_heap.begin(), _heap.end(), _greater);
+        const size_t winner = _tree[0];
+        if (_streams[winner]->advance()) {
+            updatePrefix(winner);
+        } else {
+            // Destroying the Stream closes its source.
+            _streams[winner].reset();
+            _numActive--;
+            verify(_numActive > 0);
         }
+        replay(winner);
 
-        return _current->current();
+        return _streams[_tree[0]]->current();
     }
 
 
@@ -511,30 +505,86 @@ private:
         std::shared_ptr<Input> _rest;
     };
 
-    class STLComparator {  // uses greater rather than less-than to maintain a MinHeap
-    public:
-        explicit STLComparator(const Comparator& comp) : _comp(comp) {}
-        bool operator()(unowned_ptr<const Stream> lhs, unowned_ptr<const Stream> rhs) const {
-            // first compare data
-            dassertCompIsSane(_comp, lhs->current(), rhs->current());
-            int ret = _comp(lhs->current(), rhs->current());
-            if (ret)
-                return ret > 0;
-
-            // then compare fileNums to ensure stability
-            return lhs->fileNum > rhs->fileNum;
+    void updatePrefix(size_t i) {
+        if constexpr (HasNormalizedKeyPrefix<Comparator, Key>::value) {
+            _prefixes[i] = _comp.normalizedKeyPrefix(_streams[i]->current().first);
         }
+    }
 
-    private:
-        const Comparator _comp;
-    };
+    /**
+     * Returns true if the current element of stream 'lhs' sorts before the one of stream 'rhs'.
+     * Exhausted streams sort after everything else and ties are broken by the stream index (the
+     * order of the inputs) to keep the merge stable.
+     */
+    bool less(size_t lhs, size_t rhs) const {
+        if (!_streams[lhs] || !_streams[rhs]) {
+            if (_streams[lhs] || _streams[rhs])
+                return _streams[lhs] != nullptr;
+            return lhs < rhs;
+        }
+
+        if constexpr (HasNormalizedKeyPrefix<Comparator, Key>::value) {
+            if (_prefixes[lhs] != _prefixes[rhs])
+                return _prefixes[lhs] < _prefixes[rhs];
+        }
+
+        const Data& lhsData = _streams[lhs]->current();
+        const Data& rhsData = _streams[rhs]->current();
+        dassertCompIsSane(_comp, lhsData, rhsData);
+        int ret = _comp(lhsData, rhsData);
+        if (ret)
+            return ret < 0;
+
+        return _streams[lhs]->fileNum < _streams[rhs]->fileNum;
+    }
+
+    /**
+     * Plays all the matches in the subtree rooted at 'node' and returns the winning stream. The
+     * leaves are the nodes [N, 2N) and correspond to streams [0, N).
+     */
+    size_t initTree(size_t node) {
+        if (node >= _streams.size())
+            return node - _streams.size();
+
+        size_t left = initTree(2 * node);
+        size_t right = initTree(2 * node + 1);
+        if (less(right, left)) {
+            _tree[node] = left;
+            return right;
+        }
+        _tree[node] = right;
+        return left;
+    }
+
+    /**
+     * Replays the matches on the path from the leaf of stream 'winner' to the root after that
+     * stream's current element has changed.
+     */
+    void replay(size_t winner) {
+        for (size_t node = (winner + _streams.size()) / 2; node > 0; node /= 2) {
+            if (less(_tree[node], winner)) {
+                std::swap(_tree[node], winner);
+            }
+        }
+        _tree[0] = winner;
+    }
 
     SortOptions _opts;
     unsigned long long _remaining;
     bool _first;
-    std::shared_ptr<Stream> _current;
-    std::vector<std::shared_ptr<Stream>> _heap;  // MinHeap
-    STLComparator _greater;                      // named so calls make sense
+    const Comparator _comp;
+
+    // Streams that have been exhausted are reset to null.
+    std::vector<std::unique_ptr<Stream>> _streams;
+    size_t _numActive = 0;
+
+    // The cached normalized key prefixes of the current element of each stream. Only used if the
+    // Comparator provides normalizedKeyPrefix().
+    std::vector<uint64_t> _prefixes;
+
+    // _tree[0] is the stream holding the smallest current element, _tree[1, N) are the losers of
+    // the matches played at each internal node.
+    std::vector<size_t> _tree;
 };
 
 template <typename Key, typename Value, typename Comparator>
@@ -575,7 +625,8 @@ public:
                                range.getStartOffset(),
                                range.getEndOffset(),
                                this->_settings,
-                               range.getChecksum());
+                               range.getChecksum(),
+                               sorter::makeReaderOptions(this->_opts));
                        });
     }
 
@@ -637,6 +688,13 @@ private:
 
     void sort() {
         STLComparator less(_comp);
+        const size_t numThreads =
+            std::min(this->_opts.sortThreads, _data.size() / kMinParallelSortRunSize);
+        if (numThreads > 1) {
+            parallelStableSort(_data.begin(), _data.end(), numThreads, less);
+            return;
+        }
+
         std::stable_sort(_data.begin(), _data.end(), less);
 
         // Does 2x more compares than stable_sort
@@ -669,6 +727,7 @@ private:
         }
         Iterator* iteratorPtr = writer.done();
         _nextSortedFileWriterOffset = writer.getFileEndOffset();
+        this->_spillStats.add(writer.spillStats());
 
         this->_iters.push_back(std::shared_ptr<Iterator>(iteratorPtr));
 
@@ -959,6 +1018,7 @@ private:
 
         Iterator* iteratorPtr = writer.done();
         _nextSortedFileWriterOffset = writer.getFileEndOffset();
+        this->_spillStats.add(writer.spillStats());
         this->_iters.push_back(std::shared_ptr<Iterator>(iteratorPtr));
 
         _memUsed = 0;
@@ -1009,7 +1069,7 @@ typename Sorter<Key, Value>::PersistedState Sorter<Key, Value>::persistDataForSh
         return it->getRange();
     });
 
-    return {_fileName, ranges};
+    return {_fileName, ranges, _opts.spillCompressor};
 }
 
 //
@@ -1023,6 +1083,10 @@ SortedFileWriter<Key, Value>::SortedFileWriter(const SortOptions& opts,
                                                const Settings& settings)
     : _settings(settings),
       _fileFullPath(fileFullPath),
+      _readAheadBlocks(opts.readAheadBlocks),
+      _directIO(opts.directIO),
+      _spillCompressor(opts.spillCompressor),
+      _spillCompressionLevel(opts.spillCompressionLevel),
       // The file descriptor is positioned at the end of a file when opened in append mode, but
       // _file.tellp() is not initialized on all systems to reflect this. Therefore, we must also
       // pass in the expected offset to this constructor.
@@ -1079,13 +1143,15 @@ void SortedFileWriter<Key, Value>::spill() {
         return;
 
     std::string compressed;
-    snappy::Compress(outBuffer, size, &compressed);
-    verify(compressed.size() <= size_t(std::numeric_limits<int32_t>::max()));
-
-    const bool shouldCompress = compressed.size() < size_t(_buffer.len() / 10 * 9);
-    if (shouldCompress) {
-        size = compressed.size();
-        outBuffer = const_cast<char*>(compressed.data());
+    auto compressor = SorterSpillCompressor::kNone;
+    if (_spillCompressor != SorterSpillCompressor::kNone) {
+        sorter::compressSpillBlock(
+            _spillCompressor, _spillCompressionLevel, outBuffer, size, &compressed);
+        if (compressed.size() < size_t(_buffer.len() / 10 * 9)) {
+            compressor = _spillCompressor;
+            size = compressed.size();
+            outBuffer = const_cast<char*>(compressed.data());
+        }
     }
 
     std::unique_ptr<char[]> out;
@@ -1105,17 +1171,18 @@ void SortedFileWriter<Key, Value>::spill() {
         size = resultLen;
     }
 
-    // negative size means compressed
-    size = shouldCompress ? -size : size;
+    const int32_t header = sorter::encodeSpillBlockHeader(compressor, size);
     try {
-        _file.write(reinterpret_cast<const char*>(&size), sizeof(size));
-        _file.write(outBuffer, std::abs(size));
+        _file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        _file.write(outBuffer, size);
     } catch (const std::exception&) {
         msgasserted(16821,
                     str::stream() << "error writing to file \"" << _fileFullPath
                                   << "\": " << sorter::myErrnoWithDescription());
     }
 
+    _spillStats.uncompressedBytes += _buffer.len();
+    _spillStats.bytesWritten += sizeof(header) + size;
     _buffer.reset();
 }
 
@@ -1134,7 +1201,12 @@ SortIteratorInterface<Key, Value>* SortedFileWriter<Key, Value>::done() {
     _file.close();
 
     return new sorter::FileIterator<Key, Value>(
-        _fileFullPath, _fileStartOffset, _fileEndOffset, _settings, _checksum);
+        _fileFullPath,
+        _fileStartOffset,
+        _fileEndOffset,
+        _settings,
+        _checksum,
+        sorter::SortedFileReader::Options{_readAheadBlocks, _directIO});
 }
 
 //
@@ -39,6 +39,7 @@
 #include <vector>
 
 #include "mongo/bson/util/builder.h"
+#include "mongo/db/sorter/sorter_compression.h"
 #include "mongo/db/sorter/sorter_gen.h"
 #include "mongo/util/bufreader.h"
 
@@ -86,6 +87,12 @@
  *     }
  *     Ordering _ord;
  * };
+ *
+ * Comparators may also provide the following member to speed up merging sorted runs. The returned
+ * prefixes must be consistent with the comparison: if prefix(a) < prefix(b) then a must sort
+ * before b. Keys with equal prefixes are compared in full.
+ *
+ * uint64_t normalizedKeyPrefix(const Key& key) const;
  */
 
 namespace mongo {
@@ -108,7 +115,33 @@ struct SortOptions {
     // extSortAllowed is true.
     std::string tempDir;
 
-    SortOptions() : limit(0), maxMemoryUsageBytes(64 * 1024 * 1024), extSortAllowed(false) {}
+    // The maximum number of threads used to sort the buffered data before returning it or spilling
+    // it to disk. The Comparator must be safe to call concurrently if this is greater than 1. Only
+    // used when there is no limit.
+    size_t sortThreads;
+
+    // The maximum number of blocks of each spilled run that are read from disk and decompressed
+    // in the background ahead of the merge. 0 reads every block when the merge needs it.
+    size_t readAheadBlocks;
+
+    // Whether to read spilled runs back with direct I/O, bypassing the page cache, on platforms
+    // and file systems that support it.
+    bool directIO;
+
+    // The codec used to compress blocks spilled to disk, and its compression level. A level of 0
+    // selects the default level of the codec.
+    SorterSpillCompressor spillCompressor;
+    int spillCompressionLevel;
+
+    SortOptions()
+        : limit(0),
+          maxMemoryUsageBytes(64 * 1024 * 1024),
+          extSortAllowed(false),
+          sortThreads(1),
+          readAheadBlocks(0),
+          directIO(false),
+          spillCompressor(SorterSpillCompressor::kSnappy),
+          spillCompressionLevel(0) {}
 
     // Fluent API to support expressions like SortOptions().Limit(1000).ExtSortAllowed(true)
 
@@ -131,6 +164,51 @@ struct SortOptions {
         tempDir = newTempDir;
         return *this;
     }
+
+    SortOptions& SortThreads(size_t newSortThreads) {
+        sortThreads = newSortThreads;
+        return *this;
+    }
+
+    SortOptions& ReadAheadBlocks(size_t newReadAheadBlocks) {
+        readAheadBlocks = newReadAheadBlocks;
+        return *this;
+    }
+
+    SortOptions& DirectIO(bool newDirectIO = true) {
+        directIO = newDirectIO;
+        return *this;
+    }
+
+    SortOptions& SpillCompressor(SorterSpillCompressor newSpillCompressor) {
+        spillCompressor = newSpillCompressor;
+        return *this;
+    }
+
+    SortOptions& SpillCompressionLevel(int newSpillCompressionLevel) {
+        spillCompressionLevel = newSpillCompressionLevel;
+        return *this;
+    }
+};
+
+/**
+ * The amount of data spilled to disk, before and after compression.
+ */
+struct SorterSpillStats {
+    // The number of bytes of serialized data spilled.
+    uint64_t uncompressedBytes = 0;
+
+    // The number of bytes written to disk for that data, including block headers.
+    uint64_t bytesWritten = 0;
+
+    void add(const SorterSpillStats& other) {
+        uncompressedBytes += other.uncompressedBytes;
+        bytesWritten += other.bytesWritten;
+    }
+
+    double compressionRatio() const {
+        return bytesWritten ? static_cast<double>(uncompressedBytes) / bytesWritten : 1.0;
+    }
 };
 
 /**
@@ -224,6 +302,8 @@ public:
     struct PersistedState {
         std::string fileName;
         std::vector<SorterRange> ranges;
+        // The codec that the blocks of the ranges were compressed with.
+        SorterSpillCompressor spillCompressor = SorterSpillCompressor::kSnappy;
     };
 
     explicit Sorter(const SortOptions& opts);
@@ -262,6 +342,10 @@ public:
         return _usedDisk;
     }
 
+    const SorterSpillStats& spillStats() const {
+        return _spillStats;
+    }
+
     PersistedState persistDataForShutdown();
 
 protected:
@@ -271,6 +355,8 @@ protected:
 
     bool _usedDisk{false};  // Keeps track of whether the sorter used disk or not
 
+    SorterSpillStats _spillStats;  // Data spilled by this Sorter, before and after compression.
+
     // Whether the files written by this Sorter should be kept on destruction.
     bool _shouldKeepFilesOnDestruction = false;
 
@@ -323,12 +409,25 @@ public:
         return _fileEndOffset;
     }
 
+    const SorterSpillStats& spillStats() const {
+        return _spillStats;
+    }
+
 private:
     void spill();
 
     const Settings _settings;
     std::string _fileFullPath;
     std::ofstream _file;
+
+    // Passed to the FileIterator returned by done() to configure how it reads the file back.
+    const size_t _readAheadBlocks;
+    const bool _directIO;
+
+    const SorterSpillCompressor _spillCompressor;
+    const int _spillCompressionLevel;
+
+    SorterSpillStats _spillStats;
     BufBuilder _buffer;
 
     // Keeps track of the hash of all data objects spilled to disk. Passed to the FileIterator
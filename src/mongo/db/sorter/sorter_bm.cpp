@@ -0,0 +1,167 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <boost/filesystem/operations.hpp>
+
+#include "mongo/base/data_type_endian.h"
+#include "mongo/db/sorter/sorter.h"
+#include "mongo/platform/random.h"
+
+namespace mongo {
+
+std::string nextFileName() {
+    static AtomicWord<unsigned> sorterBmFileCounter;
+    return "extsort-sorter-bm." + std::to_string(sorterBmFileCounter.fetchAndAdd(1));
+}
+
+}  // namespace mongo
+
+// Need access to internal classes
+#include "mongo/db/sorter/sorter.cpp"
+
+namespace mongo {
+namespace sorter {
+namespace {
+
+constexpr int kNumItems = 1 << 22;
+
+class IntWrapper {
+public:
+    IntWrapper(int i = 0) : _i(i) {}
+    operator const int&() const {
+        return _i;
+    }
+
+    struct SorterDeserializeSettings {};  // unused
+    void serializeForSorter(BufBuilder& buf) const {
+        buf.appendNum(_i);
+    }
+    static IntWrapper deserializeForSorter(BufReader& buf, const SorterDeserializeSettings&) {
+        return buf.read<LittleEndian<int>>().value;
+    }
+    int memUsageForSorter() const {
+        return sizeof(IntWrapper);
+    }
+    IntWrapper getOwned() const {
+        return *this;
+    }
+
+private:
+    int _i;
+};
+
+using IWPair = std::pair<IntWrapper, IntWrapper>;
+using IWIterator = SortIteratorInterface<IntWrapper, IntWrapper>;
+
+struct IWComparator {
+    int operator()(const IWPair& lhs, const IWPair& rhs) const {
+        if (lhs.first == rhs.first)
+            return 0;
+        return lhs.first < rhs.first ? -1 : 1;
+    }
+};
+
+/**
+ * Spills 'kNumItems' random ints as 'state.range(0)' sorted runs of equal size into one file, then
+ * measures merging the runs back from disk. 'state.range(1)' is the number of read-ahead blocks per
+ * run and 'state.range(2)' enables direct I/O.
+ */
+void BM_MergeSpilledRuns(benchmark::State& state) {
+    const auto numRuns = state.range(0);
+    const auto opts = SortOptions()
+                          .TempDir((boost::filesystem::temp_directory_path() /
+                                    boost::filesystem::unique_path("sorter_bm-%%%%-%%%%"))
+                                       .string())
+                          .ExtSortAllowed()
+                          .ReadAheadBlocks(state.range(1))
+                          .DirectIO(state.range(2));
+    const auto fileFullPath = opts.tempDir + "/" + nextFileName();
+
+    PseudoRandom random(1);
+    std::vector<SorterRange> ranges;
+    std::streampos offset = 0;
+    for (int64_t run = 0; run < numRuns; ++run) {
+        std::vector<int> values(kNumItems / numRuns);
+        for (auto&& value : values) {
+            value = random.nextInt32();
+        }
+        std::sort(values.begin(), values.end());
+
+        SortedFileWriter<IntWrapper, IntWrapper> writer(opts, fileFullPath, offset);
+        for (auto value : values) {
+            writer.addAlreadySorted(value, value);
+        }
+        std::unique_ptr<IWIterator> iter(writer.done());
+        ranges.push_back(iter->getRange());
+        offset = writer.getFileEndOffset();
+    }
+
+    for (auto _ : state) {
+        std::vector<std::shared_ptr<IWIterator>> iters;
+        for (auto&& range : ranges) {
+            iters.push_back(std::make_shared<FileIterator<IntWrapper, IntWrapper>>(
+                fileFullPath,
+                range.getStartOffset(),
+                range.getEndOffset(),
+                FileIterator<IntWrapper, IntWrapper>::Settings(),
+                range.getChecksum(),
+                makeReaderOptions(opts)));
+        }
+
+        std::unique_ptr<IWIterator> merged(IWIterator::merge(iters, opts, IWComparator()));
+        int64_t sum = 0;
+        while (merged->more()) {
+            sum += merged->next().first;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * kNumItems);
+
+    boost::filesystem::remove_all(opts.tempDir);
+}
+
+void mergeSpilledRunsArgs(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"runs", "readAhead", "directIO"});
+    for (int64_t numRuns : {1, 16, 256}) {
+        for (int64_t readAheadBlocks : {0, 2}) {
+            for (int64_t directIO : {0, 1}) {
+                b->Args({numRuns, readAheadBlocks, directIO});
+            }
+        }
+    }
+}
+
+BENCHMARK(BM_MergeSpilledRuns)->Apply(mergeSpilledRunsArgs)->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace sorter
+}  // namespace mongo
@@ -0,0 +1,163 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/sorter/sorter_compression.h"
+
+#include <snappy.h>
+#include <zstd.h>
+
+#include "mongo/util/assert_util.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+namespace {
+
+// The codec ids stored in the headers of compressed blocks.
+constexpr uint32_t kSnappyCodecId = 0;
+constexpr uint32_t kZstdCodecId = 1;
+constexpr int kCodecIdShift = 28;
+
+}  // namespace
+
+StatusWith<SorterSpillCompressor> parseSorterSpillCompressor(StringData name) {
+    if (name == "none"_sd) {
+        return SorterSpillCompressor::kNone;
+    }
+    if (name == "snappy"_sd) {
+        return SorterSpillCompressor::kSnappy;
+    }
+    if (name == "zstd"_sd) {
+        return SorterSpillCompressor::kZstd;
+    }
+    return Status(ErrorCodes::BadValue,
+                  str::stream() << "Unknown sorter spill compressor '" << name
+                                << "', expected one of 'none', 'snappy' or 'zstd'");
+}
+
+Status validateSorterSpillCompressor(const std::string& name) {
+    return parseSorterSpillCompressor(name).getStatus();
+}
+
+namespace sorter {
+
+int32_t encodeSpillBlockHeader(SorterSpillCompressor compressor, size_t blockSize) {
+    if (compressor == SorterSpillCompressor::kNone) {
+        invariant(blockSize <= size_t(std::numeric_limits<int32_t>::max()));
+        return blockSize;
+    }
+
+    uassert(5188900,
+            str::stream() << "Compressed sorter block of " << blockSize
+                          << " bytes exceeds the maximum of " << kMaxCompressedSpillBlockSize,
+            blockSize <= kMaxCompressedSpillBlockSize);
+    const uint32_t codecId =
+        compressor == SorterSpillCompressor::kSnappy ? kSnappyCodecId : kZstdCodecId;
+    return -static_cast<int32_t>((codecId << kCodecIdShift) | blockSize);
+}
+
+std::pair<SorterSpillCompressor, size_t> decodeSpillBlockHeader(int32_t header) {
+    if (header >= 0) {
+        return {SorterSpillCompressor::kNone, header};
+    }
+
+    const uint32_t value = -static_cast<int64_t>(header);
+    const size_t blockSize = value & kMaxCompressedSpillBlockSize;
+    switch (value >> kCodecIdShift) {
+        case kSnappyCodecId:
+            return {SorterSpillCompressor::kSnappy, blockSize};
+        case kZstdCodecId:
+            return {SorterSpillCompressor::kZstd, blockSize};
+    }
+    uasserted(5188901,
+              str::stream() << "Unknown compressor id " << (value >> kCodecIdShift)
+                            << " in sorter block header");
+}
+
+void compressSpillBlock(
+    SorterSpillCompressor compressor, int level, const char* data, size_t size, std::string* out) {
+    switch (compressor) {
+        case SorterSpillCompressor::kSnappy:
+            snappy::Compress(data, size, out);
+            return;
+        case SorterSpillCompressor::kZstd: {
+            out->resize(ZSTD_compressBound(size));
+            size_t ret = ZSTD_compress(
+                &(*out)[0], out->size(), data, size, level ? level : ZSTD_CLEVEL_DEFAULT);
+            uassert(5188902,
+                    str::stream() << "Could not compress sorter block: " << ZSTD_getErrorName(ret),
+                    !ZSTD_isError(ret));
+            out->resize(ret);
+            return;
+        }
+        case SorterSpillCompressor::kNone:
+            break;
+    }
+    MONGO_UNREACHABLE;
+}
+
+std::unique_ptr<char[]> decompressSpillBlock(SorterSpillCompressor compressor,
+                                             const char* data,
+                                             size_t size,
+                                             size_t* uncompressedSize) {
+    switch (compressor) {
+        case SorterSpillCompressor::kSnappy: {
+            dassert(snappy::IsValidCompressedBuffer(data, size));
+            uassert(17061,
+                    "couldn't get uncompressed length",
+                    snappy::GetUncompressedLength(data, size, uncompressedSize));
+
+            std::unique_ptr<char[]> out(new char[*uncompressedSize]);
+            uassert(17062, "decompression failed", snappy::RawUncompress(data, size, out.get()));
+            return out;
+        }
+        case SorterSpillCompressor::kZstd: {
+            const auto contentSize = ZSTD_getFrameContentSize(data, size);
+            uassert(5189106,
+                    "couldn't get uncompressed length",
+                    contentSize != ZSTD_CONTENTSIZE_ERROR &&
+                        contentSize != ZSTD_CONTENTSIZE_UNKNOWN);
+
+            std::unique_ptr<char[]> out(new char[contentSize]);
+            size_t ret = ZSTD_decompress(out.get(), contentSize, data, size);
+            uassert(5189107,
+                    str::stream() << "decompression failed: " << ZSTD_getErrorName(ret),
+                    !ZSTD_isError(ret) && ret == contentSize);
+            *uncompressedSize = contentSize;
+            return out;
+        }
+        case SorterSpillCompressor::kNone:
+            break;
+    }
+    MONGO_UNREACHABLE;
+}
+
+}  // namespace sorter
+}  // namespace mongo
@@ -0,0 +1,92 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "mongo/base/status_with.h"
+#include "mongo/base/string_data.h"
+
+namespace mongo {
+
+/**
+ * The codecs that the sorter can compress spilled blocks with.
+ */
+enum class SorterSpillCompressor {
+    kNone,
+    kSnappy,
+    kZstd,
+};
+
+StatusWith<SorterSpillCompressor> parseSorterSpillCompressor(StringData name);
+
+/**
+ * Validator for the internalSorterSpillCompressor server parameter.
+ */
+Status validateSorterSpillCompressor(const std::string& name);
+
+namespace sorter {
+
+/**
+ * Every block that SortedFileWriter spills is preceded by a 32-bit header. A non-negative header is
+ * the length of an uncompressed block. A negative header marks a compressed block: its absolute
+ * value holds the compressed length in the low 28 bits and the codec in the 3 bits above them.
+ * Snappy is codec 0, so files spilled before the codec was recorded still read back correctly.
+ */
+constexpr size_t kMaxCompressedSpillBlockSize = (size_t(1) << 28) - 1;
+
+int32_t encodeSpillBlockHeader(SorterSpillCompressor compressor, size_t blockSize);
+
+/**
+ * Returns the codec and the length of the block that follows 'header'.
+ */
+std::pair<SorterSpillCompressor, size_t> decodeSpillBlockHeader(int32_t header);
+
+/**
+ * Compresses 'size' bytes at 'data' with 'compressor' into 'out'. A 'level' of 0 selects the
+ * default level of the codec; codecs without levels ignore it.
+ */
+void compressSpillBlock(
+    SorterSpillCompressor compressor, int level, const char* data, size_t size, std::string* out);
+
+/**
+ * Decompresses a block that was compressed with 'compressor' and sets 'uncompressedSize' to the
+ * length of the returned buffer.
+ */
+std::unique_ptr<char[]> decompressSpillBlock(SorterSpillCompressor compressor,
+                                             const char* data,
+                                             size_t size,
+                                             size_t* uncompressedSize);
+
+}  // namespace sorter
+}  // namespace mongo
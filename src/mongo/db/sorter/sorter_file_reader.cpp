@@ -0,0 +1,387 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/sorter/sorter_file_reader.h"
+
+#include <algorithm>
+#include <boost/filesystem/operations.hpp>
+#include <cstring>
+#include <utility>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "mongo/base/init.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/sorter/sorter_compression.h"
+#include "mongo/db/storage/encryption_hooks.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/destructor_guard.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+namespace sorter {
+namespace {
+
+// Direct I/O requires the file offset, the buffer address and the length of every read to be
+// multiples of the logical block size of the device. 4KB covers every device we run on.
+constexpr size_t kDirectIOAlignment = 4096;
+constexpr size_t kDirectIOWindowSize = 1024 * 1024;
+
+// Read-ahead tasks only read and decode a few blocks each before they yield their thread, so a
+// small pool is enough to keep the disk busy for any number of concurrent merges.
+constexpr size_t kReadAheadMaxThreads = 8;
+
+std::unique_ptr<ThreadPool> readAheadPool;
+MONGO_INITIALIZER(SorterReadAheadPool)(InitializerContext* context) {
+    ThreadPool::Options options;
+    options.poolName = "SorterReadAhead";
+    options.minThreads = 0;
+    options.maxThreads = kReadAheadMaxThreads;
+    readAheadPool = std::make_unique<ThreadPool>(options);
+    readAheadPool->startup();
+
+    return Status::OK();
+}
+
+// We need to use the "real" errno everywhere, not GetLastError() on Windows
+std::string myErrnoWithDescription() {
+    int errnoCopy = errno;
+    StringBuilder sb;
+    sb << "errno:" << errnoCopy << ' ' << strerror(errnoCopy);
+    return sb.str();
+}
+
+EncryptionHooks* getEncryptionHooksIfEnabled() {
+    // Some tests may not run with a global service context.
+    if (!hasGlobalServiceContext()) {
+        return nullptr;
+    }
+    auto encryptionHooks = EncryptionHooks::get(getGlobalServiceContext());
+    if (!encryptionHooks->enabled()) {
+        return nullptr;
+    }
+    return encryptionHooks;
+}
+
+}  // namespace
+
+SortedFileReader::SortedFileReader(std::string fileFullPath,
+                                   std::streamoff fileStartOffset,
+                                   std::streamoff fileEndOffset,
+                                   Options options)
+    : _fileFullPath(std::move(fileFullPath)),
+      _fileStartOffset(fileStartOffset),
+      _fileEndOffset(fileEndOffset),
+      _options(options) {
+    uassert(16815,
+            str::stream() << "unexpected empty file: " << _fileFullPath,
+            boost::filesystem::file_size(_fileFullPath) != 0);
+}
+
+SortedFileReader::~SortedFileReader() {
+    DESTRUCTOR_GUARD(close());
+}
+
+void SortedFileReader::open() {
+    invariant(!_isOpen);
+    _offset = _fileStartOffset;
+    _windowLen = 0;
+
+#if defined(O_DIRECT)
+    if (_options.directIO) {
+        _fd = ::open(_fileFullPath.c_str(), O_RDONLY | O_DIRECT);
+        // EINVAL means that the file system does not support O_DIRECT, in which case we fall back
+        // to buffered reads.
+        uassert(5189103,
+                str::stream() << "error opening file \"" << _fileFullPath
+                              << "\": " << myErrnoWithDescription(),
+                _fd >= 0 || errno == EINVAL);
+        if (_fd >= 0 && !_window) {
+            _windowAllocation.reset(new char[kDirectIOWindowSize + kDirectIOAlignment]);
+            auto address = reinterpret_cast<uintptr_t>(_windowAllocation.get());
+            _window = reinterpret_cast<char*>((address + kDirectIOAlignment - 1) &
+                                              ~uintptr_t(kDirectIOAlignment - 1));
+        }
+    }
+#endif
+
+    if (_fd < 0) {
+        _file.open(_fileFullPath.c_str(), std::ios::in | std::ios::binary);
+        uassert(16814,
+                str::stream() << "error opening file \"" << _fileFullPath
+                              << "\": " << myErrnoWithDescription(),
+                _file.good());
+        _file.seekg(_fileStartOffset);
+        uassert(50979,
+                str::stream() << "error seeking starting offset of '" << _fileStartOffset
+                              << "' in file \"" << _fileFullPath
+                              << "\": " << myErrnoWithDescription(),
+                _file.good());
+    }
+    _isOpen = true;
+
+    if (_options.readAheadBlocks == 0) {
+        return;
+    }
+
+    bool startReadAhead;
+    {
+        stdx::lock_guard lk(_mutex);
+        _closing = false;
+        _readAheadReachedEnd = false;
+        _readAheadError = nullptr;
+        startReadAhead = _shouldStartReadAhead(lk);
+    }
+    if (startReadAhead) {
+        _scheduleReadAhead();
+    }
+}
+
+void SortedFileReader::close() {
+    if (!_isOpen) {
+        return;
+    }
+
+    {
+        stdx::unique_lock lk(_mutex);
+        _closing = true;
+        _cv.wait(lk, [&] { return !_readAheadRunning; });
+        _readAheadQueue.clear();
+    }
+    _isOpen = false;
+
+#ifndef _WIN32
+    if (_fd >= 0) {
+        int fd = std::exchange(_fd, -1);
+        uassert(5189104,
+                str::stream() << "error closing file \"" << _fileFullPath
+                              << "\": " << myErrnoWithDescription(),
+                ::close(fd) == 0);
+        return;
+    }
+#endif
+
+    _file.close();
+    uassert(50969,
+            str::stream() << "error closing file \"" << _fileFullPath
+                          << "\": " << myErrnoWithDescription(),
+            !_file.fail());
+}
+
+bool SortedFileReader::nextBlock(std::unique_ptr<char[]>* block, size_t* size) {
+    invariant(_isOpen);
+
+    Block next;
+    if (_options.readAheadBlocks == 0) {
+        if (!_readBlock(&next)) {
+            return false;
+        }
+    } else {
+        bool startReadAhead;
+        {
+            stdx::unique_lock lk(_mutex);
+            if (_readAheadQueue.empty()) {
+                if (_shouldStartReadAhead(lk)) {
+                    lk.unlock();
+                    _scheduleReadAhead();
+                    lk.lock();
+                }
+                _cv.wait(lk, [&] {
+                    return !_readAheadQueue.empty() || _readAheadReachedEnd || _readAheadError;
+                });
+            }
+
+            if (_readAheadQueue.empty()) {
+                if (_readAheadError) {
+                    std::rethrow_exception(_readAheadError);
+                }
+                return false;
+            }
+
+            next = std::move(_readAheadQueue.front());
+            _readAheadQueue.pop_front();
+            startReadAhead = _shouldStartReadAhead(lk);
+        }
+        if (startReadAhead) {
+            _scheduleReadAhead();
+        }
+    }
+
+    *block = std::move(next.data);
+    *size = next.size;
+    return true;
+}
+
+bool SortedFileReader::_readBlock(Block* block) {
+    if (_offset >= _fileEndOffset) {
+        invariant(_offset == _fileEndOffset);
+        return false;
+    }
+
+    int32_t header;
+    _read(&header, sizeof(header));
+    uassert(16816, "file too short?", _offset < _fileEndOffset);
+
+    auto [compressor, blockSize] = decodeSpillBlockHeader(header);
+
+    std::unique_ptr<char[]> buffer(new char[blockSize]);
+    _read(buffer.get(), blockSize);
+
+    if (auto encryptionHooks = getEncryptionHooksIfEnabled()) {
+        std::unique_ptr<char[]> out(new char[blockSize]);
+        size_t outLen;
+        Status status =
+            encryptionHooks->unprotectTmpData(reinterpret_cast<uint8_t*>(buffer.get()),
+                                              blockSize,
+                                              reinterpret_cast<uint8_t*>(out.get()),
+                                              blockSize,
+                                              &outLen);
+        uassert(28841,
+                str::stream() << "Failed to unprotect data: " << status.toString(),
+                status.isOK());
+        blockSize = outLen;
+        buffer.swap(out);
+    }
+
+    if (compressor == SorterSpillCompressor::kNone) {
+        block->data = std::move(buffer);
+        block->size = blockSize;
+        return true;
+    }
+
+    block->data = decompressSpillBlock(compressor, buffer.get(), blockSize, &block->size);
+    return true;
+}
+
+void SortedFileReader::_read(void* out, size_t size) {
+    if (_fd < 0) {
+        _file.read(reinterpret_cast<char*>(out), size);
+        uassert(16817,
+                str::stream() << "error reading file \"" << _fileFullPath
+                              << "\": " << myErrnoWithDescription(),
+                _file.good());
+        verify(_file.gcount() == static_cast<std::streamsize>(size));
+        _offset += size;
+        return;
+    }
+
+    auto dest = reinterpret_cast<char*>(out);
+    while (size > 0) {
+        if (_offset < _windowStart ||
+            _offset >= _windowStart + static_cast<std::streamoff>(_windowLen)) {
+            _fillDirectWindow();
+        }
+        const size_t windowPos = _offset - _windowStart;
+        const size_t len = std::min(size, _windowLen - windowPos);
+        std::memcpy(dest, _window + windowPos, len);
+        dest += len;
+        size -= len;
+        _offset += len;
+    }
+}
+
+void SortedFileReader::_fillDirectWindow() {
+#ifndef _WIN32
+    _windowStart = _offset & ~static_cast<std::streamoff>(kDirectIOAlignment - 1);
+    ssize_t bytesRead;
+    do {
+        bytesRead = ::pread(_fd, _window, kDirectIOWindowSize, _windowStart);
+    } while (bytesRead < 0 && errno == EINTR);
+
+    // The last read of the file is allowed to be short, but it must at least reach the offset we
+    // are reading from.
+    uassert(5189105,
+            str::stream() << "error reading file \"" << _fileFullPath
+                          << "\": " << myErrnoWithDescription(),
+            bytesRead > _offset - _windowStart);
+    _windowLen = bytesRead;
+#else
+    MONGO_UNREACHABLE;
+#endif
+}
+
+bool SortedFileReader::_shouldStartReadAhead(WithLock) {
+    if (_readAheadRunning || _readAheadReachedEnd || _readAheadError || _closing ||
+        _readAheadQueue.size() >= _options.readAheadBlocks) {
+        return false;
+    }
+    _readAheadRunning = true;
+    return true;
+}
+
+void SortedFileReader::_scheduleReadAhead() {
+    // The pool runs the task inline with an error status if it has been shut down, so this must
+    // not be called with '_mutex' held.
+    readAheadPool->schedule([this](Status status) {
+        try {
+            uassertStatusOK(status);
+            _readAhead();
+        } catch (...) {
+            stdx::lock_guard lk(_mutex);
+            _readAheadError = std::current_exception();
+            _readAheadRunning = false;
+            _cv.notify_all();
+        }
+    });
+}
+
+void SortedFileReader::_readAhead() {
+    while (true) {
+        {
+            stdx::lock_guard lk(_mutex);
+            if (_closing || _readAheadQueue.size() >= _options.readAheadBlocks) {
+                _readAheadRunning = false;
+                _cv.notify_all();
+                return;
+            }
+        }
+
+        Block block;
+        const bool more = _readBlock(&block);
+
+        stdx::lock_guard lk(_mutex);
+        if (!more) {
+            _readAheadReachedEnd = true;
+            _readAheadRunning = false;
+            _cv.notify_all();
+            return;
+        }
+        _readAheadQueue.push_back(std::move(block));
+        _cv.notify_all();
+    }
+}
+
+}  // namespace sorter
+}  // namespace mongo
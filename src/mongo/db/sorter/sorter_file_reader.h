@@ -0,0 +1,164 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/util/concurrency/with_lock.h"
+
+namespace mongo {
+namespace sorter {
+
+/**
+ * Reads the blocks that a SortedFileWriter spilled for one sorted data range, and returns them
+ * unprotected and decompressed.
+ *
+ * When read-ahead is enabled, blocks are read and decoded by a task on a shared thread pool into a
+ * bounded queue, so that disk reads and decompression for a range overlap with the merge that
+ * consumes it. At most one task per reader is running at a time, and it stops as soon as the queue
+ * is full; the consumer schedules a new one once it has made room.
+ *
+ * When direct I/O is requested and the platform and file system support it, the file is opened
+ * with O_DIRECT and read through an aligned window instead of through the page cache. Spill files
+ * are read exactly once, so caching them only evicts pages that are more useful to the rest of
+ * the server.
+ *
+ * This class is not thread-safe; a single consumer must call open(), nextBlock() and close().
+ */
+class SortedFileReader {
+    SortedFileReader(const SortedFileReader&) = delete;
+    SortedFileReader& operator=(const SortedFileReader&) = delete;
+
+public:
+    struct Options {
+        // The maximum number of decoded blocks buffered ahead of the consumer. 0 reads every block
+        // synchronously on the consumer's thread.
+        size_t readAheadBlocks = 0;
+
+        // Whether to bypass the page cache when it is possible to do so.
+        bool directIO = false;
+    };
+
+    SortedFileReader(std::string fileFullPath,
+                     std::streamoff fileStartOffset,
+                     std::streamoff fileEndOffset,
+                     Options options);
+
+    ~SortedFileReader();
+
+    /**
+     * Opens the file and positions the reader at the start of the range. With read-ahead enabled
+     * this also starts reading the first blocks in the background.
+     */
+    void open();
+
+    /**
+     * Stops any read-ahead in progress, discards the blocks it buffered and closes the file.
+     */
+    void close();
+
+    /**
+     * Returns the next decoded block of the range in 'block' and its length in 'size'. Returns
+     * false when the whole range has been read. Errors encountered by read-ahead are rethrown here,
+     * after the blocks read before the error have been returned.
+     */
+    bool nextBlock(std::unique_ptr<char[]>* block, size_t* size);
+
+private:
+    struct Block {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    /**
+     * Reads and decodes the block at the current offset. Returns false if the offset has reached
+     * the end of the range.
+     */
+    bool _readBlock(Block* block);
+
+    /**
+     * Reads exactly 'size' bytes at the current offset and advances it.
+     */
+    void _read(void* out, size_t size);
+
+    /**
+     * Fills the direct I/O window with the aligned region of the file that contains the current
+     * offset.
+     */
+    void _fillDirectWindow();
+
+    /**
+     * Returns true if a read-ahead task should be started, in which case the caller must call
+     * _scheduleReadAhead() after releasing '_mutex'.
+     */
+    bool _shouldStartReadAhead(WithLock);
+    void _scheduleReadAhead();
+    void _readAhead();
+
+    const std::string _fileFullPath;
+    const std::streamoff _fileStartOffset;
+    const std::streamoff _fileEndOffset;
+    const Options _options;
+
+    // The offset of the next byte to read. Only accessed by whichever thread is currently reading
+    // the file: the consumer when there is no read-ahead, otherwise the read-ahead task.
+    std::streamoff _offset = 0;
+
+    // Buffered access to the file.
+    std::ifstream _file;
+
+    // Direct access to the file. '_fd' is -1 unless the file was opened with O_DIRECT. The window
+    // holds the bytes of the file in [_windowStart, _windowStart + _windowLen).
+    int _fd = -1;
+    std::unique_ptr<char[]> _windowAllocation;
+    char* _window = nullptr;
+    std::streamoff _windowStart = 0;
+    size_t _windowLen = 0;
+
+    bool _isOpen = false;
+
+    // Read-ahead state.
+    Mutex _mutex = MONGO_MAKE_LATCH("SortedFileReader::_mutex");
+    stdx::condition_variable _cv;
+    std::deque<Block> _readAheadQueue;
+    bool _readAheadRunning = false;
+    bool _readAheadReachedEnd = false;
+    bool _closing = false;
+    std::exception_ptr _readAheadError;
+};
+
+}  // namespace sorter
+}  // namespace mongo
@@ -0,0 +1,131 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/sorter/sorter_sort_helpers.h"
+
+#include <algorithm>
+#include <exception>
+#include <vector>
+
+#include "mongo/base/init.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/util/concurrency/thread_pool.h"
+
+namespace mongo {
+namespace sorter {
+namespace {
+
+// Bounds the budget of helpers set by the callers, which the pool never has to queue behind.
+constexpr size_t kSortHelpersMaxThreads = 64;
+
+AtomicWord<size_t> busyHelpers{0};
+
+std::unique_ptr<ThreadPool> sortHelperPool;
+MONGO_INITIALIZER(SorterSortHelperPool)(InitializerContext* context) {
+    ThreadPool::Options options;
+    options.poolName = "SorterSortHelpers";
+    options.minThreads = 0;
+    options.maxThreads = kSortHelpersMaxThreads;
+    sortHelperPool = std::make_unique<ThreadPool>(options);
+    sortHelperPool->startup();
+
+    return Status::OK();
+}
+
+/**
+ * Takes up to 'wanted' helpers from the budget of 'maxBusyHelpers', and returns how many it took.
+ */
+size_t takeHelpers(size_t wanted, size_t maxBusyHelpers) {
+    maxBusyHelpers = std::min(maxBusyHelpers, kSortHelpersMaxThreads);
+    auto busy = busyHelpers.load();
+    while (true) {
+        auto count = std::min(wanted, maxBusyHelpers > busy ? maxBusyHelpers - busy : 0);
+        if (count == 0 || busyHelpers.compareAndSwap(&busy, busy + count)) {
+            return count;
+        }
+    }
+}
+
+}  // namespace
+
+void runConcurrently(size_t n, size_t maxBusyHelpers, const std::function<void(size_t)>& fn) {
+    std::vector<std::exception_ptr> errors(n);
+    auto runCall = [&](size_t i) {
+        try {
+            fn(i);
+        } catch (...) {
+            errors[i] = std::current_exception();
+        }
+    };
+
+    const size_t numHelpers = n > 1 ? takeHelpers(n - 1, maxBusyHelpers) : 0;
+    Mutex mutex = MONGO_MAKE_LATCH("runConcurrently::mutex");
+    stdx::condition_variable helpersDone;
+    size_t runningHelpers = numHelpers;
+    for (size_t i = 1; i <= numHelpers; ++i) {
+        // The pool runs the task inline with an error status if it has been shut down, in which
+        // case the call simply runs on this thread.
+        sortHelperPool->schedule([&, i](Status) {
+            runCall(i);
+            busyHelpers.fetchAndSubtract(1);
+
+            stdx::lock_guard lk(mutex);
+            if (--runningHelpers == 0) {
+                helpersDone.notify_all();
+            }
+        });
+    }
+
+    runCall(0);
+    for (size_t i = numHelpers + 1; i < n; ++i) {
+        runCall(i);
+    }
+
+    {
+        stdx::unique_lock lk(mutex);
+        helpersDone.wait(lk, [&] { return runningHelpers == 0; });
+    }
+
+    for (auto&& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+size_t numBusySortHelpers() {
+    return busyHelpers.load();
+}
+
+}  // namespace sorter
+}  // namespace mongo
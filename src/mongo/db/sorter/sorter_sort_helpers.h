@@ -0,0 +1,55 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace mongo {
+namespace sorter {
+
+/**
+ * Calls 'fn(i)' for every i in [0, n). The calling thread runs fn(0), and the other calls run on a
+ * pool of helper threads shared by every sorter in the process, for as long as fewer than
+ * 'maxBusyHelpers' helpers are busy across all sorters. The calls for which no helper is free run
+ * on the calling thread after fn(0), so that a sort which finds the helpers taken runs serially
+ * instead of adding threads. Any exception thrown by 'fn' is rethrown on the calling thread once
+ * all the calls have finished.
+ */
+void runConcurrently(size_t n, size_t maxBusyHelpers, const std::function<void(size_t)>& fn);
+
+/**
+ * Returns the number of helper threads which are running calls of runConcurrently() across all
+ * sorters.
+ */
+size_t numBusySortHelpers();
+
+}  // namespace sorter
+}  // namespace mongo
@@ -39,6 +39,7 @@
 #include "mongo/base/static_assert.h"
 #include "mongo/config.h"
 #include "mongo/db/sorter/sorter.h"
+#include "mongo/db/sorter/sorter_sort_helpers.h"
 #include "mongo/logv2/log.h"
 #include "mongo/platform/random.h"
 #include "mongo/stdx/thread.h"
@@ -122,6 +123,17 @@ private:
     Direction _dir;
 };
 
+/**
+ * Ascending comparator that also provides a coarse normalized key prefix, so that merges decide
+ * some comparisons on the prefix and fall back to the full comparison for the rest.
+ */
+class IWPrefixComparator : public IWComparator {
+public:
+    uint64_t normalizedKeyPrefix(const IntWrapper& key) const {
+        return (static_cast<uint64_t>(static_cast<int>(key)) + (1ULL << 31)) / 16;
+    }
+};
+
 class IntIterator : public IWIterator {
 public:
     IntIterator(int start = 0, int stop = INT_MAX, int increment = 1)
@@ -359,6 +371,81 @@ public:
                 mergeIterators(iterators, ASC, SortOptions().Limit(10)),
                 std::make_shared<LimitIterator>(10, std::make_shared<IntIterator>(0, 20, 1)));
         }
+        {  // test many inputs of different lengths, with and without key prefixes
+            const int numInputs = 37;
+            for (bool usePrefix : {false, true}) {
+                std::vector<std::shared_ptr<IWIterator>> vec;
+                for (int i = 0; i < numInputs; i++) {
+                    // Input i produces i, i + 37, i + 74, ... and stops early for odd inputs.
+                    vec.push_back(std::make_shared<IntIterator>(
+                        i, i % 2 ? 20 * numInputs : 40 * numInputs, numInputs));
+                }
+                std::shared_ptr<IWIterator> mergeIter(
+                    usePrefix ? IWIterator::merge(vec, SortOptions(), IWPrefixComparator())
+                              : IWIterator::merge(vec, SortOptions(), IWComparator()));
+
+                mergeIter->openSource();
+                int last = -1;
+                int count = 0;
+                while (mergeIter->more()) {
+                    IWPair pair = mergeIter->next();
+                    ASSERT_LT(last, pair.first);
+                    last = pair.first;
+                    count++;
+                }
+                mergeIter->closeSource();
+                ASSERT_EQ(count, 19 * 40 + 18 * 20);
+            }
+        }
+        {  // test that equal keys are returned in the order of the inputs
+            std::vector<IWPair> first = {{1, 10}, {2, 10}, {2, 11}};
+            std::vector<IWPair> second = {{1, 20}, {2, 20}};
+            std::vector<IWPair> third = {{0, 30}, {2, 30}};
+            std::shared_ptr<IWIterator> iterators[] = {
+                std::make_shared<sorter::InMemIterator<IntWrapper, IntWrapper>>(first),
+                std::make_shared<sorter::InMemIterator<IntWrapper, IntWrapper>>(second),
+                std::make_shared<sorter::InMemIterator<IntWrapper, IntWrapper>>(third)};
+
+            std::vector<IWPair> expected = {
+                {0, 30}, {1, 10}, {1, 20}, {2, 10}, {2, 11}, {2, 20}, {2, 30}};
+            auto mergeIter = mergeIterators(iterators, ASC);
+            mergeIter->openSource();
+            for (auto&& pair : expected) {
+                ASSERT_TRUE(mergeIter->more());
+                IWPair actual = mergeIter->next();
+                ASSERT_EQ(actual.first, pair.first);
+                ASSERT_EQ(actual.second, pair.second);
+            }
+            ASSERT_FALSE(mergeIter->more());
+            mergeIter->closeSource();
+        }
+    }
+};
+
+class ParallelStableSortTests {
+public:
+    void run() {
+        PseudoRandom random(int64_t(time(nullptr)));
+        for (size_t numThreads : {2, 3, 4, 7}) {
+            // Few distinct keys, so that stability is observable through the values.
+            std::deque<IWPair> data;
+            for (int i = 0; i < 100 * 1000; i++) {
+                data.emplace_back(random.nextInt32(100), i);
+            }
+
+            sorter::parallelStableSort(
+                data.begin(), data.end(), numThreads, [](const IWPair& lhs, const IWPair& rhs) {
+                    return static_cast<int>(lhs.first) < static_cast<int>(rhs.first);
+                });
+
+            for (size_t i = 1; i < data.size(); i++) {
+                ASSERT_LTE(static_cast<int>(data[i - 1].first), static_cast<int>(data[i].first));
+                if (static_cast<int>(data[i - 1].first) == static_cast<int>(data[i].first)) {
+                    ASSERT_LT(static_cast<int>(data[i - 1].second),
+                              static_cast<int>(data[i].second));
+                }
+            }
+        }
     }
 };
 
@@ -506,6 +593,7 @@ private:
             ASSERT_NE(state.fileName, "");
         }
         ASSERT_EQ(state.ranges.size(), numRanges);
+        ASSERT(state.spillCompressor == opts.spillCompressor);
     }
 };
 
@@ -605,6 +693,40 @@ public:
 };
 
 
+/**
+ * Sorts the same data as LotsOfDataLittleMemory, with enough memory for each spilled run to be
+ * sorted on several threads.
+ */
+class LotsOfDataParallelSort : public LotsOfDataLittleMemory</*random=*/true> {
+    SortOptions adjustSortOptions(SortOptions opts) override {
+        return opts.MaxMemoryUsageBytes(MEM_LIMIT).ExtSortAllowed().SortThreads(4);
+    }
+    size_t correctNumRanges() const override {
+        return NUM_ITEMS * sizeof(IWPair) / MEM_LIMIT + 1;
+    }
+    enum { MEM_LIMIT = 1024 * 1024 };
+};
+
+/**
+ * Sorts the same data as LotsOfDataLittleMemory, reading the spilled runs back with read-ahead and
+ * direct I/O. Direct I/O falls back to buffered reads where the file system does not support it.
+ */
+class LotsOfDataReadAhead : public LotsOfDataLittleMemory</*random=*/true> {
+    SortOptions adjustSortOptions(SortOptions opts) override {
+        return LotsOfDataLittleMemory::adjustSortOptions(opts).ReadAheadBlocks(2).DirectIO();
+    }
+};
+
+/**
+ * Sorts the same data as LotsOfDataLittleMemory, spilling it with the given compressor.
+ */
+template <SorterSpillCompressor Compressor>
+class LotsOfDataSpillCompressor : public LotsOfDataLittleMemory</*random=*/true> {
+    SortOptions adjustSortOptions(SortOptions opts) override {
+        return LotsOfDataLittleMemory::adjustSortOptions(opts).SpillCompressor(Compressor);
+    }
+};
+
 template <long long Limit, bool Random = true>
 class LotsOfDataWithLimit : public LotsOfDataLittleMemory<Random> {
     typedef LotsOfDataLittleMemory<Random> Parent;
@@ -646,11 +768,16 @@ public:
         add<InMemIterTests>();
         add<SortedFileWriterAndFileIteratorTests>();
         add<MergeIteratorTests>();
+        add<ParallelStableSortTests>();
         add<SorterTests::Basic>();
         add<SorterTests::Limit>();
         add<SorterTests::Dupes>();
         add<SorterTests::LotsOfDataLittleMemory</*random=*/false>>();
         add<SorterTests::LotsOfDataLittleMemory</*random=*/true>>();
+        add<SorterTests::LotsOfDataParallelSort>();
+        add<SorterTests::LotsOfDataReadAhead>();
+        add<SorterTests::LotsOfDataSpillCompressor<SorterSpillCompressor::kNone>>();
+        add<SorterTests::LotsOfDataSpillCompressor<SorterSpillCompressor::kZstd>>();
         add<SorterTests::LotsOfDataWithLimit<1, /*random=*/false>>();     // limit=1 is special case
         add<SorterTests::LotsOfDataWithLimit<1, /*random=*/true>>();      // limit=1 is special case
         add<SorterTests::LotsOfDataWithLimit<100, /*random=*/false>>();   // fits in mem
@@ -842,6 +969,105 @@ TEST_F(SorterMakeFromExistingRangesTest, RoundTrip) {
     }
 }
 
+TEST(SorterSpillBlockHeaderTest, RoundTrip) {
+    for (auto compressor : {SorterSpillCompressor::kNone,
+                            SorterSpillCompressor::kSnappy,
+                            SorterSpillCompressor::kZstd}) {
+        for (size_t size : {size_t(1), size_t(64 * 1024), kMaxCompressedSpillBlockSize}) {
+            auto decoded = decodeSpillBlockHeader(encodeSpillBlockHeader(compressor, size));
+            ASSERT(decoded.first == compressor);
+            ASSERT_EQ(decoded.second, size);
+        }
+    }
+}
+
+TEST(SorterSpillBlockHeaderTest, NegativeSizeWithoutCodecIsSnappy) {
+    // Files spilled before the codec was recorded mark snappy blocks with a negative size.
+    auto decoded = decodeSpillBlockHeader(-12345);
+    ASSERT(decoded.first == SorterSpillCompressor::kSnappy);
+    ASSERT_EQ(decoded.second, 12345U);
+}
+
+TEST(SorterSpillBlockHeaderTest, UnknownCodec) {
+    ASSERT_THROWS_CODE(decodeSpillBlockHeader(-static_cast<int32_t>((7U << 28) | 100)),
+                       DBException,
+                       5188901);
+}
+
+TEST(SorterSpillCompressionTest, Parse) {
+    ASSERT(uassertStatusOK(parseSorterSpillCompressor("zstd")) == SorterSpillCompressor::kZstd);
+    ASSERT_EQ(parseSorterSpillCompressor("lz4").getStatus(), ErrorCodes::BadValue);
+}
+
+TEST(SorterSpillCompressionTest, RoundTrip) {
+    std::string data;
+    for (int i = 0; i < 10000; i++) {
+        data += std::to_string(i % 100);
+    }
+    for (auto compressor : {SorterSpillCompressor::kSnappy, SorterSpillCompressor::kZstd}) {
+        std::string compressed;
+        compressSpillBlock(compressor, 0, data.data(), data.size(), &compressed);
+        ASSERT_LT(compressed.size(), data.size());
+
+        size_t uncompressedSize;
+        auto out = decompressSpillBlock(
+            compressor, compressed.data(), compressed.size(), &uncompressedSize);
+        ASSERT_EQ(StringData(out.get(), uncompressedSize), data);
+    }
+}
+
+TEST(SorterRunConcurrentlyTest, RunsEveryCallOnce) {
+    for (size_t maxBusyHelpers : {0, 2, 64}) {
+        std::vector<AtomicWord<int>> calls(7);
+        runConcurrently(calls.size(), maxBusyHelpers, [&](size_t i) { calls[i].fetchAndAdd(1); });
+        for (auto&& count : calls) {
+            ASSERT_EQ(count.load(), 1);
+        }
+    }
+}
+
+TEST(SorterRunConcurrentlyTest, RunsOnCallingThreadWithoutFreeHelpers) {
+    const auto caller = stdx::this_thread::get_id();
+    const auto busyBefore = numBusySortHelpers();
+    std::vector<stdx::thread::id> threads(5);
+    runConcurrently(
+        threads.size(), busyBefore, [&](size_t i) { threads[i] = stdx::this_thread::get_id(); });
+    for (auto&& thread : threads) {
+        ASSERT(thread == caller);
+    }
+}
+
+TEST(SorterRunConcurrentlyTest, UsesNoMoreHelpersThanBudget) {
+    const auto caller = stdx::this_thread::get_id();
+    const auto busyBefore = numBusySortHelpers();
+    std::vector<stdx::thread::id> threads(8);
+    runConcurrently(threads.size(), busyBefore + 2, [&](size_t i) {
+        threads[i] = stdx::this_thread::get_id();
+    });
+
+    ASSERT(threads[0] == caller);
+    ASSERT_LTE(std::count_if(threads.begin(),
+                             threads.end(),
+                             [&](const stdx::thread::id& thread) { return thread != caller; }),
+               2);
+    ASSERT_EQ(numBusySortHelpers(), busyBefore);
+}
+
+TEST(SorterRunConcurrentlyTest, RethrowsAfterAllCallsFinish) {
+    std::vector<AtomicWord<int>> calls(4);
+    ASSERT_THROWS_CODE(runConcurrently(calls.size(),
+                                       64,
+                                       [&](size_t i) {
+                                           calls[i].fetchAndAdd(1);
+                                           uassert(ErrorCodes::InternalError, "failed", i != 2);
+                                       }),
+                       DBException,
+                       ErrorCodes::InternalError);
+    for (auto&& count : calls) {
+        ASSERT_EQ(count.load(), 1);
+    }
+}
+
 }  // namespace
 }  // namespace sorter
 }  // namespace mongo
@@ -69,6 +69,24 @@ RecordId extractRecordId(const std::string& keyStr) {
     ++it;
     return RecordId((*it).Long());
 }
+
+/**
+ * Fills 'batch' from the final 'cursor' without a virtual call per record. The records point into
+ * the radix store, which may change under them once the cursor moves on, so each one is copied.
+ */
+template <typename CursorType>
+bool nextBatchOfOwnedRecords(CursorType* cursor, size_t maxRecords, std::vector<Record>* batch) {
+    batch->clear();
+    while (batch->size() < maxRecords) {
+        auto record = cursor->next();
+        if (!record) {
+            break;
+        }
+        record->data.makeOwned();
+        batch->push_back(std::move(*record));
+    }
+    return !batch->empty();
+}
 }  // namespace
 
 RecordStore::RecordStore(StringData ns,
@@ -453,6 +471,10 @@ boost::optional<Record> RecordStore::Cursor::next() {
     return boost::none;
 }
 
+bool RecordStore::Cursor::nextBatch(size_t maxRecords, std::vector<Record>* batch) {
+    return nextBatchOfOwnedRecords(this, maxRecords, batch);
+}
+
 boost::optional<Record> RecordStore::Cursor::seekExact(const RecordId& id) {
     _savedPosition = boost::none;
     _lastMoveWasRestore = false;
@@ -537,6 +559,10 @@ boost::optional<Record> RecordStore::ReverseCursor::next() {
     return boost::none;
 }
 
+bool RecordStore::ReverseCursor::nextBatch(size_t maxRecords, std::vector<Record>* batch) {
+    return nextBatchOfOwnedRecords(this, maxRecords, batch);
+}
+
 boost::optional<Record> RecordStore::ReverseCursor::seekExact(const RecordId& id) {
     _needFirstSeek = false;
     _savedPosition = boost::none;
@@ -187,6 +187,7 @@ private:
                const RecordStore& rs,
                VisibilityManager* visibilityManager);
         boost::optional<Record> next() final;
+        bool nextBatch(size_t maxRecords, std::vector<Record>* batch) final;
         boost::optional<Record> seekExact(const RecordId& id) final override;
         void save() final;
         void saveUnpositioned() final override;
@@ -212,6 +213,7 @@ private:
                       const RecordStore& rs,
                       VisibilityManager* visibilityManager);
         boost::optional<Record> next() final;
+        bool nextBatch(size_t maxRecords, std::vector<Record>* batch) final;
         boost::optional<Record> seekExact(const RecordId& id) final override;
         void save() final;
         void saveUnpositioned() final override;
@@ -431,6 +431,9 @@ public:
                std::string prefixBSON,
                std::string KSForIdentEnd);
     virtual void setEndPosition(const BSONObj& key, bool inclusive) override;
+    virtual bool nextBatch(size_t maxEntries,
+                           std::vector<IndexKeyEntry>* batch,
+                           RequestedInfo parts = kKeyAndLoc) override;
     virtual boost::optional<IndexKeyEntry> seek(const KeyString::Value& keyString,
                                                 RequestedInfo parts = kKeyAndLoc) override;
     virtual boost::optional<KeyStringEntry> seekForKeyString(
@@ -549,6 +552,22 @@ CursorBase<CursorImpl>::CursorBase(OperationContext* opCtx,
       _KSForIdentStart(_KSForIdentStart),
       _KSForIdentEnd(identEndBSON) {}
 
+template <class CursorImpl>
+bool CursorBase<CursorImpl>::nextBatch(size_t maxEntries,
+                                       std::vector<IndexKeyEntry>* batch,
+                                       RequestedInfo parts) {
+    // The final cursor type resolves next() statically, and the keys it builds are owned.
+    batch->clear();
+    while (batch->size() < maxEntries) {
+        auto entry = static_cast<CursorImpl*>(this)->next(parts);
+        if (!entry) {
+            break;
+        }
+        batch->push_back(std::move(*entry));
+    }
+    return !batch->empty();
+}
+
 template <class CursorImpl>
 bool CursorBase<CursorImpl>::advanceNext() {
     if (!_atEOF) {
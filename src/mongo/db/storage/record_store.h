@@ -30,6 +30,7 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <vector>
 
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/bson/mutable/damage_vector.h"
@@ -111,6 +112,33 @@ public:
      */
     virtual boost::optional<Record> next() = 0;
 
+    /**
+     * Moves forward up to 'maxRecords' times, which must be positive, and replaces the contents of
+     * 'batch' with the records found in the direction of the scan. Returns false with an empty
+     * 'batch' once the cursor has reached EOF. Implementations may return fewer records than were
+     * asked for before reaching EOF, for instance to bound the memory used by a batch. The cursor
+     * is left positioned on the last record of the batch, as if next() had returned it.
+     *
+     * Unlike the data returned by next(), the data of the records in 'batch' does not point into
+     * the storage engine. It remains valid across save() and restore(), and until the next call to
+     * next(), nextBatch() or seekExact() or the destruction of the cursor.
+     *
+     * If this throws, 'batch' holds the records found before the error and the cursor is
+     * positioned on the last of them.
+     */
+    virtual bool nextBatch(size_t maxRecords, std::vector<Record>* batch) {
+        batch->clear();
+        while (batch->size() < maxRecords) {
+            auto record = next();
+            if (!record) {
+                break;
+            }
+            record->data.makeOwned();
+            batch->push_back(std::move(*record));
+        }
+        return !batch->empty();
+    }
+
     //
     // Saving and restoring state
     //
@@ -387,6 +387,58 @@ TEST(RecordStoreTestHarness, RecordIteratorSaveRestore) {
     }
 }
 
+// Insert multiple records and read them in batches in both directions, saving and restoring the
+// cursor between batches. The data of a batch must remain valid after the cursor is restored, and
+// each batch must pick up after the last record of the one before it.
+TEST(RecordStoreTestHarness, RecordIteratorNextBatch) {
+    const auto harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+
+    const int nToInsert = 10;
+    RecordId locs[nToInsert];
+    std::string datas[nToInsert];
+    for (int i = 0; i < nToInsert; i++) {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        {
+            StringBuilder sb;
+            sb << "record " << i;
+            string data = sb.str();
+
+            WriteUnitOfWork uow(opCtx.get());
+            StatusWith<RecordId> res =
+                rs->insertRecord(opCtx.get(), data.c_str(), data.size() + 1, Timestamp());
+            ASSERT_OK(res.getStatus());
+            locs[i] = res.getValue();
+            datas[i] = data;
+            uow.commit();
+        }
+    }
+
+    for (bool forward : {true, false}) {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        auto cursor = rs->getCursor(opCtx.get(), forward);
+
+        std::vector<Record> batch;
+        int numRead = 0;
+        while (cursor->nextBatch(4, &batch)) {
+            ASSERT_LTE(batch.size(), 4U);
+
+            cursor->save();
+            cursor->restore();
+
+            for (const auto& record : batch) {
+                const int i = forward ? numRead : nToInsert - 1 - numRead;
+                ASSERT_EQUALS(locs[i], record.id);
+                ASSERT_EQUALS(datas[i], record.data.data());
+                ++numRead;
+            }
+        }
+        ASSERT_EQUALS(nToInsert, numRead);
+        ASSERT(batch.empty());
+        ASSERT(!cursor->next());
+    }
+}
+
 // Insert two records, and iterate a cursor to EOF. Seek the same cursor to the first and ensure
 // that next() returns the second record.
 TEST(RecordStoreTestHarness, SeekAfterEofAndContinue) {
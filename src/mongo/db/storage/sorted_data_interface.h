@@ -30,6 +30,7 @@
 #include <boost/optional/optional.hpp>
 #include <boost/optional/optional_io.hpp>
 #include <memory>
+#include <vector>
 
 #include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context.h"
@@ -260,6 +261,30 @@ public:
         virtual boost::optional<IndexKeyEntry> next(RequestedInfo parts = kKeyAndLoc) = 0;
         virtual boost::optional<KeyStringEntry> nextKeyString() = 0;
 
+        /**
+         * Moves forward up to 'maxEntries' times, which must be positive, and replaces the contents
+         * of 'batch' with the entries found. Returns false with an empty 'batch' once there is no
+         * more data. The cursor is left positioned on the last entry of the batch, as if next()
+         * had returned it. Unlike the keys returned by next(), the keys in 'batch' are owned.
+         *
+         * If this throws, 'batch' holds the entries found before the error and the cursor is
+         * positioned on the last of them.
+         */
+        virtual bool nextBatch(size_t maxEntries,
+                               std::vector<IndexKeyEntry>* batch,
+                               RequestedInfo parts = kKeyAndLoc) {
+            batch->clear();
+            while (batch->size() < maxEntries) {
+                auto entry = next(parts);
+                if (!entry) {
+                    break;
+                }
+                entry->key = entry->key.getOwned();
+                batch->push_back(std::move(*entry));
+            }
+            return !batch->empty();
+        }
+
         //
         // Seeking
         //
@@ -176,6 +176,54 @@ TEST(SortedDataInterface, ExhaustKeyStringCursor) {
     }
 }
 
+// Read a forward cursor with an end position in batches, saving and restoring it between batches.
+// The batches must stop at the end position and the keys must remain valid across the restore.
+TEST(SortedDataInterface, ExhaustCursorInBatches) {
+    const auto harnessHelper(newSortedDataInterfaceHarnessHelper());
+    const std::unique_ptr<SortedDataInterface> sorted(
+        harnessHelper->newSortedDataInterface(/*unique=*/false, /*partial=*/false));
+
+    int nToInsert = 10;
+    for (int i = 0; i < nToInsert; i++) {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        {
+            WriteUnitOfWork uow(opCtx.get());
+            BSONObj key = BSON("" << i);
+            RecordId loc(42, i * 2);
+            ASSERT_OK(sorted->insert(opCtx.get(), makeKeyString(sorted.get(), key, loc), true));
+            uow.commit();
+        }
+    }
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        const std::unique_ptr<SortedDataInterface::Cursor> cursor(sorted->newCursor(opCtx.get()));
+        const int endKey = 7;
+        cursor->setEndPosition(BSON("" << endKey), true);
+        ASSERT_EQ(cursor->seek(makeKeyStringForSeek(sorted.get(), BSONObj(), true, true)),
+                  IndexKeyEntry(BSON("" << 0), RecordId(42, 0)));
+
+        std::vector<IndexKeyEntry> batch;
+        int i = 1;
+        while (cursor->nextBatch(3, &batch)) {
+            ASSERT_LTE(batch.size(), 3U);
+
+            cursor->save();
+            cursor->restore();
+
+            for (const auto& entry : batch) {
+                ASSERT_EQ(entry, IndexKeyEntry(BSON("" << i), RecordId(42, i * 2)));
+                ++i;
+            }
+        }
+        ASSERT_EQ(endKey + 1, i);
+        ASSERT(batch.empty());
+
+        // Cursor at EOF should remain at EOF when advanced
+        ASSERT(!cursor->next());
+    }
+}
+
 // Call advance() on a reverse cursor until it is exhausted.
 // When a cursor positioned at EOF is advanced, it stays at EOF.
 TEST(SortedDataInterface, ExhaustCursorReversed) {
@@ -866,6 +866,21 @@ public:
         return getKeyStringEntry();
     }
 
+    bool nextBatch(size_t maxEntries,
+                   std::vector<IndexKeyEntry>* batch,
+                   RequestedInfo parts) override {
+        // The keys built by curr() are already owned.
+        batch->clear();
+        while (batch->size() < maxEntries && advanceNext()) {
+            auto entry = curr(parts);
+            if (!entry) {
+                break;
+            }
+            batch->push_back(std::move(*entry));
+        }
+        return !batch->empty();
+    }
+
     void setEndPosition(const BSONObj& key, bool inclusive) override {
         LOGV2_TRACE_CURSOR(20098,
                            "setEndPosition inclusive: {inclusive} {key}",
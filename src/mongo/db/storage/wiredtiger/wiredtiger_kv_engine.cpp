@@ -90,7 +90,7 @@
 #include "mongo/platform/atomic_word.h"
 #include "mongo/util/background.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
-#include "mongo/util/concurrency/ticketholder.h"
+#include "mongo/util/concurrency/adaptive_ticketholder.h"
 #include "mongo/util/debug_util.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/log_and_backoff.h"
@@ -255,10 +255,112 @@ std::string toString(const StorageEngine::OldestActiveTransactionTimestampResult
 }
 
 namespace {
-TicketHolder openWriteTransaction(128);
-TicketHolder openReadTransaction(128);
+SemaphoreTicketHolder openWriteTransaction(128);
+SemaphoreTicketHolder openReadTransaction(128);
+
+// Used in place of the holders above when wiredTigerAdaptiveConcurrentTransactions is set at
+// startup. Both kinds are kept at the configured size, since the order in which startup parameters
+// are set is not defined.
+AdaptiveTicketHolder adaptiveOpenWriteTransaction(128);
+AdaptiveTicketHolder adaptiveOpenReadTransaction(128);
+
+TicketHolder& getWriteTicketHolder() {
+    if (gWiredTigerAdaptiveConcurrentTransactions.load()) {
+        return adaptiveOpenWriteTransaction;
+    }
+    return openWriteTransaction;
+}
+
+TicketHolder& getReadTicketHolder() {
+    if (gWiredTigerAdaptiveConcurrentTransactions.load()) {
+        return adaptiveOpenReadTransaction;
+    }
+    return openReadTransaction;
+}
+
+const Milliseconds kTicketAdjustmentInterval(100);
+
+// WiredTiger makes application threads help with eviction once this fraction of the cache is in
+// use, or this fraction of it is dirty, with its default eviction_trigger and
+// eviction_dirty_trigger settings.
+const double kEvictionTrigger = 0.95;
+const double kEvictionDirtyTrigger = 0.20;
+
+/**
+ * Returns how close the cache is to making application threads evict, as the larger of the in use
+ * and dirty fractions relative to their triggers. At 1 or more, operations already pay for
+ * eviction, and more concurrency would only make that worse.
+ */
+double getCachePressure(WT_SESSION* session) {
+    auto getStat = [&](int key) -> boost::optional<double> {
+        auto value =
+            WiredTigerUtil::getStatisticsValue(session, "statistics:", "statistics=(fast)", key);
+        if (!value.isOK()) {
+            return boost::none;
+        }
+        return static_cast<double>(value.getValue());
+    };
+
+    auto maxBytes = getStat(WT_STAT_CONN_CACHE_BYTES_MAX);
+    auto inUseBytes = getStat(WT_STAT_CONN_CACHE_BYTES_INUSE);
+    auto dirtyBytes = getStat(WT_STAT_CONN_CACHE_BYTES_DIRTY);
+    if (!maxBytes || !inUseBytes || !dirtyBytes || *maxBytes <= 0) {
+        return 0;
+    }
+    return std::max(*inUseBytes / (*maxBytes * kEvictionTrigger),
+                    *dirtyBytes / (*maxBytes * kEvictionDirtyTrigger));
+}
 }  // namespace
 
+/**
+ * Adjusts the number of read and write tickets to the load every kTicketAdjustmentInterval. Only
+ * runs when wiredTigerAdaptiveConcurrentTransactions is set.
+ */
+class WiredTigerKVEngine::WiredTigerTicketAdjuster : public BackgroundJob {
+public:
+    explicit WiredTigerTicketAdjuster(WT_CONNECTION* conn)
+        : BackgroundJob(false /* deleteSelf */), _conn(conn) {}
+
+    virtual string name() const {
+        return "WTTicketAdjuster";
+    }
+
+    virtual void run() {
+        ThreadClient tc(name(), getGlobalServiceContext());
+        LOGV2_DEBUG(5189000, 1, "starting {name} thread", "name"_attr = name());
+
+        WiredTigerSession session(_conn);
+        while (!_shuttingDown.load()) {
+            {
+                stdx::unique_lock<Latch> lock(_mutex);
+                MONGO_IDLE_THREAD_BLOCK;
+                _condvar.wait_for(lock, kTicketAdjustmentInterval.toSystemDuration());
+            }
+
+            const double cachePressure = getCachePressure(session.getSession());
+            adaptiveOpenWriteTransaction.adjust(cachePressure);
+            adaptiveOpenReadTransaction.adjust(cachePressure);
+        }
+        LOGV2_DEBUG(5189001, 1, "stopping {name} thread", "name"_attr = name());
+    }
+
+    void shutdown() {
+        _shuttingDown.store(true);
+        {
+            stdx::unique_lock<Latch> lock(_mutex);
+            _condvar.notify_one();
+        }
+        wait();
+    }
+
+private:
+    WT_CONNECTION* _conn;
+    AtomicWord<bool> _shuttingDown{false};
+
+    Mutex _mutex = MONGO_MAKE_LATCH("WiredTigerTicketAdjuster::_mutex");  // protects _condvar
+    stdx::condition_variable _condvar;
+};
+
 OpenWriteTransactionParam::OpenWriteTransactionParam(StringData name, ServerParameterType spt)
     : ServerParameter(name, spt), _data(&openWriteTransaction) {}
 
@@ -277,7 +379,11 @@ Status OpenWriteTransactionParam::setFromString(const std::string& str) {
     if (num <= 0) {
         return {ErrorCodes::BadValue, str::stream() << name() << " has to be > 0"};
     }
-    return _data->resize(num);
+    status = _data->resize(num);
+    if (!status.isOK()) {
+        return status;
+    }
+    return adaptiveOpenWriteTransaction.resize(num);
 }
 
 OpenReadTransactionParam::OpenReadTransactionParam(StringData name, ServerParameterType spt)
@@ -298,7 +404,11 @@ Status OpenReadTransactionParam::setFromString(const std::string& str) {
     if (num <= 0) {
         return {ErrorCodes::BadValue, str::stream() << name() << " has to be > 0"};
     }
-    return _data->resize(num);
+    status = _data->resize(num);
+    if (!status.isOK()) {
+        return status;
+    }
+    return adaptiveOpenReadTransaction.resize(num);
 }
 
 StringData WiredTigerKVEngine::kTableUriPrefix = "table:"_sd;
@@ -516,7 +626,11 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
 
     _sizeStorer = std::make_unique<WiredTigerSizeStorer>(_conn, _sizeStorerUri, _readOnly);
 
-    Locker::setGlobalThrottling(&openReadTransaction, &openWriteTransaction);
+    Locker::setGlobalThrottling(&getReadTicketHolder(), &getWriteTicketHolder());
+    if (gWiredTigerAdaptiveConcurrentTransactions.load()) {
+        _ticketAdjuster = std::make_unique<WiredTigerTicketAdjuster>(_conn);
+        _ticketAdjuster->go();
+    }
 
     _runTimeConfigParam.reset(new WiredTigerEngineRuntimeConfigParameter(
         "wiredTigerEngineRuntimeConfig", ServerParameterType::kRuntimeOnly));
@@ -541,16 +655,12 @@ void WiredTigerKVEngine::appendGlobalStats(BSONObjBuilder& b) {
     BSONObjBuilder bb(b.subobjStart("concurrentTransactions"));
     {
         BSONObjBuilder bbb(bb.subobjStart("write"));
-        bbb.append("out", openWriteTransaction.used());
-        bbb.append("available", openWriteTransaction.available());
-        bbb.append("totalTickets", openWriteTransaction.outof());
+        getWriteTicketHolder().appendStats(&bbb);
         bbb.done();
     }
     {
         BSONObjBuilder bbb(bb.subobjStart("read"));
-        bbb.append("out", openReadTransaction.used());
-        bbb.append("available", openReadTransaction.available());
-        bbb.append("totalTickets", openReadTransaction.outof());
+        getReadTicketHolder().appendStats(&bbb);
         bbb.done();
     }
     bb.done();
@@ -648,6 +758,12 @@ void WiredTigerKVEngine::_openWiredTiger(const std::string& path, const std::str
 
 void WiredTigerKVEngine::cleanShutdown() {
     LOGV2(22317, "WiredTigerKVEngine shutting down");
+    // The ticket adjuster uses a session of its own, so it is stopped first on every path out of
+    // here.
+    if (_ticketAdjuster) {
+        _ticketAdjuster->shutdown();
+        _ticketAdjuster.reset();
+    }
     WiredTigerUtil::resetTableLoggingInfo();
 
     if (!_readOnly)
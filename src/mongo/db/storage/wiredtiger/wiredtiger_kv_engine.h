@@ -379,6 +379,7 @@ public:
 
 private:
     class WiredTigerSessionSweeper;
+    class WiredTigerTicketAdjuster;
 
     /**
      * Opens a connection on the WiredTiger database 'path' with the configuration 'wtOpenConfig'.
@@ -467,6 +468,7 @@ private:
     const bool _keepDataHistory = true;
 
     std::unique_ptr<WiredTigerSessionSweeper> _sessionSweeper;
+    std::unique_ptr<WiredTigerTicketAdjuster> _ticketAdjuster;
 
     std::string _rsOptions;
     std::string _indexOptions;
@@ -2210,6 +2210,35 @@ boost::optional<Record> WiredTigerRecordStoreCursorBase::next() {
     return {{id, {static_cast<const char*>(value.data), static_cast<int>(value.size)}}};
 }
 
+bool WiredTigerRecordStoreCursorBase::nextBatch(size_t maxRecords, std::vector<Record>* batch) {
+    // Bounds the size of a batch, which may exceed it by the size of its last record.
+    static constexpr int kMaxBatchBytes = 1024 * 1024;
+
+    batch->clear();
+    _batchBuffer.reset();
+
+    // The data returned by next() is only valid until the cursor moves again, so each record is
+    // copied into '_batchBuffer'. The buffer may move as it grows, so the records are only pointed
+    // at their copies once the batch is complete, including when next() throws.
+    ON_BLOCK_EXIT([&] {
+        const char* data = _batchBuffer.buf();
+        for (auto& record : *batch) {
+            record.data = RecordData(data, record.data.size());
+            data += record.data.size();
+        }
+    });
+
+    while (batch->size() < maxRecords && _batchBuffer.len() < kMaxBatchBytes) {
+        auto record = WiredTigerRecordStoreCursorBase::next();
+        if (!record) {
+            break;
+        }
+        _batchBuffer.appendBuf(record->data.data(), record->data.size());
+        batch->push_back({record->id, RecordData(nullptr, record->data.size())});
+    }
+    return !batch->empty();
+}
+
 boost::optional<Record> WiredTigerRecordStoreCursorBase::seekExact(const RecordId& id) {
     invariant(_hasRestored);
     if (_oplogVisibleTs && id.repr() > *_oplogVisibleTs) {
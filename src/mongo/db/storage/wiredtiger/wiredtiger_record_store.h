@@ -34,6 +34,7 @@
 #include <string>
 #include <wiredtiger.h>
 
+#include "mongo/bson/util/builder.h"
 #include "mongo/db/catalog/collection_options.h"
 #include "mongo/db/storage/capped_callback.h"
 #include "mongo/db/storage/kv/kv_prefix.h"
@@ -448,6 +449,8 @@ public:
 
     boost::optional<Record> next();
 
+    bool nextBatch(size_t maxRecords, std::vector<Record>* batch);
+
     boost::optional<Record> seekExact(const RecordId& id);
 
     void save();
@@ -497,6 +500,9 @@ private:
      * established.
      */
     boost::optional<std::int64_t> _oplogVisibleTs = boost::none;
+
+    // Holds copies of the records returned by the last call to nextBatch().
+    BufBuilder _batchBuffer{0};
 };
 
 class WiredTigerRecordStoreStandardCursor final : public WiredTigerRecordStoreCursorBase {
@@ -57,10 +57,6 @@ public:
         return _range.getMax();
     }
 
-    const std::string& getMaxKeyString() const {
-        return _maxKeyString;
-    }
-
     const ShardId& getShardIdAt(const boost::optional<Timestamp>& ts) const;
 
     /**
@@ -108,7 +104,6 @@ public:
 
 private:
     const ChunkRange _range;
-    const std::string _maxKeyString;
 
     const ShardId _shardId;
 
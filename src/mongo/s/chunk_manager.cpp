@@ -64,18 +64,38 @@ void checkAllElementsAreOfType(BSONType type, const BSONObj& o) {
             allElementsAreOfType(type, o));
 }
 
+// Number of chunks in the blocks of a ChunkMap which createMerged() builds from the chunks of
+// consecutive changed blocks. Blocks next to changed chunks may hold fewer or up to twice as many.
+constexpr size_t kChunksPerBlock = 512;
+
+// A block smaller than this, which is next to changed chunks, is merged with the next block by
+// createMerged(), so that a routing table which is refreshed many times does not fragment into
+// tiny blocks.
+constexpr size_t kMinChunksPerBlock = kChunksPerBlock / 4;
+
+template <typename KeyString>
 void appendChunkTo(std::vector<std::shared_ptr<ChunkInfo>>& chunks,
-                   const std::shared_ptr<ChunkInfo>& chunk) {
+                   std::vector<KeyString>& maxKeyStrings,
+                   const std::shared_ptr<ChunkInfo>& chunk,
+                   KeyString maxKeyString) {
     if (!chunks.empty() && chunk->getRange().overlaps(chunks.back()->getRange())) {
         if (chunk->getLastmod() > chunks.back()->getLastmod()) {
-            chunks.pop_back();
-            chunks.push_back(chunk);
+            chunks.back() = chunk;
+            maxKeyStrings.back() = std::move(maxKeyString);
         }
     } else {
         chunks.push_back(chunk);
+        maxKeyStrings.push_back(std::move(maxKeyString));
     }
 }
 
+struct FlattenedChunks {
+    std::vector<std::shared_ptr<ChunkInfo>> chunks;
+
+    // The KeyString encoding of the max key of each chunk.
+    std::vector<std::string> maxKeyStrings;
+};
+
 // This function processes the passed in chunks by removing the older versions of any overlapping
 // chunks. The resulting chunks must be ordered by the maximum bound and not have any
 // overlapping chunks. In order to process the original set of chunks correctly which may have
@@ -84,120 +104,157 @@ void appendChunkTo(std::vector<std::shared_ptr<ChunkInfo>>& chunks,
 // precomputed KeyString representations of the maximum bounds, this function implements the same
 // algorithm by reverse sorting the chunks by the maximum before processing but then must
 // reverse the resulting collection before it is returned.
-std::vector<std::shared_ptr<ChunkInfo>> flatten(const std::vector<ChunkType>& changedChunks) {
+FlattenedChunks flatten(const std::vector<ChunkType>& changedChunks) {
     if (changedChunks.empty())
-        return std::vector<std::shared_ptr<ChunkInfo>>();
-
-    std::vector<std::shared_ptr<ChunkInfo>> changedChunkInfos(changedChunks.size());
-    std::transform(changedChunks.begin(),
-                   changedChunks.end(),
-                   changedChunkInfos.begin(),
-                   [](const auto& c) { return std::make_shared<ChunkInfo>(c); });
+        return FlattenedChunks();
+
+    std::vector<std::pair<std::string, std::shared_ptr<ChunkInfo>>> changedChunkInfos;
+    changedChunkInfos.reserve(changedChunks.size());
+    for (const auto& c : changedChunks) {
+        auto chunkInfo = std::make_shared<ChunkInfo>(c);
+        changedChunkInfos.emplace_back(ShardKeyPattern::toKeyString(chunkInfo->getMax()),
+                                       std::move(chunkInfo));
+    }
 
     std::sort(changedChunkInfos.begin(), changedChunkInfos.end(), [](const auto& a, const auto& b) {
-        return a->getMaxKeyString() > b->getMaxKeyString();
+        return a.first > b.first;
     });
 
-    std::vector<std::shared_ptr<ChunkInfo>> flattened;
-    flattened.reserve(changedChunkInfos.size());
-    flattened.push_back(changedChunkInfos[0]);
+    FlattenedChunks flattened;
+    flattened.chunks.reserve(changedChunkInfos.size());
+    flattened.maxKeyStrings.reserve(changedChunkInfos.size());
 
-    for (size_t i = 1; i < changedChunkInfos.size(); ++i) {
-        appendChunkTo(flattened, changedChunkInfos[i]);
+    for (auto& [maxKeyString, chunkInfo] : changedChunkInfos) {
+        appendChunkTo(
+            flattened.chunks, flattened.maxKeyStrings, chunkInfo, std::move(maxKeyString));
     }
 
-    std::reverse(flattened.begin(), flattened.end());
+    std::reverse(flattened.chunks.begin(), flattened.chunks.end());
+    std::reverse(flattened.maxKeyStrings.begin(), flattened.maxKeyStrings.end());
 
     return flattened;
 }
 
+// Checks the continuity of the routing table between two consecutive chunks.
+void checkContiguous(const ChunkInfo& prev, const ChunkInfo& next) {
+    const auto comparison = prev.getMax().woCompare(next.getMin());
+    if (comparison < 0) {
+        uasserted(ErrorCodes::ConflictingOperationInProgress,
+                  str::stream() << "Gap exists in the routing table between chunks "
+                                << prev.getRange().toString() << " and "
+                                << next.getRange().toString());
+    }
+    if (comparison > 0) {
+        uasserted(ErrorCodes::ConflictingOperationInProgress,
+                  str::stream() << "Overlap exists in the routing table between chunks "
+                                << prev.getRange().toString() << " and "
+                                << next.getRange().toString());
+    }
+}
+
 }  // namespace
 
-ShardVersionMap ChunkMap::constructShardVersionMap() const {
-    ShardVersionMap shardVersions;
-    ChunkVector::const_iterator current = _chunkMap.cbegin();
+size_t ChunkMap::KeyStringColumn::bound(StringData keyString, bool orEqual) const {
+    size_t low = 0;
+    size_t high = size();
+    while (low < high) {
+        const size_t mid = low + (high - low) / 2;
+        const int comparison = (*this)[mid].compare(keyString);
+        if (comparison < 0 || (comparison == 0 && !orEqual)) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
 
-    boost::optional<BSONObj> firstMin = boost::none;
-    boost::optional<BSONObj> lastMax = boost::none;
+ChunkMap::ChunkBlock::ChunkBlock(ChunkVector chunks, const std::vector<StringData>& maxKeyStrings)
+    : _chunks(std::move(chunks)) {
+    invariant(!_chunks.empty());
+    invariant(_chunks.size() == maxKeyStrings.size());
 
-    while (current != _chunkMap.cend()) {
-        const auto& firstChunkInRange = *current;
-        const auto& currentRangeShardId = firstChunkInRange->getShardIdAt(boost::none);
+    _maxKeyStrings.reserve(_chunks.size());
+    _maxVersion = _chunks.front()->getLastmod();
 
-        // Tracks the max shard version for the shard on which the current range will reside
-        auto shardVersionIt = shardVersions.find(currentRangeShardId);
-        if (shardVersionIt == shardVersions.end()) {
-            shardVersionIt =
-                shardVersions.emplace(currentRangeShardId, _collectionVersion.epoch()).first;
+    stdx::unordered_map<ShardId, ChunkVersion, ShardId::Hasher> shardVersions;
+    for (size_t i = 0; i < _chunks.size(); ++i) {
+        const auto& chunk = _chunks[i];
+        const auto& shardId = chunk->getShardIdAt(boost::none);
+
+        // Like constructShardVersionMap(), only check the continuity where the shard changes.
+        if (i > 0 && _chunks[i - 1]->getShardIdAt(boost::none) != shardId) {
+            checkContiguous(*_chunks[i - 1], *chunk);
         }
 
-        auto& maxShardVersion = shardVersionIt->second.shardVersion;
-
-        current =
-            std::find_if(current,
-                         _chunkMap.cend(),
-                         [&currentRangeShardId, &maxShardVersion](const auto& currentChunk) {
-                             if (currentChunk->getShardIdAt(boost::none) != currentRangeShardId)
-                                 return true;
-
-                             if (currentChunk->getLastmod() > maxShardVersion)
-                                 maxShardVersion = currentChunk->getLastmod();
-
-                             return false;
-                         });
-
-        const auto rangeLast = *std::prev(current);
-
-        const auto& rangeMin = firstChunkInRange->getMin();
-        const auto& rangeMax = rangeLast->getMax();
-
-        // Check the continuity of the chunks map
-        if (lastMax && !SimpleBSONObjComparator::kInstance.evaluate(*lastMax == rangeMin)) {
-            if (SimpleBSONObjComparator::kInstance.evaluate(*lastMax < rangeMin))
-                uasserted(ErrorCodes::ConflictingOperationInProgress,
-                          str::stream() << "Gap exists in the routing table between chunks "
-                                        << findIntersectingChunk(*lastMax)->getRange().toString()
-                                        << " and " << rangeLast->getRange().toString());
-            else
-                uasserted(ErrorCodes::ConflictingOperationInProgress,
-                          str::stream() << "Overlap exists in the routing table between chunks "
-                                        << findIntersectingChunk(*lastMax)->getRange().toString()
-                                        << " and " << rangeLast->getRange().toString());
+        _maxKeyStrings.push_back(maxKeyStrings[i]);
+
+        auto& maxShardVersion = shardVersions[shardId];
+        if (chunk->getLastmod() > maxShardVersion)
+            maxShardVersion = chunk->getLastmod();
+
+        if (chunk->getLastmod() > _maxVersion)
+            _maxVersion = chunk->getLastmod();
+    }
+
+    _shardVersions.assign(shardVersions.begin(), shardVersions.end());
+}
+
+ShardVersionMap ChunkMap::constructShardVersionMap() const {
+    ShardVersionMap shardVersions;
+
+    for (size_t b = 0; b < _blocks.size(); ++b) {
+        const auto& block = *_blocks[b];
+
+        // Check the continuity of the chunks map where one block ends and the next one starts.
+        // The continuity within each block was checked when it was built.
+        if (b > 0) {
+            const auto& prev = *_blocks[b - 1]->chunks().back();
+            const auto& next = *block.chunks().front();
+            if (prev.getShardIdAt(boost::none) != next.getShardIdAt(boost::none)) {
+                checkContiguous(prev, next);
+            }
         }
 
-        if (!firstMin)
-            firstMin = rangeMin;
+        // Tracks the max shard version for each shard on which the block has chunks
+        for (const auto& [shardId, blockShardVersion] : block.shardVersions()) {
+            auto shardVersionIt = shardVersions.find(shardId);
+            if (shardVersionIt == shardVersions.end()) {
+                shardVersionIt = shardVersions.emplace(shardId, _collectionVersion.epoch()).first;
+            }
 
-        lastMax = rangeMax;
+            auto& maxShardVersion = shardVersionIt->second.shardVersion;
+            if (blockShardVersion > maxShardVersion)
+                maxShardVersion = blockShardVersion;
 
-        // If a shard has chunks it must have a shard version, otherwise we have an invalid chunk
-        // somewhere, which should have been caught at chunk load time
-        invariant(maxShardVersion.isSet());
+            // If a shard has chunks it must have a shard version, otherwise we have an invalid
+            // chunk somewhere, which should have been caught at chunk load time
+            invariant(maxShardVersion.isSet());
+        }
     }
 
-    if (!_chunkMap.empty()) {
+    if (!_blocks.empty()) {
         invariant(!shardVersions.empty());
-        invariant(firstMin.is_initialized());
-        invariant(lastMax.is_initialized());
 
-        checkAllElementsAreOfType(MinKey, firstMin.get());
-        checkAllElementsAreOfType(MaxKey, lastMax.get());
+        checkAllElementsAreOfType(MinKey, _blocks.front()->chunks().front()->getMin());
+        checkAllElementsAreOfType(MaxKey, _blocks.back()->chunks().back()->getMax());
     }
 
     return shardVersions;
 }
 
-void ChunkMap::appendChunk(const std::shared_ptr<ChunkInfo>& chunk) {
-    appendChunkTo(_chunkMap, chunk);
-
-    _collectionVersion = std::max(_collectionVersion, chunk->getLastmod());
+void ChunkMap::_appendBlock(std::shared_ptr<const ChunkBlock> block) {
+    _blockMaxKeyStrings.push_back(block->maxKeyStrings()[block->size() - 1]);
+    _size += block->size();
+    _collectionVersion = std::max(_collectionVersion, block->getMaxVersion());
+    _blocks.push_back(std::move(block));
 }
 
 std::shared_ptr<ChunkInfo> ChunkMap::findIntersectingChunk(const BSONObj& shardKey) const {
-    const auto it = _findIntersectingChunk(shardKey);
+    const auto pos = _findIntersectingChunk(shardKey);
 
-    if (it != _chunkMap.end())
-        return *it;
+    if (pos.block < _blocks.size())
+        return _blocks[pos.block]->chunks()[pos.chunk];
 
     return std::shared_ptr<ChunkInfo>();
 }
@@ -213,40 +270,123 @@ void validateChunk(const std::shared_ptr<ChunkInfo>& chunk, const ChunkVersion&
 
 ChunkMap ChunkMap::createMerged(
     const std::vector<std::shared_ptr<ChunkInfo>>& changedChunks) const {
-    size_t chunkMapIndex = 0;
-    size_t changedChunkIndex = 0;
+    std::vector<std::string> changedMaxKeyStrings;
+    changedMaxKeyStrings.reserve(changedChunks.size());
+    for (const auto& chunk : changedChunks) {
+        changedMaxKeyStrings.push_back(ShardKeyPattern::toKeyString(chunk->getMax()));
+    }
+
+    return createMerged(changedChunks, changedMaxKeyStrings);
+}
+
+ChunkMap ChunkMap::createMerged(const std::vector<std::shared_ptr<ChunkInfo>>& changedChunks,
+                                const std::vector<std::string>& changedMaxKeyStrings) const {
+    invariant(changedChunks.size() == changedMaxKeyStrings.size());
+
+    ChunkMap updatedChunkMap(getVersion().epoch());
+    updatedChunkMap._blocks.reserve(_blocks.size() + changedChunks.size() / kChunksPerBlock + 1);
+
+    // The chunks appended to 'updatedChunkMap' which are not part of one of its blocks yet. Their
+    // KeyStrings point into the blocks of this map or into 'changedMaxKeyStrings'.
+    ChunkVector pendingChunks;
+    std::vector<StringData> pendingMaxKeyStrings;
+    std::shared_ptr<ChunkInfo> lastAppendedChunk;
+
+    auto flushPendingChunks = [&](size_t count) {
+        if (count == 0)
+            return;
 
-    ChunkMap updatedChunkMap(getVersion().epoch(), _chunkMap.size() + changedChunks.size());
+        updatedChunkMap._appendBlock(std::make_shared<ChunkBlock>(
+            ChunkVector(pendingChunks.begin(), pendingChunks.begin() + count),
+            std::vector<StringData>(pendingMaxKeyStrings.begin(),
+                                    pendingMaxKeyStrings.begin() + count)));
+        pendingChunks.erase(pendingChunks.begin(), pendingChunks.begin() + count);
+        pendingMaxKeyStrings.erase(pendingMaxKeyStrings.begin(),
+                                   pendingMaxKeyStrings.begin() + count);
+    };
+
+    auto appendChunk = [&](const std::shared_ptr<ChunkInfo>& chunk, StringData maxKeyString) {
+        appendChunkTo(pendingChunks, pendingMaxKeyStrings, chunk, maxKeyString);
+        lastAppendedChunk = pendingChunks.back();
+
+        // The last pending chunk may still be replaced by a newer chunk which overlaps it, so it
+        // must stay pending. Keeping a whole block's worth also avoids leaving a tiny remainder.
+        if (pendingChunks.size() >= 2 * kChunksPerBlock)
+            flushPendingChunks(kChunksPerBlock);
+    };
+
+    size_t blockIndex = 0;
+    size_t chunkIndex = 0;
+    size_t changedChunkIndex = 0;
 
-    while (chunkMapIndex < _chunkMap.size() || changedChunkIndex < changedChunks.size()) {
-        if (chunkMapIndex >= _chunkMap.size()) {
+    while (blockIndex < _blocks.size() || changedChunkIndex < changedChunks.size()) {
+        if (blockIndex >= _blocks.size()) {
             validateChunk(changedChunks[changedChunkIndex], getVersion());
-            updatedChunkMap.appendChunk(changedChunks[changedChunkIndex++]);
+            appendChunk(changedChunks[changedChunkIndex],
+                        changedMaxKeyStrings[changedChunkIndex]);
+            ++changedChunkIndex;
             continue;
         }
 
+        const auto& block = _blocks[blockIndex];
+        const auto& chunks = block->chunks();
+
+        if (chunkIndex == 0) {
+            // A block which no changed chunk overlaps is shared with the updated map as is.
+            const bool overlapsChangedChunk = changedChunkIndex < changedChunks.size() &&
+                chunks.front()->getMin().woCompare(changedChunks[changedChunkIndex]->getMax()) <
+                    0 &&
+                chunks.back()->getMax().woCompare(changedChunks[changedChunkIndex]->getMin()) > 0;
+            const bool overlapsLastAppendedChunk = lastAppendedChunk &&
+                lastAppendedChunk->getRange().overlaps(chunks.front()->getRange());
+
+            const bool mergeWithPendingChunks = !pendingChunks.empty() &&
+                pendingChunks.size() < kMinChunksPerBlock &&
+                pendingChunks.size() + chunks.size() <= 2 * kChunksPerBlock;
+
+            if (!overlapsChangedChunk && !overlapsLastAppendedChunk && !mergeWithPendingChunks) {
+                flushPendingChunks(pendingChunks.size());
+                updatedChunkMap._appendBlock(block);
+                lastAppendedChunk = chunks.back();
+                ++blockIndex;
+                continue;
+            }
+        }
+
+        const auto advance = [&] {
+            if (++chunkIndex == chunks.size()) {
+                ++blockIndex;
+                chunkIndex = 0;
+            }
+        };
+
         if (changedChunkIndex >= changedChunks.size()) {
-            updatedChunkMap.appendChunk(_chunkMap[chunkMapIndex++]);
+            appendChunk(chunks[chunkIndex], block->maxKeyStrings()[chunkIndex]);
+            advance();
             continue;
         }
 
-        auto overlap = _chunkMap[chunkMapIndex]->getRange().overlaps(
-            changedChunks[changedChunkIndex]->getRange());
+        auto overlap =
+            chunks[chunkIndex]->getRange().overlaps(changedChunks[changedChunkIndex]->getRange());
 
         if (overlap) {
-            auto& changedChunk = changedChunks[changedChunkIndex++];
-            auto& chunkInfo = _chunkMap[chunkMapIndex];
+            auto& changedChunk = changedChunks[changedChunkIndex];
+            auto& chunkInfo = chunks[chunkIndex];
 
             auto bytesInReplacedChunk = chunkInfo->getWritesTracker()->getBytesWritten();
             changedChunk->getWritesTracker()->addBytesWritten(bytesInReplacedChunk);
 
             validateChunk(changedChunk, getVersion());
-            updatedChunkMap.appendChunk(changedChunk);
+            appendChunk(changedChunk, changedMaxKeyStrings[changedChunkIndex]);
+            ++changedChunkIndex;
         } else {
-            updatedChunkMap.appendChunk(_chunkMap[chunkMapIndex++]);
+            appendChunk(chunks[chunkIndex], block->maxKeyStrings()[chunkIndex]);
+            advance();
         }
     }
 
+    flushPendingChunks(pendingChunks.size());
+
     return updatedChunkMap;
 }
 
@@ -254,48 +394,43 @@ BSONObj ChunkMap::toBSON() const {
     BSONObjBuilder builder;
 
     builder.append("startingVersion"_sd, getVersion().toBSON());
-    builder.append("chunkCount", static_cast<int64_t>(_chunkMap.size()));
+    builder.append("chunkCount", static_cast<int64_t>(size()));
 
     {
         BSONArrayBuilder arrayBuilder(builder.subarrayStart("chunks"_sd));
-        for (const auto& chunk : _chunkMap) {
+        forEach([&](const auto& chunk) {
             arrayBuilder.append(chunk->toString());
-        }
+            return true;
+        });
     }
 
     return builder.obj();
 }
 
-ChunkMap::ChunkVector::const_iterator ChunkMap::_findIntersectingChunk(const BSONObj& shardKey,
-                                                                       bool isMaxInclusive) const {
-    auto shardKeyString = ShardKeyPattern::toKeyString(shardKey);
+ChunkMap::Position ChunkMap::_findIntersectingChunk(const BSONObj& shardKey,
+                                                    bool isMaxInclusive) const {
+    const auto shardKeyString = ShardKeyPattern::toKeyString(shardKey);
 
-    if (!isMaxInclusive) {
-        return std::lower_bound(_chunkMap.begin(),
-                                _chunkMap.end(),
-                                shardKey,
-                                [&shardKeyString](const auto& chunkInfo, const BSONObj& shardKey) {
-                                    return chunkInfo->getMaxKeyString() < shardKeyString;
-                                });
-    } else {
-        return std::upper_bound(_chunkMap.begin(),
-                                _chunkMap.end(),
-                                shardKey,
-                                [&shardKeyString](const BSONObj& shardKey, const auto& chunkInfo) {
-                                    return shardKeyString < chunkInfo->getMaxKeyString();
-                                });
-    }
+    // The chunk which contains the key is the first one whose max key is greater than it, or
+    // greater than or equal to it if the max is inclusive. It is in the first block whose last max
+    // key satisfies the same condition.
+    const bool orEqual = !isMaxInclusive;
+    const size_t block = _blockMaxKeyStrings.bound(shardKeyString, orEqual);
+    if (block == _blocks.size())
+        return _end();
+
+    return {block, _blocks[block]->maxKeyStrings().bound(shardKeyString, orEqual)};
 }
 
-std::pair<ChunkMap::ChunkVector::const_iterator, ChunkMap::ChunkVector::const_iterator>
-ChunkMap::_overlappingBounds(const BSONObj& min, const BSONObj& max, bool isMaxInclusive) const {
-    const auto itMin = _findIntersectingChunk(min);
-    const auto itMax = [&]() {
-        auto it = _findIntersectingChunk(max, isMaxInclusive);
-        return it == _chunkMap.end() ? it : ++it;
+std::pair<ChunkMap::Position, ChunkMap::Position> ChunkMap::_overlappingBounds(
+    const BSONObj& min, const BSONObj& max, bool isMaxInclusive) const {
+    const auto posMin = _findIntersectingChunk(min);
+    const auto posMax = [&]() {
+        auto pos = _findIntersectingChunk(max, isMaxInclusive);
+        return pos.block == _blocks.size() ? pos : _next(pos);
     }();
 
-    return {itMin, itMax};
+    return {posMin, posMax};
 }
 
 ShardVersionTargetingInfo::ShardVersionTargetingInfo(const OID& epoch)
@@ -732,8 +867,8 @@ RoutingTableHistory RoutingTableHistory::makeNew(
 RoutingTableHistory RoutingTableHistory::makeUpdated(
     boost::optional<TypeCollectionReshardingFields> reshardingFields,
     const std::vector<ChunkType>& changedChunks) const {
-    auto changedChunkInfos = flatten(changedChunks);
-    auto chunkMap = _chunkMap.createMerged(changedChunkInfos);
+    auto flattened = flatten(changedChunks);
+    auto chunkMap = _chunkMap.createMerged(flattened.chunks, flattened.maxKeyStrings);
 
     // Only update the same collection.
     invariant(getVersion().epoch() == chunkMap.getVersion().epoch());
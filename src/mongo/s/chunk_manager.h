@@ -70,18 +70,103 @@ using ShardVersionMap = stdx::unordered_map<ShardId, ShardVersionTargetingInfo,
  * This class serves as a Facade around how the mapping of ranges to chunks is represented. It also
  * provides a simpler, high-level interface for domain specific operations without exposing the
  * underlying implementation.
+ *
+ * The chunks are kept ordered by max key in immutable blocks of a few hundred chunks each. The
+ * max keys of the chunks of a block are KeyString-encoded back to back in a single buffer, so that
+ * finding the chunk which contains a key compares bytes with memcmp instead of dereferencing the
+ * ChunkInfo of every chunk it visits. A ChunkMap made by createMerged() shares with the ChunkMap it
+ * was made from all the blocks which the changed chunks do not overlap, so that an incremental
+ * refresh only copies the blocks it changes.
  */
 class ChunkMap {
     // Vector of chunks ordered by max key.
     using ChunkVector = std::vector<std::shared_ptr<ChunkInfo>>;
 
+    /**
+     * KeyString-encoded keys in ascending order, stored back to back in one buffer.
+     */
+    class KeyStringColumn {
+    public:
+        void reserve(size_t numKeys) {
+            _ends.reserve(numKeys);
+        }
+
+        void push_back(StringData keyString) {
+            _bytes.append(keyString.rawData(), keyString.size());
+            _ends.push_back(_bytes.size());
+        }
+
+        size_t size() const {
+            return _ends.size();
+        }
+
+        StringData operator[](size_t i) const {
+            const size_t begin = i == 0 ? 0 : _ends[i - 1];
+            return StringData(_bytes.data() + begin, _ends[i] - begin);
+        }
+
+        /**
+         * Returns the index of the first key greater than 'keyString' or, if 'orEqual' is true, of
+         * the first key greater than or equal to it. Returns size() if there is no such key.
+         */
+        size_t bound(StringData keyString, bool orEqual) const;
+
+    private:
+        std::string _bytes;
+        std::vector<uint32_t> _ends;
+    };
+
+    /**
+     * A run of consecutive chunks, ordered by max key, together with the KeyString encodings of
+     * their max keys and the highest version of the chunks of each shard among them.
+     */
+    class ChunkBlock {
+    public:
+        /**
+         * Throws ConflictingOperationInProgress if there is a gap or an overlap between two
+         * consecutive chunks which belong to different shards.
+         */
+        ChunkBlock(ChunkVector chunks, const std::vector<StringData>& maxKeyStrings);
+
+        size_t size() const {
+            return _chunks.size();
+        }
+
+        const ChunkVector& chunks() const {
+            return _chunks;
+        }
+
+        const KeyStringColumn& maxKeyStrings() const {
+            return _maxKeyStrings;
+        }
+
+        const std::vector<std::pair<ShardId, ChunkVersion>>& shardVersions() const {
+            return _shardVersions;
+        }
+
+        ChunkVersion getMaxVersion() const {
+            return _maxVersion;
+        }
+
+    private:
+        ChunkVector _chunks;
+        KeyStringColumn _maxKeyStrings;
+        std::vector<std::pair<ShardId, ChunkVersion>> _shardVersions;
+        ChunkVersion _maxVersion;
+    };
+
+    // Position of a chunk, as the index of its block and its index in that block. The position
+    // past the last chunk is {_blocks.size(), 0}.
+    struct Position {
+        size_t block;
+        size_t chunk;
+    };
+
 public:
-    explicit ChunkMap(OID epoch, size_t initialCapacity = 0) : _collectionVersion(0, 0, epoch) {
-        _chunkMap.reserve(initialCapacity);
-    }
+    explicit ChunkMap(OID epoch) : _collectionVersion(0, 0, epoch) {}
 
     size_t size() const {
-        return _chunkMap.size();
+        return _size;
     }
 
     ChunkVersion getVersion() const {
@@ -90,12 +175,8 @@ public:
 
     template <typename Callable>
     void forEach(Callable&& handler, const BSONObj& shardKey = BSONObj()) const {
-        auto it = shardKey.isEmpty() ? _chunkMap.begin() : _findIntersectingChunk(shardKey);
-
-        for (; it != _chunkMap.end(); ++it) {
-            if (!handler(*it))
-                break;
-        }
+        const auto from = shardKey.isEmpty() ? Position{0, 0} : _findIntersectingChunk(shardKey);
+        _forEachBetween(from, _end(), handler);
     }
 
     template <typename Callable>
@@ -104,29 +185,61 @@ public:
                                  bool isMaxInclusive,
                                  Callable&& handler) const {
         const auto bounds = _overlappingBounds(min, max, isMaxInclusive);
-
-        for (auto it = bounds.first; it != bounds.second; ++it) {
-            if (!handler(*it))
-                break;
-        }
+        _forEachBetween(bounds.first, bounds.second, handler);
     }
 
     ShardVersionMap constructShardVersionMap() const;
     std::shared_ptr<ChunkInfo> findIntersectingChunk(const BSONObj& shardKey) const;
 
-    void appendChunk(const std::shared_ptr<ChunkInfo>& chunk);
-
     ChunkMap createMerged(const std::vector<std::shared_ptr<ChunkInfo>>& changedChunks) const;
 
+    /**
+     * Same as above, for callers which already have the KeyString encoding of the max key of every
+     * changed chunk.
+     */
+    ChunkMap createMerged(const std::vector<std::shared_ptr<ChunkInfo>>& changedChunks,
+                          const std::vector<std::string>& changedMaxKeyStrings) const;
+
     BSONObj toBSON() const;
 
 private:
-    ChunkVector::const_iterator _findIntersectingChunk(const BSONObj& shardKey,
-                                                       bool isMaxInclusive = true) const;
-    std::pair<ChunkVector::const_iterator, ChunkVector::const_iterator> _overlappingBounds(
-        const BSONObj& min, const BSONObj& max, bool isMaxInclusive) const;
+    Position _end() const {
+        return {_blocks.size(), 0};
+    }
+
+    Position _next(Position pos) const {
+        if (++pos.chunk == _blocks[pos.block]->size()) {
+            return {pos.block + 1, 0};
+        }
+        return pos;
+    }
+
+    template <typename Callable>
+    void _forEachBetween(Position from, Position to, Callable& handler) const {
+        for (size_t b = from.block; b < _blocks.size() && b <= to.block; ++b) {
+            const auto& chunks = _blocks[b]->chunks();
+            const size_t first = b == from.block ? from.chunk : 0;
+            const size_t last = b == to.block ? to.chunk : chunks.size();
+            for (size_t i = first; i < last; ++i) {
+                if (!handler(chunks[i]))
+                    return;
+            }
+        }
+    }
+
+    void _appendBlock(std::shared_ptr<const ChunkBlock> block);
+
+    Position _findIntersectingChunk(const BSONObj& shardKey, bool isMaxInclusive = true) const;
+    std::pair<Position, Position> _overlappingBounds(const BSONObj& min,
+                                                     const BSONObj& max,
+                                                     bool isMaxInclusive) const;
+
+    std::vector<std::shared_ptr<const ChunkBlock>> _blocks;
+
+    // The KeyString encoding of the max key of the last chunk of each block.
+    KeyStringColumn _blockMaxKeyStrings;
 
-    ChunkVector _chunkMap;
+    size_t _size = 0;
 
     // Max version across all chunks
     ChunkVersion _collectionVersion;
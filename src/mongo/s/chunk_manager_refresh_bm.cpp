@@ -36,6 +36,7 @@
 #include "mongo/platform/random.h"
 #include "mongo/s/chunk_manager.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/processinfo.h"
 #include "mongo/util/str.h"
 
 namespace mongo {
@@ -354,6 +355,72 @@ void BM_RangeOverlapsChunk(benchmark::State& state,
     state.SetItemsProcessed(state.iterations());
 }
 
+template <typename CollectionMetadataBuilderFn>
+void BM_ConcurrentFindIntersectingChunk(benchmark::State& state,
+                                        CollectionMetadataBuilderFn makeCollectionMetadata) {
+    static boost::optional<CollectionMetadata> metadata;
+    static std::vector<BSONObj> keys;
+
+    const int nShards = state.range(0);
+    const int nChunks = state.range(1);
+
+    // The benchmark threads only start iterating once thread 0 has built the routing table.
+    if (state.thread_index == 0) {
+        metadata.emplace(makeCollectionMetadata(nShards, nChunks));
+        keys = makeKeys(nChunks);
+    }
+
+    size_t i = state.thread_index * 7919;
+    for (auto keepRunning : state) {
+        const auto& cm = metadata->getChunkManager();
+        benchmark::DoNotOptimize(
+            cm->findIntersectingChunkWithSimpleCollation(keys[i++ % keys.size()]));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+
+    if (state.thread_index == 0) {
+        metadata.reset();
+        keys.clear();
+    }
+}
+
+/**
+ * Reports how much the resident memory of the process grows to hold one routing table. RSS is only
+ * reported in megabytes, so this is meaningful for large numbers of chunks.
+ */
+template <typename ShardSelectorFn>
+void BM_ResidentMemoryOfChunkManager(benchmark::State& state, ShardSelectorFn selectShard) {
+    const int nShards = state.range(0);
+    const uint32_t nChunks = state.range(1);
+
+    const auto collEpoch = OID::gen();
+    const auto shardKeyPattern = KeyPattern(BSON("_id" << 1));
+
+    std::vector<ChunkType> chunks;
+    chunks.reserve(nChunks);
+
+    for (uint32_t i = 0; i < nChunks; ++i) {
+        chunks.emplace_back(kNss,
+                            getRangeForChunk(i, nChunks),
+                            ChunkVersion{i + 1, 0, collEpoch},
+                            selectShard(i, nShards, nChunks));
+    }
+
+    ProcessInfo processInfo;
+    int residentMBDelta = 0;
+    for (auto keepRunning : state) {
+        const int residentMBBefore = processInfo.getResidentSize();
+        auto rt = RoutingTableHistory::makeNew(
+            kNss, UUID::gen(), shardKeyPattern, nullptr, true, collEpoch, boost::none, chunks);
+        residentMBDelta = processInfo.getResidentSize() - residentMBBefore;
+        benchmark::DoNotOptimize(rt);
+    }
+
+    state.counters["residentMB"] = residentMBDelta;
+    state.counters["residentBytesPerChunk"] = double(residentMBDelta) * 1024 * 1024 / nChunks;
+}
+
 // The following was adapted from the BENCHMARK_CAPTURE() macro where the
 // benchmark::internal::Benchmark* is returned rather than declared as a static variable.
 #define REGISTER_BENCHMARK_CAPTURE(func, test_case_name, ...) \
@@ -393,7 +460,34 @@ MONGO_INITIALIZER(RegisterBenchmarks)(InitializerContext* context) {
             ->Args({10, 50000})
             ->Args({100, 50000})
             ->Args({1000, 50000})
-            ->Args({2, 2});
+            ->Args({2, 2})
+            ->Args({10, 500000});
+    }
+
+    // Targeting throughput of many threads which share one routing table, as on a busy mongos.
+    std::initializer_list<benchmark::internal::Benchmark*> concurrentCases{
+        REGISTER_BENCHMARK_CAPTURE(BM_ConcurrentFindIntersectingChunk,
+                                   Pessimal,
+                                   makeChunkManagerWithPessimalBalancedDistribution),
+        REGISTER_BENCHMARK_CAPTURE(BM_ConcurrentFindIntersectingChunk,
+                                   Optimal,
+                                   makeChunkManagerWithOptimalBalancedDistribution),
+    };
+
+    for (auto bmCase : concurrentCases) {
+        bmCase->Args({10, 500000})->Threads(1)->Threads(8)->Threads(32)->UseRealTime();
+    }
+
+    // A single iteration each, since memory released by the allocator is not returned to the
+    // operating system right away.
+    std::initializer_list<benchmark::internal::Benchmark*> memoryCases{
+        REGISTER_BENCHMARK_CAPTURE(
+            BM_ResidentMemoryOfChunkManager, Pessimal, pessimalShardSelector),
+        REGISTER_BENCHMARK_CAPTURE(BM_ResidentMemoryOfChunkManager, Optimal, optimalShardSelector),
+    };
+
+    for (auto bmCase : memoryCases) {
+        bmCase->Args({10, 500000})->Args({10, 1000000})->Iterations(1);
     }
 
     return Status::OK();
@@ -38,6 +38,7 @@ namespace {
 
 const NamespaceString kNss("TestDB", "TestColl");
 const ShardId kThisShard("testShard");
+const ShardId kOtherShard("otherShard");
 
 class ChunkMapTest : public unittest::Test {
 public:
@@ -45,6 +46,32 @@ public:
         return _shardKeyPattern;
     }
 
+    std::shared_ptr<ChunkInfo> makeChunk(const BSONObj& min,
+                                         const BSONObj& max,
+                                         const ChunkVersion& version,
+                                         const ShardId& shard = kThisShard) const {
+        return std::make_shared<ChunkInfo>(ChunkType{kNss, ChunkRange{min, max}, version, shard});
+    }
+
+    /**
+     * Returns a chunk map with 'numChunks' chunks, whose chunk i covers [10 * (i - 1), 10 * i),
+     * except for the first and last ones which extend to MinKey and MaxKey. The chunks alternate
+     * between two shards.
+     */
+    ChunkMap makeChunkMap(const OID& epoch, int numChunks) const {
+        std::vector<std::shared_ptr<ChunkInfo>> chunks;
+        for (int i = 0; i < numChunks; ++i) {
+            const auto min = i == 0 ? getShardKeyPattern().globalMin() : BSON("a" << 10 * (i - 1));
+            const auto max =
+                i == numChunks - 1 ? getShardKeyPattern().globalMax() : BSON("a" << 10 * i);
+            chunks.push_back(makeChunk(min,
+                                       max,
+                                       ChunkVersion(i + 1, 0, epoch),
+                                       i % 2 == 0 ? kThisShard : kOtherShard));
+        }
+        return ChunkMap{epoch}.createMerged(chunks);
+    }
+
 private:
     KeyPattern _shardKeyPattern{BSON("a" << 1)};
 };
@@ -165,4 +192,107 @@ TEST_F(ChunkMapTest, TestEnumerateOverlappingChunks) {
     ASSERT_EQ(count, 3);
 }
 
-}  // namespace mongo
\ No newline at end of file
+TEST_F(ChunkMapTest, TestIntersectingChunkInLargeMap) {
+    const OID epoch = OID::gen();
+    const int numChunks = 5000;
+    auto chunkMap = makeChunkMap(epoch, numChunks);
+
+    ASSERT_EQ(chunkMap.size(), numChunks);
+    ASSERT_EQ(chunkMap.getVersion(), ChunkVersion(numChunks, 0, epoch));
+    ASSERT_EQ(chunkMap.constructShardVersionMap().size(), 2);
+
+    for (int key = -5; key < 10 * numChunks; key += 7) {
+        auto chunk = chunkMap.findIntersectingChunk(BSON("a" << key));
+        ASSERT(chunk);
+        ASSERT(chunk->containsKey(BSON("a" << key)));
+    }
+
+    int count = 0;
+    auto lastMax = getShardKeyPattern().globalMin();
+    chunkMap.forEach([&](const auto& chunkInfo) {
+        ASSERT_BSONOBJ_EQ(chunkInfo->getMin(), lastMax);
+        lastMax = chunkInfo->getMax();
+        count++;
+        return true;
+    });
+    ASSERT_EQ(count, numChunks);
+    ASSERT_BSONOBJ_EQ(lastMax, getShardKeyPattern().globalMax());
+
+    // Ranges which cross the boundaries between the blocks of the map.
+    for (int first = 0; first < numChunks - 1500; first += 499) {
+        count = 0;
+        chunkMap.forEachOverlappingChunk(
+            BSON("a" << 10 * first + 5), BSON("a" << 10 * (first + 1000)), false, [&](auto&) {
+                count++;
+                return true;
+            });
+        ASSERT_EQ(count, 1000);
+    }
+}
+
+TEST_F(ChunkMapTest, TestMergeChangedChunksIntoLargeMap) {
+    const OID epoch = OID::gen();
+    const int numChunks = 5000;
+    auto chunkMap = makeChunkMap(epoch, numChunks);
+
+    // Split the chunk [25990, 26000) and move the chunk [30000, 30010) to the other shard.
+    auto version = chunkMap.getVersion();
+    version.incMajor();
+    auto splitLow = makeChunk(BSON("a" << 25990), BSON("a" << 25995), version);
+    version.incMinor();
+    auto splitHigh = makeChunk(BSON("a" << 25995), BSON("a" << 26000), version);
+    version.incMajor();
+    auto moved = makeChunk(BSON("a" << 30000), BSON("a" << 30010), version, kOtherShard);
+
+    const auto unchangedChunk = chunkMap.findIntersectingChunk(BSON("a" << 40000));
+    auto newChunkMap = chunkMap.createMerged({splitLow, splitHigh, moved});
+
+    ASSERT_EQ(chunkMap.size(), numChunks);
+    ASSERT_EQ(newChunkMap.size(), numChunks + 1);
+    ASSERT_EQ(newChunkMap.getVersion(), version);
+    ASSERT(newChunkMap.findIntersectingChunk(BSON("a" << 25993)) == splitLow);
+    ASSERT(newChunkMap.findIntersectingChunk(BSON("a" << 25995)) == splitHigh);
+    ASSERT(newChunkMap.findIntersectingChunk(BSON("a" << 30005)) == moved);
+    ASSERT(newChunkMap.findIntersectingChunk(BSON("a" << 40000)) == unchangedChunk);
+    ASSERT_EQ(newChunkMap.constructShardVersionMap().at(kOtherShard).shardVersion, version);
+
+    // The original map is unchanged.
+    ASSERT_BSONOBJ_EQ(chunkMap.findIntersectingChunk(BSON("a" << 25993))->getMax(),
+                      BSON("a" << 26000));
+}
+
+TEST_F(ChunkMapTest, TestRepeatedMergesIntoLargeMap) {
+    const OID epoch = OID::gen();
+    const int numChunks = 3000;
+    auto chunkMap = makeChunkMap(epoch, numChunks);
+
+    // Split many chunks one refresh at a time, so that the map is rebuilt around each of them.
+    const int numSplits = 300;
+    for (int i = 0; i < numSplits; ++i) {
+        const int min = 10 * ((i * 37) % (numChunks - 2));
+        auto version = chunkMap.getVersion();
+        version.incMajor();
+        auto low = makeChunk(BSON("a" << min), BSON("a" << min + 5), version);
+        version.incMinor();
+        auto high = makeChunk(BSON("a" << min + 5), BSON("a" << min + 10), version);
+        chunkMap = chunkMap.createMerged({low, high});
+
+        ASSERT(chunkMap.findIntersectingChunk(BSON("a" << min)) == low);
+        ASSERT(chunkMap.findIntersectingChunk(BSON("a" << min + 9)) == high);
+    }
+
+    ASSERT_EQ(chunkMap.size(), numChunks + numSplits);
+    ASSERT_EQ(chunkMap.constructShardVersionMap().size(), 2);
+
+    size_t count = 0;
+    auto lastMax = getShardKeyPattern().globalMin();
+    chunkMap.forEach([&](const auto& chunkInfo) {
+        ASSERT_BSONOBJ_EQ(chunkInfo->getMin(), lastMax);
+        lastMax = chunkInfo->getMax();
+        count++;
+        return true;
+    });
+    ASSERT_EQ(count, chunkMap.size());
+}
+
+}  // namespace mongo
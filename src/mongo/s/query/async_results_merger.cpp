@@ -39,6 +39,7 @@
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/kill_cursors_gen.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/executor/remote_command_response.h"
 #include "mongo/s/catalog/type_shard.h"
@@ -105,13 +106,18 @@ AsyncResultsMerger::AsyncResultsMerger(OperationContext* opCtx,
       // since that is not supported we treat boost::none (unspecified) to mean 'kNormal'.
       _tailableMode(params.getTailableMode().value_or(TailableModeEnum::kNormal)),
       _params(std::move(params)),
-      _mergeQueue(MergingComparator(
-          _remotes, _params.getSort().value_or(BSONObj()), _params.getCompareWholeSortKey())),
       _promisedMinSortKeys(PromisedMinSortKeyComparator(_params.getSort().value_or(BSONObj()))) {
     if (params.getTxnNumber()) {
         invariant(params.getSessionId());
     }
 
+    // Sort keys are encoded as KeyStrings when they are received, unless the sort pattern has more
+    // fields than an Ordering can describe.
+    if (_params.getSort() &&
+        static_cast<size_t>(_params.getSort()->nFields()) <= Ordering::kMaxCompoundIndexKeys) {
+        _sortKeyOrdering = Ordering::make(*_params.getSort());
+    }
+
     size_t remoteIndex = 0;
     for (const auto& remote : _params.getRemotes()) {
         _remotes.emplace_back(remote.getHostAndPort(),
@@ -221,6 +227,7 @@ void AsyncResultsMerger::addNewShardCursors(std::vector<RemoteCursor>&& newCurso
                               remote.getCursorResponse().getPartialResultsReturned());
         _addBatchToBuffer(lk, newIndex, remote.getCursorResponse());
     }
+    _mergeTree.invalidate();
 }
 
 bool AsyncResultsMerger::partialResultsReturned() const {
@@ -307,11 +314,11 @@ bool AsyncResultsMerger::_readySorted(WithLock lk) {
 }
 
 bool AsyncResultsMerger::_readySortedTailable(WithLock lk) {
-    if (_mergeQueue.empty()) {
+    if (_mergeTree.empty()) {
         return false;
     }
 
-    auto smallestRemote = _mergeQueue.top();
+    auto smallestRemote = _mergeTree.top();
     auto smallestResult = _remotes[smallestRemote].docBuffer.front();
     auto keyWeWantToReturn =
         extractSortKey(*smallestResult.getResult(), _params.getCompareWholeSortKey());
@@ -355,29 +362,30 @@ StatusWith<ClusterQueryResult> AsyncResultsMerger::nextReady() {
     return _params.getSort() ? _nextReadySorted(lk) : _nextReadyUnsorted(lk);
 }
 
-ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
+ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock lk) {
     // Tailable non-awaitData cursors cannot have a sort.
     invariant(_tailableMode != TailableModeEnum::kTailable);
 
-    if (_mergeQueue.empty()) {
+    if (_mergeTree.empty()) {
         return {};
     }
 
-    size_t smallestRemote = _mergeQueue.top();
-    _mergeQueue.pop();
+    size_t smallestRemote = _mergeTree.top();
 
     invariant(!_remotes[smallestRemote].docBuffer.empty());
     invariant(_remotes[smallestRemote].status.isOK());
 
     ClusterQueryResult front = _remotes[smallestRemote].docBuffer.front();
     _remotes[smallestRemote].docBuffer.pop();
-
-    // Re-populate the merging queue with the next result from 'smallestRemote', if it has a
-    // next result.
-    if (!_remotes[smallestRemote].docBuffer.empty()) {
-        _mergeQueue.push(smallestRemote);
+    if (_sortKeyOrdering) {
+        _remotes[smallestRemote].sortKeyBuffer.pop();
     }
 
+    // Replay the matches of 'smallestRemote' against its next result, if it has a next result.
+    _mergeTree.replayTop();
+
+    _prefetchNextBatchIfNeeded(lk, smallestRemote);
+
     // For sorted tailable awaitData cursors, update the high water mark to the document's sort key.
     if (_tailableMode == TailableModeEnum::kTailableAndAwaitData) {
         if (_remotes[smallestRemote].eligibleForHighWaterMark) {
@@ -420,6 +428,41 @@ ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock) {
     return {};
 }
 
+int AsyncResultsMerger::_compareNextResults(size_t lhsIndex, size_t rhsIndex) const {
+    const auto& lhs = _remotes[lhsIndex];
+    const auto& rhs = _remotes[rhsIndex];
+
+    if (_sortKeyOrdering) {
+        const auto& lhsKey = lhs.sortKeyBuffer.front();
+        const auto& rhsKey = rhs.sortKeyBuffer.front();
+        return KeyString::compare(lhsKey.data(), rhsKey.data(), lhsKey.size(), rhsKey.size());
+    }
+
+    return compareSortKeys(
+        extractSortKey(*lhs.docBuffer.front().getResult(), _params.getCompareWholeSortKey()),
+        extractSortKey(*rhs.docBuffer.front().getResult(), _params.getCompareWholeSortKey()),
+        *_params.getSort());
+}
+
+void AsyncResultsMerger::_prefetchNextBatchIfNeeded(WithLock lk, size_t remoteIndex) {
+    auto& remote = _remotes[remoteIndex];
+
+    // Batches of tailable cursors are only requested once the previous batch has been returned,
+    // and remotes without buffered results are asked for their next batch by nextEvent().
+    if (_tailableMode != TailableModeEnum::kNormal || !_opCtx || _lifecycleState != kAlive ||
+        !remote.status.isOK() || remote.exhausted() || remote.cbHandle.isValid() ||
+        !remote.hasNext()) {
+        return;
+    }
+
+    if (remote.docBuffer.size() * 2 > remote.lastBatchSize) {
+        return;
+    }
+
+    // An error scheduling the getMore is reported by the next call to ready().
+    remote.status = _askForNextBatch(lk, remoteIndex);
+}
+
 Status AsyncResultsMerger::_askForNextBatch(WithLock, size_t remoteIndex) {
     invariant(_opCtx, "Cannot schedule a getMore without an OperationContext");
     auto& remote = _remotes[remoteIndex];
@@ -709,8 +752,13 @@ void AsyncResultsMerger::_cleanUpFailedBatch(WithLock lk, Status status, size_t
     if (_params.getAllowPartialResults() || remote.status == ErrorCodes::ExchangePassthrough) {
         // Clear the results buffer and cursor id, and set 'partialResultsReturned' if appropriate.
         remote.partialResultsReturned = (remote.status != ErrorCodes::ExchangePassthrough);
+        if (remote.hasNext()) {
+            _mergeTree.invalidate();
+        }
         std::queue<ClusterQueryResult> emptyBuffer;
         std::swap(remote.docBuffer, emptyBuffer);
+        std::queue<std::string> emptySortKeyBuffer;
+        std::swap(remote.sortKeyBuffer, emptySortKeyBuffer);
         remote.status = Status::OK();
         remote.cursorId = 0;
     }
@@ -766,6 +814,18 @@ bool AsyncResultsMerger::_addBatchToBuffer(WithLock lk,
                                            const CursorResponse& response) {
     auto& remote = _remotes[remoteIndex];
     _updateRemoteMetadata(lk, remoteIndex, response);
+
+    // A remote which had no buffered results before this batch changes its next result, and so
+    // must rejoin the merge.
+    if (_params.getSort() && !remote.hasNext() && !response.getBatch().empty()) {
+        _mergeTree.invalidate();
+    }
+
+    boost::optional<KeyString::Builder> sortKeyBuilder;
+    if (_sortKeyOrdering) {
+        sortKeyBuilder.emplace(KeyString::Version::kLatestVersion, *_sortKeyOrdering);
+    }
+
     for (const auto& obj : response.getBatch()) {
         // If there's a sort, we're expecting the remote node to have given us back a sort key.
         if (_params.getSort()) {
@@ -783,6 +843,15 @@ bool AsyncResultsMerger::_addBatchToBuffer(WithLock lk,
                                          << "' was not of type Object in document: " << obj);
                 return false;
             }
+
+            if (sortKeyBuilder) {
+                sortKeyBuilder->resetToEmpty(*_sortKeyOrdering);
+                for (auto&& elem : extractSortKey(obj, _params.getCompareWholeSortKey())) {
+                    sortKeyBuilder->appendBSONElement(elem);
+                }
+                remote.sortKeyBuffer.emplace(sortKeyBuilder->getBuffer(),
+                                             sortKeyBuilder->getSize());
+            }
         }
 
         ClusterQueryResult result(obj);
@@ -790,10 +859,8 @@ bool AsyncResultsMerger::_addBatchToBuffer(WithLock lk,
         ++remote.fetchedCount;
     }
 
-    // If we're doing a sorted merge, then we have to make sure to put this remote onto the merge
-    // queue.
-    if (_params.getSort() && !response.getBatch().empty()) {
-        _mergeQueue.push(remoteIndex);
+    if (!response.getBatch().empty()) {
+        remote.lastBatchSize = response.getBatch().size();
     }
     return true;
 }
@@ -907,16 +974,75 @@ bool AsyncResultsMerger::RemoteCursorData::exhausted() const {
 }
 
 //
-// AsyncResultsMerger::MergingComparator
+// AsyncResultsMerger::MergeTree
 //
 
-bool AsyncResultsMerger::MergingComparator::operator()(const size_t& lhs, const size_t& rhs) {
-    const ClusterQueryResult& leftDoc = _remotes[lhs].docBuffer.front();
-    const ClusterQueryResult& rightDoc = _remotes[rhs].docBuffer.front();
+bool AsyncResultsMerger::MergeTree::empty() {
+    if (!_built) {
+        _build();
+    }
+    return _nodes.empty() || !_merger->_remotes[_nodes[0]].hasNext();
+}
+
+size_t AsyncResultsMerger::MergeTree::top() {
+    if (!_built) {
+        _build();
+    }
+    invariant(!_nodes.empty());
+    return _nodes[0];
+}
+
+void AsyncResultsMerger::MergeTree::replayTop() {
+    if (!_built) {
+        _build();
+        return;
+    }
+
+    size_t winner = _nodes[0];
+    for (size_t pos = (_nodes.size() + winner) / 2; pos > 0; pos /= 2) {
+        if (_beats(_nodes[pos], winner)) {
+            std::swap(_nodes[pos], winner);
+        }
+    }
+    _nodes[0] = winner;
+}
+
+void AsyncResultsMerger::MergeTree::_build() {
+    const size_t numRemotes = _merger->_remotes.size();
+    _nodes.assign(numRemotes, 0);
+    _built = true;
+    if (numRemotes == 0) {
+        return;
+    }
+
+    // Play the matches bottom-up, recording the winner of each match in 'winners' and its loser in
+    // '_nodes'.
+    std::vector<size_t> winners(2 * numRemotes);
+    for (size_t remoteIndex = 0; remoteIndex < numRemotes; ++remoteIndex) {
+        winners[numRemotes + remoteIndex] = remoteIndex;
+    }
+    for (size_t pos = numRemotes - 1; pos > 0; --pos) {
+        size_t winner = winners[2 * pos];
+        size_t loser = winners[2 * pos + 1];
+        if (_beats(loser, winner)) {
+            std::swap(winner, loser);
+        }
+        winners[pos] = winner;
+        _nodes[pos] = loser;
+    }
+    _nodes[0] = winners[1];
+}
+
+bool AsyncResultsMerger::MergeTree::_beats(size_t lhs, size_t rhs) const {
+    if (!_merger->_remotes[lhs].hasNext()) {
+        return false;
+    }
+    if (!_merger->_remotes[rhs].hasNext()) {
+        return true;
+    }
 
-    return compareSortKeys(extractSortKey(*leftDoc.getResult(), _compareWholeSortKey),
-                           extractSortKey(*rightDoc.getResult(), _compareWholeSortKey),
-                           _sort) > 0;
+    auto cmp = _merger->_compareNextResults(lhs, rhs);
+    return cmp < 0 || (cmp == 0 && lhs < rhs);
 }
 
 bool AsyncResultsMerger::PromisedMinSortKeyComparator::operator()(
@@ -35,6 +35,7 @@
 
 #include "mongo/base/status_with.h"
 #include "mongo/bson/bsonobj.h"
+#include "mongo/bson/ordering.h"
 #include "mongo/db/cursor_id.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/platform/mutex.h"
@@ -64,8 +65,10 @@ class CursorResponse;
  *
  * Task-scheduling behavior differs depending on whether there is a sort. If the result documents
  * must be sorted, we pass the sort through to the remote nodes and then merge the sorted streams.
- * This requires waiting until we have a response from every remote before returning results.
- * Without a sort, we are ready to return results as soon as we have *any* response from a remote.
+ * This requires waiting until we have a response from every remote before returning results, so
+ * for non-tailable sorted merges the next batch is requested from a remote while it still has
+ * buffered results. Without a sort, we are ready to return results as soon as we have *any*
+ * response from a remote.
  *
  * On any error, the caller is responsible for shutting down the ARM using the kill() method.
  *
@@ -88,8 +91,8 @@ public:
      * the hosts on which they exist in _remotes.
      *
      * Additionally copies each remote's first batch of results, if one exists, into that remote's
-     * docBuffer. If a sort is specified in the ClusterClientCursorParams, places the remotes with
-     * buffered results onto _mergeQueue.
+     * docBuffer. If a sort is specified in the ClusterClientCursorParams, the remotes with buffered
+     * results are merged through _mergeTree.
      *
      * The TaskExecutor* must remain valid for the lifetime of the ARM.
      *
@@ -308,6 +311,15 @@ private:
         // The buffer of results that have been retrieved but not yet returned to the caller.
         std::queue<ClusterQueryResult> docBuffer;
 
+        // If there is a sort which can be encoded as a KeyString, holds the KeyString encodings of
+        // the sort keys of the results in 'docBuffer', in the same order. They are computed once
+        // when a batch is received, so that the merge compares sort keys with a memcmp.
+        std::queue<std::string> sortKeyBuffer;
+
+        // The number of results in the last non-empty batch received from this remote. Used to
+        // decide when to request the next batch of a sorted merge ahead of time.
+        size_t lastBatchSize = 0;
+
         // Is valid if there is currently a pending request to this remote.
         executor::TaskExecutor::CallbackHandle cbHandle;
 
@@ -320,24 +332,61 @@ private:
         long long fetchedCount = 0;
     };
 
-    class MergingComparator {
+    /**
+     * A loser tree over the remotes of a sorted merge, whose winner is the remote with the next
+     * result in sort order. Each internal node records the remote which lost the match between the
+     * winners of its two subtrees, so that once the winner's first buffered result is consumed,
+     * only the matches on the path from its leaf to the root are replayed, with one comparison per
+     * level. Remotes without buffered results lose every match.
+     *
+     * The tree is built lazily, and must be invalidated whenever the first buffered result of a
+     * remote other than the winner changes, or remotes are added.
+     */
+    class MergeTree {
     public:
-        MergingComparator(const std::vector<RemoteCursorData>& remotes,
-                          const BSONObj& sort,
-                          bool compareWholeSortKey)
-            : _remotes(remotes), _sort(sort), _compareWholeSortKey(compareWholeSortKey) {}
+        explicit MergeTree(const AsyncResultsMerger* merger) : _merger(merger) {}
+
+        /**
+         * Returns true if no remote has a buffered result.
+         */
+        bool empty();
 
-        bool operator()(const size_t& lhs, const size_t& rhs);
+        /**
+         * Returns the index into '_remotes' of the remote with the next result in sort order.
+         * Invalid to call if empty() is true.
+         */
+        size_t top();
+
+        /**
+         * Restores the tree after the first buffered result of the remote returned by top() has
+         * been consumed.
+         */
+        void replayTop();
+
+        /**
+         * Forces the tree to be rebuilt before its next use.
+         */
+        void invalidate() {
+            _built = false;
+        }
 
     private:
-        const std::vector<RemoteCursorData>& _remotes;
+        void _build();
 
-        const BSONObj _sort;
+        /**
+         * Returns true if the next result of remote 'lhs' sorts before that of remote 'rhs'. Ties
+         * are broken by the remote index, so that this is a strict total order.
+         */
+        bool _beats(size_t lhs, size_t rhs) const;
 
-        // When '_compareWholeSortKey' is true, $sortKey is a scalar value, rather than an object.
-        // We extract the sort key {$sortKey: <value>}. The sort key pattern '_sort' is verified to
-        // be {$sortKey: 1}.
-        const bool _compareWholeSortKey;
+        const AsyncResultsMerger* const _merger;
+
+        // '_nodes[0]' is the overall winner and '_nodes[i]', for 0 < i < _nodes.size(), is the
+        // loser of the match at internal node i. The leaf of remote r is at position
+        // _nodes.size() + r, and the parent of position p is at p / 2.
+        std::vector<size_t> _nodes;
+
+        bool _built = false;
     };
 
     using MinSortKeyRemoteIdPair = std::pair<BSONObj, size_t>;
@@ -393,6 +442,19 @@ private:
     ClusterQueryResult _nextReadySorted(WithLock);
     ClusterQueryResult _nextReadyUnsorted(WithLock);
 
+    /**
+     * Returns an int less than 0, 0, or greater than 0 if the first buffered result of the remote
+     * at 'lhsIndex' sorts before, the same as, or after that of the remote at 'rhsIndex'. Both
+     * remotes must have buffered results.
+     */
+    int _compareNextResults(size_t lhsIndex, size_t rhsIndex) const;
+
+    /**
+     * For non-tailable sorted merges, asks the remote at 'remoteIndex' for its next batch once it
+     * has consumed half of its last batch, so that the merge does not have to wait for it.
+     */
+    void _prefetchNextBatchIfNeeded(WithLock, size_t remoteIndex);
+
     using CbData = executor::TaskExecutor::RemoteCommandCallbackArgs;
     using CbResponse = executor::TaskExecutor::ResponseStatus;
 
@@ -483,12 +545,16 @@ private:
     // Must be acquired before accessing any data members (other than _params, which is read-only).
     mutable Mutex _mutex = MONGO_MAKE_LATCH("AsyncResultsMerger::_mutex");
 
+    // The ordering of the sort key pattern, if there is a sort with few enough fields for its sort
+    // keys to be encoded as KeyStrings. Otherwise sort keys are compared as BSON.
+    boost::optional<Ordering> _sortKeyOrdering;
+
     // Data tracking the state of our communication with each of the remote nodes.
     std::vector<RemoteCursorData> _remotes;
 
-    // The top of this priority queue is the index into '_remotes' for the remote host that has the
-    // next document to return, according to the sort order. Used only if there is a sort.
-    std::priority_queue<size_t, std::vector<size_t>, MergingComparator> _mergeQueue;
+    // The winner of this tree is the index into '_remotes' for the remote host that has the next
+    // document to return, according to the sort order. Used only if there is a sort.
+    MergeTree _mergeTree{this};
 
     // The index into '_remotes' for the remote from which we are currently retrieving results.
     // Used only if there is *not* a sort.
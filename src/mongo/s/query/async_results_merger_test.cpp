@@ -469,6 +469,123 @@ TEST_F(AsyncResultsMergerTest, SortedButNoSortKey) {
     executor()->waitForEvent(killEvent);
 }
 
+TEST_F(AsyncResultsMergerTest, SortedMergeOfManyShardsWithMixedTypeSortKeys) {
+    BSONObj findCmd = fromjson("{find: 'testcoll', sort: {a: -1, b: 1}}");
+    const BSONObj sortPattern = BSON("a" << -1 << "b" << 1);
+    const size_t kNumRemotes = 40;
+    const size_t kNumResults = 400;
+
+    // Generate sort keys whose first component mixes numeric types and strings, sort them, and
+    // deal them out to the remotes so that the batch of every remote is in sort order.
+    std::vector<BSONObj> results;
+    for (size_t i = 0; i < kNumResults; ++i) {
+        BSONArrayBuilder sortKey;
+        switch (i % 4) {
+            case 0:
+                sortKey.append(static_cast<int>(i % 50));
+                break;
+            case 1:
+                sortKey.append(static_cast<long long>(i % 30));
+                break;
+            case 2:
+                sortKey.append(static_cast<double>(i % 40) + 0.5);
+                break;
+            default:
+                sortKey.append("s" + std::to_string(i % 10));
+        }
+        sortKey.append(static_cast<int>(i % 7));
+        results.push_back(BSON("_id" << static_cast<int>(i) << "$sortKey" << sortKey.arr()));
+    }
+    auto sortKeyOf = [](const BSONObj& result) {
+        return result["$sortKey"].embeddedObject();
+    };
+    std::sort(results.begin(), results.end(), [&](const BSONObj& lhs, const BSONObj& rhs) {
+        return sortKeyOf(lhs).woCompare(sortKeyOf(rhs), sortPattern, false) < 0;
+    });
+
+    std::vector<std::vector<BSONObj>> batches(kNumRemotes);
+    for (size_t i = 0; i < results.size(); ++i) {
+        batches[i % kNumRemotes].push_back(results[i]);
+    }
+    std::vector<RemoteCursor> cursors;
+    for (size_t i = 0; i < kNumRemotes; ++i) {
+        cursors.push_back(makeRemoteCursor(kTestShardIds[i % kTestShardIds.size()],
+                                           kTestShardHosts[i % kTestShardHosts.size()],
+                                           CursorResponse(kTestNss, 0, std::move(batches[i]))));
+    }
+    auto arm = makeARMFromExistingCursors(std::move(cursors), findCmd);
+
+    // ARM returns all results in sorted order.
+    boost::optional<BSONObj> previous;
+    for (size_t i = 0; i < kNumResults; ++i) {
+        ASSERT_TRUE(arm->ready());
+        auto next = unittest::assertGet(arm->nextReady());
+        ASSERT_FALSE(next.isEOF());
+        auto result = next.getResult()->getOwned();
+        if (previous) {
+            ASSERT_LTE(sortKeyOf(*previous).woCompare(sortKeyOf(result), sortPattern, false), 0);
+        }
+        previous = result;
+    }
+    ASSERT_TRUE(arm->ready());
+    ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
+}
+
+TEST_F(AsyncResultsMergerTest, SortedMergeRequestsNextBatchBeforeBufferIsEmpty) {
+    BSONObj findCmd = fromjson("{find: 'testcoll', sort: {_id: 1}}");
+    std::vector<BSONObj> firstBatch1 = {fromjson("{$sortKey: [1]}"),
+                                        fromjson("{$sortKey: [3]}"),
+                                        fromjson("{$sortKey: [5]}"),
+                                        fromjson("{$sortKey: [7]}")};
+    std::vector<BSONObj> firstBatch2 = {fromjson("{$sortKey: [2]}"),
+                                        fromjson("{$sortKey: [4]}"),
+                                        fromjson("{$sortKey: [6]}"),
+                                        fromjson("{$sortKey: [8]}")};
+    std::vector<RemoteCursor> cursors;
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[0], kTestShardHosts[0], CursorResponse(kTestNss, 5, std::move(firstBatch1))));
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[1], kTestShardHosts[1], CursorResponse(kTestNss, 0, std::move(firstBatch2))));
+    auto arm = makeARMFromExistingCursors(std::move(cursors), findCmd);
+
+    ASSERT_TRUE(arm->ready());
+    ASSERT_FALSE(networkHasReadyRequests());
+    ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: [1]}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: [2]}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_FALSE(networkHasReadyRequests());
+
+    // Once half of the first shard's batch has been returned, ARM asks it for the next batch while
+    // it is still ready to return the buffered results.
+    ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: [3]}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_TRUE(networkHasReadyRequests());
+    auto getMoreCmd = getNthPendingRequest(0).cmdObj;
+    ASSERT_EQ(getMoreCmd.firstElementFieldNameStringData(), "getMore"_sd);
+    ASSERT_EQ(getMoreCmd.firstElement().numberLong(), 5);
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: [4]}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: [5]}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+
+    // The first shard responds before its buffer runs out.
+    std::vector<CursorResponse> responses;
+    std::vector<BSONObj> batch = {fromjson("{$sortKey: [9]}"), fromjson("{$sortKey: [10]}")};
+    responses.emplace_back(kTestNss, CursorId(0), batch);
+    scheduleNetworkResponses(std::move(responses));
+    ASSERT_TRUE(arm->remotesExhausted());
+
+    for (int i = 6; i <= 10; ++i) {
+        ASSERT_TRUE(arm->ready());
+        ASSERT_BSONOBJ_EQ(BSON("$sortKey" << BSON_ARRAY(i)),
+                          *unittest::assertGet(arm->nextReady()).getResult());
+    }
+    ASSERT_TRUE(arm->ready());
+    ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
+}
+
 TEST_F(AsyncResultsMergerTest, HasFirstBatch) {
     std::vector<BSONObj> firstBatch = {
         fromjson("{_id: 1}"), fromjson("{_id: 2}"), fromjson("{_id: 3}")};
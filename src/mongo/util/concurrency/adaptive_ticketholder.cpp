@@ -0,0 +1,274 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/concurrency/adaptive_ticketholder.h"
+
+#include <algorithm>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/util/system_tick_source.h"
+
+namespace mongo {
+namespace {
+
+// How quickly the baseline hold time follows hold times above it, per call to adjust().
+const double kBaselineRiseRate = 0.01;
+
+}  // namespace
+
+AdaptiveTicketHolder::AdaptiveTicketHolder(int maxTickets, TickSource* tickSource)
+    : _tickSource(tickSource), _limit(maxTickets), _maxTickets(maxTickets) {}
+
+bool AdaptiveTicketHolder::tryAcquire() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (_used >= _limit.load() || !_normalQueue.empty() || !_lowQueue.empty()) {
+        return false;
+    }
+    _accumulateInUse(lk);
+    ++_used;
+    return true;
+}
+
+bool AdaptiveTicketHolder::_waitForTicketUntil(OperationContext* opCtx,
+                                               Date_t until,
+                                               Priority priority) {
+    stdx::unique_lock<Latch> lk(_mutex);
+    if (_used < _limit.load() && _normalQueue.empty() && _lowQueue.empty()) {
+        _accumulateInUse(lk);
+        ++_used;
+        return true;
+    }
+
+    Waiter waiter;
+    auto& queue = _queue(priority);
+    queue.push_back(&waiter);
+    _queuedDuringInterval = true;
+
+    auto granted = [&] {
+        return waiter.granted;
+    };
+    try {
+        bool acquired = true;
+        if (until == Date_t::max()) {
+            if (opCtx) {
+                opCtx->waitForConditionOrInterrupt(waiter.cv, lk, granted);
+            } else {
+                waiter.cv.wait(lk, granted);
+            }
+        } else if (opCtx) {
+            acquired = opCtx->waitForConditionOrInterruptUntil(waiter.cv, lk, until, granted);
+        } else {
+            acquired = waiter.cv.wait_until(lk, until.toSystemTimePoint(), granted);
+        }
+
+        if (!acquired) {
+            queue.erase(std::find(queue.begin(), queue.end(), &waiter));
+        }
+        return acquired;
+    } catch (...) {
+        if (!lk.owns_lock()) {
+            lk.lock();
+        }
+        // The ticket may have been handed over just before the wait was interrupted.
+        if (waiter.granted) {
+            _release(lk, false /* completed */);
+        } else {
+            queue.erase(std::find(queue.begin(), queue.end(), &waiter));
+        }
+        throw;
+    }
+}
+
+void AdaptiveTicketHolder::release() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    _release(lk, true /* completed */);
+}
+
+void AdaptiveTicketHolder::_release(WithLock lk, bool completed) {
+    invariant(_used > 0);
+    _accumulateInUse(lk);
+    --_used;
+    if (completed) {
+        ++_released;
+    }
+    _grantWaiters(lk);
+}
+
+Status AdaptiveTicketHolder::resize(int newSize) {
+    if (newSize < kMinTickets) {
+        return Status(ErrorCodes::BadValue,
+                      str::stream() << "Minimum value for tickets is " << kMinTickets
+                                    << "; given " << newSize);
+    }
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    _maxTickets = newSize;
+    _setLimit(lk, _adjusting ? std::min(_limit.load(), newSize) : newSize);
+    return Status::OK();
+}
+
+int AdaptiveTicketHolder::available() const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    return std::max(_limit.load() - _used, 0);
+}
+
+int AdaptiveTicketHolder::used() const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    return _used;
+}
+
+int AdaptiveTicketHolder::outof() const {
+    return _limit.load();
+}
+
+int AdaptiveTicketHolder::queued() const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    return _normalQueue.size() + _lowQueue.size();
+}
+
+void AdaptiveTicketHolder::adjust(double cachePressure) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    _adjusting = true;
+    _cachePressure = cachePressure;
+    _accumulateInUse(lk);
+
+    const auto now = _lastInUseChange;
+    if (_intervalStart == 0 || now <= _intervalStart) {
+        _intervalStart = now;
+        _inUseTicks = 0;
+        _released = 0;
+        return;
+    }
+
+    if (_released > 0) {
+        // By Little's law, the mean time a ticket was held is the mean number of tickets in use
+        // divided by the rate at which they were released.
+        const auto elapsed = now - _intervalStart;
+        const double meanInUse = _inUseTicks / elapsed;
+        const double intervalMicros =
+            durationCount<Microseconds>(_getTickSource()->ticksTo<Microseconds>(elapsed));
+        _latencyMicros = meanInUse * intervalMicros / _released;
+
+        if (_baselineLatencyMicros == 0 || _latencyMicros < _baselineLatencyMicros) {
+            _baselineLatencyMicros = _latencyMicros;
+        } else {
+            _baselineLatencyMicros += (_latencyMicros - _baselineLatencyMicros) * kBaselineRiseRate;
+        }
+    }
+
+    // Longer hold times only point at overload if requests also had to wait for tickets. Without
+    // a queue they more likely come from a shift to longer operations, which fewer tickets would
+    // not help.
+    const bool overloaded = _queuedDuringInterval && _released > 0 &&
+        _latencyMicros > kLatencyTolerance * _baselineLatencyMicros;
+
+    const int limit = _limit.load();
+    int newLimit = limit;
+    if (cachePressure >= 1.0 || overloaded) {
+        newLimit = std::max(kMinTickets, static_cast<int>(limit * kDecreaseFactor));
+    } else if (_queuedDuringInterval) {
+        newLimit = std::min(_maxTickets, limit + 1);
+    }
+
+    if (newLimit > limit) {
+        ++_increases;
+    } else if (newLimit < limit) {
+        ++_decreases;
+    }
+    _setLimit(lk, newLimit);
+
+    _intervalStart = now;
+    _inUseTicks = 0;
+    _released = 0;
+    _queuedDuringInterval = !_normalQueue.empty() || !_lowQueue.empty();
+}
+
+void AdaptiveTicketHolder::reset() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    _adjusting = false;
+    _intervalStart = 0;
+    _setLimit(lk, _maxTickets);
+}
+
+void AdaptiveTicketHolder::_appendImplStats(BSONObjBuilder* b) const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    b->append("maxTickets", _maxTickets);
+    b->append("adjusting", _adjusting);
+    b->append("latencyMicros", _latencyMicros);
+    b->append("baselineLatencyMicros", _baselineLatencyMicros);
+    b->append("cachePressure", _cachePressure);
+    b->append("limitIncreases", _increases);
+    b->append("limitDecreases", _decreases);
+}
+
+TickSource* AdaptiveTicketHolder::_getTickSource() const {
+    return _tickSource ? _tickSource : SystemTickSource::get();
+}
+
+void AdaptiveTicketHolder::_accumulateInUse(WithLock) {
+    const auto now = _getTickSource()->getTicks();
+    if (_lastInUseChange != 0) {
+        _inUseTicks += static_cast<double>(_used) * (now - _lastInUseChange);
+    }
+    _lastInUseChange = now;
+}
+
+void AdaptiveTicketHolder::_grantWaiters(WithLock lk) {
+    while (_used < _limit.load()) {
+        Waiter* waiter;
+        if (!_lowQueue.empty() &&
+            (_normalQueue.empty() || _normalGrantsSinceLowGrant >= kNormalGrantsPerLowGrant)) {
+            waiter = _lowQueue.front();
+            _lowQueue.pop_front();
+            _normalGrantsSinceLowGrant = 0;
+        } else if (!_normalQueue.empty()) {
+            waiter = _normalQueue.front();
+            _normalQueue.pop_front();
+            if (!_lowQueue.empty()) {
+                ++_normalGrantsSinceLowGrant;
+            }
+        } else {
+            break;
+        }
+
+        _accumulateInUse(lk);
+        ++_used;
+        waiter->granted = true;
+        waiter->cv.notify_one();
+    }
+}
+
+void AdaptiveTicketHolder::_setLimit(WithLock lk, int limit) {
+    _limit.store(limit);
+    _grantWaiters(lk);
+}
+
+}  // namespace mongo
@@ -0,0 +1,168 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+
+#include "mongo/util/concurrency/ticketholder.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/tick_source.h"
+
+namespace mongo {
+
+/**
+ * A TicketHolder whose number of tickets adapts to the load, between a floor of kMinTickets and a
+ * ceiling set through resize().
+ *
+ * Requests that cannot be admitted right away wait in two FIFO queues, one per priority. Freed
+ * tickets go to the normal priority queue first, except that every kNormalGrantsPerLowGrant-th
+ * ticket goes to the low priority queue if it is not empty, so that neither queue starves.
+ *
+ * The owner calls adjust() periodically. Each call derives the mean time tickets were held during
+ * the last interval from the mean number of tickets in use and the number released (Little's
+ * law), and then adjusts the limit the way additive increase/multiplicative decrease congestion
+ * control does:
+ *  - the limit shrinks by kDecreaseFactor if the caller reports cache pressure, or if requests
+ *    had to queue during the interval and the mean hold time exceeds kLatencyTolerance times the
+ *    baseline hold time observed at low load;
+ *  - otherwise the limit grows by one ticket if requests had to queue during the interval;
+ *  - otherwise it is left alone, since more tickets would not be used.
+ */
+class AdaptiveTicketHolder final : public TicketHolder {
+public:
+    static constexpr int kMinTickets = 5;
+    static constexpr int kNormalGrantsPerLowGrant = 8;
+    static constexpr double kDecreaseFactor = 0.9;
+    static constexpr double kLatencyTolerance = 2.0;
+
+    /**
+     * Starts with 'maxTickets' tickets. Uses the system tick source if 'tickSource' is null, which
+     * allows instances to be created before the global initializers have run.
+     */
+    explicit AdaptiveTicketHolder(int maxTickets, TickSource* tickSource = nullptr);
+
+    bool tryAcquire() override;
+
+    void release() override;
+
+    /**
+     * Sets the ceiling of the limit. Lowering it below the current limit lowers the limit too;
+     * requests holding tickets keep them until they release them.
+     */
+    Status resize(int newSize) override;
+
+    int available() const override;
+
+    int used() const override;
+
+    /**
+     * Returns the current limit.
+     */
+    int outof() const override;
+
+    /**
+     * Returns the number of requests waiting for a ticket.
+     */
+    int queued() const;
+
+    /**
+     * Adjusts the limit from the load observed since the previous call. 'cachePressure' is at
+     * least 1 when the storage engine cache is too full for more concurrency to help.
+     */
+    void adjust(double cachePressure);
+
+    /**
+     * Returns the limit to its ceiling, for when adjusting is disabled.
+     */
+    void reset();
+
+private:
+    struct Waiter {
+        stdx::condition_variable cv;
+        bool granted = false;
+    };
+
+    bool _waitForTicketUntil(OperationContext* opCtx, Date_t until, Priority priority) override;
+
+    void _appendImplStats(BSONObjBuilder* b) const override;
+
+    TickSource* _getTickSource() const;
+
+    /**
+     * Accounts for the tickets in use since the last change in their number. Must be called
+     * before any change to '_used'.
+     */
+    void _accumulateInUse(WithLock);
+
+    /**
+     * Hands out free tickets to the queued requests.
+     */
+    void _grantWaiters(WithLock);
+
+    void _setLimit(WithLock, int limit);
+
+    void _release(WithLock, bool completed);
+
+    std::deque<Waiter*>& _queue(Priority priority) {
+        return priority == Priority::kNormal ? _normalQueue : _lowQueue;
+    }
+
+    TickSource* const _tickSource;
+
+    mutable Mutex _mutex =
+        MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(0), "AdaptiveTicketHolder::_mutex");
+
+    // The limit can be read without the mutex, but only changes under it.
+    AtomicWord<int> _limit;
+    int _maxTickets;
+    int _used = 0;
+    bool _adjusting = false;
+
+    std::deque<Waiter*> _normalQueue;
+    std::deque<Waiter*> _lowQueue;
+    int _normalGrantsSinceLowGrant = 0;
+
+    // Load observed since the interval began, at the previous call to adjust().
+    TickSource::Tick _intervalStart = 0;
+    TickSource::Tick _lastInUseChange = 0;
+    double _inUseTicks = 0;
+    long long _released = 0;
+    bool _queuedDuringInterval = false;
+
+    // Mean ticket hold time in microseconds during the last interval, and the baseline it is
+    // compared against. The baseline follows lower hold times at once and higher ones slowly.
+    double _latencyMicros = 0;
+    double _baselineLatencyMicros = 0;
+    double _cachePressure = 0;
+    long long _increases = 0;
+    long long _decreases = 0;
+};
+
+}  // namespace mongo
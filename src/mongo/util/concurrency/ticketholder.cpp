@@ -35,11 +35,70 @@
 
 #include <iostream>
 
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/logv2/log.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/str.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
+bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until, Priority priority) {
+    // Attempt to get a ticket without waiting in order to avoid expensive time calculations.
+    if (tryAcquire()) {
+        return true;
+    }
+
+    auto& queued = _queued[static_cast<size_t>(priority)];
+    queued.fetchAndAdd(1);
+    ON_BLOCK_EXIT([&] { queued.fetchAndSubtract(1); });
+
+    Timer timer;
+    const bool acquired = _waitForTicketUntil(opCtx, until, priority);
+    _recordWait(Microseconds(timer.micros()), acquired);
+    return acquired;
+}
+
+void TicketHolder::_recordWait(Microseconds waitTime, bool acquired) {
+    if (!acquired) {
+        _timedOut.fetchAndAdd(1);
+        return;
+    }
+
+    size_t bucket = 0;
+    while (bucket < kWaitTimeBucketBoundsMillis.size() &&
+           waitTime >= Milliseconds(kWaitTimeBucketBoundsMillis[bucket])) {
+        ++bucket;
+    }
+    _waitTimeBuckets[bucket].fetchAndAdd(1);
+    _totalWaitMicros.fetchAndAdd(durationCount<Microseconds>(waitTime));
+}
+
+void TicketHolder::appendStats(BSONObjBuilder* b) const {
+    b->append("out", used());
+    b->append("available", available());
+    b->append("totalTickets", outof());
+    {
+        BSONObjBuilder queued(b->subobjStart("queued"));
+        queued.append("normal", _queued[static_cast<size_t>(Priority::kNormal)].load());
+        queued.append("low", _queued[static_cast<size_t>(Priority::kLow)].load());
+    }
+    {
+        BSONObjBuilder waits(b->subobjStart("waits"));
+        waits.append("totalWaitMicros", _totalWaitMicros.load());
+        waits.append("timedOut", _timedOut.load());
+
+        BSONObjBuilder histogram(waits.subobjStart("histogram"));
+        for (size_t bucket = 0; bucket < kWaitTimeBucketBoundsMillis.size(); ++bucket) {
+            histogram.append(str::stream() << "lt" << kWaitTimeBucketBoundsMillis[bucket] << "ms",
+                             _waitTimeBuckets[bucket].load());
+        }
+        histogram.append(str::stream() << "ge" << kWaitTimeBucketBoundsMillis.back() << "ms",
+                         _waitTimeBuckets.back().load());
+    }
+    _appendImplStats(b);
+}
+
 #if defined(__linux__)
 namespace {
 
@@ -71,15 +130,15 @@ void tsFromDate(const Date_t& deadline, struct timespec& ts) {
 }
 }  // namespace
 
-TicketHolder::TicketHolder(int num) : _outof(num) {
+SemaphoreTicketHolder::SemaphoreTicketHolder(int num) : _outof(num) {
     check(sem_init(&_sem, 0, num));
 }
 
-TicketHolder::~TicketHolder() {
+SemaphoreTicketHolder::~SemaphoreTicketHolder() {
     check(sem_destroy(&_sem));
 }
 
-bool TicketHolder::tryAcquire() {
+bool SemaphoreTicketHolder::tryAcquire() {
     while (0 != sem_trywait(&_sem)) {
         if (errno == EAGAIN)
             return false;
@@ -89,16 +148,9 @@ bool TicketHolder::tryAcquire() {
     return true;
 }
 
-void TicketHolder::waitForTicket(OperationContext* opCtx) {
-    waitForTicketUntil(opCtx, Date_t::max());
-}
-
-bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
-    // Attempt to get a ticket without waiting in order to avoid expensive time calculations.
-    if (sem_trywait(&_sem) == 0) {
-        return true;
-    }
-
+bool SemaphoreTicketHolder::_waitForTicketUntil(OperationContext* opCtx,
+                                                Date_t until,
+                                                Priority priority) {
     const Milliseconds intervalMs(500);
     struct timespec ts;
 
@@ -129,11 +181,11 @@ bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
     return true;
 }
 
-void TicketHolder::release() {
+void SemaphoreTicketHolder::release() {
     check(sem_post(&_sem));
 }
 
-Status TicketHolder::resize(int newSize) {
+Status SemaphoreTicketHolder::resize(int newSize) {
     stdx::lock_guard<Latch> lk(_resizeMutex);
 
     if (newSize < 5)
@@ -159,43 +211,44 @@ Status TicketHolder::resize(int newSize) {
     return Status::OK();
 }
 
-int TicketHolder::available() const {
+int SemaphoreTicketHolder::available() const {
     int val = 0;
     check(sem_getvalue(&_sem, &val));
     return val;
 }
 
-int TicketHolder::used() const {
+int SemaphoreTicketHolder::used() const {
     return outof() - available();
 }
 
-int TicketHolder::outof() const {
+int SemaphoreTicketHolder::outof() const {
     return _outof.load();
 }
 
 #else
 
-TicketHolder::TicketHolder(int num) : _outof(num), _num(num) {}
+SemaphoreTicketHolder::SemaphoreTicketHolder(int num) : _outof(num), _num(num) {}
 
-TicketHolder::~TicketHolder() = default;
+SemaphoreTicketHolder::~SemaphoreTicketHolder() = default;
 
-bool TicketHolder::tryAcquire() {
+bool SemaphoreTicketHolder::tryAcquire() {
     stdx::lock_guard<Latch> lk(_mutex);
     return _tryAcquire();
 }
 
-void TicketHolder::waitForTicket(OperationContext* opCtx) {
+bool SemaphoreTicketHolder::_waitForTicketUntil(OperationContext* opCtx,
+                                                Date_t until,
+                                                Priority priority) {
     stdx::unique_lock<Latch> lk(_mutex);
 
-    if (opCtx) {
-        opCtx->waitForConditionOrInterrupt(_newTicket, lk, [this] { return _tryAcquire(); });
-    } else {
-        _newTicket.wait(lk, [this] { return _tryAcquire(); });
+    if (until == Date_t::max()) {
+        if (opCtx) {
+            opCtx->waitForConditionOrInterrupt(_newTicket, lk, [this] { return _tryAcquire(); });
+        } else {
+            _newTicket.wait(lk, [this] { return _tryAcquire(); });
+        }
+        return true;
     }
-}
-
-bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
-    stdx::unique_lock<Latch> lk(_mutex);
 
     if (opCtx) {
         return opCtx->waitForConditionOrInterruptUntil(
@@ -206,7 +259,7 @@ bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
     }
 }
 
-void TicketHolder::release() {
+void SemaphoreTicketHolder::release() {
     {
         stdx::lock_guard<Latch> lk(_mutex);
         _num++;
@@ -214,7 +267,7 @@ void TicketHolder::release() {
     _newTicket.notify_one();
 }
 
-Status TicketHolder::resize(int newSize) {
+Status SemaphoreTicketHolder::resize(int newSize) {
     stdx::lock_guard<Latch> lk(_mutex);
 
     int used = _outof.load() - _num;
@@ -236,19 +289,19 @@ Status TicketHolder::resize(int newSize) {
     return Status::OK();
 }
 
-int TicketHolder::available() const {
+int SemaphoreTicketHolder::available() const {
     return _num;
 }
 
-int TicketHolder::used() const {
+int SemaphoreTicketHolder::used() const {
     return outof() - _num;
 }
 
-int TicketHolder::outof() const {
+int SemaphoreTicketHolder::outof() const {
     return _outof.load();
 }
 
-bool TicketHolder::_tryAcquire() {
+bool SemaphoreTicketHolder::_tryAcquire() {
     if (_num <= 0) {
         if (_num < 0) {
             std::cerr << "DISASTER! in TicketHolder" << std::endl;
@@ -28,11 +28,14 @@
  */
 #pragma once
 
+#include <array>
+
 #if defined(__linux__)
 #include <semaphore.h>
 #endif
 
 #include "mongo/db/operation_context.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/platform/mutex.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/util/concurrency/mutex.h"
@@ -41,22 +44,35 @@
 
 namespace mongo {
 
+class BSONObjBuilder;
+
+/**
+ * Limits the number of operations that may run concurrently, e.g. inside the storage engine.
+ * Keeps statistics about the requests that had to wait for a ticket.
+ */
 class TicketHolder {
     TicketHolder(const TicketHolder&) = delete;
     TicketHolder& operator=(const TicketHolder&) = delete;
 
 public:
-    explicit TicketHolder(int num);
-    ~TicketHolder();
+    /**
+     * Admission priority of a ticket request. Holders that queue their waiters admit kNormal
+     * requests ahead of kLow ones; the others treat both alike.
+     */
+    enum class Priority { kNormal, kLow };
+
+    virtual ~TicketHolder() = default;
 
-    bool tryAcquire();
+    virtual bool tryAcquire() = 0;
 
     /**
      * Attempts to acquire a ticket. Blocks until a ticket is acquired or the OperationContext
      * 'opCtx' is killed, throwing an AssertionException.
      * If 'opCtx' is not provided or equal to nullptr, the wait is not interruptible.
      */
-    void waitForTicket(OperationContext* opCtx);
+    void waitForTicket(OperationContext* opCtx, Priority priority = Priority::kNormal) {
+        waitForTicketUntil(opCtx, Date_t::max(), priority);
+    }
     void waitForTicket() {
         waitForTicket(nullptr);
     }
@@ -68,21 +84,82 @@ public:
      * proceed.
      * If 'opCtx' is not provided or equal to nullptr, the wait is not interruptible.
      */
-    bool waitForTicketUntil(OperationContext* opCtx, Date_t until);
+    bool waitForTicketUntil(OperationContext* opCtx,
+                            Date_t until,
+                            Priority priority = Priority::kNormal);
     bool waitForTicketUntil(Date_t until) {
         return waitForTicketUntil(nullptr, until);
     }
-    void release();
 
-    Status resize(int newSize);
+    virtual void release() = 0;
+
+    virtual Status resize(int newSize) = 0;
+
+    virtual int available() const = 0;
+
+    virtual int used() const = 0;
+
+    virtual int outof() const = 0;
+
+    /**
+     * Appends the ticket counts, the number of queued requests and a histogram of the time
+     * requests waited for a ticket.
+     */
+    void appendStats(BSONObjBuilder* b) const;
+
+protected:
+    TicketHolder() = default;
+
+private:
+    // Upper bounds in milliseconds of the wait time histogram buckets. A last bucket holds the
+    // longer waits.
+    static constexpr std::array<long long, 5> kWaitTimeBucketBoundsMillis = {
+        1, 10, 100, 1000, 10000};
+
+    /**
+     * Waits for a ticket after an attempt to acquire one right away failed.
+     */
+    virtual bool _waitForTicketUntil(OperationContext* opCtx, Date_t until, Priority priority) = 0;
+
+    /**
+     * Appends the statistics specific to the implementation.
+     */
+    virtual void _appendImplStats(BSONObjBuilder* b) const {}
+
+    void _recordWait(Microseconds waitTime, bool acquired);
+
+    // Number of requests currently waiting for a ticket, by priority.
+    std::array<AtomicWord<int>, 2> _queued;
+
+    // Number of requests that waited for a ticket, by the bucket of their wait time.
+    std::array<AtomicWord<long long>, kWaitTimeBucketBoundsMillis.size() + 1> _waitTimeBuckets;
+    AtomicWord<long long> _totalWaitMicros;
+    AtomicWord<long long> _timedOut;
+};
+
+/**
+ * A TicketHolder with a fixed number of tickets, which does not distinguish priorities.
+ */
+class SemaphoreTicketHolder final : public TicketHolder {
+public:
+    explicit SemaphoreTicketHolder(int num);
+    ~SemaphoreTicketHolder() override;
 
-    int available() const;
+    bool tryAcquire() override;
 
-    int used() const;
+    void release() override;
 
-    int outof() const;
+    Status resize(int newSize) override;
+
+    int available() const override;
+
+    int used() const override;
+
+    int outof() const override;
 
 private:
+    bool _waitForTicketUntil(OperationContext* opCtx, Date_t until, Priority priority) override;
+
 #if defined(__linux__)
     mutable sem_t _sem;
 
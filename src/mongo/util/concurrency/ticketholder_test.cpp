@@ -32,14 +32,21 @@
 
 #include "mongo/platform/basic.h"
 
+#include <vector>
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/adaptive_ticketholder.h"
 #include "mongo/util/concurrency/ticketholder.h"
+#include "mongo/util/tick_source_mock.h"
+#include "mongo/util/time_support.h"
 
 namespace {
 using namespace mongo;
 
 TEST(TicketholderTest, BasicTimeout) {
-    TicketHolder holder(1);
+    SemaphoreTicketHolder holder(1);
     ASSERT_EQ(holder.used(), 0);
     ASSERT_EQ(holder.available(), 1);
     ASSERT_EQ(holder.outof(), 1);
@@ -72,4 +79,245 @@ TEST(TicketholderTest, BasicTimeout) {
     holder.release();
     ASSERT_EQ(holder.used(), 0);
 }
+
+/**
+ * Waits until 'holder' has 'count' queued requests.
+ */
+void waitForQueued(const AdaptiveTicketHolder& holder, int count) {
+    while (holder.queued() != count) {
+        sleepmillis(1);
+    }
+}
+
+TEST(AdaptiveTicketholderTest, BasicTimeout) {
+    AdaptiveTicketHolder holder(AdaptiveTicketHolder::kMinTickets);
+    for (int i = 0; i < AdaptiveTicketHolder::kMinTickets; ++i) {
+        ASSERT(holder.tryAcquire());
+    }
+    ASSERT_EQ(holder.available(), 0);
+    ASSERT_FALSE(holder.tryAcquire());
+    ASSERT_FALSE(holder.waitForTicketUntil(Date_t::now() + Milliseconds(2)));
+
+    holder.release();
+    ASSERT(holder.waitForTicketUntil(Date_t::now() + Milliseconds(2)));
+    ASSERT_EQ(holder.used(), AdaptiveTicketHolder::kMinTickets);
+    ASSERT_EQ(holder.queued(), 0);
+}
+
+TEST(AdaptiveTicketholderTest, LowPriorityRequestsAreNotStarved) {
+    const int numNormal = AdaptiveTicketHolder::kNormalGrantsPerLowGrant + 1;
+    AdaptiveTicketHolder holder(AdaptiveTicketHolder::kMinTickets);
+    for (int i = 0; i < AdaptiveTicketHolder::kMinTickets; ++i) {
+        ASSERT(holder.tryAcquire());
+    }
+
+    // Queue the low priority request first, then the normal priority ones, one after the other.
+    // The last element of 'granted' stands for the low priority request.
+    std::vector<AtomicWord<bool>> granted(numNormal + 1);
+    std::vector<stdx::thread> threads;
+    threads.emplace_back([&] {
+        holder.waitForTicket(nullptr, TicketHolder::Priority::kLow);
+        granted[numNormal].store(true);
+    });
+    waitForQueued(holder, 1);
+    for (int i = 0; i < numNormal; ++i) {
+        threads.emplace_back([&, i] {
+            holder.waitForTicket(nullptr);
+            granted[i].store(true);
+        });
+        waitForQueued(holder, i + 2);
+    }
+
+    // Normal priority requests go first, but only kNormalGrantsPerLowGrant of them in a row.
+    std::vector<int> expectedOrder;
+    for (int i = 0; i < AdaptiveTicketHolder::kNormalGrantsPerLowGrant; ++i) {
+        expectedOrder.push_back(i);
+    }
+    expectedOrder.push_back(numNormal);
+    expectedOrder.push_back(numNormal - 1);
+
+    for (size_t step = 0; step < expectedOrder.size(); ++step) {
+        holder.release();
+        while (!granted[expectedOrder[step]].load()) {
+            sleepmillis(1);
+        }
+        int numGranted = 0;
+        for (auto& g : granted) {
+            numGranted += g.load();
+        }
+        ASSERT_EQ(numGranted, static_cast<int>(step) + 1);
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(holder.used(), AdaptiveTicketHolder::kMinTickets);
+}
+
+TEST(AdaptiveTicketholderTest, CachePressureShrinksLimitDownToMinimum) {
+    TickSourceMock<Microseconds> tickSource;
+    AdaptiveTicketHolder holder(10, &tickSource);
+
+    // The first call only starts the interval.
+    tickSource.advance(Milliseconds(100));
+    holder.adjust(1.0);
+    ASSERT_EQ(holder.outof(), 10);
+
+    tickSource.advance(Milliseconds(100));
+    holder.adjust(1.0);
+    ASSERT_EQ(holder.outof(), 9);
+
+    for (int i = 0; i < 10; ++i) {
+        tickSource.advance(Milliseconds(100));
+        holder.adjust(1.0);
+    }
+    ASSERT_EQ(holder.outof(), AdaptiveTicketHolder::kMinTickets);
+}
+
+TEST(AdaptiveTicketholderTest, QueuedRequestsGrowLimitUpToMaximum) {
+    TickSourceMock<Microseconds> tickSource;
+    AdaptiveTicketHolder holder(10, &tickSource);
+
+    tickSource.advance(Milliseconds(100));
+    holder.adjust(0);
+    tickSource.advance(Milliseconds(100));
+    holder.adjust(1.0);
+    ASSERT_EQ(holder.outof(), 9);
+
+    // Without queued requests, the limit stays the same.
+    tickSource.advance(Milliseconds(100));
+    holder.adjust(0);
+    ASSERT_EQ(holder.outof(), 9);
+
+    for (int i = 0; i < 9; ++i) {
+        ASSERT(holder.tryAcquire());
+    }
+    stdx::thread waiter([&] { holder.waitForTicket(nullptr); });
+    waitForQueued(holder, 1);
+
+    // Growing the limit hands the new ticket to the queued request.
+    tickSource.advance(Milliseconds(100));
+    holder.adjust(0);
+    waiter.join();
+    ASSERT_EQ(holder.outof(), 10);
+    ASSERT_EQ(holder.used(), 10);
+
+    // The limit does not grow past the maximum.
+    ASSERT_FALSE(holder.waitForTicketUntil(Date_t::now()));
+    tickSource.advance(Milliseconds(100));
+    holder.adjust(0);
+    ASSERT_EQ(holder.outof(), 10);
+}
+
+/**
+ * Sets the baseline hold time of 'holder' to 1ms with one ticket held for 1ms during a 2ms
+ * interval.
+ */
+void setBaselineHoldTime(AdaptiveTicketHolder& holder, TickSourceMock<Microseconds>& tickSource) {
+    tickSource.advance(Milliseconds(1));
+    holder.adjust(0);
+
+    ASSERT(holder.tryAcquire());
+    tickSource.advance(Milliseconds(1));
+    holder.release();
+    tickSource.advance(Milliseconds(1));
+    holder.adjust(0);
+    ASSERT_EQ(holder.outof(), 10);
+
+    BSONObjBuilder stats;
+    holder.appendStats(&stats);
+    ASSERT_EQ(stats.obj()["baselineLatencyMicros"].numberDouble(), 1000);
+}
+
+TEST(AdaptiveTicketholderTest, LongerHoldTimesShrinkLimitWhenRequestsQueue) {
+    TickSourceMock<Microseconds> tickSource;
+    AdaptiveTicketHolder holder(10, &tickSource);
+    setBaselineHoldTime(holder, tickSource);
+
+    // Holding every ticket for ten times the baseline while a request waits means the server is
+    // overloaded.
+    for (int i = 0; i < 10; ++i) {
+        ASSERT(holder.tryAcquire());
+    }
+    stdx::thread waiter([&] { holder.waitForTicket(nullptr); });
+    waitForQueued(holder, 1);
+    tickSource.advance(Milliseconds(10));
+    for (int i = 0; i < 10; ++i) {
+        holder.release();
+    }
+    waiter.join();
+    holder.release();
+    holder.adjust(0);
+    ASSERT_EQ(holder.outof(), 9);
+
+    BSONObjBuilder after;
+    holder.appendStats(&after);
+    auto stats = after.obj();
+    ASSERT_GT(stats["latencyMicros"].numberDouble(),
+              AdaptiveTicketHolder::kLatencyTolerance * 1000);
+    ASSERT_EQ(stats["limitDecreases"].numberLong(), 1);
+}
+
+TEST(AdaptiveTicketholderTest, LongerHoldTimesWithoutQueuedRequestsKeepLimit) {
+    TickSourceMock<Microseconds> tickSource;
+    AdaptiveTicketHolder holder(10, &tickSource);
+    setBaselineHoldTime(holder, tickSource);
+
+    // Holding a ticket ten times longer than the baseline with nothing waiting only means the
+    // operations got longer, so the limit stays the same however long that lasts.
+    for (int i = 0; i < 5; ++i) {
+        ASSERT(holder.tryAcquire());
+        tickSource.advance(Milliseconds(10));
+        holder.release();
+        holder.adjust(0);
+        ASSERT_EQ(holder.outof(), 10);
+    }
+
+    BSONObjBuilder after;
+    holder.appendStats(&after);
+    auto stats = after.obj();
+    ASSERT_EQ(stats["latencyMicros"].numberDouble(), 10000);
+    ASSERT_EQ(stats["limitDecreases"].numberLong(), 0);
+}
+
+TEST(AdaptiveTicketholderTest, ResetRestoresMaximum) {
+    TickSourceMock<Microseconds> tickSource;
+    AdaptiveTicketHolder holder(10, &tickSource);
+
+    tickSource.advance(Milliseconds(100));
+    holder.adjust(1.0);
+    tickSource.advance(Milliseconds(100));
+    holder.adjust(1.0);
+    ASSERT_EQ(holder.outof(), 9);
+
+    // While adjusting, resizing only moves the ceiling down to the current limit.
+    ASSERT_OK(holder.resize(20));
+    ASSERT_EQ(holder.outof(), 9);
+
+    holder.reset();
+    ASSERT_EQ(holder.outof(), 20);
+
+    // Once reset, resizing sets the limit again.
+    ASSERT_OK(holder.resize(15));
+    ASSERT_EQ(holder.outof(), 15);
+    ASSERT_NOT_OK(holder.resize(AdaptiveTicketHolder::kMinTickets - 1));
+}
+
+TEST(AdaptiveTicketholderTest, AppendStats) {
+    AdaptiveTicketHolder holder(10);
+    ASSERT(holder.tryAcquire());
+
+    BSONObjBuilder builder;
+    holder.appendStats(&builder);
+    auto stats = builder.obj();
+    ASSERT_EQ(stats["out"].numberInt(), 1);
+    ASSERT_EQ(stats["available"].numberInt(), 9);
+    ASSERT_EQ(stats["totalTickets"].numberInt(), 10);
+    ASSERT_EQ(stats["queued"]["normal"].numberInt(), 0);
+    ASSERT_EQ(stats["queued"]["low"].numberInt(), 0);
+    ASSERT_EQ(stats["waits"]["timedOut"].numberLong(), 0);
+    ASSERT(stats["waits"]["histogram"]["ge10000ms"].isNumber());
+    ASSERT_EQ(stats["maxTickets"].numberInt(), 10);
+    ASSERT_FALSE(stats["adjusting"].trueValue());
+}
 }  // namespace